@@ -23,6 +23,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "os_core.h"
+#include "os_input.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -52,6 +53,7 @@ uint32_t Task2stack[256];
 uint32_t count1 = 0;
 uint32_t count2 = 0;
 
+OS_Input Key;
 OS_Sem Sem = {
   .count = 0,
   .WaitListHead = NULL,
@@ -78,21 +80,14 @@ void Task1(void)
 
 void Task2(void)
 {
+  OS_InputEvent event;
+
   for(;;){
-    if (HAL_GPIO_ReadPin(GPIOB, GPIO_PIN_9) == GPIO_PIN_RESET)
+    // 阻塞等待去抖后的按键事件，没有按键时不占 CPU
+    if (OS_InputWait(&event, OS_WAIT_FOREVER) && event.Type == OS_INPUT_PRESS)
     {
-      OS_Delay(20);
-      if (HAL_GPIO_ReadPin(GPIOB, GPIO_PIN_9) == GPIO_PIN_RESET)
-      {
-        OS_SemPost(&Sem);
-
-        while (HAL_GPIO_ReadPin(GPIOB, GPIO_PIN_9) == GPIO_PIN_RESET)
-        {
-          OS_Delay(10); // 每次检测间隔10ms，让出CPU
-        }
-      }
+      OS_SemPost(&Sem);
     }
-    OS_Delay(10);
   }
 }
 
@@ -131,6 +126,7 @@ int main(void)
   /* USER CODE BEGIN 2 */
   OS_TaskCreate(&Task1TCB, Task1, Task1stack, 256);
   OS_TaskCreate(&Task2TCB, Task2, Task2stack, 256);
+  OS_InputAdd(&Key, 0, GPIOB, GPIO_PIN_9, GPIO_PIN_RESET, 20);
   OS_StartScheduler();
   /* USER CODE END 2 */
 
@@ -23,6 +23,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "os_core.h"
+#include "os_tick.h"
+#include "os_time.h"
+#include "os_input.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -142,15 +145,15 @@ void UsageFault_Handler(void)
 /**
   * @brief This function handles System service call via SWI instruction.
   */
-void SVC_Handler(void)
-{
-  /* USER CODE BEGIN SVCall_IRQn 0 */
+// void SVC_Handler(void)
+// {
+//   /* USER CODE BEGIN SVCall_IRQn 0 */
 
-  /* USER CODE END SVCall_IRQn 0 */
-  /* USER CODE BEGIN SVCall_IRQn 1 */
+//   /* USER CODE END SVCall_IRQn 0 */
+//   /* USER CODE BEGIN SVCall_IRQn 1 */
 
-  /* USER CODE END SVCall_IRQn 1 */
-}
+//   /* USER CODE END SVCall_IRQn 1 */
+// }
 
 /**
   * @brief This function handles Debug monitor.
@@ -188,7 +191,9 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+#if (OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_SYSTICK)
   OS_Tick_Handler();
+#endif
   /* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -200,5 +205,39 @@ void SysTick_Handler(void)
 /******************************************************************************/
 
 /* USER CODE BEGIN 1 */
+#if (OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_TIM2)
+/**
+  * @brief This function handles TIM2 global interrupt (RTOS tick).
+  */
+void TIM2_IRQHandler(void)
+{
+  OS_Tick_AcknowledgeIRQ();
+  OS_Tick_Handler();
+}
+#endif
+
+/**
+  * @brief This function handles TIM3 global interrupt (OS_DelayUs one-shot timer).
+  */
+void TIM3_IRQHandler(void)
+{
+  OS_HrTimer_IRQHandler();
+}
+
+/**
+  * @brief This function handles EXTI line[9:5] interrupts (input event service).
+  */
+void EXTI9_5_IRQHandler(void)
+{
+  OS_Input_EXTI_IRQHandler();
+}
+
+/**
+  * @brief This function handles TIM4 global interrupt (input debounce timer).
+  */
+void TIM4_IRQHandler(void)
+{
+  OS_Input_TIM_IRQHandler();
+}
 
 /* USER CODE END 1 */
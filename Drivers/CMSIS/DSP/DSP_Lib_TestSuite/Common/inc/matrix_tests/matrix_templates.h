@@ -38,7 +38,7 @@
             (float32_t *)matrix_output_f32_ref,                         \
             ((output_type *) &matrix_output_ref)->pData,                \
             (float32_t *)matrix_output_f32_fut,                         \
-            ((output_type *) &matrix_output_ref)->pData,                \
+            ((output_type *) &matrix_output_fut)->pData,                \
             ((output_type *) &matrix_output_fut)->numRows *             \
             ((output_type *) &matrix_output_ref)->numCols,              \
             output_content_type,                                        \
@@ -48,16 +48,17 @@
 
 /**
  *  Compare the outputs from the function under test and the reference
- *  function using SNR. This is special for float64_t
+ *  function using SNR. This is special for float64_t, whose outputs are
+ *  matrix_output_fut64 and matrix_output_ref64.
  */
 #define MATRIX_DBL_SNR_COMPARE_INTERFACE(output_type)                   \
     do                                                                  \
     {                                                                   \
         TEST_ASSERT_DBL_SNR(                                            \
-            (float64_t *)matrix_output_f32_ref,                         \
-            (float64_t *)matrix_output_f32_fut,                         \
-            ((output_type *) &matrix_output_fut)->numRows *             \
-            ((output_type *) &matrix_output_ref)->numCols,              \
+            ((output_type *) &matrix_output_ref64)->pData,              \
+            ((output_type *) &matrix_output_fut64)->pData,              \
+            ((output_type *) &matrix_output_fut64)->numRows *           \
+            ((output_type *) &matrix_output_ref64)->numCols,            \
             MATRIX_SNR_THRESHOLD                                        \
             );                                                          \
     } while (0)
@@ -200,6 +201,17 @@
             ((input_type)(matrix_ptr))->numCols;        \
     } while (0)
 
+/* float64_t outputs are separate matrix instances; without their size the
+ * matrix check returns ARM_MATH_SIZE_MISMATCH and leaves them untouched. */
+#define MATRIX_TEST_CONFIG_SAMESIZE_OUTPUT64(matrix_ptr)            \
+    do                                                              \
+    {                                                               \
+        matrix_output_fut64.numRows = (matrix_ptr)->numRows;        \
+        matrix_output_fut64.numCols = (matrix_ptr)->numCols;        \
+        matrix_output_ref64.numRows = (matrix_ptr)->numRows;        \
+        matrix_output_ref64.numCols = (matrix_ptr)->numCols;        \
+    } while (0)
+
 #define MATRIX_TEST_CONFIG_TRANSPOSE_OUTPUT(input_type,     \
                                             matrix_ptr)     \
         do                                                  \
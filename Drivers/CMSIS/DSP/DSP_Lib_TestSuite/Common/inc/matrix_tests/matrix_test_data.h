@@ -41,6 +41,7 @@ extern MATRIX_TEST_BIGGEST_INPUT_TYPE matrix_output_f32_ref[MATRIX_TEST_MAX_ELTS
 extern MATRIX_TEST_BIGGEST_INPUT_TYPE matrix_output_scratch[MATRIX_TEST_MAX_ELTS];
 
 /* Matrix Inputs */
+extern float32_t matrix_f32_100_rand[100];
 MATRIX_DECLARE_INPUTS(f64);
 MATRIX_DECLARE_INPUTS(f32);
 MATRIX_DECLARE_INPUTS(q31);
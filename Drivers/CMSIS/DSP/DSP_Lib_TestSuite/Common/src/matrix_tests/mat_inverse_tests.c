@@ -54,7 +54,7 @@ JTEST_DEFINE_TEST(arm_mat_inverse_f64_test, arm_mat_inverse_f64)
                          
         if (MATRIX_TEST_VALID_SQUARE_DIMENSIONS(arm_matrix_instance_f64 *, mat_ptr))
         {
-            MATRIX_TEST_CONFIG_SAMESIZE_OUTPUT(arm_matrix_instance_f64 *, mat_ptr);
+            MATRIX_TEST_CONFIG_SAMESIZE_OUTPUT64(mat_ptr);
 
             /* arm_mat_inverse_f64() modifies its source input. Use the scratch
              * buffer to store a copy of the intended input. */
@@ -78,6 +78,115 @@ JTEST_DEFINE_TEST(arm_mat_inverse_f64_test, arm_mat_inverse_f64)
     return JTEST_TEST_PASSED;
 }
 
+/*--------------------------------------------------------------------------------*/
+/* Zero pivots */
+/*--------------------------------------------------------------------------------*/
+
+/* The random inputs never have a zero on the diagonal, so the row exchange is
+ * not reached by the tests above. The first matrix has a zero in the first
+ * pivot, the second gets an exact zero in the second pivot after the first
+ * column is eliminated (4 - 2 * 2). */
+#define MAT_INVERSE_PIVOT_DATA(type)          \
+    static type mat_inverse_##type##_zero_pivot1[9] = \
+    {                                           \
+        0, 2, 1,                                \
+        1, 1, 0,                                \
+        3, 0, 1                                 \
+    };                                          \
+    static type mat_inverse_##type##_zero_pivot2[9] = \
+    {                                           \
+        1, 2, 3,                                \
+        2, 4, 1,                                \
+        3, 1, 2                                 \
+    }
+
+MAT_INVERSE_PIVOT_DATA(float32_t);
+MAT_INVERSE_PIVOT_DATA(float64_t);
+
+static arm_matrix_instance_f32 matrix_f32_3x3_zero_pivot1 = {3, 3, mat_inverse_float32_t_zero_pivot1};
+static arm_matrix_instance_f32 matrix_f32_3x3_zero_pivot2 = {3, 3, mat_inverse_float32_t_zero_pivot2};
+static arm_matrix_instance_f64 matrix_f64_3x3_zero_pivot1 = {3, 3, mat_inverse_float64_t_zero_pivot1};
+static arm_matrix_instance_f64 matrix_f64_3x3_zero_pivot2 = {3, 3, mat_inverse_float64_t_zero_pivot2};
+
+ARR_DESC_DEFINE(arm_matrix_instance_f32 *,
+                matrix_f32_zero_pivot_inputs,
+                2,
+                CURLY(
+                    &matrix_f32_3x3_zero_pivot1,
+                    &matrix_f32_3x3_zero_pivot2
+                    ));
+
+ARR_DESC_DEFINE(arm_matrix_instance_f64 *,
+                matrix_f64_zero_pivot_inputs,
+                2,
+                CURLY(
+                    &matrix_f64_3x3_zero_pivot1,
+                    &matrix_f64_3x3_zero_pivot2
+                    ));
+
+JTEST_DEFINE_TEST(arm_mat_inverse_f32_zero_pivot_test, arm_mat_inverse_f32)
+{
+    TEMPLATE_DO_ARR_DESC(
+        mat_idx, arm_matrix_instance_f32 *, mat_ptr, matrix_f32_zero_pivot_inputs
+        ,
+        MATRIX_TEST_CONFIG_SAMESIZE_OUTPUT(arm_matrix_instance_f32 *, mat_ptr);
+
+        {
+            float32_t * original_pdata_ptr = mat_ptr->pData;
+
+            memcpy(matrix_output_scratch,
+                   mat_ptr->pData,
+                   mat_ptr->numRows * mat_ptr->numCols * sizeof(float32_t));
+            mat_ptr->pData = (void*) &matrix_output_scratch;
+
+            if (arm_mat_inverse_f32(mat_ptr, &matrix_output_fut) != ARM_MATH_SUCCESS)
+            {
+                mat_ptr->pData = original_pdata_ptr;
+                return JTEST_TEST_FAILED;
+            }
+            mat_ptr->pData = original_pdata_ptr;
+        }
+
+        ref_mat_inverse_f32(mat_ptr, &matrix_output_ref);
+
+        MATRIX_SNR_COMPARE_INTERFACE(arm_matrix_instance_f32,
+                                     float32_t);
+        );
+
+    return JTEST_TEST_PASSED;
+}
+
+JTEST_DEFINE_TEST(arm_mat_inverse_f64_zero_pivot_test, arm_mat_inverse_f64)
+{
+    TEMPLATE_DO_ARR_DESC(
+        mat_idx, arm_matrix_instance_f64 *, mat_ptr, matrix_f64_zero_pivot_inputs
+        ,
+        MATRIX_TEST_CONFIG_SAMESIZE_OUTPUT64(mat_ptr);
+
+        {
+            float64_t * original_pdata_ptr = mat_ptr->pData;
+
+            memcpy(matrix_output_scratch,
+                   mat_ptr->pData,
+                   mat_ptr->numRows * mat_ptr->numCols * sizeof(float64_t));
+            mat_ptr->pData = (void*) &matrix_output_scratch;
+
+            if (arm_mat_inverse_f64(mat_ptr, &matrix_output_fut64) != ARM_MATH_SUCCESS)
+            {
+                mat_ptr->pData = original_pdata_ptr;
+                return JTEST_TEST_FAILED;
+            }
+            mat_ptr->pData = original_pdata_ptr;
+        }
+
+        ref_mat_inverse_f64(mat_ptr, &matrix_output_ref64);
+
+        MATRIX_DBL_SNR_COMPARE_INTERFACE(arm_matrix_instance_f64);
+        );
+
+    return JTEST_TEST_PASSED;
+}
+
 /*--------------------------------------------------------------------------------*/
 /* Collect all tests in a group. */
 /*--------------------------------------------------------------------------------*/
@@ -89,4 +198,6 @@ JTEST_DEFINE_GROUP(mat_inverse_tests)
     */
     JTEST_TEST_CALL(arm_mat_inverse_f32_test);
     JTEST_TEST_CALL(arm_mat_inverse_f64_test);
+    JTEST_TEST_CALL(arm_mat_inverse_f32_zero_pivot_test);
+    JTEST_TEST_CALL(arm_mat_inverse_f64_zero_pivot_test);
 }
@@ -17,6 +17,59 @@
 
 JTEST_ARM_MAT_MULT_FAST_TEST(q31);
 
+/*--------------------------------------------------------------------------------*/
+/* Q31 with numColsA % 4 != 0 and numColsB > 1 */
+/*--------------------------------------------------------------------------------*/
+
+/* Without the DSP extension every output element is a dot product unrolled by
+ * four with a tail loop for the rest, and pInB has to move on to the next
+ * column of B. The shared inputs only have numColsA of 1 or 4 here. */
+static arm_matrix_instance_q31 matrix_q31_2x3_rand1 = {2, 3, (q31_t *) matrix_f32_100_rand};
+static arm_matrix_instance_q31 matrix_q31_3x2_rand2 = {3, 2, (q31_t *) (matrix_f32_100_rand + 1)};
+static arm_matrix_instance_q31 matrix_q31_4x3_rand1 = {4, 3, (q31_t *) matrix_f32_100_rand};
+static arm_matrix_instance_q31 matrix_q31_3x4_rand2 = {3, 4, (q31_t *) (matrix_f32_100_rand + 1)};
+static arm_matrix_instance_q31 matrix_q31_3x6_rand1 = {3, 6, (q31_t *) matrix_f32_100_rand};
+static arm_matrix_instance_q31 matrix_q31_6x3_rand2 = {6, 3, (q31_t *) (matrix_f32_100_rand + 1)};
+static arm_matrix_instance_q31 matrix_q31_2x7_rand1 = {2, 7, (q31_t *) matrix_f32_100_rand};
+static arm_matrix_instance_q31 matrix_q31_7x2_rand2 = {7, 2, (q31_t *) (matrix_f32_100_rand + 1)};
+
+ARR_DESC_DEFINE(arm_matrix_instance_q31 *,
+                matrix_q31_odd_a_inputs,
+                4,
+                CURLY(
+                    &matrix_q31_2x3_rand1,
+                    &matrix_q31_4x3_rand1,
+                    &matrix_q31_3x6_rand1,
+                    &matrix_q31_2x7_rand1
+                    ));
+
+ARR_DESC_DEFINE(arm_matrix_instance_q31 *,
+                matrix_q31_odd_b_inputs,
+                4,
+                CURLY(
+                    &matrix_q31_3x2_rand2,
+                    &matrix_q31_3x4_rand2,
+                    &matrix_q31_6x3_rand2,
+                    &matrix_q31_7x2_rand2
+                    ));
+
+JTEST_DEFINE_TEST(arm_mat_mult_fast_q31_odd_cols_test, arm_mat_mult_fast_q31)
+{
+    MATRIX_TEST_TEMPLATE_ELT2(
+        matrix_q31_odd_a_inputs,
+        matrix_q31_odd_b_inputs,
+        arm_matrix_instance_q31 * ,
+        arm_matrix_instance_q31,
+        TYPE_FROM_ABBREV(q31),
+        arm_mat_mult_fast_q31,
+        ARM_mat_mult_fast_INPUT_INTERFACE,
+        ref_mat_mult_fast_q31,
+        REF_mat_mult_fast_INPUT_INTERFACE,
+        MATRIX_TEST_CONFIG_MULTIPLICATIVE_OUTPUT,
+        MATRIX_TEST_VALID_MULTIPLICATIVE_DIMENSIONS,
+        MATRIX_SNR_COMPARE_INTERFACE);
+}
+
 /*--------------------------------------------------------------------------------*/
 /* Q15 Uses a Different interface than the others. */
 /*--------------------------------------------------------------------------------*/
@@ -53,5 +106,6 @@ JTEST_DEFINE_GROUP(mat_mult_fast_tests)
       To skip a test, comment it out.
     */
     JTEST_TEST_CALL(arm_mat_mult_fast_q31_test);
+    JTEST_TEST_CALL(arm_mat_mult_fast_q31_odd_cols_test);
     JTEST_TEST_CALL(arm_mat_mult_fast_q15_test);
 }
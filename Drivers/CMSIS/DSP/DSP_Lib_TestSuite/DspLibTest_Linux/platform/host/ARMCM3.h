@@ -0,0 +1,26 @@
+/* Host stand-in for the ARMCM3 device header.
+ *
+ * jtest_systick.h only needs the SysTick registers. On the host they are
+ * emulated by host_systick() in jtest_linux.c on top of CLOCK_MONOTONIC, so
+ * the "cycles" reported by JTEST_COUNT_CYCLES() are nanoseconds. */
+#ifndef ARMCM3_H
+#define ARMCM3_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+#define SysTick_CTRL_CLKSOURCE_Msk  (1UL << 2U)
+#define SysTick_CTRL_ENABLE_Msk     (1UL << 0U)
+
+SysTick_Type * host_systick(void);
+
+#define SysTick (host_systick())
+
+#endif /* ARMCM3_H */
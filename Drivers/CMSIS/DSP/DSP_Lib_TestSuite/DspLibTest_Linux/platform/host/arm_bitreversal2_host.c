@@ -0,0 +1,53 @@
+/* C versions of the assembly routines in arm_bitreversal2.S, which only
+ * assembles for ARM targets. The tables hold byte offsets into the buffer, as
+ * generated for the CFFT instances in arm_common_tables.c. */
+#include "arm_math.h"
+
+void arm_bitreversal_32(
+  uint32_t * pSrc,
+  const uint16_t bitRevLen,
+  const uint16_t * pBitRevTab)
+{
+  uint32_t i;
+  uint32_t tmp;
+  uint32_t *a;
+  uint32_t *b;
+
+  for (i = 0U; i < bitRevLen; i += 2U)
+  {
+    a = (uint32_t *) ((uint8_t *) pSrc + pBitRevTab[i]);
+    b = (uint32_t *) ((uint8_t *) pSrc + pBitRevTab[i + 1U]);
+
+    /* real */
+    tmp = a[0];
+    a[0] = b[0];
+    b[0] = tmp;
+
+    /* imag */
+    tmp = a[1];
+    a[1] = b[1];
+    b[1] = tmp;
+  }
+}
+
+void arm_bitreversal_16(
+  uint16_t * pSrc,
+  const uint16_t bitRevLen,
+  const uint16_t * pBitRevTab)
+{
+  uint32_t i;
+  uint32_t tmp;
+  uint32_t *a;
+  uint32_t *b;
+
+  for (i = 0U; i < bitRevLen; i += 2U)
+  {
+    /* q15 complex values are half the size of the 32-bit ones */
+    a = (uint32_t *) ((uint8_t *) pSrc + (pBitRevTab[i] >> 1U));
+    b = (uint32_t *) ((uint8_t *) pSrc + (pBitRevTab[i + 1U] >> 1U));
+
+    tmp = *a;
+    *a = *b;
+    *b = tmp;
+  }
+}
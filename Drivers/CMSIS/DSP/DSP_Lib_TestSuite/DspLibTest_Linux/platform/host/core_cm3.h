@@ -0,0 +1,48 @@
+/* Host stand-in for CMSIS core_cm3.h.
+ *
+ * arm_math.h includes core_cm3.h for ARM_MATH_CM3. On the host only the
+ * compiler macros and the few intrinsics the Cortex-M3 code paths of the DSP
+ * and NN libraries use are needed; the register definitions are not. */
+#ifndef __CORE_CM3_H_GENERIC
+#define __CORE_CM3_H_GENERIC
+
+#include <stdint.h>
+
+#define __ASM              __asm
+#define __INLINE           inline
+#define __STATIC_INLINE    static inline
+#define __STATIC_FORCEINLINE __attribute__((always_inline)) static inline
+
+/* Count leading zeros, CLZ returns 32 for 0. */
+static inline uint8_t __CLZ(uint32_t value)
+{
+    return (value == 0u) ? 32u : (uint8_t)__builtin_clz(value);
+}
+
+/* Signed saturate to sat bits (1..32), as the SSAT instruction. */
+static inline int32_t __SSAT_host(int32_t val, uint32_t sat)
+{
+    int32_t max = (int32_t)((1u << (sat - 1u)) - 1u);
+    int32_t min = -max - 1;
+
+    return (val > max) ? max : ((val < min) ? min : val);
+}
+#define __SSAT(ARG1, ARG2) __SSAT_host((int32_t)(ARG1), (ARG2))
+
+/* Unsigned saturate to sat bits (0..31), as the USAT instruction. */
+static inline uint32_t __USAT_host(int32_t val, uint32_t sat)
+{
+    uint32_t max = (1u << sat) - 1u;
+
+    return (val < 0) ? 0u : (((uint32_t)val > max) ? max : (uint32_t)val);
+}
+#define __USAT(ARG1, ARG2) __USAT_host((int32_t)(ARG1), (ARG2))
+
+/* Rotate right, as the ROR instruction. */
+static inline uint32_t __ROR(uint32_t op1, uint32_t op2)
+{
+    op2 %= 32u;
+    return (op2 == 0u) ? op1 : ((op1 >> op2) | (op1 << (32u - op2)));
+}
+
+#endif /* __CORE_CM3_H_GENERIC */
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <string.h>
+#include "jtest.h"
+#include "all_tests.h"
+
+/*--------------------------------------------------------------------------------*/
+/* Action Triggers */
+/*--------------------------------------------------------------------------------*/
+
+/* Replaces jtest_trigger_action.c. Instead of having the Keil debugger break on
+ * these functions and read JTEST_FW.str_buffer, the buffer is written straight
+ * to stdout (semihosted on QEMU). The output is the same text the uVision INI
+ * scripts log, so run_tests.sh parses it the way parseLog.py parses theirs. */
+
+void test_start    (void) {
+  JTEST_FW.test_start++;
+}
+
+void test_end      (void) {
+  JTEST_FW.test_end++;
+}
+
+void group_start   (void) {
+  JTEST_FW.group_start++;
+}
+
+void group_end     (void) {
+  JTEST_FW.group_end++;
+}
+
+void dump_str      (void) {
+  /* jtest_dump_str_segments() calls this once per segment and shifts the
+   * buffer down in between, so only the first segment is printed each time. */
+  fwrite(JTEST_FW.str_buffer, 1,
+         strnlen(JTEST_FW.str_buffer, JTEST_STR_MAX_OUTPUT_SIZE), stdout);
+  JTEST_FW.dump_str++;
+}
+
+void dump_data     (void) {
+  JTEST_FW.dump_data++;
+}
+
+void exit_fw       (void) {
+  fflush(stdout);
+  JTEST_FW.exit_fw++;
+}
+
+/*--------------------------------------------------------------------------------*/
+/* Host SysTick */
+/*--------------------------------------------------------------------------------*/
+
+#ifdef JTEST_LINUX_HOST
+#include <time.h>
+
+static SysTick_Type host_systick_regs;
+static uint64_t     host_systick_start;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* JTEST_COUNT_CYCLES() goes through the SysTick pointer for every register
+ * access. While the counter is disabled each access re-arms the start time, so
+ * the last one before JTEST_SYSTICK_START() marks the start. Once enabled, VAL
+ * counts down one per nanosecond from LOAD and stops at zero like the 24-bit
+ * hardware counter would wrap. */
+SysTick_Type * host_systick(void)
+{
+    uint64_t now = host_now_ns();
+    uint64_t elapsed;
+
+    if ((host_systick_regs.CTRL & SysTick_CTRL_ENABLE_Msk) == 0)
+    {
+        host_systick_start = now;
+    }
+    else
+    {
+        elapsed = now - host_systick_start;
+        host_systick_regs.VAL = (elapsed >= host_systick_regs.LOAD) ?
+            0 : host_systick_regs.LOAD - (uint32_t)elapsed;
+    }
+
+    return &host_systick_regs;
+}
+#endif /* JTEST_LINUX_HOST */
+
+/*--------------------------------------------------------------------------------*/
+/* Main */
+/*--------------------------------------------------------------------------------*/
+
+int main(void)
+{
+    JTEST_INIT();               /* Initialize test framework. */
+
+    JTEST_GROUP_CALL(all_tests); /* Run all tests. */
+
+    JTEST_ACT_EXIT_FW();        /* Exit test framework.  */
+
+    return (JTEST_FW.failed == 0) ? 0 : 1;
+}
@@ -213,12 +213,15 @@ arm_status arm_mat_inverse_f64(
         return ARM_MATH_SINGULAR;
       }
 
-      /* Restore pInT1  */
-      pInT1 = pIn;
+      /* Restore pInT1 to the pivot element  */
+      pInT1 = pIn + (l * numCols);
 
       /* Destination pointer modifier */
       k = 1U;
 
+      /* No row exchange done yet for this column */
+      flag = 0U;
+
       /* Check if the pivot element is the most significant of the column */
       if ( (in > 0.0f ? in : -in) != maxC)
       {
@@ -228,7 +231,7 @@ arm_status arm_mat_inverse_f64(
         while (i > 0U)
         {
           /* Update the input and destination pointers */
-          pInT2 = pInT1 + (numCols * l);
+          pInT2 = pInT1 + (numCols * k);
           pOutT2 = pOutT1 + (numCols * k);
 
           /* Look for the most significant element to
@@ -528,6 +531,9 @@ arm_status arm_mat_inverse_f64(
       /* Destination pointer modifier */
       k = 1U;
 
+      /* No row exchange done yet for this column */
+      flag = 0U;
+
       /* Check if the pivot element is zero */
       if (*pInT1 == 0.0f)
       {
@@ -535,7 +541,7 @@ arm_status arm_mat_inverse_f64(
         for (i = (l + 1U); i < numRows; i++)
         {
           /* Update the input and destination pointers */
-          pInT2 = pInT1 + (numCols * l);
+          pInT2 = pInT1 + (numCols * k);
           pOutT2 = pOutT1 + (numCols * k);
 
           /* Check if there is a non zero pivot element to
@@ -197,7 +197,7 @@ arm_status arm_mat_mult_fast_q31(
           colCnt--;
         }
 
-#ifdef ARM_MATH_CM0_FAMILY
+#if !defined (ARM_MATH_DSP)
         /* If the columns of pSrcA is not a multiple of 4, compute any remaining output samples here. */
         colCnt = numColsA % 0x4U;
         while (colCnt > 0U)
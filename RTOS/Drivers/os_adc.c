@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ * @file    os_adc.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   ADC 连续采样服务实现
+ *
+ * 乒乓交接：
+ * - 半区 h 填满时 DMA 开始写另一个半区 (1-h)。此时如果 1-h 还在等着被取走，
+ *   或者正被处理任务使用，这块数据就会被覆盖，记一次溢出
+ * - Pending 只记最新填满的半区，被覆盖的旧块直接作废；信号量里多出来的计数
+ *   会让 OS_AdcWait 看到 Pending == -1，回去接着等
+ * - Pending/Owned 由 DMA 中断和处理任务共同修改，任务一侧关中断操作
+ *
+ ******************************************************************************
+ */
+
+#include "os_adc.h"
+#include "os_dma.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_AdcStream *AdcListHead = NULL; // 已注册的采样流，用于从 HAL 句柄找到采样流
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static OS_AdcStream *AdcFind(ADC_HandleTypeDef *hadc)
+{
+    OS_AdcStream *p_adc;
+
+    for (p_adc = AdcListHead; p_adc != NULL; p_adc = p_adc->Next)
+    {
+        if (p_adc->Hadc == hadc)
+            return p_adc;
+    }
+    return NULL;
+}
+
+// 从注册表里摘掉采样流，不在表里就什么也不做
+static void AdcUnlink(OS_AdcStream *p_adc)
+{
+    OS_AdcStream **pp;
+
+    OS_EnterCritical();
+    for (pp = &AdcListHead; *pp != NULL && *pp != p_adc; pp = &(*pp)->Next)
+    {
+    }
+    if (*pp != NULL)
+    {
+        *pp = p_adc->Next;
+    }
+    OS_ExitCritical();
+}
+
+// 半区 half 填满，DMA 正在写另一个半区
+static void AdcBlockDone(ADC_HandleTypeDef *hadc, int8_t half)
+{
+    OS_AdcStream *p_adc = AdcFind(hadc);
+
+    if (p_adc == NULL)
+        return;
+
+    if (p_adc->Pending != -1 || p_adc->Owned == 1 - half)
+    {
+        p_adc->Overruns++;
+    }
+
+    p_adc->Pending = half;
+    p_adc->Sequence++;
+    OS_SemPost(&p_adc->Ready);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_AdcStart(OS_AdcStream *p_adc, ADC_HandleTypeDef *hadc, uint16_t *buffer,
+                    uint32_t block_samples, uint8_t channels)
+{
+    // 1. 检查参数：半满/全满回调在 DMA 中断里释放信号量，DMA 中断必须被内核临界区屏蔽
+    if (p_adc == NULL || hadc == NULL || buffer == NULL || channels == 0 ||
+        block_samples == 0 || block_samples % channels != 0 ||
+        hadc->DMA_Handle == NULL || hadc->DMA_Handle->Init.Mode != DMA_CIRCULAR ||
+        !OS_DmaIrqKernelAware(hadc->DMA_Handle))
+    {
+        return 0;
+    }
+
+    // 2. 重复启动时先摘掉上一次的注册，否则节点会被插入两次、链表成环
+    AdcUnlink(p_adc);
+
+    // 3. 填写采样流
+    p_adc->Hadc = hadc;
+    p_adc->Buffer = buffer;
+    p_adc->BlockSamples = block_samples;
+    p_adc->Channels = channels;
+    p_adc->Pending = -1;
+    p_adc->Owned = -1;
+    p_adc->Overruns = 0;
+    p_adc->Sequence = 0;
+    p_adc->Ready.count = 0;
+    p_adc->Ready.WaitListHead = NULL;
+    p_adc->Ready.WaitListTail = NULL;
+
+    // 4. 注册，然后启动循环 DMA；启动失败就撤销注册
+    OS_EnterCritical();
+    p_adc->Next = AdcListHead;
+    AdcListHead = p_adc;
+    OS_ExitCritical();
+
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t *)buffer, 2 * block_samples) != HAL_OK)
+    {
+        AdcUnlink(p_adc);
+        return 0;
+    }
+    return 1;
+}
+
+void OS_AdcStop(OS_AdcStream *p_adc)
+{
+    // 先停 DMA，之后不会再有回调找这个采样流
+    HAL_ADC_Stop_DMA(p_adc->Hadc);
+    AdcUnlink(p_adc);
+}
+
+uint16_t *OS_AdcWait(OS_AdcStream *p_adc, uint32_t *p_seq, uint32_t timeout)
+{
+    int8_t half;
+    uint32_t seq;
+
+    for (;;)
+    {
+        if (!OS_SemWaitTimeout(&p_adc->Ready, timeout))
+            return NULL;
+
+        OS_EnterCritical();
+        half = p_adc->Pending;
+        seq = p_adc->Sequence;
+        if (half != -1)
+        {
+            p_adc->Pending = -1;
+            p_adc->Owned = half;
+        }
+        OS_ExitCritical();
+
+        if (half != -1)
+            break;
+        // 被覆盖的旧块留下的计数，接着等
+    }
+
+    if (p_seq != NULL)
+        *p_seq = seq;
+
+    return &p_adc->Buffer[half * p_adc->BlockSamples];
+}
+
+void OS_AdcRelease(OS_AdcStream *p_adc)
+{
+    p_adc->Owned = -1;
+}
+
+uint32_t OS_AdcOverruns(const OS_AdcStream *p_adc)
+{
+    return p_adc->Overruns;
+}
+
+void OS_AdcToQ15(const OS_AdcStream *p_adc, const uint16_t *block, uint8_t channel, int16_t *dst)
+{
+    uint32_t i;
+    uint32_t n = p_adc->BlockSamples / p_adc->Channels;
+
+    block += channel;
+    for (i = 0; i < n; i++)
+    {
+        // 12 位右对齐：减去中点后左移 4 位，满量程正好对应 q15 的 [-1, 1)
+        dst[i] = (int16_t)(((int32_t)*block - 2048) << 4);
+        block += p_adc->Channels;
+    }
+}
+
+/* HAL 回调 ------------------------------------------------------------ */
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    AdcBlockDone(hadc, 0);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    AdcBlockDone(hadc, 1);
+}
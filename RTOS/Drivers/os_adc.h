@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    os_adc.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   ADC 连续采样服务 (HAL adc + 循环 DMA，乒乓缓冲)
+ *
+ * - DMA 循环搬运到一块两倍块长的缓冲区，前后两半轮流作为乒乓缓冲
+ * - 半满/全满中断各释放一次信号量，处理任务每次拿到一整块，不再有逐个采样的中断
+ * - DMA 开始覆盖一块还没被处理完（或还没被取走）的数据时记一次溢出
+ *
+ * 使用前提：ADC 由应用配置成扫描模式、外部定时器触发（决定采样率），
+ * DMA 配成 DMA_CIRCULAR、半字宽度，DMA 中断优先级数值 >= OS_CFG_MAX_SYSCALL_PRIO
+ * （CubeMX 默认是 0，要改，否则 OS_AdcStart 返回 0）。本驱动实现了 HAL_ADC_ConvHalfCpltCallback /
+ * HAL_ADC_ConvCpltCallback
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_ADC_H
+#define __OS_ADC_H
+
+#include "os_core.h"
+#include "stm32f1xx_hal.h"
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  ADC 采样流结构体定义
+ */
+typedef struct Adc_Stream
+{
+    ADC_HandleTypeDef *Hadc;             ///< HAL ADC 句柄
+    uint16_t *Buffer;                    ///< DMA 缓冲区，长度 2 * BlockSamples
+    uint32_t BlockSamples;               ///< 一块的采样数（所有通道交织在一起）
+    uint8_t Channels;                    ///< 扫描的通道数
+    volatile int8_t Pending;             ///< 已经填满、还没被取走的半区，-1 表示没有
+    volatile int8_t Owned;               ///< 处理任务正在使用的半区，-1 表示没有
+    volatile uint32_t Overruns;          ///< 溢出（丢块）次数
+    volatile uint32_t Sequence;          ///< 已经填满的块数，用来发现丢块
+    OS_Sem Ready;                        ///< 每填满半区释放一次
+    struct Adc_Stream *Next;             ///< 指向下一个已注册的采样流
+} OS_AdcStream;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化采样流并启动循环 DMA
+ * @param  buffer       : DMA 缓冲区，长度 2 * block_samples 个半字
+ * @param  block_samples: 一块的采样数，必须是 channels 的整数倍
+ * @param  channels     : 扫描的通道数
+ * @return uint8_t      : 1 成功，0 参数错误、DMA 不是循环模式、DMA 中断优先级高于内核天花板
+ *                        或 HAL_ADC_Start_DMA 失败
+ * @note   停止后可以再次启动同一个采样流
+ */
+uint8_t OS_AdcStart(OS_AdcStream *p_adc, ADC_HandleTypeDef *hadc, uint16_t *buffer,
+                    uint32_t block_samples, uint8_t channels);
+
+/**
+ * @brief  停止采样，并把采样流从注册表中摘掉（之后可以释放或另作他用）
+ */
+void OS_AdcStop(OS_AdcStream *p_adc);
+
+/**
+ * @brief  等待下一块数据（只能有一个处理任务）
+ * @param  p_seq  : 返回这一块的序号，可以为 NULL；序号不连续说明中间丢过块
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint16_t*: 一整块交织的采样，处理完必须调用 OS_AdcRelease；超时返回 NULL
+ */
+uint16_t *OS_AdcWait(OS_AdcStream *p_adc, uint32_t *p_seq, uint32_t timeout);
+
+/**
+ * @brief  归还 OS_AdcWait 拿到的块
+ */
+void OS_AdcRelease(OS_AdcStream *p_adc);
+
+/**
+ * @brief  读取溢出次数
+ */
+uint32_t OS_AdcOverruns(const OS_AdcStream *p_adc);
+
+/**
+ * @brief  从交织的块里取出一个通道，转换成 q15（12 位无符号 -> 以 2048 为零点的有符号）
+ * @param  block  : OS_AdcWait 返回的块
+ * @param  channel: 通道序号（扫描顺序，从 0 开始）
+ * @param  dst    : 输出，长度 BlockSamples / Channels，可以直接交给 CMSIS-DSP 的 q15 函数
+ */
+void OS_AdcToQ15(const OS_AdcStream *p_adc, const uint16_t *block, uint8_t channel, int16_t *dst);
+
+#endif /* __OS_ADC_H */
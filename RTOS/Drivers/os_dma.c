@@ -0,0 +1,231 @@
+/**
+ ******************************************************************************
+ * @file    os_dma.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   存储器到存储器 DMA 拷贝服务实现
+ *
+ * - 所有通道共用一个请求队列；通道空闲时从队头取请求启动
+ * - 队列和通道的 Active 由任务（入队）和 DMA 中断（完成、启动下一个）共同修改，
+ *   任务一侧关中断操作
+ * - 每次启动前按对齐情况选传输宽度（字/半字/字节），宽度变了才重新初始化通道
+ * - 完成时有回调就调用回调，否则释放信号量。二者只做其一：
+ *   释放信号量之后请求就可能已经被等待者释放了
+ *
+ ******************************************************************************
+ */
+
+#include "os_dma.h"
+#include <string.h>
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_DmaChannel *ChannelListHead = NULL; // 通道池
+static OS_DmaCopyReq *QueueHead = NULL;       // 请求队列头
+static OS_DmaCopyReq *QueueTail = NULL;       // 请求队列尾
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t DmaWidth(const void *dst, const void *src, uint32_t len)
+{
+    uint32_t bits = (uint32_t)dst | (uint32_t)src | len;
+
+    if ((bits & 3u) == 0)
+        return 4;
+    if ((bits & 1u) == 0)
+        return 2;
+    return 1;
+}
+
+static void DmaFinish(OS_DmaCopyReq *p_req, uint8_t status)
+{
+    void (*callback)(OS_DmaCopyReq *, void *) = p_req->Callback;
+
+    p_req->Status = status;
+    if (callback != NULL)
+        callback(p_req, p_req->Arg);
+    else
+        OS_SemPost(&p_req->Done);
+}
+
+// 空闲通道从队头取请求启动，调用者负责关中断或处在 DMA 中断里
+static void DmaStart(OS_DmaChannel *p_ch)
+{
+    OS_DmaCopyReq *p_req;
+    uint32_t width;
+    uint32_t palign;
+    uint32_t malign;
+
+    while (p_ch->Active == NULL && QueueHead != NULL)
+    {
+        // 1. 出队
+        p_req = QueueHead;
+        QueueHead = p_req->Next;
+        if (QueueHead == NULL)
+            QueueTail = NULL;
+
+        // 2. 传输宽度变了才重新初始化通道
+        width = DmaWidth(p_req->Dst, p_req->Src, p_req->Len);
+        palign = (width == 4) ? DMA_PDATAALIGN_WORD : (width == 2) ? DMA_PDATAALIGN_HALFWORD : DMA_PDATAALIGN_BYTE;
+        malign = (width == 4) ? DMA_MDATAALIGN_WORD : (width == 2) ? DMA_MDATAALIGN_HALFWORD : DMA_MDATAALIGN_BYTE;
+        if (p_ch->Hdma.Init.PeriphDataAlignment != palign)
+        {
+            p_ch->Hdma.Init.PeriphDataAlignment = palign;
+            p_ch->Hdma.Init.MemDataAlignment = malign;
+            HAL_DMA_Init(&p_ch->Hdma);
+        }
+
+        // 3. 启动，存储器到存储器时 CPAR 是源、CMAR 是目的
+        p_ch->Active = p_req;
+        if (HAL_DMA_Start_IT(&p_ch->Hdma, (uint32_t)p_req->Src, (uint32_t)p_req->Dst, p_req->Len / width) != HAL_OK)
+        {
+            p_ch->Active = NULL;
+            DmaFinish(p_req, OS_DMA_ERROR);
+        }
+    }
+}
+
+static void DmaComplete(OS_DmaChannel *p_ch, uint8_t status)
+{
+    OS_DmaCopyReq *p_req = p_ch->Active;
+
+    p_ch->Active = NULL;
+    if (p_req != NULL)
+        DmaFinish(p_req, status);
+
+    DmaStart(p_ch);
+}
+
+// Hdma 是 OS_DmaChannel 的第一个成员，句柄地址就是通道地址
+static void DmaXferCplt(DMA_HandleTypeDef *hdma)
+{
+    DmaComplete((OS_DmaChannel *)hdma, OS_DMA_OK);
+}
+
+static void DmaXferError(DMA_HandleTypeDef *hdma)
+{
+    DmaComplete((OS_DmaChannel *)hdma, OS_DMA_ERROR);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_DmaCopyAddChannel(OS_DmaChannel *p_ch, DMA_Channel_TypeDef *instance)
+{
+    int32_t irqn;
+
+    if (p_ch == NULL)
+        return 0;
+    p_ch->Hdma.Instance = instance;
+    irqn = OS_DmaIRQn(&p_ch->Hdma);
+    if (irqn < 0)
+        return 0;
+
+    // 1. 配置成存储器到存储器，两边地址都递增
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    p_ch->Hdma.Init.Direction = DMA_MEMORY_TO_MEMORY;
+    p_ch->Hdma.Init.PeriphInc = DMA_PINC_ENABLE;
+    p_ch->Hdma.Init.MemInc = DMA_MINC_ENABLE;
+    p_ch->Hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    p_ch->Hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    p_ch->Hdma.Init.Mode = DMA_NORMAL;
+    p_ch->Hdma.Init.Priority = DMA_PRIORITY_LOW; // 不和外设抢总线
+    if (HAL_DMA_Init(&p_ch->Hdma) != HAL_OK)
+        return 0;
+
+    p_ch->Hdma.XferCpltCallback = DmaXferCplt;
+    p_ch->Hdma.XferHalfCpltCallback = NULL;
+    p_ch->Hdma.XferErrorCallback = DmaXferError;
+    p_ch->Hdma.XferAbortCallback = NULL;
+    p_ch->Active = NULL;
+
+    NVIC_SetPriority((IRQn_Type)irqn, 14);
+    NVIC_EnableIRQ((IRQn_Type)irqn);
+
+    // 2. 加入通道池，顺便把排队中的请求启动起来
+    OS_EnterCritical();
+    p_ch->Next = ChannelListHead;
+    ChannelListHead = p_ch;
+    DmaStart(p_ch);
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_DmaCopyAsync(OS_DmaCopyReq *p_req, void *dst, const void *src, uint32_t len,
+                        void (*callback)(OS_DmaCopyReq *, void *), void *arg)
+{
+    OS_DmaChannel *p_ch;
+
+    if (p_req == NULL || dst == NULL || src == NULL || len == 0 ||
+        len / DmaWidth(dst, src, len) > 0xFFFF || ChannelListHead == NULL)
+    {
+        return 0;
+    }
+
+    p_req->Src = src;
+    p_req->Dst = dst;
+    p_req->Len = len;
+    p_req->Callback = callback;
+    p_req->Arg = arg;
+    p_req->Status = OS_DMA_PENDING;
+    p_req->Next = NULL;
+    p_req->Done.count = 0;
+    p_req->Done.WaitListHead = NULL;
+    p_req->Done.WaitListTail = NULL;
+
+    OS_EnterCritical();
+
+    // 1. 入队
+    if (QueueTail == NULL)
+        QueueHead = p_req;
+    else
+        QueueTail->Next = p_req;
+    QueueTail = p_req;
+
+    // 2. 有空闲通道就启动
+    for (p_ch = ChannelListHead; p_ch != NULL && QueueHead != NULL; p_ch = p_ch->Next)
+    {
+        DmaStart(p_ch);
+    }
+
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_DmaCopyWait(OS_DmaCopyReq *p_req, uint32_t timeout)
+{
+    if (p_req->Status == OS_DMA_PENDING)
+        OS_SemWaitTimeout(&p_req->Done, timeout);
+
+    return p_req->Status;
+}
+
+void OS_DmaCopy(void *dst, const void *src, uint32_t len)
+{
+    OS_DmaCopyReq req;
+
+    // 1. 不值得或者不能阻塞：直接拷贝
+    if (len < OS_DMA_COPY_MIN || OS_CPU_InISR() || g_OSRunning == 0 || g_SchedLockNesting > 0 ||
+        !OS_DmaCopyAsync(&req, dst, src, len, NULL, NULL))
+    {
+        memcpy(dst, src, len);
+        return;
+    }
+
+    // 2. 阻塞等待，拷贝期间别的任务运行
+    while (OS_DmaCopyWait(&req, OS_WAIT_FOREVER) == OS_DMA_PENDING)
+        ;
+
+    // 3. DMA 出错时退回 CPU 拷贝，保证调用者拿到的数据是对的
+    if (req.Status != OS_DMA_OK)
+    {
+        memcpy(dst, src, len);
+    }
+}
+
+void OS_DmaCopy_IRQHandler(OS_DmaChannel *p_ch)
+{
+    HAL_DMA_IRQHandler(&p_ch->Hdma);
+}
@@ -0,0 +1,134 @@
+/**
+ ******************************************************************************
+ * @file    os_dma.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   存储器到存储器 DMA 拷贝服务 (HAL dma)
+ *
+ * 把大块内存搬移交给 DMA1，CPU 去运行别的任务：
+ * - 应用把空闲的 DMA1 通道交给本服务（OS_DmaCopyAddChannel），组成通道池
+ * - 拷贝请求先进先出排队，有空闲通道就启动；完成中断里接着启动下一个
+ * - 完成时可以回调，也可以让请求者阻塞等待（OS_DmaCopy）
+ * - 短于 OS_DMA_COPY_MIN 的拷贝直接 memcpy，DMA 的启动和中断开销比它还大
+ *
+ * 需要在对应的 DMA1_ChannelX_IRQHandler 里调用 OS_DmaCopy_IRQHandler(&channel)
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_DMA_H
+#define __OS_DMA_H
+
+#include "os_core.h"
+#include "stm32f1xx_hal.h"
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#ifndef OS_DMA_COPY_MIN
+/**
+ * OS_DmaCopy 改用 DMA 的最小字节数。
+ * 256 是估计值，还没有在板子上测过：用 RTOS/Test/Board/dma_copy_bench.c
+ * 按 RTOS/Test/Board/HowTo.txt 测出 memcpy 和 DMA 的交叉点后替换，
+ * 并在这里注明测量时的主频和编译优化等级
+ */
+#define OS_DMA_COPY_MIN  256u
+#endif
+
+/* 拷贝状态 ---------------------------------------------------------------- */
+
+#define OS_DMA_PENDING  0u  ///< 排队中或正在拷贝
+#define OS_DMA_OK       1u  ///< 拷贝完成
+#define OS_DMA_ERROR    2u  ///< DMA 传输错误
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  拷贝请求（由调用者分配，完成之前不能释放）
+ */
+typedef struct Dma_Copy_Request
+{
+    const void *Src;                                ///< 源地址
+    void *Dst;                                      ///< 目的地址
+    uint32_t Len;                                   ///< 字节数
+    void (*Callback)(struct Dma_Copy_Request *, void *); ///< 完成回调（在 DMA 中断里执行），可以为 NULL
+    void *Arg;                                      ///< 回调参数
+    volatile uint8_t Status;                        ///< OS_DMA_PENDING / OK / ERROR
+    struct Dma_Copy_Request *Next;                  ///< 指向队列里的下一个请求
+    OS_Sem Done;                                    ///< 完成时释放一次
+} OS_DmaCopyReq;
+
+/**
+ * @brief  DMA 通道结构体定义
+ */
+typedef struct Dma_Channel
+{
+    DMA_HandleTypeDef Hdma;              ///< HAL DMA 句柄，必须是第一个成员（回调里由句柄找回通道）
+    OS_DmaCopyReq *Active;               ///< 正在拷贝的请求，NULL 表示空闲
+    struct Dma_Channel *Next;            ///< 指向通道池里的下一个通道
+} OS_DmaChannel;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  把一个空闲的 DMA1 通道加入通道池
+ * @param  instance: DMA1_Channel1 ~ DMA1_Channel7，不能再被外设使用
+ * @return uint8_t : 1 成功，0 参数错误
+ */
+uint8_t OS_DmaCopyAddChannel(OS_DmaChannel *p_ch, DMA_Channel_TypeDef *instance);
+
+/**
+ * @brief  提交一个拷贝请求，不等待完成（可以在中断里调用）
+ * @param  callback: 完成回调，可以为 NULL；也可以用 OS_DmaCopyWait 等待
+ * @return uint8_t : 1 已入队，0 参数错误、没有通道或长度超出一次 DMA 的范围
+ * @note   一次最多 65535 个传输单位（源、目的、长度都 4 字节对齐时按字传输）
+ */
+uint8_t OS_DmaCopyAsync(OS_DmaCopyReq *p_req, void *dst, const void *src, uint32_t len,
+                        void (*callback)(OS_DmaCopyReq *, void *), void *arg);
+
+/**
+ * @brief  等待拷贝请求完成
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 请求状态；超时时返回 OS_DMA_PENDING
+ */
+uint8_t OS_DmaCopyWait(OS_DmaCopyReq *p_req, uint32_t timeout);
+
+/**
+ * @brief  拷贝内存并等到完成，拷贝期间调用者阻塞，别的任务可以运行
+ * @note   太短、在中断里、调度器上锁或者没有通道时退化成 memcpy
+ */
+void OS_DmaCopy(void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief  DMA 通道中断入口，由对应的 DMA1_ChannelX_IRQHandler 调用
+ */
+void OS_DmaCopy_IRQHandler(OS_DmaChannel *p_ch);
+
+/**
+ * @brief  DMA1 通道的中断号，驱动用它检查 DMA 中断的优先级
+ * @return int32_t: DMA1_ChannelX_IRQn，不是 DMA1 通道时返回 -1
+ */
+static inline int32_t OS_DmaIRQn(const DMA_HandleTypeDef *hdma)
+{
+    uintptr_t addr;
+
+    if (hdma == NULL)
+        return -1;
+    addr = (uintptr_t)hdma->Instance;
+    if (addr < DMA1_Channel1_BASE || addr > DMA1_Channel7_BASE)
+        return -1;
+    return DMA1_Channel1_IRQn + (int32_t)((addr - DMA1_Channel1_BASE) / (DMA1_Channel2_BASE - DMA1_Channel1_BASE));
+}
+
+/**
+ * @brief  DMA 通道中断里能否调用 OS_ 函数（优先级数值 >= OS_CFG_MAX_SYSCALL_PRIO）
+ * @return uint8_t: 1 可以；0 不能，或者不是 DMA1 通道
+ */
+static inline uint8_t OS_DmaIrqKernelAware(const DMA_HandleTypeDef *hdma)
+{
+    int32_t irqn = OS_DmaIRQn(hdma);
+
+    return irqn >= 0 && OS_CPU_IrqKernelAware(irqn);
+}
+
+#endif /* __OS_DMA_H */
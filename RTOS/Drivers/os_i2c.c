@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * @file    os_i2c.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   I2C 总线管理器实现
+ *
+ * 队列的维护方式和 os_spi.c 相同：空闲时由提交者启动，忙时入队，
+ * 完成（或出错）中断里出队、释放信号量并启动下一个事务。
+ *
+ ******************************************************************************
+ */
+
+#include "os_i2c.h"
+#include "os_dma.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_I2cBus *I2cListHead = NULL; // 已注册的总线，用于从 HAL 句柄找到总线
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static OS_I2cBus *I2cFind(I2C_HandleTypeDef *hi2c)
+{
+    OS_I2cBus *p_bus;
+
+    for (p_bus = I2cListHead; p_bus != NULL; p_bus = p_bus->Next)
+    {
+        if (p_bus->Hi2c == hi2c)
+            return p_bus;
+    }
+    return NULL;
+}
+
+// 结束队列头的事务，调用者负责关中断或处在完成中断里
+static void I2cFinish(OS_I2cBus *p_bus, uint8_t status)
+{
+    OS_I2cXfer *p_xfer = p_bus->Head;
+
+    // 先出队再释放信号量：请求者被唤醒后可能马上释放描述符
+    p_bus->Head = p_xfer->Next;
+    if (p_bus->Head == NULL)
+        p_bus->Tail = NULL;
+
+    p_xfer->Status = status;
+    OS_SemPost(&p_xfer->Done);
+}
+
+// 启动队列头的事务，启动失败就放弃它继续下一个
+static void I2cStart(OS_I2cBus *p_bus)
+{
+    OS_I2cXfer *p_xfer;
+    HAL_StatusTypeDef ret;
+
+    while (p_bus->Head != NULL)
+    {
+        p_xfer = p_bus->Head;
+
+        if (p_xfer->MemAddSize != 0)
+        {
+            if (p_xfer->Read)
+                ret = HAL_I2C_Mem_Read_DMA(p_bus->Hi2c, p_xfer->DevAddress, p_xfer->MemAddress,
+                                           p_xfer->MemAddSize, p_xfer->Data, p_xfer->Len);
+            else
+                ret = HAL_I2C_Mem_Write_DMA(p_bus->Hi2c, p_xfer->DevAddress, p_xfer->MemAddress,
+                                            p_xfer->MemAddSize, p_xfer->Data, p_xfer->Len);
+        }
+        else
+        {
+            if (p_xfer->Read)
+                ret = HAL_I2C_Master_Receive_DMA(p_bus->Hi2c, p_xfer->DevAddress, p_xfer->Data, p_xfer->Len);
+            else
+                ret = HAL_I2C_Master_Transmit_DMA(p_bus->Hi2c, p_xfer->DevAddress, p_xfer->Data, p_xfer->Len);
+        }
+
+        if (ret == HAL_OK)
+            return;
+
+        I2cFinish(p_bus, OS_I2C_ERROR);
+    }
+}
+
+static void I2cComplete(I2C_HandleTypeDef *hi2c, uint8_t status)
+{
+    OS_I2cBus *p_bus = I2cFind(hi2c);
+
+    if (p_bus == NULL || p_bus->Head == NULL)
+        return;
+
+    I2cFinish(p_bus, status);
+    I2cStart(p_bus);
+}
+
+// 完成和出错回调在 I2C 事件/错误中断和 DMA 中断里调用 OS_SemPost，这四个中断都必须被内核临界区屏蔽
+static uint8_t I2cIrqKernelAware(const I2C_HandleTypeDef *hi2c)
+{
+    IRQn_Type ev = (hi2c->Instance == I2C1) ? I2C1_EV_IRQn : I2C2_EV_IRQn;
+    IRQn_Type er = (hi2c->Instance == I2C1) ? I2C1_ER_IRQn : I2C2_ER_IRQn;
+
+    return OS_CPU_IrqKernelAware(ev) && OS_CPU_IrqKernelAware(er) &&
+           OS_DmaIrqKernelAware(hi2c->hdmatx) && OS_DmaIrqKernelAware(hi2c->hdmarx);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_I2cInit(OS_I2cBus *p_bus, I2C_HandleTypeDef *hi2c)
+{
+    if (p_bus == NULL || hi2c == NULL || hi2c->hdmatx == NULL || hi2c->hdmarx == NULL ||
+        !I2cIrqKernelAware(hi2c))
+    {
+        return 0;
+    }
+
+    p_bus->Hi2c = hi2c;
+    p_bus->Head = NULL;
+    p_bus->Tail = NULL;
+
+    OS_EnterCritical();
+    p_bus->Next = I2cListHead;
+    I2cListHead = p_bus;
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_I2cSubmit(OS_I2cBus *p_bus, OS_I2cXfer *p_xfer)
+{
+    if (p_xfer == NULL || p_xfer->Data == NULL || p_xfer->Len == 0)
+        return 0;
+
+    p_xfer->Status = OS_I2C_PENDING;
+    p_xfer->Next = NULL;
+    p_xfer->Done.count = 0;
+    p_xfer->Done.WaitListHead = NULL;
+    p_xfer->Done.WaitListTail = NULL;
+
+    OS_EnterCritical();
+    if (p_bus->Head == NULL) // 总线空闲，直接启动
+    {
+        p_bus->Head = p_xfer;
+        p_bus->Tail = p_xfer;
+        I2cStart(p_bus);
+    }
+    else
+    {
+        p_bus->Tail->Next = p_xfer;
+        p_bus->Tail = p_xfer;
+    }
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_I2cWait(OS_I2cXfer *p_xfer, uint32_t timeout)
+{
+    if (p_xfer->Status == OS_I2C_PENDING)
+        OS_SemWaitTimeout(&p_xfer->Done, timeout);
+
+    return p_xfer->Status;
+}
+
+uint8_t OS_I2cTransfer(OS_I2cBus *p_bus, OS_I2cXfer *p_xfer)
+{
+    if (!OS_I2cSubmit(p_bus, p_xfer))
+        return OS_I2C_ERROR;
+
+    // 调度器上锁时无法阻塞，只能忙等
+    while (OS_I2cWait(p_xfer, OS_WAIT_FOREVER) == OS_I2C_PENDING)
+        ;
+
+    return p_xfer->Status;
+}
+
+/* HAL 回调 ------------------------------------------------------------ */
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_OK);
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_OK);
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_OK);
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_ERROR);
+}
+
+void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    I2cComplete(hi2c, OS_I2C_ERROR);
+}
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * @file    os_i2c.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   I2C 总线管理器 (HAL i2c + dma，事务队列)
+ *
+ * 和 os_spi 相同的事务队列模型：
+ * - 事务描述符给出器件地址、可选的寄存器地址、方向和数据区
+ * - 先进先出排队，由总线独占执行；一个事务的完成中断里直接启动下一个
+ * - 请求者阻塞在描述符自带的信号量上
+ *
+ * 使用前提：I2C 由应用初始化为主机模式，hdmatx/hdmarx 都接好 DMA (DMA_NORMAL)，
+ * 事件和错误中断已经打开。事件、错误和两个 DMA 中断的优先级数值都 >= OS_CFG_MAX_SYSCALL_PRIO
+ * （CubeMX 默认是 0，要改），否则 OS_I2cInit 返回 0。本驱动实现了 HAL_I2C_Master/Mem 的 Tx/Rx 完成回调、
+ * HAL_I2C_ErrorCallback 和 HAL_I2C_AbortCpltCallback
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_I2C_H
+#define __OS_I2C_H
+
+#include "os_core.h"
+#include "stm32f1xx_hal.h"
+
+/* 事务状态 ---------------------------------------------------------------- */
+
+#define OS_I2C_PENDING  0u  ///< 排队中或正在传输
+#define OS_I2C_OK       1u  ///< 传输完成
+#define OS_I2C_ERROR    2u  ///< 无应答、仲裁丢失等，事务被放弃
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  I2C 事务描述符（由请求者分配，完成之前不能释放或修改）
+ */
+typedef struct I2c_Transfer
+{
+    uint16_t DevAddress;                 ///< 器件地址（HAL 格式：7 位地址左移一位）
+    uint16_t MemAddress;                 ///< 寄存器地址
+    uint16_t MemAddSize;                 ///< 寄存器地址宽度，0 表示不带寄存器地址，
+                                         ///< 否则为 I2C_MEMADD_SIZE_8BIT / 16BIT
+    uint8_t Read;                        ///< 1 读，0 写
+    uint8_t *Data;                       ///< 数据区
+    uint16_t Len;                        ///< 字节数
+    volatile uint8_t Status;             ///< OS_I2C_PENDING / OK / ERROR
+    struct I2c_Transfer *Next;           ///< 指向队列里的下一个事务
+    OS_Sem Done;                         ///< 事务结束时释放一次
+} OS_I2cXfer;
+
+/**
+ * @brief  I2C 总线结构体定义
+ */
+typedef struct I2c_Bus
+{
+    I2C_HandleTypeDef *Hi2c;             ///< HAL I2C 句柄
+    OS_I2cXfer *Head;                    ///< 队列头（正在传输的事务）
+    OS_I2cXfer *Tail;                    ///< 队列尾
+    struct I2c_Bus *Next;                ///< 指向下一条已注册的总线
+} OS_I2cBus;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  注册一条 I2C 总线
+ * @return uint8_t: 1 成功，0 参数错误、没有接 DMA 或中断优先级高于内核天花板
+ */
+uint8_t OS_I2cInit(OS_I2cBus *p_bus, I2C_HandleTypeDef *hi2c);
+
+/**
+ * @brief  提交一个事务，不等待完成（可以在中断里调用）
+ * @return uint8_t: 1 已入队，0 参数错误
+ */
+uint8_t OS_I2cSubmit(OS_I2cBus *p_bus, OS_I2cXfer *p_xfer);
+
+/**
+ * @brief  等待事务结束
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 事务状态；超时时返回 OS_I2C_PENDING
+ */
+uint8_t OS_I2cWait(OS_I2cXfer *p_xfer, uint32_t timeout);
+
+/**
+ * @brief  提交事务并一直等到它结束
+ * @return uint8_t: OS_I2C_OK 或 OS_I2C_ERROR
+ */
+uint8_t OS_I2cTransfer(OS_I2cBus *p_bus, OS_I2cXfer *p_xfer);
+
+#endif /* __OS_I2C_H */
@@ -0,0 +1,287 @@
+/**
+ ******************************************************************************
+ * @file    os_input.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   中断驱动的按键/输入事件服务实现
+ *
+ * 一条输入线的状态变化：
+ * - 空闲：EXTI 线打开，等边沿
+ * - 边沿中断：清挂起位，屏蔽这条 EXTI 线（抖动期间不再进中断），记下去抖截止时刻，
+ *   按所有输入线里最早的截止时刻给 TIM4 编程
+ * - TIM4 中断：对到期的输入线采样，和稳定状态不同就入队一个事件并释放信号量；
+ *   然后清挂起位、重新打开 EXTI 线。打开之后再采一次，
+ *   和稳定状态不一致说明去抖期间又变了，直接重新去抖
+ *
+ * EXTI 和 TIM4 中断用同一个优先级，二者不会互相打断，输入线状态不需要关中断保护。
+ * 事件队列只有 TIM4 中断一个生产者，消费者任务在临界区里出队。
+ *
+ ******************************************************************************
+ */
+
+#include "os_input.h"
+#include "os_time.h"
+#include "os_tick.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_Input *InputListHead = NULL; // 已注册的输入线
+static TIM_HandleTypeDef DebounceTimerHandle;
+static uint8_t DebounceTimerReady = 0;
+
+static OS_InputEvent EventQueue[OS_INPUT_QUEUE_SIZE];
+static volatile uint32_t EventHead = 0; // 写位置（TIM4 中断）
+static volatile uint32_t EventTail = 0; // 读位置（任务）
+static OS_Sem EventSem;                 // 队列里的事件数
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// TIM4：10 kHz 计数，单脉冲模式，一次最长 6.5 s
+static void DebounceTimerInit(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    uint32_t timclk = ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) ? pclk1 : pclk1 * 2;
+
+    __HAL_RCC_TIM4_CLK_ENABLE();
+
+    DebounceTimerHandle.Instance = TIM4;
+    DebounceTimerHandle.Init.Prescaler = timclk / 10000 - 1; // 1 个计数 = 100 us
+    DebounceTimerHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    DebounceTimerHandle.Init.Period = 0xFFFF;
+    DebounceTimerHandle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    DebounceTimerHandle.Init.RepetitionCounter = 0;
+    DebounceTimerHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_OnePulse_Init(&DebounceTimerHandle, TIM_OPMODE_SINGLE) != HAL_OK)
+    {
+        while (1); /* 配置失败了，死循环 */
+    }
+
+    DebounceTimerHandle.Instance->CR1 |= TIM_CR1_URS;
+    __HAL_TIM_CLEAR_FLAG(&DebounceTimerHandle, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&DebounceTimerHandle, TIM_IT_UPDATE);
+
+    NVIC_SetPriority(TIM4_IRQn, 14);
+    NVIC_EnableIRQ(TIM4_IRQn);
+}
+
+// 按最早的去抖截止时刻给 TIM4 编程，没有在去抖的输入线就停掉
+static void DebounceTimerProgram(void)
+{
+    OS_Input *p_in;
+    uint64_t earliest = 0;
+    uint64_t now;
+    uint64_t remain;
+    uint8_t found = 0;
+
+    for (p_in = InputListHead; p_in != NULL; p_in = p_in->Next)
+    {
+        if (p_in->Armed && (!found || p_in->Deadline < earliest))
+        {
+            earliest = p_in->Deadline;
+            found = 1;
+        }
+    }
+
+    __HAL_TIM_DISABLE(&DebounceTimerHandle);
+    __HAL_TIM_CLEAR_FLAG(&DebounceTimerHandle, TIM_FLAG_UPDATE);
+    if (!found)
+        return;
+
+    now = OS_TimeNowCycles();
+    remain = (earliest > now) ? earliest - now : 0;
+    remain = (remain * 10000u + OS_Tick_GetClock() - 1) / OS_Tick_GetClock(); // 向上取整到 100 us
+    if (remain == 0)
+        remain = 1;
+    if (remain > 0xFFFF)
+        remain = 0xFFFF;
+
+    __HAL_TIM_SET_AUTORELOAD(&DebounceTimerHandle, (uint32_t)remain);
+    __HAL_TIM_SET_COUNTER(&DebounceTimerHandle, 0);
+    __HAL_TIM_ENABLE(&DebounceTimerHandle);
+}
+
+static uint8_t InputRead(const OS_Input *p_in)
+{
+    return (HAL_GPIO_ReadPin(p_in->Port, p_in->Pin) == p_in->ActiveLevel) ? 1 : 0;
+}
+
+// 屏蔽 EXTI 线，开始一次去抖
+// 去抖时间在这里才换算成计数：OS_InputAdd 可能早于节拍源初始化（例如 TIM2 的预分频还没设），
+// 那时 OS_Tick_GetClock 给的不是最终的计数频率
+static void InputArm(OS_Input *p_in)
+{
+    EXTI->IMR &= ~(1uL << (p_in->Exti.Line & EXTI_PIN_MASK));
+    p_in->Deadline = OS_TimeNowCycles() + (uint64_t)p_in->DebounceMs * OS_Tick_GetClock() / 1000u;
+    p_in->Armed = 1;
+}
+
+static void EventPush(const OS_Input *p_in, uint8_t pressed)
+{
+    uint32_t head = EventHead;
+
+    if (head - EventTail >= OS_INPUT_QUEUE_SIZE) // 队列满了，丢掉这个事件
+        return;
+
+    EventQueue[head % OS_INPUT_QUEUE_SIZE].Id = p_in->Id;
+    EventQueue[head % OS_INPUT_QUEUE_SIZE].Type = pressed ? OS_INPUT_PRESS : OS_INPUT_RELEASE;
+    EventQueue[head % OS_INPUT_QUEUE_SIZE].Tick = g_SystemTickCount;
+    EventHead = head + 1;
+
+    OS_SemPost(&EventSem);
+}
+
+static IRQn_Type ExtiIRQn(uint32_t line)
+{
+    if (line <= 4)
+        return (IRQn_Type)(EXTI0_IRQn + line);
+    if (line <= 9)
+        return EXTI9_5_IRQn;
+    return EXTI15_10_IRQn;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_InputAdd(OS_Input *p_in, uint8_t id, GPIO_TypeDef *port, uint16_t pin,
+                    GPIO_PinState active_level, uint32_t debounce_ms)
+{
+    EXTI_ConfigTypeDef config;
+    OS_Input *p;
+    uint32_t line;
+
+    // 1. 检查参数：一次只能注册一个引脚
+    if (p_in == NULL || port == NULL || pin == 0 || (pin & (pin - 1)) != 0 ||
+        debounce_ms == 0 || debounce_ms > 6000)
+    {
+        return 0;
+    }
+    line = POSITION_VAL(pin);
+
+    OS_EnterCritical();
+
+    // 2. EXTI 线和引脚号一一对应，不同端口的同号引脚不能同时使用
+    for (p = InputListHead; p != NULL; p = p->Next)
+    {
+        if ((p->Exti.Line & EXTI_PIN_MASK) == line)
+        {
+            OS_ExitCritical();
+            return 0;
+        }
+    }
+
+    if (!DebounceTimerReady)
+    {
+        DebounceTimerInit();
+        DebounceTimerReady = 1;
+    }
+
+    // 3. 填写输入线
+    p_in->Port = port;
+    p_in->Pin = pin;
+    p_in->ActiveLevel = active_level;
+    p_in->Id = id;
+    p_in->Armed = 0;
+    p_in->DebounceMs = (uint16_t)debounce_ms;
+    p_in->Stable = InputRead(p_in);
+
+    // 4. 通过 HAL EXTI 驱动配置双边沿中断 (AFIO 选择端口)
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    config.Line = EXTI_GPIO | line;
+    config.Mode = EXTI_MODE_INTERRUPT;
+    config.Trigger = EXTI_TRIGGER_RISING_FALLING;
+    config.GPIOSel = ((uint32_t)port - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE);
+    HAL_EXTI_GetHandle(&p_in->Exti, config.Line);
+    HAL_EXTI_SetConfigLine(&p_in->Exti, &config);
+    HAL_EXTI_ClearPending(&p_in->Exti, EXTI_TRIGGER_RISING_FALLING);
+
+    // 5. 挂到链表头
+    p_in->Next = InputListHead;
+    InputListHead = p_in;
+
+    NVIC_SetPriority(ExtiIRQn(line), 14);
+    NVIC_EnableIRQ(ExtiIRQn(line));
+
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_InputWait(OS_InputEvent *p_event, uint32_t timeout)
+{
+    if (!OS_SemWaitTimeout(&EventSem, timeout))
+        return 0;
+
+    // 可能有多个任务在等，出队要关中断
+    OS_EnterCritical();
+    *p_event = EventQueue[EventTail % OS_INPUT_QUEUE_SIZE];
+    EventTail = EventTail + 1;
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_InputIsPressed(const OS_Input *p_in)
+{
+    return p_in->Stable;
+}
+
+void OS_Input_EXTI_IRQHandler(void)
+{
+    OS_Input *p_in;
+    uint8_t armed = 0;
+
+    for (p_in = InputListHead; p_in != NULL; p_in = p_in->Next)
+    {
+        if (HAL_EXTI_GetPending(&p_in->Exti, EXTI_TRIGGER_RISING_FALLING))
+        {
+            HAL_EXTI_ClearPending(&p_in->Exti, EXTI_TRIGGER_RISING_FALLING);
+            if (!p_in->Armed) // 屏蔽期间挂起位也会置位，去抖中的线不重新计时
+            {
+                InputArm(p_in);
+                armed = 1;
+            }
+        }
+    }
+
+    if (armed)
+    {
+        DebounceTimerProgram();
+    }
+}
+
+void OS_Input_TIM_IRQHandler(void)
+{
+    OS_Input *p_in;
+    uint64_t now;
+    uint8_t level;
+
+    __HAL_TIM_CLEAR_FLAG(&DebounceTimerHandle, TIM_FLAG_UPDATE);
+
+    now = OS_TimeNowCycles();
+    for (p_in = InputListHead; p_in != NULL; p_in = p_in->Next)
+    {
+        if (!p_in->Armed || p_in->Deadline > now)
+            continue;
+
+        // 1. 去抖结束，采样
+        p_in->Armed = 0;
+        level = InputRead(p_in);
+        if (level != p_in->Stable)
+        {
+            p_in->Stable = level;
+            EventPush(p_in, level);
+        }
+
+        // 2. 重新打开 EXTI 线
+        HAL_EXTI_ClearPending(&p_in->Exti, EXTI_TRIGGER_RISING_FALLING);
+        EXTI->IMR |= (1uL << (p_in->Exti.Line & EXTI_PIN_MASK));
+
+        // 3. 打开之前的边沿已经丢了，电平和稳定状态不一致就再去抖一次
+        if (InputRead(p_in) != p_in->Stable)
+        {
+            InputArm(p_in);
+        }
+    }
+
+    DebounceTimerProgram();
+}
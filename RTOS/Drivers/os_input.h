@@ -0,0 +1,106 @@
+/**
+ ******************************************************************************
+ * @file    os_input.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   中断驱动的按键/输入事件服务 (EXTI + 去抖定时器)
+ *
+ * 取代任务里的定时轮询：
+ * - 引脚边沿触发 EXTI 中断，屏蔽这条线并启动去抖定时器 (TIM4，单次)
+ * - 去抖时间到了再采样一次，电平确实变了才生成按下/松开事件
+ * - 任务阻塞在 OS_InputWait 上，没有输入时不占 CPU，也没有任务切换
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_INPUT_H
+#define __OS_INPUT_H
+
+#include "os_core.h"
+#include "stm32f1xx_hal.h"
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#ifndef OS_INPUT_QUEUE_SIZE
+#define OS_INPUT_QUEUE_SIZE  8u  ///< 事件队列深度，满了以后新事件会被丢掉
+#endif
+
+/**
+ * @brief  输入事件类型
+ */
+typedef enum
+{
+    OS_INPUT_RELEASE = 0, ///< 松开（回到非有效电平）
+    OS_INPUT_PRESS,       ///< 按下（进入有效电平）
+} OS_InputEventType;
+
+/**
+ * @brief  输入事件
+ */
+typedef struct
+{
+    uint8_t Id;              ///< OS_InputAdd 时指定的输入编号
+    OS_InputEventType Type;  ///< 按下还是松开
+    uint32_t Tick;           ///< 去抖完成时的系统节拍
+} OS_InputEvent;
+
+/**
+ * @brief  输入线结构体定义（由调用者分配，注册后不能释放）
+ */
+typedef struct Input_Line
+{
+    GPIO_TypeDef *Port;         ///< GPIO 端口
+    uint16_t Pin;               ///< GPIO 引脚 (GPIO_PIN_x)
+    GPIO_PinState ActiveLevel;  ///< 按下时的电平
+    uint8_t Id;                 ///< 事件里带的输入编号
+    uint8_t Stable;             ///< 去抖后的稳定状态（1 = 按下）
+    volatile uint8_t Armed;     ///< 去抖定时是否在进行
+    uint16_t DebounceMs;        ///< 去抖时间（单位：ms），每次开始去抖时才换算成节拍定时器计数
+    uint64_t Deadline;          ///< 去抖结束的时刻（单位：节拍定时器计数）
+    EXTI_HandleTypeDef Exti;    ///< HAL EXTI 句柄
+    struct Input_Line *Next;    ///< 指向下一条已注册的输入线
+} OS_Input;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  注册一条输入线，配置 EXTI 双边沿中断
+ * @param  p_in       : 输入线结构体
+ * @param  id         : 事件里带的输入编号
+ * @param  port       : GPIO 端口，引脚需要事先配置成输入
+ * @param  pin        : GPIO 引脚 (GPIO_PIN_x，一次只能一个)
+ * @param  active_level: 按下时的电平
+ * @param  debounce_ms: 去抖时间（单位ms，1 ~ 6000）
+ * @return uint8_t    : 1 成功，0 参数错误或这条 EXTI 线已经被占用
+ * @note   可以在 OS_StartScheduler 之前调用：节拍源那时可能还没初始化，
+ *         去抖时间留到每次去抖开始时再按 OS_Tick_GetClock 换算
+ */
+uint8_t OS_InputAdd(OS_Input *p_in, uint8_t id, GPIO_TypeDef *port, uint16_t pin,
+                    GPIO_PinState active_level, uint32_t debounce_ms);
+
+/**
+ * @brief  等待下一个去抖后的输入事件
+ * @param  p_event: 取出的事件
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 1 取到事件，0 超时
+ */
+uint8_t OS_InputWait(OS_InputEvent *p_event, uint32_t timeout);
+
+/**
+ * @brief  查询去抖后的当前状态
+ * @return uint8_t: 1 按下，0 松开
+ */
+uint8_t OS_InputIsPressed(const OS_Input *p_in);
+
+/**
+ * @brief  EXTI 中断入口，所有接了输入线的 EXTIx_IRQHandler 都调用它
+ */
+void OS_Input_EXTI_IRQHandler(void);
+
+/**
+ * @brief  去抖定时器中断入口，由 TIM4_IRQHandler 调用
+ */
+void OS_Input_TIM_IRQHandler(void);
+
+#endif /* __OS_INPUT_H */
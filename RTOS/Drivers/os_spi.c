@@ -0,0 +1,198 @@
+/**
+ ******************************************************************************
+ * @file    os_spi.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   SPI 总线管理器实现
+ *
+ * 没有单独的总线管理任务：
+ * - 总线空闲时，提交事务的一方直接启动它；忙时只入队
+ * - DMA 完成中断里拉高片选、出队、释放信号量，然后马上启动下一个事务
+ * - 队列由任务（入队）和完成中断（出队）共同修改，任务一侧关中断操作
+ *
+ ******************************************************************************
+ */
+
+#include "os_spi.h"
+#include "os_dma.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_SpiBus *SpiListHead = NULL; // 已注册的总线，用于从 HAL 句柄找到总线
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static OS_SpiBus *SpiFind(SPI_HandleTypeDef *hspi)
+{
+    OS_SpiBus *p_bus;
+
+    for (p_bus = SpiListHead; p_bus != NULL; p_bus = p_bus->Next)
+    {
+        if (p_bus->Hspi == hspi)
+            return p_bus;
+    }
+    return NULL;
+}
+
+static void SpiCsWrite(const OS_SpiXfer *p_xfer, GPIO_PinState state)
+{
+    if (p_xfer->CsPort != NULL)
+        HAL_GPIO_WritePin(p_xfer->CsPort, p_xfer->CsPin, state);
+}
+
+// 结束队列头的事务，调用者负责关中断或处在完成中断里
+static void SpiFinish(OS_SpiBus *p_bus, uint8_t status)
+{
+    OS_SpiXfer *p_xfer = p_bus->Head;
+
+    SpiCsWrite(p_xfer, GPIO_PIN_SET);
+
+    // 先出队再释放信号量：请求者被唤醒后可能马上释放描述符
+    p_bus->Head = p_xfer->Next;
+    if (p_bus->Head == NULL)
+        p_bus->Tail = NULL;
+
+    p_xfer->Status = status;
+    OS_SemPost(&p_xfer->Done);
+}
+
+// 启动队列头的事务，启动失败就放弃它继续下一个
+static void SpiStart(OS_SpiBus *p_bus)
+{
+    OS_SpiXfer *p_xfer;
+    HAL_StatusTypeDef ret;
+
+    while (p_bus->Head != NULL)
+    {
+        p_xfer = p_bus->Head;
+        SpiCsWrite(p_xfer, GPIO_PIN_RESET);
+
+        if (p_xfer->TxData != NULL && p_xfer->RxData != NULL)
+            ret = HAL_SPI_TransmitReceive_DMA(p_bus->Hspi, (uint8_t *)p_xfer->TxData, p_xfer->RxData, p_xfer->Len);
+        else if (p_xfer->TxData != NULL)
+            ret = HAL_SPI_Transmit_DMA(p_bus->Hspi, (uint8_t *)p_xfer->TxData, p_xfer->Len);
+        else
+            ret = HAL_SPI_Receive_DMA(p_bus->Hspi, p_xfer->RxData, p_xfer->Len);
+
+        if (ret == HAL_OK)
+            return;
+
+        SpiFinish(p_bus, OS_SPI_ERROR);
+    }
+}
+
+static void SpiComplete(SPI_HandleTypeDef *hspi, uint8_t status)
+{
+    OS_SpiBus *p_bus = SpiFind(hspi);
+
+    if (p_bus == NULL || p_bus->Head == NULL)
+        return;
+
+    SpiFinish(p_bus, status);
+    SpiStart(p_bus);
+}
+
+// 完成回调在 DMA 中断里调用 OS_SemPost，两个 DMA 中断都必须被内核临界区屏蔽；
+// HAL 在 DMA 传输期间打开了 SPI 错误中断，SPI 中断如果也打开了，同样要满足
+static uint8_t SpiIrqKernelAware(const SPI_HandleTypeDef *hspi)
+{
+    IRQn_Type irqn = (hspi->Instance == SPI1) ? SPI1_IRQn : SPI2_IRQn;
+
+    if (NVIC_GetEnableIRQ(irqn) && !OS_CPU_IrqKernelAware(irqn))
+        return 0;
+
+    return OS_DmaIrqKernelAware(hspi->hdmatx) && OS_DmaIrqKernelAware(hspi->hdmarx);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_SpiInit(OS_SpiBus *p_bus, SPI_HandleTypeDef *hspi)
+{
+    if (p_bus == NULL || hspi == NULL || hspi->hdmatx == NULL || hspi->hdmarx == NULL ||
+        !SpiIrqKernelAware(hspi))
+    {
+        return 0;
+    }
+
+    p_bus->Hspi = hspi;
+    p_bus->Head = NULL;
+    p_bus->Tail = NULL;
+
+    OS_EnterCritical();
+    p_bus->Next = SpiListHead;
+    SpiListHead = p_bus;
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_SpiSubmit(OS_SpiBus *p_bus, OS_SpiXfer *p_xfer)
+{
+    if (p_xfer == NULL || p_xfer->Len == 0 || (p_xfer->TxData == NULL && p_xfer->RxData == NULL))
+        return 0;
+
+    p_xfer->Status = OS_SPI_PENDING;
+    p_xfer->Next = NULL;
+    p_xfer->Done.count = 0;
+    p_xfer->Done.WaitListHead = NULL;
+    p_xfer->Done.WaitListTail = NULL;
+
+    OS_EnterCritical();
+    if (p_bus->Head == NULL) // 总线空闲，直接启动
+    {
+        p_bus->Head = p_xfer;
+        p_bus->Tail = p_xfer;
+        SpiStart(p_bus);
+    }
+    else
+    {
+        p_bus->Tail->Next = p_xfer;
+        p_bus->Tail = p_xfer;
+    }
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_SpiWait(OS_SpiXfer *p_xfer, uint32_t timeout)
+{
+    if (p_xfer->Status == OS_SPI_PENDING)
+        OS_SemWaitTimeout(&p_xfer->Done, timeout);
+
+    return p_xfer->Status;
+}
+
+uint8_t OS_SpiTransfer(OS_SpiBus *p_bus, OS_SpiXfer *p_xfer)
+{
+    if (!OS_SpiSubmit(p_bus, p_xfer))
+        return OS_SPI_ERROR;
+
+    // 调度器上锁时无法阻塞，只能忙等
+    while (OS_SpiWait(p_xfer, OS_WAIT_FOREVER) == OS_SPI_PENDING)
+        ;
+
+    return p_xfer->Status;
+}
+
+/* HAL 回调 ------------------------------------------------------------ */
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    SpiComplete(hspi, OS_SPI_OK);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    SpiComplete(hspi, OS_SPI_OK);
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    SpiComplete(hspi, OS_SPI_OK);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    SpiComplete(hspi, OS_SPI_ERROR);
+}
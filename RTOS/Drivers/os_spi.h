@@ -0,0 +1,90 @@
+/**
+ ******************************************************************************
+ * @file    os_spi.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   SPI 总线管理器 (HAL spi + dma，事务队列)
+ *
+ * 多个任务共享一条 SPI 总线时，不需要再自己加锁：
+ * - 每次传输用一个事务描述符描述（片选、发送区、接收区、长度）
+ * - 事务排成先进先出队列，由总线独占执行，片选在事务开始时拉低、结束时拉高
+ * - 一个事务的 DMA 完成中断里直接启动下一个，中间不经过任何任务，总线没有空闲间隙
+ * - 请求者阻塞在描述符自带的信号量上，传输期间 CPU 可以运行别的任务
+ *
+ * 使用前提：SPI 由应用初始化为主机模式，hdmatx/hdmarx 都接好 DMA (DMA_NORMAL)。
+ * 两个 DMA 中断（以及打开了的话 SPI 中断）的优先级数值都 >= OS_CFG_MAX_SYSCALL_PRIO，
+ * CubeMX 默认是 0，要改，否则 OS_SpiInit 返回 0。
+ * 本驱动实现了 HAL_SPI_TxCpltCallback / RxCpltCallback / TxRxCpltCallback / ErrorCallback
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_SPI_H
+#define __OS_SPI_H
+
+#include "os_core.h"
+#include "stm32f1xx_hal.h"
+
+/* 事务状态 ---------------------------------------------------------------- */
+
+#define OS_SPI_PENDING  0u  ///< 排队中或正在传输
+#define OS_SPI_OK       1u  ///< 传输完成
+#define OS_SPI_ERROR    2u  ///< HAL 报错，事务被放弃
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  SPI 事务描述符（由请求者分配，完成之前不能释放或修改）
+ */
+typedef struct Spi_Transfer
+{
+    GPIO_TypeDef *CsPort;                ///< 片选端口，NULL 表示不操作片选
+    uint16_t CsPin;                      ///< 片选引脚，低电平有效
+    const uint8_t *TxData;               ///< 发送数据，NULL 表示只接收
+    uint8_t *RxData;                     ///< 接收缓冲区，NULL 表示只发送
+    uint16_t Len;                        ///< 字节数
+    volatile uint8_t Status;             ///< OS_SPI_PENDING / OK / ERROR
+    struct Spi_Transfer *Next;           ///< 指向队列里的下一个事务
+    OS_Sem Done;                         ///< 事务结束时释放一次
+} OS_SpiXfer;
+
+/**
+ * @brief  SPI 总线结构体定义
+ */
+typedef struct Spi_Bus
+{
+    SPI_HandleTypeDef *Hspi;             ///< HAL SPI 句柄
+    OS_SpiXfer *Head;                    ///< 队列头（正在传输的事务）
+    OS_SpiXfer *Tail;                    ///< 队列尾
+    struct Spi_Bus *Next;                ///< 指向下一条已注册的总线
+} OS_SpiBus;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  注册一条 SPI 总线
+ * @return uint8_t: 1 成功，0 参数错误、没有接 DMA 或中断优先级高于内核天花板
+ */
+uint8_t OS_SpiInit(OS_SpiBus *p_bus, SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief  提交一个事务，不等待完成（可以在中断里调用）
+ * @return uint8_t: 1 已入队，0 参数错误
+ */
+uint8_t OS_SpiSubmit(OS_SpiBus *p_bus, OS_SpiXfer *p_xfer);
+
+/**
+ * @brief  等待事务结束
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 事务状态；超时时返回 OS_SPI_PENDING
+ */
+uint8_t OS_SpiWait(OS_SpiXfer *p_xfer, uint32_t timeout);
+
+/**
+ * @brief  提交事务并一直等到它结束
+ * @return uint8_t: OS_SPI_OK 或 OS_SPI_ERROR
+ */
+uint8_t OS_SpiTransfer(OS_SpiBus *p_bus, OS_SpiXfer *p_xfer);
+
+#endif /* __OS_SPI_H */
@@ -0,0 +1,277 @@
+/**
+ ******************************************************************************
+ * @file    os_uart.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   基于 DMA 的 UART 驱动实现
+ *
+ * 接收：
+ * - HAL_UARTEx_ReceiveToIdle_DMA 在循环模式下，半满、满和空闲线都会回调
+ *   HAL_UARTEx_RxEventCallback，Size 是 DMA 当前写到的位置
+ * - RxDmaPos 记录上次搬到哪里，两者之间（可能跨过末尾）就是新数据
+ * - 接收环形缓冲区的唤醒阈值是 1，有数据就唤醒读任务；满了就丢弃并计数
+ * - 接收出错时 HAL 会停掉接收 DMA，在错误回调里重新启动
+ *
+ * 发送：
+ * - 发送队列由任务（入队、撤销）和发送完成中断（出队、启动下一个）共同修改，
+ *   任务一侧在临界区里操作
+ * - 队列头就是 DMA 正在发送的请求
+ *
+ ******************************************************************************
+ */
+
+#include "os_uart.h"
+#include "os_dma.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_Uart *UartListHead = NULL; // 已注册的 UART，用于从 HAL 句柄找到驱动
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static OS_Uart *UartFind(UART_HandleTypeDef *huart)
+{
+    OS_Uart *p_uart;
+
+    for (p_uart = UartListHead; p_uart != NULL; p_uart = p_uart->Next)
+    {
+        if (p_uart->Huart == huart)
+            return p_uart;
+    }
+    return NULL;
+}
+
+static uint8_t UartRxStart(OS_Uart *p_uart)
+{
+    p_uart->RxDmaPos = 0;
+    return HAL_UARTEx_ReceiveToIdle_DMA(p_uart->Huart, p_uart->RxDmaBuf, p_uart->RxDmaSize) == HAL_OK;
+}
+
+static void UartRxPush(OS_Uart *p_uart, const uint8_t *data, uint32_t len)
+{
+    uint32_t written = OS_RingBufWrite(&p_uart->Rx, data, len);
+
+    p_uart->RxOverflow += len - written;
+}
+
+// 启动队列头的发送，调用者负责关中断或处在发送完成中断里
+static void UartTxStart(OS_Uart *p_uart)
+{
+    OS_UartTxReq *p_req;
+
+    while (p_uart->TxHead != NULL)
+    {
+        p_req = p_uart->TxHead;
+        if (HAL_UART_Transmit_DMA(p_uart->Huart, p_req->Data, p_req->Len) == HAL_OK)
+            return;
+
+        // 只有 UART 状态异常时才会走到这里：放弃这个请求，免得写任务永远等下去
+        p_uart->TxHead = p_req->Next;
+        if (p_uart->TxHead == NULL)
+            p_uart->TxTail = NULL;
+        OS_SemPost(&p_req->Done);
+    }
+}
+
+// 从发送队列里摘掉还没开始发送的请求，调用者负责关中断
+static uint8_t UartTxUnlink(OS_Uart *p_uart, OS_UartTxReq *p_req)
+{
+    OS_UartTxReq *prev = p_uart->TxHead;
+
+    if (prev == NULL || prev == p_req) // 空队列，或者正在发送
+        return 0;
+
+    while (prev->Next != NULL && prev->Next != p_req)
+    {
+        prev = prev->Next;
+    }
+    if (prev->Next == NULL) // 已经发完出队了
+        return 0;
+
+    prev->Next = p_req->Next;
+    if (p_uart->TxTail == p_req)
+        p_uart->TxTail = prev;
+    return 1;
+}
+
+// 回调在 UART 和 DMA 中断里调用 OS_ 函数，这三个中断都必须被内核临界区屏蔽
+static uint8_t UartIrqKernelAware(const UART_HandleTypeDef *huart)
+{
+    int32_t irqn;
+
+    if (huart->Instance == USART1)
+        irqn = USART1_IRQn;
+    else if (huart->Instance == USART2)
+        irqn = USART2_IRQn;
+    else if (huart->Instance == USART3)
+        irqn = USART3_IRQn;
+    else
+        return 0;
+
+    return OS_CPU_IrqKernelAware(irqn) &&
+           OS_DmaIrqKernelAware(huart->hdmarx) && OS_DmaIrqKernelAware(huart->hdmatx);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_UartInit(OS_Uart *p_uart, UART_HandleTypeDef *huart,
+                    uint8_t *rx_dma_buf, uint16_t rx_dma_size,
+                    uint8_t *rx_buf, uint32_t rx_size)
+{
+    // 1. 检查参数：接收必须是循环 DMA，发送必须接了 DMA，中断都在内核天花板之下
+    if (p_uart == NULL || huart == NULL || rx_dma_buf == NULL || rx_dma_size == 0 ||
+        huart->hdmarx == NULL || huart->hdmarx->Init.Mode != DMA_CIRCULAR ||
+        huart->hdmatx == NULL || !UartIrqKernelAware(huart))
+    {
+        return 0;
+    }
+
+    if (!OS_RingBufInit(&p_uart->Rx, rx_buf, rx_size, 1))
+        return 0;
+
+    // 2. 填写驱动结构体
+    p_uart->Huart = huart;
+    p_uart->RxDmaBuf = rx_dma_buf;
+    p_uart->RxDmaSize = rx_dma_size;
+    p_uart->RxOverflow = 0;
+    p_uart->TxHead = NULL;
+    p_uart->TxTail = NULL;
+
+    // 3. 注册，然后启动接收
+    OS_EnterCritical();
+    p_uart->Next = UartListHead;
+    UartListHead = p_uart;
+    OS_ExitCritical();
+
+    return UartRxStart(p_uart);
+}
+
+uint32_t OS_UartRead(OS_Uart *p_uart, uint8_t *data, uint32_t len, uint32_t timeout)
+{
+    if (len == 0)
+        return 0;
+
+    if (OS_RingBufCount(&p_uart->Rx) == 0 && !OS_RingBufWaitTimeout(&p_uart->Rx, timeout))
+        return 0;
+
+    return OS_RingBufRead(&p_uart->Rx, data, len);
+}
+
+uint8_t OS_UartWriteAsync(OS_Uart *p_uart, OS_UartTxReq *p_req, const uint8_t *data, uint16_t len)
+{
+    if (p_req == NULL || data == NULL || len == 0)
+        return 0;
+
+    p_req->Data = data;
+    p_req->Len = len;
+    p_req->Next = NULL;
+    p_req->Done.count = 0;
+    p_req->Done.WaitListHead = NULL;
+    p_req->Done.WaitListTail = NULL;
+
+    OS_EnterCritical();
+    if (p_uart->TxHead == NULL) // 发送空闲，直接启动
+    {
+        p_uart->TxHead = p_req;
+        p_uart->TxTail = p_req;
+        UartTxStart(p_uart);
+    }
+    else
+    {
+        p_uart->TxTail->Next = p_req;
+        p_uart->TxTail = p_req;
+    }
+    OS_ExitCritical();
+
+    return 1;
+}
+
+uint8_t OS_UartTxWait(OS_UartTxReq *p_req, uint32_t timeout)
+{
+    return OS_SemWaitTimeout(&p_req->Done, timeout);
+}
+
+uint8_t OS_UartWrite(OS_Uart *p_uart, const uint8_t *data, uint16_t len, uint32_t timeout)
+{
+    OS_UartTxReq req;
+
+    // 1. 请求放在栈上，必须能一直阻塞到发送完成
+    if (OS_CPU_InISR() || g_SchedLockNesting > 0)
+        return 0;
+
+    if (!OS_UartWriteAsync(p_uart, &req, data, len))
+        return 0;
+
+    if (OS_UartTxWait(&req, timeout))
+        return 1;
+
+    // 2. 超时：还在排队就撤销
+    OS_EnterCritical();
+    if (UartTxUnlink(p_uart, &req))
+    {
+        OS_ExitCritical();
+        return 0;
+    }
+    OS_ExitCritical();
+
+    // 3. 已经在发送（或刚刚发完），等它结束
+    OS_UartTxWait(&req, OS_WAIT_FOREVER);
+    return 1;
+}
+
+/* HAL 回调 ------------------------------------------------------------ */
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    OS_Uart *p_uart = UartFind(huart);
+
+    if (p_uart == NULL || Size == p_uart->RxDmaPos)
+        return;
+
+    // 把 RxDmaPos 到 Size 之间的新数据搬进环形缓冲区
+    if (Size > p_uart->RxDmaPos)
+    {
+        UartRxPush(p_uart, &p_uart->RxDmaBuf[p_uart->RxDmaPos], Size - p_uart->RxDmaPos);
+    }
+    else // DMA 已经绕回开头
+    {
+        UartRxPush(p_uart, &p_uart->RxDmaBuf[p_uart->RxDmaPos], p_uart->RxDmaSize - p_uart->RxDmaPos);
+        UartRxPush(p_uart, p_uart->RxDmaBuf, Size);
+    }
+
+    p_uart->RxDmaPos = (Size == p_uart->RxDmaSize) ? 0 : Size;
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    OS_Uart *p_uart = UartFind(huart);
+    OS_UartTxReq *p_req;
+
+    if (p_uart == NULL || p_uart->TxHead == NULL)
+        return;
+
+    // 先出队再释放信号量：写任务被唤醒后可能马上释放这个请求
+    p_req = p_uart->TxHead;
+    p_uart->TxHead = p_req->Next;
+    if (p_uart->TxHead == NULL)
+        p_uart->TxTail = NULL;
+
+    OS_SemPost(&p_req->Done);
+
+    UartTxStart(p_uart);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    OS_Uart *p_uart = UartFind(huart);
+
+    if (p_uart == NULL)
+        return;
+
+    // DMA 模式下的接收错误都会让 HAL 停掉接收，重新启动
+    if (huart->RxState == HAL_UART_STATE_READY)
+    {
+        UartRxStart(p_uart);
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ ******************************************************************************
+ * @file    os_uart.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   基于 DMA 的 UART 驱动 (HAL uart + dma)
+ *
+ * - 接收：循环 DMA + 空闲线检测，半满/满/空闲三种事件都把新数据搬进 OS_RingBuf，
+ *   读任务阻塞在 OS_UartRead 上，直到有数据或超时
+ * - 发送：调用者提供的发送请求排成链表，DMA 一次发一个，发完在中断里接着发下一个；
+ *   每个请求带一个信号量，写任务阻塞在它上面等发送完成
+ *
+ * 使用前提：
+ * - UART 已由应用初始化（MX_USARTx_UART_Init），hdmarx 配成 DMA_CIRCULAR，
+ *   hdmatx 配成 DMA_NORMAL，DMA 和 UART 中断已经打开
+ * - UART、接收 DMA、发送 DMA 三个中断的优先级数值都 >= OS_CFG_MAX_SYSCALL_PRIO
+ *   （CubeMX 默认是 0，要改），否则 OS_UartInit 返回 0
+ * - 本驱动实现了 HAL_UARTEx_RxEventCallback / HAL_UART_TxCpltCallback /
+ *   HAL_UART_ErrorCallback，应用里不能再定义它们
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_UART_H
+#define __OS_UART_H
+
+#include "os_core.h"
+#include "os_ringbuf.h"
+#include "stm32f1xx_hal.h"
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  发送请求（由调用者分配，完成之前不能释放）
+ */
+typedef struct Uart_Tx_Request
+{
+    const uint8_t *Data;                 ///< 要发送的数据，完成之前不能修改
+    uint16_t Len;                        ///< 字节数
+    struct Uart_Tx_Request *Next;        ///< 指向队列里的下一个请求
+    OS_Sem Done;                         ///< 发送完成时释放一次
+} OS_UartTxReq;
+
+/**
+ * @brief  UART 驱动结构体定义
+ */
+typedef struct Uart_Driver
+{
+    UART_HandleTypeDef *Huart;           ///< HAL UART 句柄
+    uint8_t *RxDmaBuf;                   ///< 循环 DMA 接收区
+    uint16_t RxDmaSize;                  ///< 循环 DMA 接收区大小
+    uint16_t RxDmaPos;                   ///< 已经搬进环形缓冲区的位置
+    OS_RingBuf Rx;                       ///< 接收环形缓冲区（中断写，一个读任务读）
+    volatile uint32_t RxOverflow;        ///< 环形缓冲区满导致丢弃的字节数
+    OS_UartTxReq *TxHead;                ///< 发送队列头（正在发送的请求）
+    OS_UartTxReq *TxTail;                ///< 发送队列尾
+    struct Uart_Driver *Next;            ///< 指向下一个已注册的 UART
+} OS_Uart;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化 UART 驱动并启动循环 DMA 接收
+ * @param  p_uart     : 驱动结构体
+ * @param  huart      : 已经初始化好的 HAL UART 句柄
+ * @param  rx_dma_buf : 循环 DMA 接收区
+ * @param  rx_dma_size: 循环 DMA 接收区大小（字节）
+ * @param  rx_buf     : 接收环形缓冲区存储区
+ * @param  rx_size    : 接收环形缓冲区大小（字节，必须是 2 的幂）
+ * @return uint8_t    : 1 成功，0 参数错误、DMA 配置不符合要求或中断优先级高于内核天花板
+ */
+uint8_t OS_UartInit(OS_Uart *p_uart, UART_HandleTypeDef *huart,
+                    uint8_t *rx_dma_buf, uint16_t rx_dma_size,
+                    uint8_t *rx_buf, uint32_t rx_size);
+
+/**
+ * @brief  读取接收到的数据（只能有一个读任务）
+ * @param  data   : 存放数据的缓冲区
+ * @param  len    : 最多读多少字节
+ * @param  timeout: 没有数据时最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint32_t: 实际读到的字节数，0 表示超时
+ */
+uint32_t OS_UartRead(OS_Uart *p_uart, uint8_t *data, uint32_t len, uint32_t timeout);
+
+/**
+ * @brief  提交一个发送请求，不等待完成
+ * @note   请求排在队列尾；完成后 p_req->Done 被释放一次，用 OS_UartTxWait 等待
+ */
+uint8_t OS_UartWriteAsync(OS_Uart *p_uart, OS_UartTxReq *p_req, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief  等待发送请求完成
+ * @param  timeout: 最长等待的节拍数，0 表示不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 1 已完成，0 超时
+ */
+uint8_t OS_UartTxWait(OS_UartTxReq *p_req, uint32_t timeout);
+
+/**
+ * @brief  发送数据并等待完成
+ * @param  timeout: 在队列里排队的最长时间（节拍数），OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 1 发送完成，0 超时（数据一个字节也没有发出去）
+ * @note   超时只作用于排队阶段：一旦 DMA 开始搬这块数据，就一直等到它发完，
+ *         否则函数返回后 data 所在的栈空间还会被 DMA 读
+ */
+uint8_t OS_UartWrite(OS_Uart *p_uart, const uint8_t *data, uint16_t len, uint32_t timeout);
+
+#endif /* __OS_UART_H */
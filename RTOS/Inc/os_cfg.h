@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ * @file    os_cfg.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 内核配置文件 (Kernel Configuration)
+ *
+ * 本文件集中存放可以按工程调整的内核配置：
+ * - 系统节拍频率
+ * - 节拍时钟源 (SysTick 或通用定时器)
+ * - 微秒延时的忙等门限
+ * - 内核中断天花板
+ * - 信号量快速路径开关
+ * - 调试检查开关
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_CFG_H
+#define __OS_CFG_H
+
+/* 节拍时钟源可选项 ------------------------------------------------------ */
+
+#define OS_TICK_SOURCE_SYSTICK  0  ///< SysTick，与 HAL_IncTick 共用 1 ms 中断
+#define OS_TICK_SOURCE_TIM2     1  ///< TIM2，SysTick 只留给 HAL，可提供更细的节拍内时间戳
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#define OS_TICK_RATE_HZ     1000u  ///< 系统节拍频率，1 tick = 1 ms
+                                   ///< 使用 SysTick 时必须保持 1000，否则 HAL_GetTick 会走偏
+
+#define OS_CFG_TICK_SOURCE  OS_TICK_SOURCE_SYSTICK  ///< 节拍时钟源
+
+#define OS_CFG_DELAY_US_SPIN  20u  ///< OS_DelayUs 短于这个值（单位us）时直接忙等，
+                                   ///< 两次任务切换加一次定时器中断的开销比它还大
+
+#define OS_CFG_MAX_SYSCALL_PRIO  5u  ///< 内核中断天花板 (NVIC 优先级数值)
+                                     ///< 临界区用 BASEPRI 只屏蔽数值 >= 它的中断；
+                                     ///< 数值更小的中断不受内核影响，但不能调用任何 OS_ 函数。
+                                     ///< 汇编里用的 BASEPRI 值 g_OSBasePri 由 os_cpu.c 从它算出，不用另外修改
+                                     ///< 会调用 OS_ 函数的中断（驱动的 DMA/外设中断等）优先级数值都必须 >= 它
+
+#ifndef OS_CFG_SEM_FAST_PATH
+#define OS_CFG_SEM_FAST_PATH  1u  ///< 1：信号量 Wait/Post 先走 LDREX/STREX 快速路径，只有阻塞或唤醒时才进临界区
+                                  ///< 0：一律进临界区（RTOS/Test/Host 的 sem_bench 用它对比两种路径）
+#endif
+
+#ifndef OS_CFG_DEBUG_CHECKS
+#define OS_CFG_DEBUG_CHECKS  0u  ///< 1：打开调试检查，发现违反约定时停在死循环里，方便调试器定位
+                                 ///< 目前检查：在中断里调用 OS_SemPost 时，该中断优先级数值 >= OS_CFG_MAX_SYSCALL_PRIO
+#endif
+
+#endif /* __OS_CFG_H */
@@ -18,10 +18,15 @@
 #ifndef __OS_CORE_H
 #define __OS_CORE_H
 
+#include "os_cfg.h"
 #include "os_cpu.h"
 #include "os_types.h"
 #include <stddef.h>
 
+/* 宏定义 ----------------------------------------------------------- */
+
+#define OS_WAIT_FOREVER  0xFFFFFFFFu  ///< 超时参数：永远等待
+
 /* 数据结构定义 -------------------------------------------------------- */
 
 /**
@@ -40,7 +45,11 @@ typedef struct Task_Control_Block
     struct Task_Control_Block *Next; ///< 指向下一个任务的指针
     OS_TaskState State; ///< 任务状态
     volatile uint32_t DelayTicks; ///< 延时的时间（单位ms）
-    struct Task_Control_Block *NextWaitTask ///< 指向下一个正在等待同一个信号量的任务
+    struct Task_Control_Block *NextWaitTask; ///< 指向下一个正在等待同一个信号量的任务
+    struct Semaphore *PendSem; ///< 正在等待的信号量，超时后要从它的等待链表里摘掉
+    volatile uint8_t PendTimeout; ///< 上一次等待是否因超时而结束
+    uint64_t WakeCycles; ///< OS_DelayUs 的唤醒时刻（单位：节拍定时器计数）
+    struct Task_Control_Block *NextHrTask; ///< 指向下一个等待高分辨率定时器的任务
 } OS_TCB;
 
 /**
@@ -49,13 +58,16 @@ typedef struct Task_Control_Block
 typedef struct Semaphore
 {
     volatile uint16_t count;
-    OS_TCB  *WaitListHead; 
+    OS_TCB  * volatile WaitListHead; ///< 无锁快速路径会在中断打开时读取它
     OS_TCB  *WaitListTail;
 } OS_Sem;
 
 
 /* 全局变量声明 -------------------------------------------------------- */
 extern volatile uint32_t g_SystemTickCount;
+extern volatile uint32_t g_SystemTickCountHigh;
+extern volatile uint32_t g_OSRunning;
+extern volatile uint32_t g_SchedLockNesting;
 extern OS_TCB* task_list_head;
 extern OS_TCB* CurrentTCB;
 extern OS_TCB* NextTCB;
@@ -84,9 +96,15 @@ void OS_Tick_Handler(void);
 /**
  * @brief  任务阻塞延时
  * @param  ticks: 延时的时间长度（单位ms）
+ * @note   调度器上锁期间调用会立即返回
  */
 void OS_Delay(uint32_t ticks);
 
+/**
+ * @brief  主动让出 CPU，切换到下一个就绪任务（没有别的就绪任务时直接返回）
+ */
+void OS_Yield(void);
+
 /**
  * @brief  进入临界区
  */
@@ -97,15 +115,39 @@ void OS_EnterCritical(void);
  */
 void OS_ExitCritical(void);
 
+/**
+ * @brief  调度器上锁（可嵌套）
+ * @note   上锁期间不关中断，中断照常响应；SysTick 和信号量发送只记录待切换，
+ *         最外层 OS_SchedUnlock 时统一切换一次。上锁期间不能调用阻塞函数
+ */
+void OS_SchedLock(void);
+
+/**
+ * @brief  调度器解锁
+ */
+void OS_SchedUnlock(void);
+
 /**
  * @brief  等待信号量
+ * @note   count > 0 时用 LDREX/STREX 直接减一，不关中断；只有需要阻塞时才进入临界区
  * @param  p_sem: 指向信号量的指针变量
- * @return uint8_t: 只会返回 1，代表接收到信号量
+ * @return uint8_t: 返回 1 代表接收到信号量；调度器上锁且需要阻塞时返回 0
  */
 uint8_t OS_SemWait(OS_Sem *p_sem);
 
+/**
+ * @brief  带超时地等待信号量
+ * @param  p_sem: 指向信号量的指针变量
+ * @param  ticks: 最多等待的时间（单位ms），0 表示不等待，OS_WAIT_FOREVER 表示永远等待
+ * @return uint8_t: 1 代表接收到信号量；超时或调度器上锁时返回 0
+ */
+uint8_t OS_SemWaitTimeout(OS_Sem *p_sem, uint32_t ticks);
+
 /**
  * @brief  发送信号量
+ * @note   没有任务在等待时用 LDREX/STREX 直接加一，不关中断；只有需要唤醒任务时才进入临界区
+ * @note   可以在中断里调用，但该中断优先级数值必须 >= OS_CFG_MAX_SYSCALL_PRIO
+ *         （OS_CFG_DEBUG_CHECKS 为 1 时会检查）
  * @param  p_sem: 指向信号量的指针变量
  * @return uint8_t: 只会返回 1，代表发送出信号量
  */
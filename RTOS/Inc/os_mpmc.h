@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ * @file    os_mpmc.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   多生产者/多消费者无锁有界队列 (MPMC Queue)
+ *
+ * 基于 Dmitry Vyukov 的有界 MPMC 队列：
+ * - 每个槽位带一个序号，入队/出队位置用 LDREX/STREX 抢占
+ * - 任务和中断都可以随时入队、出队，全程不关中断
+ * - 队列满或空时立即返回 0，不会阻塞，也不会在中断里自旋等待
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_MPMC_H
+#define __OS_MPMC_H
+
+#include "os_core.h"
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  MPMC 队列结构体定义
+ */
+typedef struct MpmcQueue
+{
+    uint8_t *Buffer;               ///< 元素存储区，大小为 容量 * ItemSize
+    volatile uint32_t *Sequence;   ///< 每个槽位的序号，长度为 容量
+    uint32_t Mask;                 ///< 容量 - 1
+    uint32_t ItemSize;             ///< 单个元素大小（单位：字节）
+    volatile uint32_t EnqueuePos;  ///< 下一个入队位置
+    volatile uint32_t DequeuePos;  ///< 下一个出队位置
+} OS_MpmcQueue;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化 MPMC 队列
+ * @param  p_q: 指向队列的指针变量
+ * @param  buffer: 元素存储区，至少 capacity * item_size 字节
+ * @param  sequence: 序号数组，至少 capacity 个元素
+ * @param  capacity: 队列容量（单位：元素个数），必须是 2 的幂且不小于 2
+ * @param  item_size: 单个元素大小（单位：字节）
+ * @return uint8_t: 1 代表成功；capacity 不是 2 的幂或小于 2 时返回 0
+ * @note   容量为 1 时槽位序号无法区分“已写好”和“下一圈空闲”，所以不支持
+ */
+uint8_t OS_MpmcQueueInit(OS_MpmcQueue *p_q, void *buffer, volatile uint32_t *sequence,
+                         uint32_t capacity, uint32_t item_size);
+
+/**
+ * @brief  入队（任务和中断都可以调用）
+ * @return uint8_t: 1 代表成功；队列满时返回 0
+ */
+uint8_t OS_MpmcQueuePush(OS_MpmcQueue *p_q, const void *item);
+
+/**
+ * @brief  出队（任务和中断都可以调用）
+ * @param  item: 接收元素的缓冲区；为 NULL 时只丢弃队头元素
+ * @return uint8_t: 1 代表成功；队列空时返回 0
+ * @note   如果某个生产者抢到槽位后被打断、还没写完，该槽位之后的元素暂时也读不到
+ */
+uint8_t OS_MpmcQueuePop(OS_MpmcQueue *p_q, void *item);
+
+/**
+ * @brief  查询队列中的元素个数（近似值，仅供统计）
+ */
+uint32_t OS_MpmcQueueCount(const OS_MpmcQueue *p_q);
+
+#endif /* __OS_MPMC_H */
@@ -0,0 +1,116 @@
+/**
+ ******************************************************************************
+ * @file    os_ringbuf.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   单生产者/单消费者无锁环形缓冲区 (SPSC Ring Buffer)
+ *
+ * 适用于中断向任务传送字节流 (UART、ADC 等)：
+ * - 容量必须是 2 的幂，读写索引自由增长，用掩码取模
+ * - 写索引只由生产者修改，读索引只由消费者修改，双方都不需要关中断
+ * - 支持零拷贝的连续区间 (Span) 读写
+ * - 可选的阈值唤醒：数据攒够 WakeThreshold 字节才唤醒一次读任务
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_RINGBUF_H
+#define __OS_RINGBUF_H
+
+#include "os_core.h"
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  环形缓冲区结构体定义
+ */
+typedef struct RingBuffer
+{
+    uint8_t *Buffer;                 ///< 存储区
+    uint32_t Mask;                   ///< 容量 - 1
+    volatile uint32_t Head;          ///< 写索引，只由生产者修改
+    volatile uint32_t Tail;          ///< 读索引，只由消费者修改
+    uint32_t WakeThreshold;          ///< 数据量达到该值时唤醒读任务，0 表示不使用唤醒
+    volatile uint32_t ReaderWaiting; ///< 读任务正睡在 OS_RingBufWait 里
+    volatile uint32_t FlushRequest;  ///< 生产者要求读任务不必等满阈值
+    OS_Sem DataSem;                  ///< 读任务阻塞用的信号量
+} OS_RingBuf;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化环形缓冲区
+ * @param  p_rb: 指向环形缓冲区的指针变量
+ * @param  buffer: 存储区首地址
+ * @param  size: 存储区大小（单位：字节），必须是 2 的幂
+ * @param  wake_threshold: 唤醒阈值（单位：字节），0 表示不使用 OS_RingBufWait
+ * @return uint8_t: 1 代表成功；size 不是 2 的幂时返回 0
+ */
+uint8_t OS_RingBufInit(OS_RingBuf *p_rb, uint8_t *buffer, uint32_t size, uint32_t wake_threshold);
+
+/**
+ * @brief  查询可读的字节数
+ */
+uint32_t OS_RingBufCount(const OS_RingBuf *p_rb);
+
+/**
+ * @brief  查询可写的字节数
+ */
+uint32_t OS_RingBufFree(const OS_RingBuf *p_rb);
+
+/**
+ * @brief  写入数据（生产者调用，可在中断里使用）
+ * @return uint32_t: 实际写入的字节数，空间不够时只写一部分
+ */
+uint32_t OS_RingBufWrite(OS_RingBuf *p_rb, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief  读出数据（消费者调用）
+ * @return uint32_t: 实际读出的字节数
+ */
+uint32_t OS_RingBufRead(OS_RingBuf *p_rb, uint8_t *data, uint32_t len);
+
+/**
+ * @brief  获取一段连续的可写区间（生产者调用，零拷贝写）
+ * @param  span: 返回区间首地址
+ * @return uint32_t: 区间长度，写完后用 OS_RingBufCommit 提交
+ */
+uint32_t OS_RingBufWriteSpan(OS_RingBuf *p_rb, uint8_t **span);
+
+/**
+ * @brief  提交通过 OS_RingBufWriteSpan 写入的数据，必要时唤醒读任务
+ */
+void OS_RingBufCommit(OS_RingBuf *p_rb, uint32_t len);
+
+/**
+ * @brief  获取一段连续的可读区间（消费者调用，零拷贝读）
+ * @param  span: 返回区间首地址
+ * @return uint32_t: 区间长度，处理完后用 OS_RingBufConsume 释放
+ */
+uint32_t OS_RingBufReadSpan(OS_RingBuf *p_rb, uint8_t **span);
+
+/**
+ * @brief  释放通过 OS_RingBufReadSpan 读取的数据
+ */
+void OS_RingBufConsume(OS_RingBuf *p_rb, uint32_t len);
+
+/**
+ * @brief  阻塞等待数据量达到唤醒阈值（只能有一个读任务调用）
+ * @return uint8_t: 1 代表有数据可读；调度器上锁导致无法阻塞时返回 0
+ */
+uint8_t OS_RingBufWait(OS_RingBuf *p_rb);
+
+/**
+ * @brief  带超时的 OS_RingBufWait
+ * @param  timeout: 最长等待的节拍数，0 表示只检查不等待，OS_WAIT_FOREVER 表示一直等
+ * @return uint8_t: 1 代表有数据可读；超时或无法阻塞时返回 0
+ */
+uint8_t OS_RingBufWaitTimeout(OS_RingBuf *p_rb, uint32_t timeout);
+
+/**
+ * @brief  不足阈值也唤醒读任务（例如 UART 空闲线中断时把零头交出去）
+ */
+void OS_RingBufFlush(OS_RingBuf *p_rb);
+
+#endif /* __OS_RINGBUF_H */
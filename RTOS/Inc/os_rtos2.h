@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file    os_rtos2.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-RTOS2 适配层 (cmsis_os2.h -> os_core)
+ *
+ * 本文件给出 CMSIS-RTOS2 各对象的控制块定义，供应用静态分配：
+ * - 所有 osXxxNew 都必须通过 attr->cb_mem 提供控制块，线程还要提供 stack_mem，
+ *   消息队列还要提供 mq_mem（大小用 OS_RTOS2_MQ_MEM_SIZE 计算）
+ * - 适配层不做任何动态内存分配，缺少内存时 osXxxNew 返回 NULL
+ * - 内核只有时间片轮转，线程优先级会被记录但不参与调度
+ * - 内核不能删除或挂起别的任务，osThreadTerminate（别的线程）、osThreadSuspend、
+ *   osThreadResume、osThreadDetach、osThreadJoin 都返回 osErrorResource；
+ *   osThreadExit 让线程永远睡下去，它的栈和控制块不能再用
+ * - 内核的信号量等待不能被取消，osXxxDelete 在有线程等待（互斥量还被持有）时
+ *   返回 osErrorResource，不删除
+ * - 没有实现（链接时报错）：osKernelSuspend/Resume、osKernelGetSysTimer*、
+ *   osThreadGetCount/Enumerate/GetStackSpace、osMemoryPool*
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_RTOS2_H
+#define __OS_RTOS2_H
+
+#include "cmsis_os2.h"
+#include "os_core.h"
+#include "os_mpmc.h"
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define OS_RTOS2_TIMER_STACK_SIZE  256  ///< 软件定时器线程的栈大小（单位：字）
+
+/**
+ * @brief  消息队列 mq_mem 需要的字节数：消息本身（对齐到 4 字节）+ 每个槽位一个序号
+ * @note   msg_count 必须是 2 的幂且不小于 2（见 OS_MpmcQueueInit）
+ */
+#define OS_RTOS2_MQ_MEM_SIZE(msg_count, msg_size) \
+    ((((msg_count) * (msg_size) + 3u) & ~3u) + (msg_count) * sizeof(uint32_t))
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  事件标志组控制块，线程标志也用它
+ */
+typedef struct
+{
+    volatile uint32_t Flags;  ///< 当前标志位
+    volatile uint32_t Waiters;///< 正在等待的线程数，置位时据此唤醒
+    OS_Sem Sem;               ///< 等待者阻塞用的信号量
+    const char *Name;
+} OS_Rtos2EventFlags;
+
+/**
+ * @brief  线程控制块，TCB 必须放在第一个，osThreadId_t 可以直接当 OS_TCB* 用
+ */
+typedef struct
+{
+    OS_TCB Tcb;             ///< 内核任务控制块
+    osThreadFunc_t Func;    ///< 线程入口
+    void *Argument;         ///< 线程参数
+    const char *Name;       ///< 线程名
+    uint32_t StackSize;     ///< 栈大小（单位：字节）
+    osPriority_t Priority;  ///< 记录下来的优先级（不参与调度）
+    OS_Rtos2EventFlags Flags; ///< 线程标志 (osThreadFlags*)
+    volatile uint8_t Exited;  ///< 已调用 osThreadExit（或线程函数已返回）
+} OS_Rtos2Thread;
+
+/**
+ * @brief  信号量控制块
+ */
+typedef struct
+{
+    OS_Sem Sem;         ///< 内核信号量
+    uint32_t MaxCount;  ///< 最大计数
+    const char *Name;
+} OS_Rtos2Semaphore;
+
+/**
+ * @brief  互斥量控制块：二值信号量 + 持有者 + 递归计数
+ */
+typedef struct
+{
+    OS_Sem Sem;         ///< 内核信号量，计数为 1 表示空闲
+    OS_TCB *Owner;      ///< 当前持有者
+    uint32_t Nesting;   ///< 递归加锁次数
+    uint32_t AttrBits;  ///< osMutexRecursive 等属性
+    const char *Name;
+} OS_Rtos2Mutex;
+
+/**
+ * @brief  消息队列控制块：MPMC 无锁队列 + 空位/消息两个计数信号量
+ */
+typedef struct
+{
+    OS_MpmcQueue Queue; ///< 存放消息的无锁队列
+    OS_Sem Items;       ///< 队列里的消息数
+    OS_Sem Slots;       ///< 队列里的空位数
+    const char *Name;
+} OS_Rtos2MessageQueue;
+
+/**
+ * @brief  软件定时器控制块，由定时器线程统一处理
+ */
+typedef struct Rtos2Timer
+{
+    osTimerFunc_t Func;       ///< 回调函数（在定时器线程里执行）
+    void *Argument;           ///< 回调参数
+    osTimerType_t Type;       ///< 单次或周期
+    uint32_t Period;          ///< 周期（单位：tick）
+    uint32_t Expire;          ///< 下一次到期的 tick
+    volatile uint8_t Running; ///< 是否在运行
+    struct Rtos2Timer *Next;  ///< 全部定时器组成的链表
+    const char *Name;
+} OS_Rtos2Timer;
+
+#endif /* __OS_RTOS2_H */
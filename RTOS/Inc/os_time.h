@@ -0,0 +1,84 @@
+/**
+ ******************************************************************************
+ * @file    os_time.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 高分辨率单调时间 (Monotonic Time)
+ *
+ * 把 64 位节拍计数和节拍定时器的当前计数值拼成一个单调时间：
+ * - 64 位节拍计数不会回绕（1 ms 节拍可以用 5 亿年）
+ * - 分辨率是节拍定时器的一个计数（SysTick 时就是一个 CPU 周期）
+ * - 读取过程不关中断，被节拍中断打断时自动重读，不会读到撕裂的 64 位值
+ *
+ * 微秒级延时 OS_DelayUs：
+ * - 等待的任务按唤醒时刻排成链表，单次定时器 (TIM3) 只为最早的那个编程
+ * - 任务阻塞期间让出 CPU，不再忙等
+ *
+ * 周期任务 OS_DelayUntil：按绝对的周期起点等待，误差不会逐周期累积，
+ * 并报告错过了几个起点
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_TIME_H
+#define __OS_TIME_H
+
+#include "os_core.h"
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define OS_DELAY_UNTIL_ERROR  0xFFFFFFFFu  ///< OS_DelayUntil：period 为 0，或者当前不能阻塞
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  读取 64 位节拍计数
+ * @return uint64_t: 节拍中断开始以来经过的节拍数（SysTick 作时钟源时从上电开始计）
+ */
+uint64_t OS_TimeNowTicks(void);
+
+/**
+ * @brief  读取高分辨率时间（单位：节拍定时器计数）
+ * @return uint64_t: 节拍数 * 每节拍计数 + 当前节拍内已经过的计数
+ * @note   计数频率由 OS_Tick_GetClock() 给出；SysTick 作时钟源时等于 CPU 主频
+ */
+uint64_t OS_TimeNowCycles(void);
+
+/**
+ * @brief  读取高分辨率时间（单位：ns）
+ */
+uint64_t OS_TimeNowNs(void);
+
+/**
+ * @brief  把节拍定时器计数换算成 ns
+ */
+uint64_t OS_TimeCyclesToNs(uint64_t cycles);
+
+/**
+ * @brief  任务阻塞延时（单位：us）
+ * @param  us: 延时的时间长度
+ * @note   短于 OS_CFG_DELAY_US_SPIN、调度器上锁、在中断里或调度器还没启动时改为忙等。
+ *         忙等只读节拍定时器的计数，不需要节拍中断；定时器还没开始计数时
+ *         （TIM2 作时钟源且调度器未启动）立即返回
+ */
+void OS_DelayUs(uint32_t us);
+
+/**
+ * @brief  周期任务的等待：阻塞到上一个周期起点之后 period 个节拍
+ * @param  p_next: 上一个周期的起点（节拍数，第一次调用前设为 OS_TimeNowTicks()），
+ *                 返回时改成这一个周期的起点
+ * @param  period: 周期（节拍数），不能为 0
+ * @return uint32_t: 错过的周期起点个数，0 表示按时；period 为 0、在中断里或调度器上锁
+ *         （OS_Delay 会立即返回，等不到起点）时返回 OS_DELAY_UNTIL_ERROR，*p_next 不变
+ * @note   起点恰好是当前节拍不算错过，直接返回、不阻塞；
+ *         错过时也不阻塞，只让同优先级任务先跑一下，并从当前节拍重新对齐
+ */
+uint32_t OS_DelayUntil(uint64_t *p_next, uint32_t period);
+
+/**
+ * @brief  处理高分辨率定时器中断的“回调函数”，由 TIM3_IRQHandler 调用
+ */
+void OS_HrTimer_IRQHandler(void);
+
+#endif /* __OS_TIME_H */
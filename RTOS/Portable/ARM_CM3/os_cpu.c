@@ -14,7 +14,18 @@
  */
 
 #include "os_cpu.h"
+#include "os_cfg.h"
+#include "os_tick.h"
 
+extern void OS_Tick_Handler(void);
+
+
+#if (OS_CFG_MAX_SYSCALL_PRIO == 0) || (OS_CFG_MAX_SYSCALL_PRIO >= (1 << __NVIC_PRIO_BITS))
+#error "OS_CFG_MAX_SYSCALL_PRIO must be 1 .. (1 << __NVIC_PRIO_BITS) - 1 (BASEPRI 0 masks nothing)"
+#endif
+
+/* 内核天花板只在 os_cfg.h 定义一次，汇编通过这个常量拿到同一个值 */
+const uint32_t g_OSBasePri = OS_CFG_MAX_SYSCALL_PRIO << (8 - __NVIC_PRIO_BITS);
 
 void OS_TaskReturn(void)
 {
@@ -54,20 +65,21 @@ uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32
   return sp;
 }
 
-void OS_Init_Timer(uint32_t ms)
+void OS_Init_Timer(uint32_t freq)
 {
-    uint32_t ticks = 72000000 * ms / 1000;
-
-    if(SysTick_Config(ticks)){
+    /* 节拍时钟源由 os_cfg.h 的 OS_CFG_TICK_SOURCE 选择 (os_tick_systick.c / os_tick_tim2.c) */
+    if(OS_Tick_Setup(freq, OS_Tick_Handler) != 0){
         while(1); /* 配置失败了，死循环 */
     }
 
     /* 设置优先级 */
     NVIC_SetPriority(PendSV_IRQn, 15); 
     
-    NVIC_SetPriority(SysTick_IRQn, 14); 
+    NVIC_SetPriority((IRQn_Type)OS_Tick_GetIRQn(), 14); 
 
-    __enable_irq(); // 开全局中断
+    OS_Tick_Enable();
+
+    /* 全局中断由 OS_StartFirstTask 在复位 MSP 之后再打开 */
 }
 
 void OS_Trigger_PendSV(void)
@@ -77,10 +89,19 @@ void OS_Trigger_PendSV(void)
 
 void OS_Enable_IRQ(void)
 {
-  __enable_irq();
+  __set_BASEPRI(0);
 }
 
 void OS_Disable_IRQ(void)
 {
-  __disable_irq();
+  /* 只屏蔽优先级不高于天花板的中断，更高优先级的中断不受内核临界区影响 */
+  __set_BASEPRI(OS_CFG_MAX_SYSCALL_PRIO << (8 - __NVIC_PRIO_BITS));
+  __DSB();
+  __ISB();
+}
+
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn)
+{
+  /* NVIC_GetPriority 返回的是去掉低位之后的优先级数值，和 OS_CFG_MAX_SYSCALL_PRIO 同一个单位 */
+  return NVIC_GetPriority((IRQn_Type)irqn) >= OS_CFG_MAX_SYSCALL_PRIO;
 }
@@ -21,6 +21,25 @@
 #include <stdint.h>
 #include "stm32f1xx.h"
 
+/* 独占访问指令 (LDREX/STREX) ------------------------------------------------ */
+
+/* 进入或退出异常时硬件会清除本地独占监视器，
+ * 所以 LDREX 和 STREX 之间只要被任何中断或任务切换打断，STREX 就一定失败 */
+#define OS_CPU_LDREXH(addr)         __LDREXH(addr)         ///< 独占读 16 位
+#define OS_CPU_STREXH(value, addr)  __STREXH(value, addr)  ///< 独占写 16 位，成功返回 0
+#define OS_CPU_LDREXW(addr)         __LDREXW(addr)         ///< 独占读 32 位
+#define OS_CPU_STREXW(value, addr)  __STREXW(value, addr)  ///< 独占写 32 位，成功返回 0
+#define OS_CPU_CLREX()              __CLREX()              ///< 放弃独占访问
+
+/* 当前是否运行在中断（Handler 模式）里 */
+#define OS_CPU_InISR()              (__get_IPSR() != 0u)
+
+/* 当前中断的中断号（CMSIS IRQn 编号，系统异常为负数），只在中断里有意义 */
+#define OS_CPU_ActiveIRQn()         ((int32_t)__get_IPSR() - 16)
+
+/* 内存屏障：保证屏障之前的访存（包括 DMA 能看到的）先于之后的访存完成 */
+#define OS_CPU_DMB()                __DMB()
+
 /* 函数声明 ---------------------------------------------------------------- */
 
 /**
@@ -34,9 +53,15 @@ uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32
 
 /**
  * @brief  初始化SysTick
- * @param  ms: 时间片长度（单位ms） 
+ * @param  freq: 节拍频率（单位Hz），即 OS_TICK_RATE_HZ
+ */
+void OS_Init_Timer(uint32_t freq);
+
+/**
+ * @brief  复位 MSP 并通过 SVC 启动第一个任务 (汇编实现，永不返回)
+ * @note   调用前 CurrentTCB 必须指向第一个要运行的任务
  */
-void OS_Init_Timer(uint32_t ms);
+void OS_StartFirstTask(void);
 
 /**
  * @brief  触发PendSV中断
@@ -44,13 +69,51 @@ void OS_Init_Timer(uint32_t ms);
 void OS_Trigger_PendSV(void);
 
 /**
- * @brief  打开全局中断
+ * @brief  打开中断（清除 BASEPRI）
  */
 void OS_Enable_IRQ(void);
 
 /**
- * @brief  关闭全局中断
+ * @brief  关闭内核管理的中断（BASEPRI 提到 OS_CFG_MAX_SYSCALL_PRIO）
+ * @note   优先级数值小于 OS_CFG_MAX_SYSCALL_PRIO 的中断不会被屏蔽，
+ *         它们里面不能调用任何 OS_ 函数
  */
 void OS_Disable_IRQ(void);
 
+/**
+ * @brief  中断里能否调用 OS_ 函数
+ * @param  irqn   : CMSIS 中断号
+ * @return uint8_t: 1 优先级数值 >= OS_CFG_MAX_SYSCALL_PRIO，会被内核临界区屏蔽；0 不能调用
+ */
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn);
+
+/**
+ * @brief  内核临界区写入 BASEPRI 的值，os_cpu_a.s 的 PendSV_Handler 也从这里读
+ */
+extern const uint32_t g_OSBasePri;
+
+/* 高分辨率单次定时器 (os_hrtimer.c, TIM3) ---------------------------- */
+
+/**
+ * @brief  初始化 TIM3：1 MHz 计数，单脉冲模式，打开更新中断
+ */
+void OS_HrTimer_Init(void);
+
+/**
+ * @brief  启动一次单次定时
+ * @param  us: 多少 us 后进入 TIM3 中断（1 ~ 65535，超出范围会被截断）
+ * @note   会覆盖上一次还没到期的定时
+ */
+void OS_HrTimer_Start(uint32_t us);
+
+/**
+ * @brief  停止定时器，丢弃还没到期的定时
+ */
+void OS_HrTimer_Stop(void);
+
+/**
+ * @brief  清除 TIM3 更新中断标志，在 TIM3_IRQHandler 里调用
+ */
+void OS_HrTimer_AcknowledgeIRQ(void);
+
 #endif /* __OS_CPU_H */
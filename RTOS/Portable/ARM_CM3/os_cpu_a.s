@@ -25,31 +25,80 @@
 ; 5. 引入外部符号 (相当于 C 语言的 extern，我们要访问 C 里的变量)
     IMPORT  CurrentTCB  ; 在 C 里定义的全局变量叫 CurrentTCB
     IMPORT  NextTCB
+    IMPORT  g_OSRunning ; 调度器运行标志，由 SVC_Handler 置 1
+    IMPORT  g_OSBasePri ; 内核中断天花板的 BASEPRI 值，在 os_cpu.c 里由 os_cfg.h 算出
+
+; 6. 常量定义
+NVIC_VTOR       EQU     0xE000ED08  ; 向量表偏移寄存器，向量表第 0 项就是 MSP 初值
 
 
 ;===============================================================================
 ; 函数实现
 ;===============================================================================
 
+; -----------------------------------------
+; 函数：OS_StartFirstTask
+; 复位 MSP 并通过 SVC 启动第一个任务，永不返回
+; -----------------------------------------
+OS_StartFirstTask  PROC
+    EXPORT  OS_StartFirstTask
+    CPSID I ; 关中断，MSP 复位期间不允许任何中断使用主栈
+
+    LDR R0, =NVIC_VTOR ; R0 = VTOR 寄存器地址
+    LDR R0, [R0] ; R0 = 向量表首地址
+    LDR R0, [R0] ; R0 = 向量表第 0 项，也就是复位时 MSP 的初值（主栈栈顶）
+    MSR MSP, R0 ; MSP 回到栈顶，main() 之前占用的主栈空间全部还给中断嵌套使用
+
+    MOV R0, #0
+    MSR BASEPRI, R0 ; OS_StartScheduler 里提高的 BASEPRI 在这里清掉，任务从开中断的状态开始运行
+    CPSIE I ; 开中断。此时 g_OSRunning 仍为 0，SysTick 即使触发也不会调度
+    DSB
+    ISB
+    SVC #0 ; 由 SVC_Handler 恢复第一个任务的上下文
+
+    NOP ; 永远不会执行到这里
+    ENDP
+
+; -----------------------------------------
+; 函数：SVC_Handler
+; 只用于启动第一个任务：恢复 CurrentTCB 的上下文，并以 PSP 返回线程模式
+; -----------------------------------------
+SVC_Handler  PROC
+    EXPORT  SVC_Handler
+    LDR R3, =CurrentTCB ; R3 = CurrentTCB 的地址
+    LDR R1, [R3] ; R1 = 第一个任务的 TCB
+    LDR R0, [R1] ; R0 = 该任务的 sp
+    LDMIA R0!, {R4-R11} ; 恢复软件区
+    MSR PSP, R0 ; PSP 指向硬件区，异常返回时由硬件出栈
+    ISB
+
+    LDR R2, =g_OSRunning
+    MOV R0, #1
+    STR R0, [R2] ; 从这里开始 SysTick 才会真正参与调度
+
+    ORR LR, LR, #0x0D   ; LR = 0xFFFFFFFD，返回线程模式并使用 PSP，栈的切换由硬件一次完成
+    BX LR
+    ENDP
+
 ; -----------------------------------------
 ; 函数：PendSV_Handler
 ; -----------------------------------------
 PendSV_Handler  PROC  ; PROC代表函数的开头
     EXPORT  PendSV_Handler
-    CPSID I ; 关中断
+    LDR R0, =g_OSBasePri
+    LDR R0, [R0]
+    MSR BASEPRI, R0 ; 屏蔽内核管理的中断，天花板以上的中断照常响应
+    ISB
     MRS R0, PSP
     ISB ; 指令同步隔离，确保程序生效
 
     LDR R2, =CurrentTCB ; 现在R2里存的是CurrentTCB的地址
     LDR R1, [R2] ; 把R2（CurrentTCB）地址中所存的值（就是TCB的首地址，也就是sp变量的地址）存到R1里
 
-    CMP R1, #0          ; 比较R1和0
-    BEQ RestoreContext  ; 如果相等 (Z标志位为1)，直接跳转到恢复上下文部分
-
+    ; 第一个任务由 SVC_Handler 启动，进入 PendSV 时 CurrentTCB 一定有效，不再需要判空
     STMDB R0!, {R4-R11}
     STR R0, [R1] ; 把现在的R0（也就是PSP最终指向的地址）存到R1指向的地址（也就是存进sp变量）
 
-RestoreContext
     LDR R2, =NextTCB ; 现在R2里存的是NextTCB的地址
     LDR R3, =CurrentTCB ; 现在R3里存的是CurrentTCB的地址
     LDR R1, [R2] ; 把R2（NextTCB）地址中所存的值存到R1里
@@ -58,14 +107,12 @@ RestoreContext
     LDMIA R0!, {R4-R11}
     MSR PSP, R0
     ORR LR, LR, #0x04   ; 将LR的第2位置1，返回时使用PSP
-    CPSIE I
+    MOV R0, #0
+    MSR BASEPRI, R0
     BX LR
     ENDP
 
+    ALIGN ; 保证文字池 (LDR Rx, =xxx) 4 字节对齐
 
-
-
-
-
-; 6. 文件结束 (必须有，且必须放在最后一行)
+; 7. 文件结束 (必须有，且必须放在最后一行)
     END
\ No newline at end of file
@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    os_hrtimer.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   高分辨率单次定时器 (TIM3，HAL tim 驱动)
+ *
+ * 为 OS_DelayUs 提供微秒级的单次超时中断：
+ * - TIM3 预分频到 1 MHz，单脉冲模式，每次只为最早的截止时间编程一次
+ * - 单次最长 65535 us，更远的截止时间会分段触发
+ * - 中断入口在 stm32f1xx_it.c 的 TIM3_IRQHandler
+ *
+ ******************************************************************************
+ */
+
+#include "os_cpu.h"
+#include "stm32f1xx_hal.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static TIM_HandleTypeDef HrTimerHandle;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void OS_HrTimer_Init(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    uint32_t timclk = ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1) ? pclk1 : pclk1 * 2;
+
+    __HAL_RCC_TIM3_CLK_ENABLE();
+
+    HrTimerHandle.Instance = TIM3;
+    HrTimerHandle.Init.Prescaler = timclk / 1000000 - 1; // 1 个计数 = 1 us
+    HrTimerHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    HrTimerHandle.Init.Period = 0xFFFF;
+    HrTimerHandle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    HrTimerHandle.Init.RepetitionCounter = 0;
+    HrTimerHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_OnePulse_Init(&HrTimerHandle, TIM_OPMODE_SINGLE) != HAL_OK)
+    {
+        while (1); /* 配置失败了，死循环 */
+    }
+
+    // 只让计数溢出产生更新事件，避免手动装载时误触发中断
+    HrTimerHandle.Instance->CR1 |= TIM_CR1_URS;
+    __HAL_TIM_CLEAR_FLAG(&HrTimerHandle, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&HrTimerHandle, TIM_IT_UPDATE);
+
+    // 和节拍中断同一优先级，二者不会互相嵌套着访问内核
+    NVIC_SetPriority(TIM3_IRQn, 14);
+    NVIC_EnableIRQ(TIM3_IRQn);
+}
+
+void OS_HrTimer_Start(uint32_t us)
+{
+    if (us == 0)
+        us = 1;
+    if (us > 0xFFFF)
+        us = 0xFFFF;
+
+    __HAL_TIM_DISABLE(&HrTimerHandle);
+    __HAL_TIM_SET_AUTORELOAD(&HrTimerHandle, us);
+    __HAL_TIM_SET_COUNTER(&HrTimerHandle, 0);
+    __HAL_TIM_CLEAR_FLAG(&HrTimerHandle, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE(&HrTimerHandle); // 单脉冲模式：溢出一次后硬件自动停止
+}
+
+void OS_HrTimer_Stop(void)
+{
+    __HAL_TIM_DISABLE(&HrTimerHandle);
+    __HAL_TIM_CLEAR_FLAG(&HrTimerHandle, TIM_FLAG_UPDATE);
+}
+
+void OS_HrTimer_AcknowledgeIRQ(void)
+{
+    __HAL_TIM_CLEAR_FLAG(&HrTimerHandle, TIM_FLAG_UPDATE);
+}
@@ -0,0 +1,87 @@
+/**
+ ******************************************************************************
+ * @file    os_tick_systick.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   节拍时钟源：SysTick (CMSIS os_tick.h 接口)
+ *
+ * SysTick 同时给 HAL_IncTick 和内核提供 1 ms 中断，两者都在
+ * stm32f1xx_it.c 的 SysTick_Handler 里调用。
+ * 重装值由 SystemCoreClock 计算，不再写死 72 MHz。
+ *
+ ******************************************************************************
+ */
+
+#include "os_cfg.h"
+
+#if (OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_SYSTICK)
+
+#include "os_cpu.h"
+#include "os_tick.h"
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int32_t OS_Tick_Setup(uint32_t freq, IRQHandler_t handler)
+{
+    uint32_t load;
+
+    (void)handler; // 中断入口固定为 SysTick_Handler
+
+    if (freq == 0)
+        return -1;
+
+    load = SystemCoreClock / freq - 1;
+    if (load > SysTick_LOAD_RELOAD_Msk)
+        return -1;
+
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+    SysTick->LOAD = load;
+    SysTick->VAL = 0;
+
+    return 0;
+}
+
+void OS_Tick_Enable(void)
+{
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+}
+
+void OS_Tick_Disable(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+}
+
+void OS_Tick_AcknowledgeIRQ(void)
+{
+    // SysTick 的挂起位在进入中断时由硬件自动清除
+}
+
+int32_t OS_Tick_GetIRQn(void)
+{
+    return (int32_t)SysTick_IRQn;
+}
+
+uint32_t OS_Tick_GetClock(void)
+{
+    return SystemCoreClock;
+}
+
+uint32_t OS_Tick_GetInterval(void)
+{
+    return SysTick->LOAD + 1;
+}
+
+uint32_t OS_Tick_GetCount(void)
+{
+    // SysTick 是递减计数器，换算成从本节拍开始经过的计数
+    return SysTick->LOAD - SysTick->VAL;
+}
+
+uint32_t OS_Tick_GetOverflow(void)
+{
+    // 读 CTRL.COUNTFLAG 会把它清掉，这里改看中断挂起位
+    return (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) ? 1 : 0;
+}
+
+#endif /* OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_SYSTICK */
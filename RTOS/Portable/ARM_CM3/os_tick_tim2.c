@@ -0,0 +1,109 @@
+/**
+ ******************************************************************************
+ * @file    os_tick_tim2.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   节拍时钟源：TIM2 (CMSIS os_tick.h 接口)
+ *
+ * 使用 TIM2 的更新中断作为内核节拍，SysTick 只留给 HAL_IncTick：
+ * - 定时器时钟由 SystemCoreClock 和 APB1 分频推算 (APB1 分频不为 1 时再乘 2)
+ * - 预分频取能让重装值放进 16 位的最小值，保证节拍内时间戳分辨率最高
+ * - 中断入口在 stm32f1xx_it.c 的 TIM2_IRQHandler
+ *
+ ******************************************************************************
+ */
+
+#include "os_cfg.h"
+
+#if (OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_TIM2)
+
+#include "os_cpu.h"
+#include "os_tick.h"
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t Tim2InputClock(void)
+{
+    uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+    uint32_t pclk1 = SystemCoreClock >> APBPrescTable[ppre1];
+
+    // APB1 分频系数不为 1 时，定时器时钟是 PCLK1 的两倍
+    return (APBPrescTable[ppre1] == 0) ? pclk1 : pclk1 * 2;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int32_t OS_Tick_Setup(uint32_t freq, IRQHandler_t handler)
+{
+    uint32_t counts;
+    uint32_t prescaler;
+
+    (void)handler; // 中断入口固定为 TIM2_IRQHandler
+
+    if (freq == 0)
+        return -1;
+
+    counts = Tim2InputClock() / freq;
+    prescaler = (counts - 1) / 0x10000; // 让 counts / (prescaler + 1) 不超过 65536
+    if (counts == 0 || prescaler > 0xFFFF)
+        return -1;
+
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    (void)RCC->APB1ENR; // 等时钟生效
+
+    TIM2->CR1 = TIM_CR1_URS; // 向上计数，只有计数溢出才产生更新中断
+    TIM2->PSC = prescaler;
+    TIM2->ARR = counts / (prescaler + 1) - 1;
+    TIM2->CNT = 0;
+    TIM2->EGR = TIM_EGR_UG; // 立即装载 PSC
+    TIM2->SR = 0;
+
+    return 0;
+}
+
+void OS_Tick_Enable(void)
+{
+    TIM2->DIER |= TIM_DIER_UIE;
+    TIM2->CR1 |= TIM_CR1_CEN;
+    NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+void OS_Tick_Disable(void)
+{
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+    TIM2->DIER &= ~TIM_DIER_UIE;
+    NVIC_DisableIRQ(TIM2_IRQn);
+}
+
+void OS_Tick_AcknowledgeIRQ(void)
+{
+    TIM2->SR = ~TIM_SR_UIF; // 写 0 清除，写 1 无效
+}
+
+int32_t OS_Tick_GetIRQn(void)
+{
+    return (int32_t)TIM2_IRQn;
+}
+
+uint32_t OS_Tick_GetClock(void)
+{
+    return Tim2InputClock() / (TIM2->PSC + 1);
+}
+
+uint32_t OS_Tick_GetInterval(void)
+{
+    return TIM2->ARR + 1;
+}
+
+uint32_t OS_Tick_GetCount(void)
+{
+    return TIM2->CNT; // 向上计数，就是从本节拍开始经过的计数
+}
+
+uint32_t OS_Tick_GetOverflow(void)
+{
+    return (TIM2->SR & TIM_SR_UIF) ? 1 : 0;
+}
+
+#endif /* OS_CFG_TICK_SOURCE == OS_TICK_SOURCE_TIM2 */
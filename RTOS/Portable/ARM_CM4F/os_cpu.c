@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * @file    os_cpu.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 移植层 C 语言实现 (ARM Cortex-M4F)
+ *
+ * 本文件包含涉及硬件细节但可用 C 语言实现的函数：
+ * - 任务栈初始化 (Task_Stack_Init)
+ * - 伪造异常栈帧 (xPSR, PC, LR, R12, R3-R0) 与 EXC_RETURN
+ *
+ ******************************************************************************
+ */
+
+#include "os_cpu.h"
+#include "os_cfg.h"
+
+
+#if (OS_CFG_MAX_SYSCALL_PRIO == 0) || (OS_CFG_MAX_SYSCALL_PRIO >= (1 << __NVIC_PRIO_BITS))
+#error "OS_CFG_MAX_SYSCALL_PRIO must be 1 .. (1 << __NVIC_PRIO_BITS) - 1 (BASEPRI 0 masks nothing)"
+#endif
+
+/* 内核天花板只在 os_cfg.h 定义一次，汇编通过这个常量拿到同一个值 */
+const uint32_t g_OSBasePri = OS_CFG_MAX_SYSCALL_PRIO << (8 - __NVIC_PRIO_BITS);
+
+void OS_TaskReturn(void)
+{
+  for(;;);
+}
+
+uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32_t stack_depth)
+{
+  /* 第一步：找到栈顶 */
+  uint32_t* sp = stack_init_address + stack_depth;
+
+  /* 第二步：字节对齐 */
+  sp = (uint32_t *)((uint32_t)sp & 0xFFFFFFF8); // 先把sp转成uint32_t，再把最后3位抹成0，最后转成uint32_t *
+
+  /* 第三步：填入数据 */
+  /* 硬件区：新任务还没用过 FPU，所以是不带浮点寄存器的基本栈帧 */
+  *(--sp) = (uint32_t)0x01000000; // xPSR
+  *(--sp) = (uint32_t)task_function; // PC
+  *(--sp) = (uint32_t)OS_TaskReturn; // LR
+  *(--sp) = (uint32_t)0x0; // R12 
+  *(--sp) = (uint32_t)0x0; // R3
+  *(--sp) = (uint32_t)0x0; // R2
+  *(--sp) = (uint32_t)0x0; // R1
+  *(--sp) = (uint32_t)0x0; // R0
+
+  /* 软件区：EXC_RETURN 放在最高地址，对应 STMDB {R4-R11, LR} 的顺序 */
+  *(--sp) = OS_CPU_EXC_RETURN_THREAD_PSP; // EXC_RETURN (bit4 = 1，无浮点上下文)
+  *(--sp) = (uint32_t)0x0; // R11
+  *(--sp) = (uint32_t)0x0; // R10
+  *(--sp) = (uint32_t)0x0; // R9
+  *(--sp) = (uint32_t)0x0; // R8
+  *(--sp) = (uint32_t)0x0; // R7
+  *(--sp) = (uint32_t)0x0; // R6
+  *(--sp) = (uint32_t)0x0; // R5
+  *(--sp) = (uint32_t)0x0; // R4
+
+  /* 第四步：返回sp */
+  return sp;
+}
+
+void OS_Init_Timer(uint32_t freq)
+{
+    if(freq == 0 || SysTick_Config(SystemCoreClock / freq)){
+        while(1); /* 配置失败了，死循环 */
+    }
+
+    /* 设置优先级 */
+    NVIC_SetPriority(PendSV_IRQn, 15); 
+    
+    NVIC_SetPriority(SysTick_IRQn, 14); 
+
+    /* 全局中断由 OS_StartFirstTask 在复位 MSP 之后再打开 */
+}
+
+void OS_Trigger_PendSV(void)
+{
+    SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+}
+
+void OS_Enable_IRQ(void)
+{
+  __set_BASEPRI(0);
+}
+
+void OS_Disable_IRQ(void)
+{
+  /* 只屏蔽优先级不高于天花板的中断，更高优先级的中断不受内核临界区影响 */
+  __set_BASEPRI(OS_CFG_MAX_SYSCALL_PRIO << (8 - __NVIC_PRIO_BITS));
+  __DSB();
+  __ISB();
+}
+
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn)
+{
+  /* NVIC_GetPriority 返回的是去掉低位之后的优先级数值，和 OS_CFG_MAX_SYSCALL_PRIO 同一个单位 */
+  return NVIC_GetPriority((IRQn_Type)irqn) >= OS_CFG_MAX_SYSCALL_PRIO;
+}
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file    os_cpu.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 架构相关头文件 (ARM Cortex-M4F)
+ *
+ * 本文件包含与特定硬件架构相关的定义和宏：
+ * - 处理器特定的数据类型
+ * - 临界区保护宏 (关中断/开中断)
+ * - 堆栈增长方向定义
+ * - 汇编指令封装
+ *
+ * 与 ARM_CM3 移植层的区别：任务栈的软件区多保存一个 EXC_RETURN，
+ * PendSV 根据它的 bit4 决定是否保存 S16-S31（见 os_cpu_a.s）。
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_CPU_H
+#define __OS_CPU_H
+
+#include <stdint.h>
+
+/* 芯片头文件：在工程的预定义宏里指定，例如 OS_CPU_DEVICE_HEADER="stm32f4xx.h"
+ * 默认使用 CMSIS 包里的通用 Cortex-M4F 设备头 (Device/ARM/ARMCM4) */
+#ifdef OS_CPU_DEVICE_HEADER
+#include OS_CPU_DEVICE_HEADER
+#else
+#include "ARMCM4_FP.h"
+#endif
+
+/* 独占访问指令 (LDREX/STREX) ------------------------------------------------ */
+
+/* 进入或退出异常时硬件会清除本地独占监视器，
+ * 所以 LDREX 和 STREX 之间只要被任何中断或任务切换打断，STREX 就一定失败 */
+#define OS_CPU_LDREXH(addr)         __LDREXH(addr)         ///< 独占读 16 位
+#define OS_CPU_STREXH(value, addr)  __STREXH(value, addr)  ///< 独占写 16 位，成功返回 0
+#define OS_CPU_LDREXW(addr)         __LDREXW(addr)         ///< 独占读 32 位
+#define OS_CPU_STREXW(value, addr)  __STREXW(value, addr)  ///< 独占写 32 位，成功返回 0
+#define OS_CPU_CLREX()              __CLREX()              ///< 放弃独占访问
+
+/* 当前是否运行在中断（Handler 模式）里 */
+#define OS_CPU_InISR()              (__get_IPSR() != 0u)
+
+/* 当前中断的中断号（CMSIS IRQn 编号，系统异常为负数），只在中断里有意义 */
+#define OS_CPU_ActiveIRQn()         ((int32_t)__get_IPSR() - 16)
+
+/* 内存屏障：保证屏障之前的访存（包括 DMA 能看到的）先于之后的访存完成 */
+#define OS_CPU_DMB()                __DMB()
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+#define OS_CPU_EXC_RETURN_THREAD_PSP 0xFFFFFFFDu ///< 返回线程模式、使用 PSP、无浮点栈帧
+
+/* 函数声明 ---------------------------------------------------------------- */
+
+/**
+ * @brief  初始化任务栈
+ * @param  task_entry: 任务入口函数地址
+ * @param  stack_top : 栈数组的起始地址（低地址）
+ * @param  stack_size: 栈大小（单位：元素个数，不是字节）
+ * @return uint32_t* : 初始化后的栈顶指针 (SP)
+ * @note   用到浮点的任务，栈要比整数任务多留 34 个字（S0-S15、FPSCR、保留字、S16-S31）
+ */
+uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32_t stack_depth);
+
+/**
+ * @brief  初始化SysTick
+ * @param  freq: 节拍频率（单位Hz），即 OS_TICK_RATE_HZ
+ */
+void OS_Init_Timer(uint32_t freq);
+
+/**
+ * @brief  打开 FPU 并启用硬件惰性压栈 (汇编实现，由 OS_StartFirstTask 调用)
+ */
+void OS_Init_FPU(void);
+
+/**
+ * @brief  复位 MSP 并通过 SVC 启动第一个任务 (汇编实现，永不返回)
+ * @note   调用前 CurrentTCB 必须指向第一个要运行的任务
+ */
+void OS_StartFirstTask(void);
+
+/**
+ * @brief  触发PendSV中断
+ */
+void OS_Trigger_PendSV(void);
+
+/**
+ * @brief  打开中断（清除 BASEPRI）
+ */
+void OS_Enable_IRQ(void);
+
+/**
+ * @brief  关闭内核管理的中断（BASEPRI 提到 OS_CFG_MAX_SYSCALL_PRIO）
+ * @note   优先级数值小于 OS_CFG_MAX_SYSCALL_PRIO 的中断不会被屏蔽，
+ *         它们里面不能调用任何 OS_ 函数
+ */
+void OS_Disable_IRQ(void);
+
+/**
+ * @brief  中断里能否调用 OS_ 函数
+ * @param  irqn   : CMSIS 中断号
+ * @return uint8_t: 1 优先级数值 >= OS_CFG_MAX_SYSCALL_PRIO，会被内核临界区屏蔽；0 不能调用
+ */
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn);
+
+/**
+ * @brief  内核临界区写入 BASEPRI 的值，os_cpu_a.s 的 PendSV_Handler 也从这里读
+ */
+extern const uint32_t g_OSBasePri;
+
+#endif /* __OS_CPU_H */
@@ -0,0 +1,151 @@
+;********************************************************************************
+; file: os_cpu_a.s
+; brief:   RTOS 的底层汇编接口 (Cortex-M4F)
+;
+; 浮点上下文使用硬件惰性压栈 (FPCCR.ASPEN = LSPEN = 1)：
+; - 任务第一次执行浮点指令后 CONTROL.FPCA 置 1，之后进入异常时
+;   EXC_RETURN 的 bit4 为 0，硬件只为 S0-S15/FPSCR 预留空间，并不真正写入
+; - PendSV 只有在 bit4 为 0 时才保存/恢复 S16-S31，
+;   从没用过 FPU 的整数任务切换开销和 ARM_CM3 移植层完全一样
+; - EXC_RETURN 跟随任务一起保存在任务栈上，恢复时据此决定是否出栈 S16-S31
+;********************************************************************************
+
+; 1. 声明：承诺堆栈是 8 字节对齐的
+    PRESERVE8
+
+; 2. 声明：我们要使用 Thumb 指令集
+    THUMB
+
+; 3. 定义段 (Section)
+    AREA    |.text|, CODE, READONLY
+
+; 4. 引入外部符号
+    IMPORT  CurrentTCB
+    IMPORT  NextTCB
+    IMPORT  g_OSRunning ; 调度器运行标志，由 SVC_Handler 置 1
+    IMPORT  g_OSBasePri ; 内核中断天花板的 BASEPRI 值，在 os_cpu.c 里由 os_cfg.h 算出
+
+; 5. 常量定义
+NVIC_VTOR       EQU     0xE000ED08  ; 向量表偏移寄存器，向量表第 0 项就是 MSP 初值
+SCB_CPACR       EQU     0xE000ED88  ; 协处理器访问控制寄存器
+FPU_FPCCR       EQU     0xE000EF34  ; 浮点上下文控制寄存器
+
+
+;===============================================================================
+; 函数实现
+;===============================================================================
+
+; -----------------------------------------
+; 函数：OS_Init_FPU
+; 打开 CP10/CP11 的完全访问权限，并启用自动保存 + 惰性压栈
+; -----------------------------------------
+OS_Init_FPU  PROC
+    EXPORT  OS_Init_FPU
+    LDR R0, =SCB_CPACR
+    LDR R1, [R0]
+    ORR R1, R1, #(0xF << 20) ; CP10、CP11 完全访问
+    STR R1, [R0]
+
+    LDR R0, =FPU_FPCCR
+    LDR R1, [R0]
+    ORR R1, R1, #(0x3 << 30) ; ASPEN | LSPEN
+    STR R1, [R0]
+
+    DSB
+    ISB
+    BX LR
+    ENDP
+
+; -----------------------------------------
+; 函数：OS_StartFirstTask
+; 复位 MSP 并通过 SVC 启动第一个任务，永不返回
+; -----------------------------------------
+OS_StartFirstTask  PROC
+    EXPORT  OS_StartFirstTask
+    CPSID I ; 关中断，MSP 复位期间不允许任何中断使用主栈
+
+    BL OS_Init_FPU
+
+    LDR R0, =NVIC_VTOR ; R0 = VTOR 寄存器地址
+    LDR R0, [R0] ; R0 = 向量表首地址
+    LDR R0, [R0] ; R0 = 向量表第 0 项，也就是复位时 MSP 的初值（主栈栈顶）
+    MSR MSP, R0 ; MSP 回到栈顶，main() 之前占用的主栈空间全部还给中断嵌套使用
+
+    MOV R0, #0
+    MSR CONTROL, R0 ; 清掉 main() 可能留下的 FPCA，保证 SVC 压的是基本栈帧
+    ISB
+
+    MOV R0, #0
+    MSR BASEPRI, R0 ; OS_StartScheduler 里提高的 BASEPRI 在这里清掉，任务从开中断的状态开始运行
+    CPSIE I ; 开中断。此时 g_OSRunning 仍为 0，SysTick 即使触发也不会调度
+    DSB
+    ISB
+    SVC #0 ; 由 SVC_Handler 恢复第一个任务的上下文
+
+    NOP ; 永远不会执行到这里
+    ENDP
+
+; -----------------------------------------
+; 函数：SVC_Handler
+; 只用于启动第一个任务：恢复 CurrentTCB 的上下文，并以 PSP 返回线程模式
+; -----------------------------------------
+SVC_Handler  PROC
+    EXPORT  SVC_Handler
+    LDR R3, =CurrentTCB ; R3 = CurrentTCB 的地址
+    LDR R1, [R3] ; R1 = 第一个任务的 TCB
+    LDR R0, [R1] ; R0 = 该任务的 sp
+    LDMIA R0!, {R4-R11, LR} ; 恢复软件区，LR = 任务栈里的 EXC_RETURN (0xFFFFFFFD)
+    MSR PSP, R0 ; PSP 指向硬件区，异常返回时由硬件出栈
+    ISB
+
+    LDR R2, =g_OSRunning
+    MOV R0, #1
+    STR R0, [R2] ; 从这里开始 SysTick 才会真正参与调度
+
+    BX LR ; 返回线程模式并使用 PSP，栈的切换由硬件一次完成
+    ENDP
+
+; -----------------------------------------
+; 函数：PendSV_Handler
+; -----------------------------------------
+PendSV_Handler  PROC
+    EXPORT  PendSV_Handler
+    LDR R0, =g_OSBasePri
+    LDR R0, [R0]
+    MSR BASEPRI, R0 ; 屏蔽内核管理的中断，天花板以上的中断照常响应
+    ISB
+    MRS R0, PSP
+    ISB
+
+    LDR R2, =CurrentTCB ; R2 = CurrentTCB 的地址
+    LDR R1, [R2] ; R1 = 当前任务的 TCB
+
+    TST LR, #0x10 ; EXC_RETURN bit4 为 0 说明当前任务用过 FPU
+    IT EQ
+    VSTMDBEQ R0!, {S16-S31} ; 只为浮点任务保存 S16-S31（同时触发 S0-S15 的惰性压栈）
+
+    STMDB R0!, {R4-R11, LR} ; 保存软件区，连同 EXC_RETURN 一起
+    STR R0, [R1] ; 保存当前任务的 sp
+
+    LDR R2, =NextTCB ; R2 = NextTCB 的地址
+    LDR R3, =CurrentTCB ; R3 = CurrentTCB 的地址
+    LDR R1, [R2] ; R1 = 下一个任务的 TCB
+    STR R1, [R3] ; CurrentTCB = NextTCB
+    LDR R0, [R1] ; R0 = 下一个任务的 sp
+    LDMIA R0!, {R4-R11, LR} ; 恢复软件区，LR = 下一个任务自己的 EXC_RETURN
+
+    TST LR, #0x10 ; 下一个任务用过 FPU 才恢复 S16-S31
+    IT EQ
+    VLDMIAEQ R0!, {S16-S31}
+
+    MSR PSP, R0
+    ISB
+    MOV R0, #0
+    MSR BASEPRI, R0
+    BX LR
+    ENDP
+
+    ALIGN ; 保证文字池 (LDR Rx, =xxx) 4 字节对齐
+
+; 6. 文件结束 (必须有，且必须放在最后一行)
+    END
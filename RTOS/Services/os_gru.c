@@ -0,0 +1,128 @@
+/**
+ ******************************************************************************
+ * @file    os_gru.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   流式 GRU 推理实现
+ *
+ * 一个时间步（h 为隐藏状态，x 为输入帧）：
+ * - r = sigmoid(Wr [x, h])，然后 r = r * h
+ * - z = sigmoid(Wz [x, h])
+ * - c = tanh(Wh [r, x])，然后 c = z * c
+ * - h = c - (z - 1) * h，即 h = z * c + (1 - z) * h
+ *
+ ******************************************************************************
+ */
+
+#include "os_gru.h"
+#include <string.h>
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static void GruFc(const OS_Gru *p_gru, const q15_t *vec, const q7_t *wt, const q7_t *bias, q15_t *out)
+{
+    const OS_GruWeights *w = p_gru->Weights;
+    uint16_t dim = p_gru->InputSize + p_gru->HistorySize;
+
+    if (w->Reordered)
+        arm_fully_connected_mat_q7_vec_q15_opt(vec, wt, dim, p_gru->HistorySize, w->BiasShift, w->OutShift,
+                                               bias, out, NULL);
+    else
+        arm_fully_connected_mat_q7_vec_q15(vec, wt, dim, p_gru->HistorySize, w->BiasShift, w->OutShift,
+                                           bias, out, NULL);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void OS_GruInit(OS_Gru *p_gru, const OS_GruWeights *weights, uint16_t input_size, uint16_t history_size,
+                q15_t *scratch)
+{
+    p_gru->Weights = weights;
+    p_gru->InputSize = input_size;
+    p_gru->HistorySize = history_size;
+    p_gru->Scratch = scratch;
+    p_gru->Input = scratch + history_size;
+    p_gru->History = scratch + history_size + input_size;
+
+    p_gru->Steps = 0;
+    p_gru->Overruns = 0;
+    p_gru->LastCycles = 0;
+    p_gru->MaxCycles = 0;
+    p_gru->BudgetCycles = 0;
+    p_gru->OverBudget = 0;
+    OS_GruReset(p_gru);
+}
+
+void OS_GruReset(OS_Gru *p_gru)
+{
+    memset(p_gru->History, 0, p_gru->HistorySize * sizeof(q15_t));
+}
+
+const q15_t *OS_GruStep(OS_Gru *p_gru, const q15_t *frame)
+{
+    const OS_GruWeights *w = p_gru->Weights;
+    uint16_t hs = p_gru->HistorySize;
+    q15_t *reset = p_gru->Scratch;
+    q15_t *history = p_gru->History;
+    q15_t *update = history + hs;
+    q15_t *hidden = update + hs;
+    uint64_t start = OS_TimeNowCycles();
+    uint64_t elapsed;
+
+    if (frame != NULL)
+        memcpy(p_gru->Input, frame, p_gru->InputSize * sizeof(q15_t));
+
+    // 1. 重置门：[input, history] 在缓冲区里是连续的
+    GruFc(p_gru, p_gru->Input, w->Reset, w->ResetBias, reset);
+    arm_nn_activations_direct_q15(reset, hs, 0, ARM_SIGMOID);
+    arm_mult_q15(history, reset, reset, hs);
+
+    // 2. 更新门
+    GruFc(p_gru, p_gru->Input, w->Update, w->UpdateBias, update);
+    arm_nn_activations_direct_q15(update, hs, 0, ARM_SIGMOID);
+
+    // 3. 候选状态：[reset * history, input] 同样连续
+    GruFc(p_gru, reset, w->Hidden, w->HiddenBias, hidden);
+    arm_nn_activations_direct_q15(hidden, hs, 0, ARM_TANH);
+
+    // 4. 合成新的隐藏状态
+    arm_mult_q15(update, hidden, hidden, hs);
+    arm_offset_q15(update, (q15_t)0x8000, update, hs);
+    arm_mult_q15(history, update, update, hs);
+    arm_sub_q15(hidden, update, history, hs);
+
+    elapsed = OS_TimeNowCycles() - start;
+    p_gru->LastCycles = elapsed;
+    if (elapsed > p_gru->MaxCycles)
+        p_gru->MaxCycles = elapsed;
+    p_gru->Steps++;
+
+    return history;
+}
+
+void OS_GruRunPeriodic(OS_Gru *p_gru, uint32_t period, uint8_t (*fetch)(q15_t *input, void *arg),
+                       void (*emit)(const q15_t *hidden, void *arg), void *arg)
+{
+    uint64_t next = OS_TimeNowTicks();
+    uint32_t missed;
+
+    while (1)
+    {
+        // 1. 有新帧就算一步
+        if (fetch(p_gru->Input, arg))
+        {
+            OS_GruStep(p_gru, NULL);
+            if (p_gru->BudgetCycles != 0 && p_gru->LastCycles > p_gru->BudgetCycles)
+                p_gru->OverBudget++;
+            if (emit != NULL)
+                emit(p_gru->History, arg);
+        }
+
+        // 2. 等到下一个周期的起点，错过的起点计入 Overruns
+        missed = OS_DelayUntil(&next, period);
+        if (missed == OS_DELAY_UNTIL_ERROR)
+            return; // period 为 0，或者 fetch/emit 没有给调度器解锁
+        p_gru->Overruns += missed;
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    os_gru.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   流式 GRU 推理：每来一帧特征算一个时间步
+ *
+ * - 隐藏状态保存在运行器里，跨调用保持，不需要把整段序列攒齐再算
+ * - 每一步的计算量固定：三次 (InputSize + HistorySize) x HistorySize 的全连接
+ *   加几次长度为 HistorySize 的向量运算，没有和数据相关的分支，
+ *   所以单帧耗时有确定的上界，记录的 MaxCycles 就是它的实测值
+ * - OS_GruRunPeriodic 把取帧、计算、输出放进一个周期任务里，并统计超时；
+ *   设了 BudgetCycles 时还统计单帧耗时超出预算的帧数
+ * - 计算顺序和临时缓冲区布局与 CMSIS-NN 的 gru 例程相同，结果逐位一致
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_GRU_H
+#define __OS_GRU_H
+
+#include "os_core.h"
+#include "os_time.h"
+#include "arm_math.h"
+#include "arm_nnfunctions.h"
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+/**
+ * @brief  临时缓冲区的 q15 个数：reset | input | history | update | hidden
+ */
+#define OS_GRU_SCRATCH_SIZE(input_size, history_size) (4u * (history_size) + (input_size))
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  GRU 权重
+ * @note   更新门、重置门的输入向量为 [input, history]，
+ *         候选状态的输入向量为 [reset * history, input]（与 gru 例程相同）
+ */
+typedef struct
+{
+    const q7_t *Update;        ///< 更新门权重，HistorySize 行 x (InputSize + HistorySize) 列
+    const q7_t *Reset;         ///< 重置门权重
+    const q7_t *Hidden;        ///< 候选状态权重
+    const q7_t *UpdateBias;    ///< 更新门偏置，HistorySize 个
+    const q7_t *ResetBias;     ///< 重置门偏置
+    const q7_t *HiddenBias;    ///< 候选状态偏置
+    uint16_t BiasShift;        ///< 偏置左移（例程为 0）
+    uint16_t OutShift;         ///< 输出右移（例程为 15）
+    uint8_t Reordered;         ///< 1：权重按 _opt 版本重排，用 arm_fully_connected_mat_q7_vec_q15_opt
+} OS_GruWeights;
+
+/**
+ * @brief  流式 GRU 运行器
+ */
+typedef struct
+{
+    const OS_GruWeights *Weights; ///< 权重
+    uint16_t InputSize;        ///< 每帧特征数
+    uint16_t HistorySize;      ///< 隐藏状态长度
+    q15_t *Scratch;            ///< 临时缓冲区，OS_GRU_SCRATCH_SIZE 个 q15
+    q15_t *Input;              ///< 输入帧在缓冲区里的位置，可以直接往这里写
+    q15_t *History;            ///< 隐藏状态在缓冲区里的位置
+
+    uint32_t Steps;            ///< 已处理的帧数
+    uint32_t Overruns;         ///< 周期任务里错过的周期数
+    uint64_t LastCycles;       ///< 最近一帧的耗时（节拍定时器计数）
+    uint64_t MaxCycles;        ///< 单帧最长耗时
+    uint64_t BudgetCycles;     ///< 单帧耗时预算（节拍定时器计数），0 表示不检查；初始化后再设
+    uint32_t OverBudget;       ///< 周期任务里耗时超出 BudgetCycles 的帧数
+} OS_Gru;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化运行器，隐藏状态清零
+ */
+void OS_GruInit(OS_Gru *p_gru, const OS_GruWeights *weights, uint16_t input_size, uint16_t history_size,
+                q15_t *scratch);
+
+/**
+ * @brief  隐藏状态清零（一段新的语音开始时调用）
+ */
+void OS_GruReset(OS_Gru *p_gru);
+
+/**
+ * @brief  处理一帧
+ * @param  frame: InputSize 个特征；NULL 表示已经写在 p_gru->Input 里
+ * @return const q15_t *: 更新后的隐藏状态（HistorySize 个）
+ */
+const q15_t *OS_GruStep(OS_Gru *p_gru, const q15_t *frame);
+
+/**
+ * @brief  周期任务主循环，正常情况下不返回
+ * @param  period: 周期（节拍数）
+ * @param  fetch : 把一帧写进 input，返回 1；这个周期没有新帧时返回 0
+ * @param  emit  : 每算完一帧调用一次，可以为 NULL
+ * @note   用 OS_DelayUntil 等待：一帧算完时已经错过的周期起点计入 Overruns，并从当前节拍重新对齐；
+ *         BudgetCycles 不为 0 时，单帧耗时 LastCycles 超出它计入 OverBudget。
+ *         OS_DelayUntil 报错（period 为 0，或者 fetch/emit 返回时调度器还锁着）时返回
+ */
+void OS_GruRunPeriodic(OS_Gru *p_gru, uint32_t period, uint8_t (*fetch)(q15_t *input, void *arg),
+                       void (*emit)(const q15_t *hidden, void *arg), void *arg);
+
+#endif /* __OS_GRU_H */
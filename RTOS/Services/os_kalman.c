@@ -0,0 +1,344 @@
+/**
+ ******************************************************************************
+ * @file    os_kalman.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   卡尔曼滤波服务实现
+ *
+ * 预测：x = F x，P = F P F' + Q
+ * 更新：y = z - H x，S = H P H' + R，K = P H' S^-1，
+ *       x = x + K y，P = P - K H P
+ * P 对称，所以 P H' 直接由 H P 转置得到，少做一次 n x n x m 的乘法
+ *
+ ******************************************************************************
+ */
+
+#include "os_kalman.h"
+#include <string.h>
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+/**
+ * @brief  c = a * b，a 为 rows x inner，b 为 inner x cols
+ */
+static void MatMultF32(float32_t *a, float32_t *b, float32_t *c, uint16_t rows, uint16_t inner, uint16_t cols)
+{
+    arm_matrix_instance_f32 ma, mb, mc;
+
+    arm_mat_init_f32(&ma, rows, inner, a);
+    arm_mat_init_f32(&mb, inner, cols, b);
+    arm_mat_init_f32(&mc, rows, cols, c);
+    arm_mat_mult_f32(&ma, &mb, &mc);
+}
+
+/**
+ * @brief  c = a * b；fast 为 1 时用 arm_mat_mult_fast_q31（不饱和，截断到 2.30 累加）
+ */
+static void MatMultQ31(q31_t *a, q31_t *b, q31_t *c, uint16_t rows, uint16_t inner, uint16_t cols, uint8_t fast)
+{
+    arm_matrix_instance_q31 ma, mb, mc;
+
+    arm_mat_init_q31(&ma, rows, inner, a);
+    arm_mat_init_q31(&mb, inner, cols, b);
+    arm_mat_init_q31(&mc, rows, cols, c);
+    if (fast)
+        arm_mat_mult_fast_q31(&ma, &mb, &mc);
+    else
+        arm_mat_mult_q31(&ma, &mb, &mc);
+}
+
+/**
+ * @brief  dst = src'，src 为 rows x cols
+ */
+static void MatTrans(const OS_Kalman *p_kf, void *src, void *dst, uint16_t rows, uint16_t cols)
+{
+    if (p_kf->Format == OS_KALMAN_F32)
+    {
+        arm_matrix_instance_f32 ms, md;
+
+        arm_mat_init_f32(&ms, rows, cols, (float32_t *)src);
+        arm_mat_init_f32(&md, cols, rows, (float32_t *)dst);
+        arm_mat_trans_f32(&ms, &md);
+    }
+    else
+    {
+        arm_matrix_instance_q31 ms, md;
+
+        arm_mat_init_q31(&ms, rows, cols, (q31_t *)src);
+        arm_mat_init_q31(&md, cols, rows, (q31_t *)dst);
+        arm_mat_trans_q31(&ms, &md);
+    }
+}
+
+/**
+ * @brief  求 SInv = S^-1，S 为 float32（arm_mat_inverse_f32 会改写 S）
+ */
+static uint8_t MatInverse(OS_Kalman *p_kf, float32_t *s)
+{
+    arm_matrix_instance_f32 ms, md;
+    uint16_t m = p_kf->Measures;
+
+    arm_mat_init_f32(&ms, m, m, s);
+    arm_mat_init_f32(&md, m, m, p_kf->SInv);
+    return arm_mat_inverse_f32(&ms, &md) == ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief  P = (P + P') / 2，抵消 P - K H P 的舍入误差造成的不对称
+ */
+static void KalmanSymmetrize(OS_Kalman *p_kf)
+{
+    uint16_t n = p_kf->States;
+    uint16_t i, j;
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = i + 1u; j < n; j++)
+        {
+            if (p_kf->Format == OS_KALMAN_F32)
+            {
+                float32_t *P = (float32_t *)p_kf->P;
+                float32_t v = 0.5f * (P[i * n + j] + P[j * n + i]);
+
+                P[i * n + j] = v;
+                P[j * n + i] = v;
+            }
+            else
+            {
+                q31_t *P = (q31_t *)p_kf->P;
+                q31_t v = (q31_t)(((q63_t)P[i * n + j] + P[j * n + i]) >> 1);
+
+                P[i * n + j] = v;
+                P[j * n + i] = v;
+            }
+        }
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_KalmanInit(OS_Kalman *p_kf, uint8_t format, uint8_t states, uint8_t measures,
+                      const OS_KalmanModel *model, void *arena, uint32_t arena_size)
+{
+    uint32_t *w = (uint32_t *)arena; // float32_t 和 q31_t 都是 4 字节
+    uint32_t n = states;
+    uint32_t m = measures;
+
+    // 1. 参数检查
+    if (states == 0 || measures == 0)
+        return 0;
+    if (format == OS_KALMAN_F32)
+    {
+        if (arena_size < OS_KALMAN_ARENA_SIZE_F32(n, m))
+            return 0;
+    }
+    else if (format == OS_KALMAN_Q31)
+    {
+        if (arena_size < OS_KALMAN_ARENA_SIZE_Q31(n, m) || model->GainShift > 31u)
+            return 0;
+    }
+    else
+    {
+        return 0;
+    }
+
+    p_kf->Model = model;
+    p_kf->Format = format;
+    p_kf->States = states;
+    p_kf->Measures = measures;
+
+    // 2. 切分工作区，布局见 OS_KALMAN_ARENA_SIZE_F32/_Q31
+    p_kf->X = w;    w += n;
+    p_kf->P = w;    w += n * n;
+    p_kf->Z = w;    w += m;
+    p_kf->Ft = w;   w += n * n;
+    p_kf->Tmp = w;  w += n * n;
+    p_kf->HX = w;   w += m;
+    p_kf->HP = w;   w += m * n;
+    p_kf->Ht = w;   w += n * m;
+    p_kf->KY = w;   w += n;
+    p_kf->S = w;    w += m * m;
+    p_kf->PHt = w;  w += n * m;
+    p_kf->K = w;    w += n * m;
+    p_kf->SInv = (float32_t *)w;
+    w += m * m;
+
+    if (format == OS_KALMAN_F32)
+    {
+        // float32 版本直接在 S、PH'、K 上算
+        p_kf->SF = (float32_t *)p_kf->S;
+        p_kf->PHtF = (float32_t *)p_kf->PHt;
+        p_kf->KF = (float32_t *)p_kf->K;
+    }
+    else
+    {
+        p_kf->SF = (float32_t *)w;   w += m * m;
+        p_kf->PHtF = (float32_t *)w; w += n * m;
+        p_kf->KF = (float32_t *)w;
+    }
+
+    memset(p_kf->X, 0, n * 4u);
+    memset(p_kf->P, 0, n * n * 4u);
+
+    p_kf->Steps = 0;
+    p_kf->Updates = 0;
+    p_kf->Singular = 0;
+    p_kf->Overruns = 0;
+    p_kf->LastCycles = 0;
+    p_kf->MaxCycles = 0;
+
+    return 1;
+}
+
+void OS_KalmanSetState(OS_Kalman *p_kf, const void *x, const void *P)
+{
+    uint32_t n = p_kf->States;
+
+    memcpy(p_kf->X, x, n * 4u);
+    memcpy(p_kf->P, P, n * n * 4u);
+}
+
+void OS_KalmanPredict(OS_Kalman *p_kf)
+{
+    const OS_KalmanModel *mdl = p_kf->Model;
+    uint16_t n = p_kf->States;
+
+    // 1. 状态外推（EKF 的回调在这里顺便刷新雅可比 F）
+    if (mdl->Propagate != NULL)
+    {
+        mdl->Propagate(p_kf->X, mdl->Arg);
+    }
+    else
+    {
+        if (p_kf->Format == OS_KALMAN_F32)
+            MatMultF32((float32_t *)mdl->F, (float32_t *)p_kf->X, (float32_t *)p_kf->KY, n, n, 1);
+        else
+            MatMultQ31((q31_t *)mdl->F, (q31_t *)p_kf->X, (q31_t *)p_kf->KY, n, n, 1, 1);
+        memcpy(p_kf->X, p_kf->KY, n * 4u);
+    }
+
+    // 2. P = F P F' + Q
+    MatTrans(p_kf, mdl->F, p_kf->Ft, n, n);
+    if (p_kf->Format == OS_KALMAN_F32)
+    {
+        MatMultF32((float32_t *)mdl->F, (float32_t *)p_kf->P, (float32_t *)p_kf->Tmp, n, n, n);
+        MatMultF32((float32_t *)p_kf->Tmp, (float32_t *)p_kf->Ft, (float32_t *)p_kf->P, n, n, n);
+        arm_add_f32((float32_t *)p_kf->P, (float32_t *)mdl->Q, (float32_t *)p_kf->P, n * n);
+    }
+    else
+    {
+        MatMultQ31((q31_t *)mdl->F, (q31_t *)p_kf->P, (q31_t *)p_kf->Tmp, n, n, n, 1);
+        MatMultQ31((q31_t *)p_kf->Tmp, (q31_t *)p_kf->Ft, (q31_t *)p_kf->P, n, n, n, 1);
+        arm_add_q31((q31_t *)p_kf->P, (q31_t *)mdl->Q, (q31_t *)p_kf->P, n * n);
+    }
+
+    p_kf->Steps++;
+}
+
+uint8_t OS_KalmanUpdate(OS_Kalman *p_kf, const void *z)
+{
+    const OS_KalmanModel *mdl = p_kf->Model;
+    uint16_t n = p_kf->States;
+    uint16_t m = p_kf->Measures;
+    uint8_t f32 = (p_kf->Format == OS_KALMAN_F32);
+
+    if (z != NULL)
+        memcpy(p_kf->Z, z, m * 4u);
+
+    // 1. 新息 y = z - h(x)（EKF 的回调在这里顺便刷新雅可比 H）
+    if (mdl->Observe != NULL)
+        mdl->Observe(p_kf->X, p_kf->HX, mdl->Arg);
+    else if (f32)
+        MatMultF32((float32_t *)mdl->H, (float32_t *)p_kf->X, (float32_t *)p_kf->HX, m, n, 1);
+    else
+        MatMultQ31((q31_t *)mdl->H, (q31_t *)p_kf->X, (q31_t *)p_kf->HX, m, n, 1, 1);
+
+    // 2. S = H P H' + R，P H' = (H P)'
+    MatTrans(p_kf, mdl->H, p_kf->Ht, m, n);
+    if (f32)
+    {
+        arm_sub_f32((float32_t *)p_kf->Z, (float32_t *)p_kf->HX, (float32_t *)p_kf->Z, m);
+        MatMultF32((float32_t *)mdl->H, (float32_t *)p_kf->P, (float32_t *)p_kf->HP, m, n, n);
+        MatMultF32((float32_t *)p_kf->HP, (float32_t *)p_kf->Ht, (float32_t *)p_kf->S, m, n, m);
+        arm_add_f32((float32_t *)p_kf->S, (float32_t *)mdl->R, (float32_t *)p_kf->S, m * m);
+    }
+    else
+    {
+        arm_sub_q31((q31_t *)p_kf->Z, (q31_t *)p_kf->HX, (q31_t *)p_kf->Z, m);
+        MatMultQ31((q31_t *)mdl->H, (q31_t *)p_kf->P, (q31_t *)p_kf->HP, m, n, n, 1);
+        MatMultQ31((q31_t *)p_kf->HP, (q31_t *)p_kf->Ht, (q31_t *)p_kf->S, m, n, m, 1);
+        arm_add_q31((q31_t *)p_kf->S, (q31_t *)mdl->R, (q31_t *)p_kf->S, m * m);
+        arm_q31_to_float((q31_t *)p_kf->S, p_kf->SF, m * m);
+    }
+    MatTrans(p_kf, p_kf->HP, p_kf->PHt, m, n);
+
+    // 3. K = P H' S^-1：m x m 的求逆和 n x m x m 的乘法在 float32 里做，
+    //    S 和 P H' 的缩放相同，转成 float32 不影响 K
+    if (!MatInverse(p_kf, p_kf->SF))
+    {
+        p_kf->Singular++;
+        return 0;
+    }
+    if (!f32)
+        arm_q31_to_float((q31_t *)p_kf->PHt, p_kf->PHtF, n * m);
+    MatMultF32(p_kf->PHtF, p_kf->SInv, p_kf->KF, n, m, m);
+
+    // 4. x = x + K y，P = P - K H P
+    if (f32)
+    {
+        MatMultF32((float32_t *)p_kf->K, (float32_t *)p_kf->Z, (float32_t *)p_kf->KY, n, m, 1);
+        arm_add_f32((float32_t *)p_kf->X, (float32_t *)p_kf->KY, (float32_t *)p_kf->X, n);
+        MatMultF32((float32_t *)p_kf->K, (float32_t *)p_kf->HP, (float32_t *)p_kf->Tmp, n, m, n);
+        arm_sub_f32((float32_t *)p_kf->P, (float32_t *)p_kf->Tmp, (float32_t *)p_kf->P, n * n);
+    }
+    else
+    {
+        // K 可能超出 [-1, 1)，按 K / 2^GainShift 存，乘完再带饱和左移回来
+        arm_scale_f32(p_kf->KF, 1.0f / (float32_t)(1ul << mdl->GainShift), p_kf->KF, n * m);
+        arm_float_to_q31(p_kf->KF, (q31_t *)p_kf->K, n * m);
+
+        MatMultQ31((q31_t *)p_kf->K, (q31_t *)p_kf->Z, (q31_t *)p_kf->KY, n, m, 1, 0);
+        arm_shift_q31((q31_t *)p_kf->KY, mdl->GainShift, (q31_t *)p_kf->KY, n);
+        arm_add_q31((q31_t *)p_kf->X, (q31_t *)p_kf->KY, (q31_t *)p_kf->X, n);
+        MatMultQ31((q31_t *)p_kf->K, (q31_t *)p_kf->HP, (q31_t *)p_kf->Tmp, n, m, n, 0);
+        arm_shift_q31((q31_t *)p_kf->Tmp, mdl->GainShift, (q31_t *)p_kf->Tmp, n * n);
+        arm_sub_q31((q31_t *)p_kf->P, (q31_t *)p_kf->Tmp, (q31_t *)p_kf->P, n * n);
+    }
+    KalmanSymmetrize(p_kf);
+
+    p_kf->Updates++;
+    return 1;
+}
+
+void OS_KalmanRunPeriodic(OS_Kalman *p_kf, uint32_t period, uint8_t (*fetch)(void *z, void *arg),
+                          void (*emit)(const void *x, void *arg), void *arg)
+{
+    uint64_t next = OS_TimeNowTicks();
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t missed;
+
+    while (1)
+    {
+        // 1. 每个周期预测一次，有新量测就更新
+        start = OS_TimeNowCycles();
+        OS_KalmanPredict(p_kf);
+        if (fetch(p_kf->Z, arg))
+            OS_KalmanUpdate(p_kf, NULL);
+
+        elapsed = OS_TimeNowCycles() - start;
+        p_kf->LastCycles = elapsed;
+        if (elapsed > p_kf->MaxCycles)
+            p_kf->MaxCycles = elapsed;
+
+        if (emit != NULL)
+            emit(p_kf->X, arg);
+
+        // 2. 等到下一个周期的起点，错过的起点计入 Overruns
+        missed = OS_DelayUntil(&next, period);
+        if (missed == OS_DELAY_UNTIL_ERROR)
+            return; // period 为 0，或者 fetch/emit 没有给调度器解锁
+        p_kf->Overruns += missed;
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file    os_kalman.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   卡尔曼滤波服务 (arm_mat_*，q31 / float32 两种格式)
+ *
+ * - 全部中间矩阵在初始化时从一块工作区里切出来，预测/更新时不占任务栈，
+ *   滤波任务的栈只需要容纳几层函数调用
+ * - q31 版本：预测的 F P F'、H P 等乘法用 arm_mat_mult_fast_q31，
+ *   增益和协方差修正用带饱和的 arm_mat_mult_q31；
+ *   只有 m x m 的新息协方差求逆和增益在 float32 里算（CMSIS 没有定点求逆）
+ * - 线性模型直接用 F、H；EKF 注册 Propagate/Observe 回调，
+ *   在回调里算非线性的 f(x)、h(x) 并刷新雅可比 F、H
+ * - OS_KalmanRunPeriodic 按固定周期预测，有量测时更新
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_KALMAN_H
+#define __OS_KALMAN_H
+
+#include "os_core.h"
+#include "os_time.h"
+#include "arm_math.h"
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+#define OS_KALMAN_F32 0u   ///< 矩阵、状态都是 float32_t
+#define OS_KALMAN_Q31 1u   ///< 矩阵、状态都是 q31_t（数值须预先缩放到 [-1, 1)）
+
+/**
+ * @brief  工作区大小（单位：字节），n 为状态数，m 为量测数
+ * @note   x | P | F' | 临时 n x n | z | Hx | HP | H' | Ky | S | PH' | K | S^-1
+ *         q31 另需 S、PH'、K 的 float32 副本
+ */
+#define OS_KALMAN_ARENA_SIZE_F32(n, m) \
+    (4u * (2u * (n) + 3u * (n) * (n) + 2u * (m) + 4u * (n) * (m) + 2u * (m) * (m)))
+#define OS_KALMAN_ARENA_SIZE_Q31(n, m) \
+    (4u * (2u * (n) + 3u * (n) * (n) + 2u * (m) + 6u * (n) * (m) + 3u * (m) * (m)))
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  系统模型，矩阵按行存储，格式与滤波器一致
+ */
+typedef struct
+{
+    void *F;                   ///< 状态转移，n x n（EKF 时为 f 的雅可比）
+    void *H;                   ///< 量测矩阵，m x n（EKF 时为 h 的雅可比）
+    void *Q;                   ///< 过程噪声协方差，n x n
+    void *R;                   ///< 量测噪声协方差，m x m
+    void (*Propagate)(void *x, void *arg);              ///< x = f(x)，原地更新；NULL 表示 x = F x
+    void (*Observe)(const void *x, void *hx, void *arg); ///< hx = h(x)；NULL 表示 hx = H x
+    void *Arg;                 ///< 回调参数
+    uint8_t GainShift;         ///< q31：增益按 K / 2^GainShift 存储，K 的元素最大到 2^GainShift
+} OS_KalmanModel;
+
+/**
+ * @brief  卡尔曼滤波器
+ */
+typedef struct
+{
+    const OS_KalmanModel *Model; ///< 系统模型
+    uint8_t Format;            ///< OS_KALMAN_F32 / OS_KALMAN_Q31
+    uint8_t States;            ///< 状态数 n
+    uint8_t Measures;          ///< 量测数 m
+
+    void *X;                   ///< 状态估计，n 个
+    void *P;                   ///< 估计协方差，n x n
+    void *Z;                   ///< 量测，m 个；更新时原地变成新息
+    void *Ft;                  ///< F 的转置
+    void *Tmp;                 ///< n x n 临时：F P，K H P
+    void *HX;                  ///< 预测量测 Hx，m 个
+    void *HP;                  ///< H P，m x n
+    void *Ht;                  ///< H 的转置，n x m
+    void *KY;                  ///< 临时 n 个：F x，K y
+    void *S;                   ///< 新息协方差 H P H' + R，m x m
+    void *PHt;                 ///< P H'，n x m
+    void *K;                   ///< 卡尔曼增益，n x m
+    float32_t *SInv;           ///< S 的逆，m x m
+    float32_t *SF;             ///< q31：S 的 float32 副本（求逆时被改写）
+    float32_t *PHtF;           ///< q31：P H' 的 float32 副本
+    float32_t *KF;             ///< q31：K 的 float32 副本
+
+    uint32_t Steps;            ///< 预测次数
+    uint32_t Updates;          ///< 更新次数
+    uint32_t Singular;         ///< S 不可逆而跳过的更新次数
+    uint32_t Overruns;         ///< 周期任务里错过的周期数
+    uint64_t LastCycles;       ///< 最近一个周期的耗时（节拍定时器计数）
+    uint64_t MaxCycles;        ///< 单个周期最长耗时
+} OS_Kalman;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化滤波器，状态和协方差清零
+ * @param  format: OS_KALMAN_F32 / OS_KALMAN_Q31
+ * @param  states: 状态数 n
+ * @param  measures: 量测数 m
+ * @param  arena: 工作区，4 字节对齐
+ * @param  arena_size: 工作区大小，不小于 OS_KALMAN_ARENA_SIZE_F32/_Q31(n, m)
+ * @return uint8_t: 1 代表成功；参数不合法或工作区不够时返回 0
+ */
+uint8_t OS_KalmanInit(OS_Kalman *p_kf, uint8_t format, uint8_t states, uint8_t measures,
+                      const OS_KalmanModel *model, void *arena, uint32_t arena_size);
+
+/**
+ * @brief  设置初始状态和协方差
+ * @param  x: n 个
+ * @param  P: n x n
+ */
+void OS_KalmanSetState(OS_Kalman *p_kf, const void *x, const void *P);
+
+/**
+ * @brief  预测：x = F x（或 f(x)），P = F P F' + Q
+ */
+void OS_KalmanPredict(OS_Kalman *p_kf);
+
+/**
+ * @brief  量测更新
+ * @param  z: m 个量测；NULL 表示已经写在 p_kf->Z 里
+ * @return uint8_t: 1 代表已更新；S 不可逆时返回 0，状态不变并计入 Singular
+ */
+uint8_t OS_KalmanUpdate(OS_Kalman *p_kf, const void *z);
+
+/**
+ * @brief  周期任务主循环，正常情况下不返回
+ * @param  period: 周期（节拍数），每个周期预测一次
+ * @param  fetch : 有新量测时写进 z 并返回 1，然后做一次更新；没有时返回 0
+ * @param  emit  : 每个周期结束调用一次，可以为 NULL
+ * @note   用 OS_DelayUntil 等待：一个周期算完时已经错过的周期起点计入 Overruns，并从当前节拍重新对齐
+ *         OS_DelayUntil 报错（period 为 0，或者 fetch/emit 返回时调度器还锁着）时返回
+ */
+void OS_KalmanRunPeriodic(OS_Kalman *p_kf, uint32_t period, uint8_t (*fetch)(void *z, void *arg),
+                          void (*emit)(const void *x, void *arg), void *arg);
+
+#endif /* __OS_KALMAN_H */
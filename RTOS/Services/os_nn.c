@@ -0,0 +1,833 @@
+/**
+ ******************************************************************************
+ * @file    os_nn.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   可抢占的 CMSIS-NN 推理运行器实现
+ *
+ * 卷积按输出行分块 [r0, r1)：
+ * - 需要的输入从第 r0 * stride - pad 行开始。basic_nonsquare 逐点检查边界，
+ *   把输入指针移到这一行（为负时改用部分上填充），padding_y 取剩下的上填充即可
+ * - fast_nonsquare 只在上下各 padding_y 行里检查边界，中间行直接读内存，
+ *   而且上下填充必须相同。所以有填充时这样安排：
+ *   1. 先算底部 2 * pad 行（对称填充调用）：后 pad 行正确，
+ *      前 pad 行把上方的真实数据当成了 0，是错的
+ *   2. 再从第 0 行开始往下算（第一块带上填充，其余块不带填充），
+ *      一直到 OutDim - pad 行，正好把第 1 步里算错的行覆盖掉
+ *   多算 pad 行，换来中间行都走不检查边界的快速路径
+ *
+ ******************************************************************************
+ */
+
+#include "os_nn.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint16_t NnMin(uint16_t a, uint16_t b)
+{
+    return (a < b) ? a : b;
+}
+
+static q15_t *NnScratch(const OS_NnRunner *p_run, const OS_NnLayer *p_l)
+{
+    return (p_l->Scratch != NULL) ? p_l->Scratch : p_run->ColBuffer;
+}
+
+// 卷积输出第 r 行在 Out 里的位置
+static q7_t *NnRowPtr(const OS_NnLayer *p_l, uint16_t r)
+{
+    return p_l->Out + (uint32_t)r * p_l->OutDim * p_l->OutCh;
+}
+
+static uint8_t NnIsFast(const OS_NnLayer *p_l)
+{
+    return p_l->Type == OS_NN_CONV_FAST || p_l->Type == OS_NN_CONV_FAST_RELU_POOL;
+}
+
+// 两列 im2col 的字节数（q15）
+static uint32_t NnColBytes(const OS_NnLayer *p_l)
+{
+    return 2u * 2u * p_l->InCh * p_l->KerDim * p_l->KerDim;
+}
+
+// 融合层行带缓冲区的行数：一组池化行的窗口，fast 带填充时至少 pad 行
+static uint16_t NnBandRows(const OS_NnLayer *p_l)
+{
+    uint16_t g = (p_l->TileRows != 0) ? NnMin(p_l->TileRows, p_l->PoolDim) : 1;
+    uint16_t rows = (g - 1) * p_l->PoolStride + p_l->PoolKer;
+
+    if (NnIsFast(p_l) && rows < p_l->Padding)
+        rows = p_l->Padding;
+    return NnMin(rows, p_l->OutDim);
+}
+
+// 计算 rows 行卷积输出写到 out，输入从第 in_base 行开始，上填充 pad_y
+static arm_status NnConvRows(const OS_NnLayer *p_l, q15_t *col, q7_t *out, uint16_t rows,
+                             uint16_t in_base, uint16_t pad_y)
+{
+    const q7_t *in = p_l->In + (uint32_t)in_base * p_l->InDim * p_l->InCh;
+    uint16_t in_rows = p_l->InDim - in_base;
+
+    if (NnIsFast(p_l))
+    {
+        return arm_convolve_HWC_q7_fast_nonsquare(in, p_l->InDim, in_rows, p_l->InCh, p_l->Weights, p_l->OutCh,
+                                                  p_l->KerDim, p_l->KerDim, p_l->Padding, pad_y,
+                                                  p_l->Stride, p_l->Stride, p_l->Bias, p_l->BiasShift,
+                                                  p_l->OutShift, out, p_l->OutDim, rows, col, NULL);
+    }
+    return arm_convolve_HWC_q7_basic_nonsquare(in, p_l->InDim, in_rows, p_l->InCh, p_l->Weights, p_l->OutCh,
+                                               p_l->KerDim, p_l->KerDim, p_l->Padding, pad_y,
+                                               p_l->Stride, p_l->Stride, p_l->Bias, p_l->BiasShift,
+                                               p_l->OutShift, out, p_l->OutDim, rows, col, NULL);
+}
+
+// 整层一次算完
+static arm_status NnConvFull(const OS_NnLayer *p_l, q15_t *col)
+{
+    switch (p_l->Type)
+    {
+    case OS_NN_CONV_RGB:
+        return arm_convolve_HWC_q7_RGB(p_l->In, p_l->InDim, p_l->InCh, p_l->Weights, p_l->OutCh, p_l->KerDim,
+                                       p_l->Padding, p_l->Stride, p_l->Bias, p_l->BiasShift, p_l->OutShift,
+                                       p_l->Out, p_l->OutDim, col, NULL);
+    case OS_NN_CONV_FAST:
+        return arm_convolve_HWC_q7_fast(p_l->In, p_l->InDim, p_l->InCh, p_l->Weights, p_l->OutCh, p_l->KerDim,
+                                        p_l->Padding, p_l->Stride, p_l->Bias, p_l->BiasShift, p_l->OutShift,
+                                        p_l->Out, p_l->OutDim, col, NULL);
+    default:
+        return arm_convolve_HWC_q7_basic(p_l->In, p_l->InDim, p_l->InCh, p_l->Weights, p_l->OutCh, p_l->KerDim,
+                                         p_l->Padding, p_l->Stride, p_l->Bias, p_l->BiasShift, p_l->OutShift,
+                                         p_l->Out, p_l->OutDim, col, NULL);
+    }
+}
+
+// 卷积层的一步，返回 1 表示本层已算完
+static uint8_t NnConvStep(OS_NnRunner *p_run, const OS_NnLayer *p_l, arm_status *p_status)
+{
+    uint16_t out = p_l->OutDim;
+    uint16_t pad = p_l->Padding;
+    uint16_t stride = p_l->Stride;
+    uint16_t r0 = p_run->Row;
+    uint16_t r1;
+    int32_t top;
+    q15_t *col = NnScratch(p_run, p_l);
+
+    if (p_l->TileRows == 0 || p_l->TileRows >= out ||
+        (p_l->Type == OS_NN_CONV_FAST && out < 2 * pad))
+    {
+        *p_status = NnConvFull(p_l, NnScratch(p_run, p_l));
+        return 1;
+    }
+
+    // 1. basic：每块独立，输入指针移到所需的第一行
+    if (p_l->Type != OS_NN_CONV_FAST)
+    {
+        r1 = NnMin(r0 + p_l->TileRows, out);
+        top = (int32_t)r0 * stride - pad;
+        if (top < 0)
+            *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, r0), r1 - r0, 0, (uint16_t)(-top));
+        else
+            *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, r0), r1 - r0, (uint16_t)top, 0);
+        p_run->Row = r1;
+        return r1 >= out;
+    }
+
+    // 2. fast 无填充：每块都在图像内部
+    if (pad == 0)
+    {
+        r1 = NnMin(r0 + p_l->TileRows, out);
+        *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, r0), r1 - r0, r0 * stride, 0);
+        p_run->Row = r1;
+        return r1 >= out;
+    }
+
+    // 3. fast 有填充：先算底部（前 pad 行是错的，稍后被覆盖）
+    if (!p_run->TailDone)
+    {
+        *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, out - 2 * pad), 2 * pad, (out - 2 * pad) * stride, pad);
+        p_run->TailDone = 1;
+        return 0;
+    }
+
+    // 4. 第一块带上填充，至少 pad 行
+    if (r0 == 0)
+    {
+        r1 = NnMin(p_l->TileRows < pad ? pad : p_l->TileRows, out - pad);
+        *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, 0), r1, 0, pad);
+    }
+    // 5. 中间块不需要任何填充
+    else
+    {
+        r1 = NnMin(r0 + p_l->TileRows, out - pad);
+        *p_status = NnConvRows(p_l, col, NnRowPtr(p_l, r0), r1 - r0, r0 * stride - pad, 0);
+    }
+    p_run->Row = r1;
+    return r1 >= out - pad;
+}
+
+// 全连接层的一步：按输出行分块，权重和偏置跟着偏移
+static uint8_t NnFcStep(OS_NnRunner *p_run, const OS_NnLayer *p_l, arm_status *p_status)
+{
+    uint16_t tile = p_l->TileRows;
+    uint16_t r0 = p_run->Row;
+    uint16_t r1;
+
+    if (tile == 0 || tile >= p_l->OutCh)
+        tile = p_l->OutCh;
+    else if (p_l->Type == OS_NN_FC_OPT)
+        tile = (tile + 3u) & ~3u; // 重排后的权重 4 行一组，块边界必须对齐到组
+
+    r1 = NnMin(r0 + tile, p_l->OutCh);
+    if (p_l->Type == OS_NN_FC_OPT)
+        *p_status = arm_fully_connected_q7_opt(p_l->In, p_l->Weights + (uint32_t)r0 * p_l->InDim, p_l->InDim,
+                                               r1 - r0, p_l->BiasShift, p_l->OutShift, p_l->Bias + r0,
+                                               p_l->Out + r0, NnScratch(p_run, p_l));
+    else
+        *p_status = arm_fully_connected_q7(p_l->In, p_l->Weights + (uint32_t)r0 * p_l->InDim, p_l->InDim,
+                                           r1 - r0, p_l->BiasShift, p_l->OutShift, p_l->Bias + r0,
+                                           p_l->Out + r0, NnScratch(p_run, p_l));
+    p_run->Row = r1;
+    return r1 >= p_l->OutCh;
+}
+
+// ReLU 的一步：按输入行分块
+static uint8_t NnReluStep(OS_NnRunner *p_run, const OS_NnLayer *p_l)
+{
+    uint32_t row_size = (uint32_t)p_l->InDim * p_l->InCh;
+    uint16_t tile = (p_l->TileRows == 0) ? p_l->InDim : p_l->TileRows;
+    uint16_t r1 = NnMin(p_run->Row + tile, p_l->InDim);
+    uint32_t left = (uint32_t)(r1 - p_run->Row) * row_size;
+    q7_t *p = p_l->In + p_run->Row * row_size;
+    uint16_t n;
+
+    while (left > 0) // arm_relu_q7 的长度是 16 位
+    {
+        n = (left > 0x8000u) ? 0x8000u : (uint16_t)left;
+        arm_relu_q7(p, n);
+        p += n;
+        left -= n;
+    }
+    p_run->Row = r1;
+    return r1 >= p_l->InDim;
+}
+
+// 融合层：卷积第 r 行在行带缓冲区里，或者在底部那一块里
+static const q7_t *NnFusedRow(const OS_NnRunner *p_run, const OS_NnLayer *p_l, const q7_t *band,
+                              const q7_t *tail, uint16_t limit, uint16_t r)
+{
+    uint32_t row_size = (uint32_t)p_l->OutDim * p_l->OutCh;
+
+    if (r < limit)
+        return band + (r - p_run->BandStart) * row_size;
+    return tail + (r - (p_l->OutDim - 2 * p_l->Padding)) * row_size;
+}
+
+// 融合层：把卷积行 [BandEnd, end) 补进行带缓冲区
+static arm_status NnFusedFill(OS_NnRunner *p_run, const OS_NnLayer *p_l, q15_t *col, q7_t *band, uint16_t end)
+{
+    uint16_t pad = p_l->Padding;
+    uint16_t stride = p_l->Stride;
+    uint16_t c = p_run->BandEnd;
+    q7_t *dst = band + (uint32_t)(c - p_run->BandStart) * p_l->OutDim * p_l->OutCh;
+    arm_status status;
+    int32_t top;
+
+    if (c >= end)
+        return ARM_MATH_SUCCESS;
+
+    if (!NnIsFast(p_l))
+    {
+        top = (int32_t)c * stride - pad;
+        if (top < 0)
+            status = NnConvRows(p_l, col, dst, end - c, 0, (uint16_t)(-top));
+        else
+            status = NnConvRows(p_l, col, dst, end - c, (uint16_t)top, 0);
+    }
+    else if (pad == 0)
+    {
+        status = NnConvRows(p_l, col, dst, end - c, c * stride, 0);
+    }
+    else if (c == 0)
+    {
+        // fast 内核的上填充区总是写满 pad 行，第一块至少算 pad 行
+        if (end < pad)
+            end = pad;
+        status = NnConvRows(p_l, col, dst, end, 0, pad);
+    }
+    else
+    {
+        status = NnConvRows(p_l, col, dst, end - c, c * stride - pad, 0);
+    }
+    p_run->BandEnd = end;
+    return status;
+}
+
+// 融合层：池化行 [i0, i1)，初值 0 顺带完成 ReLU
+static void NnFusedPool(const OS_NnRunner *p_run, const OS_NnLayer *p_l, const q7_t *band, const q7_t *tail,
+                        uint16_t limit, uint16_t i0, uint16_t i1)
+{
+    uint16_t ch = p_l->OutCh;
+    int32_t y0, y1, x0, x1, y, x;
+    const q7_t *src;
+    q7_t *dst;
+    uint16_t i, j, c;
+
+    for (i = i0; i < i1; i++)
+    {
+        y0 = (int32_t)i * p_l->PoolStride - p_l->PoolPadding;
+        y1 = y0 + p_l->PoolKer;
+        if (y0 < 0)
+            y0 = 0;
+        if (y1 > p_l->OutDim)
+            y1 = p_l->OutDim;
+
+        for (j = 0; j < p_l->PoolDim; j++)
+        {
+            x0 = (int32_t)j * p_l->PoolStride - p_l->PoolPadding;
+            x1 = x0 + p_l->PoolKer;
+            if (x0 < 0)
+                x0 = 0;
+            if (x1 > p_l->OutDim)
+                x1 = p_l->OutDim;
+
+            dst = p_l->Out + ((uint32_t)i * p_l->PoolDim + j) * ch;
+            memset(dst, 0, ch);
+            for (y = y0; y < y1; y++)
+            {
+                src = NnFusedRow(p_run, p_l, band, tail, limit, (uint16_t)y) + x0 * ch;
+                for (x = x0; x < x1; x++, src += ch)
+                {
+                    for (c = 0; c < ch; c++)
+                    {
+                        if (src[c] > dst[c])
+                            dst[c] = src[c];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 融合层的一步：TileRows 组池化行（为 0 时一步做完整层，内部仍按行带推进）
+static uint8_t NnFusedStep(OS_NnRunner *p_run, const OS_NnLayer *p_l, arm_status *p_status)
+{
+    uint16_t out = p_l->OutDim;
+    uint16_t pad = p_l->Padding;
+    uint32_t row_size = (uint32_t)out * p_l->OutCh;
+    uint8_t fast_pad = NnIsFast(p_l) && pad != 0;
+    uint16_t limit = fast_pad ? out - pad : out;
+    uint16_t g = (p_l->TileRows != 0) ? p_l->TileRows : 1;
+    q15_t *col = NnScratch(p_run, p_l);
+    q7_t *band = (q7_t *)col + NnColBytes(p_l);
+    q7_t *tail = band + NnBandRows(p_l) * row_size;
+    uint16_t i0, i1, a, b, keep;
+    int32_t lo;
+
+    if (fast_pad && out < 2 * pad)
+    {
+        *p_status = ARM_MATH_SIZE_MISMATCH;
+        return 1;
+    }
+
+    // 1. 带填充的 fast 卷积：先算底部 2 * pad 行，后 pad 行留给最后几组池化
+    if (fast_pad && !p_run->TailDone)
+    {
+        *p_status = NnConvRows(p_l, col, tail, 2 * pad, (out - 2 * pad) * p_l->Stride, pad);
+        p_run->TailDone = 1;
+        if (*p_status != ARM_MATH_SUCCESS)
+            return 1;
+    }
+
+    do
+    {
+        // 2. 本组池化行需要的卷积行 [a, b)
+        i0 = p_run->Row;
+        i1 = NnMin(i0 + g, p_l->PoolDim);
+        lo = (int32_t)i0 * p_l->PoolStride - p_l->PoolPadding;
+        a = (lo < 0) ? 0 : (uint16_t)lo;
+        lo = (int32_t)(i1 - 1) * p_l->PoolStride - p_l->PoolPadding + p_l->PoolKer;
+        b = (lo > out) ? out : (uint16_t)lo;
+
+        // 3. 丢掉用完的行，和本组重叠的行挪到缓冲区开头
+        if (a > p_run->BandStart)
+        {
+            keep = (p_run->BandEnd > a) ? p_run->BandEnd - a : 0;
+            memmove(band, band + (uint32_t)(a - p_run->BandStart) * row_size, keep * row_size);
+            p_run->BandStart = a;
+            if (p_run->BandEnd < a)
+                p_run->BandEnd = a;
+        }
+
+        // 4. 补算缺的卷积行，再池化
+        *p_status = NnFusedFill(p_run, p_l, col, band, NnMin(b, limit));
+        if (*p_status != ARM_MATH_SUCCESS)
+            return 1;
+        NnFusedPool(p_run, p_l, band, tail, limit, i0, i1);
+        p_run->Row = i1;
+    } while (p_l->TileRows == 0 && p_run->Row < p_l->PoolDim);
+
+    return p_run->Row >= p_l->PoolDim;
+}
+
+/* 内存规划 ---------------------------------------------------------------- */
+
+#define NN_PLAN_UNPLACED 0xFFFFFFFFu
+
+static uint32_t NnAlign4(uint32_t n)
+{
+    return (n + 3u) & ~3u;
+}
+
+// 跟着 Alias 找到一组原地张量的根
+static uint16_t NnPlanRoot(const OS_NnTensor *t, uint16_t i)
+{
+    while (t[i].Alias != OS_NN_NO_ALIAS)
+        i = t[i].Alias;
+    return i;
+}
+
+// 把根为 root 的一组放在 offset 处，和已摆好的张量冲突时返回 1，并给出下一个候选偏移
+static uint8_t NnPlanConflict(const OS_NnTensor *t, uint16_t num, uint16_t root, uint32_t offset,
+                              uint32_t *p_next)
+{
+    uint16_t i, j;
+
+    for (i = 0; i < num; i++)
+    {
+        if (t[i].Size == 0 || NnPlanRoot(t, i) != root)
+            continue;
+        for (j = 0; j < num; j++)
+        {
+            if (t[j].Size == 0 || t[j].Offset == NN_PLAN_UNPLACED)
+                continue;
+            if (t[i].First > t[j].Last || t[j].First > t[i].Last)
+                continue; // 生存期不重叠
+            if (offset >= t[j].Offset + NnAlign4(t[j].Size) || t[j].Offset >= offset + NnAlign4(t[i].Size))
+                continue; // 空间不重叠
+            *p_next = t[j].Offset + NnAlign4(t[j].Size);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t NnInSize(const OS_NnLayer *p_l)
+{
+    if (p_l->Type == OS_NN_FC || p_l->Type == OS_NN_FC_OPT || p_l->Type == OS_NN_SOFTMAX)
+        return p_l->InDim;
+    return (uint32_t)p_l->InDim * p_l->InDim * p_l->InCh;
+}
+
+static uint32_t NnOutSize(const OS_NnLayer *p_l)
+{
+    switch (p_l->Type)
+    {
+    case OS_NN_RELU:
+    case OS_NN_SOFTMAX:
+        return NnInSize(p_l);
+    case OS_NN_MAXPOOL:
+    case OS_NN_AVEPOOL:
+        return (uint32_t)p_l->OutDim * p_l->OutDim * p_l->InCh;
+    case OS_NN_FC:
+    case OS_NN_FC_OPT:
+        return p_l->OutCh;
+    case OS_NN_CONV_RELU_POOL:
+    case OS_NN_CONV_FAST_RELU_POOL:
+        return (uint32_t)p_l->PoolDim * p_l->PoolDim * p_l->OutCh;
+    default:
+        return (uint32_t)p_l->OutDim * p_l->OutDim * p_l->OutCh;
+    }
+}
+
+static uint8_t NnInPlace(const OS_NnLayer *p_l)
+{
+    switch (p_l->Type)
+    {
+    case OS_NN_RELU:
+    case OS_NN_SOFTMAX:
+        return 1;
+    case OS_NN_MAXPOOL:
+        return p_l->Padding == 0 && (uint32_t)p_l->Stride * p_l->InDim >= 2u * p_l->OutDim;
+    default:
+        return 0;
+    }
+}
+
+/* 性能统计 ---------------------------------------------------------------- */
+
+static const char *const NnTypeName[] = {
+    "conv_rgb", "conv_basic", "conv_fast", "conv_dw", "relu", "maxpool", "avepool", "fc", "fc_opt", "softmax",
+    "conv_relu_pool", "conv_fast_relu_pool"};
+
+static uint64_t NnMacs(const OS_NnLayer *p_l)
+{
+    uint64_t pixels = (uint64_t)p_l->OutDim * p_l->OutDim;
+
+    switch (p_l->Type)
+    {
+    case OS_NN_CONV_RGB:
+    case OS_NN_CONV_BASIC:
+    case OS_NN_CONV_FAST:
+    case OS_NN_CONV_RELU_POOL:
+    case OS_NN_CONV_FAST_RELU_POOL:
+        return pixels * p_l->OutCh * p_l->InCh * p_l->KerDim * p_l->KerDim;
+    case OS_NN_CONV_DW:
+        return pixels * p_l->OutCh * p_l->KerDim * p_l->KerDim;
+    case OS_NN_FC:
+    case OS_NN_FC_OPT:
+        return (uint64_t)p_l->InDim * p_l->OutCh;
+    default:
+        return 0;
+    }
+}
+
+static uint32_t NnWeightBytes(const OS_NnLayer *p_l)
+{
+    uint32_t k2 = (uint32_t)p_l->KerDim * p_l->KerDim;
+
+    switch (p_l->Type)
+    {
+    case OS_NN_CONV_RGB:
+    case OS_NN_CONV_BASIC:
+    case OS_NN_CONV_FAST:
+    case OS_NN_CONV_RELU_POOL:
+    case OS_NN_CONV_FAST_RELU_POOL:
+        return p_l->OutCh * (p_l->InCh * k2 + 1u);
+    case OS_NN_CONV_DW:
+        return p_l->OutCh * (k2 + 1u);
+    case OS_NN_FC:
+    case OS_NN_FC_OPT:
+        return p_l->OutCh * (p_l->InDim + 1u);
+    default:
+        return 0;
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void OS_NnRunnerInit(OS_NnRunner *p_run, const OS_NnLayer *layers, uint16_t num_layers, q15_t *col_buffer)
+{
+    p_run->Layers = layers;
+    p_run->NumLayers = num_layers;
+    p_run->ColBuffer = col_buffer;
+
+    p_run->Inferences = 0;
+    p_run->Steps = 0;
+    p_run->LastCycles = 0;
+    p_run->MaxCycles = 0;
+    p_run->Profile = NULL;
+    p_run->ProfileRuns = 0;
+    OS_NnAbort(p_run);
+}
+
+void OS_NnAbort(OS_NnRunner *p_run)
+{
+    p_run->Layer = 0;
+    p_run->Row = 0;
+    p_run->TailDone = 0;
+    p_run->BandStart = 0;
+    p_run->BandEnd = 0;
+}
+
+uint8_t OS_NnStep(OS_NnRunner *p_run)
+{
+    const OS_NnLayer *p_l = &p_run->Layers[p_run->Layer];
+    arm_status status = ARM_MATH_SUCCESS;
+    uint8_t layer_done = 1;
+    uint64_t elapsed;
+    uint32_t t0 = OS_NN_PROFILE_CLOCK();
+
+    // 1. 第一步：记下起点
+    if (p_run->Layer == 0 && p_run->Row == 0 && !p_run->TailDone)
+    {
+        p_run->StartCycles = OS_TimeNowCycles();
+        p_run->Steps = 0;
+    }
+
+    // 2. 执行这一步
+    switch (p_l->Type)
+    {
+    case OS_NN_CONV_RGB:
+    case OS_NN_CONV_BASIC:
+    case OS_NN_CONV_FAST:
+        layer_done = NnConvStep(p_run, p_l, &status);
+        break;
+    case OS_NN_CONV_RELU_POOL:
+    case OS_NN_CONV_FAST_RELU_POOL:
+        layer_done = NnFusedStep(p_run, p_l, &status);
+        break;
+    case OS_NN_CONV_DW:
+        status = arm_depthwise_separable_conv_HWC_q7(p_l->In, p_l->InDim, p_l->InCh, p_l->Weights, p_l->OutCh,
+                                                     p_l->KerDim, p_l->Padding, p_l->Stride, p_l->Bias,
+                                                     p_l->BiasShift, p_l->OutShift, p_l->Out, p_l->OutDim,
+                                                     NnScratch(p_run, p_l), NULL);
+        break;
+    case OS_NN_RELU:
+        layer_done = NnReluStep(p_run, p_l);
+        break;
+    case OS_NN_MAXPOOL:
+        arm_maxpool_q7_HWC(p_l->In, p_l->InDim, p_l->InCh, p_l->KerDim, p_l->Padding, p_l->Stride,
+                           p_l->OutDim, (q7_t *)NnScratch(p_run, p_l), p_l->Out);
+        break;
+    case OS_NN_AVEPOOL:
+        arm_avepool_q7_HWC(p_l->In, p_l->InDim, p_l->InCh, p_l->KerDim, p_l->Padding, p_l->Stride,
+                           p_l->OutDim, (q7_t *)NnScratch(p_run, p_l), p_l->Out);
+        break;
+    case OS_NN_FC:
+    case OS_NN_FC_OPT:
+        layer_done = NnFcStep(p_run, p_l, &status);
+        break;
+    case OS_NN_SOFTMAX:
+        arm_softmax_q7(p_l->In, p_l->InDim, p_l->Out);
+        break;
+    default:
+        status = ARM_MATH_ARGUMENT_ERROR;
+        break;
+    }
+    p_run->Steps++;
+
+    if (p_run->Profile != NULL)
+    {
+        p_run->Profile[p_run->Layer].Steps++;
+        p_run->Profile[p_run->Layer].Cycles += (uint32_t)(OS_NN_PROFILE_CLOCK() - t0);
+    }
+
+    if (status != ARM_MATH_SUCCESS)
+    {
+        OS_NnAbort(p_run);
+        p_run->Steps = 0;
+        return OS_NN_ERROR;
+    }
+
+    // 3. 换到下一层
+    if (layer_done)
+    {
+        p_run->Layer++;
+        p_run->Row = 0;
+        p_run->TailDone = 0;
+        p_run->BandStart = 0;
+        p_run->BandEnd = 0;
+    }
+    if (p_run->Layer < p_run->NumLayers)
+        return OS_NN_BUSY;
+
+    // 4. 整个网络跑完：统计耗时
+    elapsed = OS_TimeNowCycles() - p_run->StartCycles;
+    p_run->LastCycles = elapsed;
+    if (elapsed > p_run->MaxCycles)
+        p_run->MaxCycles = elapsed;
+    p_run->Inferences++;
+    if (p_run->Profile != NULL)
+        p_run->ProfileRuns++;
+    p_run->Layer = 0;
+    return OS_NN_DONE;
+}
+
+uint8_t OS_NnRun(OS_NnRunner *p_run, uint64_t deadline)
+{
+    uint8_t ret;
+
+    while (1)
+    {
+        ret = OS_NnStep(p_run);
+        if (ret != OS_NN_BUSY)
+            return ret;
+
+        // 步与步之间：让同优先级的任务先跑，再看时间够不够
+        OS_Yield();
+        if (deadline != 0 && OS_TimeNowCycles() >= deadline)
+            return OS_NN_TIMEOUT;
+    }
+}
+
+uint32_t OS_NnLayerScratchSize(const OS_NnLayer *p_l)
+{
+    uint32_t size;
+
+    switch (p_l->Type)
+    {
+    case OS_NN_CONV_RGB:
+    case OS_NN_CONV_BASIC:
+    case OS_NN_CONV_FAST:
+    case OS_NN_CONV_DW:
+        return NnColBytes(p_l);
+    case OS_NN_CONV_RELU_POOL:
+    case OS_NN_CONV_FAST_RELU_POOL:
+        size = NnColBytes(p_l) + (uint32_t)NnBandRows(p_l) * p_l->OutDim * p_l->OutCh;
+        if (NnIsFast(p_l) && p_l->Padding != 0)
+            size += 2u * p_l->Padding * p_l->OutDim * p_l->OutCh; // 底部那一块
+        return size;
+    case OS_NN_FC:
+    case OS_NN_FC_OPT:
+        return 2u * p_l->InDim;
+    case OS_NN_AVEPOOL:
+        return 2u * p_l->OutDim * p_l->InCh;
+    default:
+        return 0;
+    }
+}
+
+void OS_NnProfileStart(OS_NnRunner *p_run, OS_NnLayerProfile *profile)
+{
+    uint16_t i;
+
+    if (profile != NULL)
+    {
+        for (i = 0; i < p_run->NumLayers; i++)
+        {
+            profile[i].Steps = 0;
+            profile[i].Cycles = 0;
+        }
+#ifdef OS_NN_PROFILE_DWT
+        // 打开 DWT 周期计数器（不清零，可能别的模块也在用）
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    }
+    p_run->ProfileRuns = 0;
+    p_run->Profile = profile;
+}
+
+uint32_t OS_NnProfileCsv(const OS_NnRunner *p_run, char *buf, uint32_t size)
+{
+    const OS_NnLayer *p_l;
+    uint32_t runs = (p_run->ProfileRuns != 0) ? p_run->ProfileRuns : 1;
+    uint32_t len = 0;
+    uint64_t cycles, macs, mpc;
+    uint16_t i;
+    int n;
+
+    if (p_run->Profile == NULL || size == 0)
+        return 0;
+
+    n = snprintf(buf, size, "layer,type,steps,cycles,macs,macs_per_cycle,act_bytes,weight_bytes\n");
+    for (i = 0; n >= 0 && len + (uint32_t)n < size && i < p_run->NumLayers; i++)
+    {
+        len += (uint32_t)n;
+        p_l = &p_run->Layers[i];
+        cycles = p_run->Profile[i].Cycles / runs;
+        macs = NnMacs(p_l);
+        mpc = (cycles != 0) ? macs * 1000u / cycles : 0; // 保留三位小数，不依赖浮点 printf
+
+        n = snprintf(buf + len, size - len, "%u,%s,%lu,%lu,%lu,%lu.%03lu,%lu,%lu\n", (unsigned)i,
+                     NnTypeName[p_l->Type], (unsigned long)(p_run->Profile[i].Steps / runs),
+                     (unsigned long)cycles, (unsigned long)macs,
+                     (unsigned long)(mpc / 1000u), (unsigned long)(mpc % 1000u),
+                     (unsigned long)(NnInSize(p_l) + NnOutSize(p_l)), (unsigned long)NnWeightBytes(p_l));
+    }
+    if (n >= 0 && len + (uint32_t)n < size)
+        len += (uint32_t)n;
+    else
+        len = size - 1; // 截断：snprintf 已经保证以 0 结尾
+    return len;
+}
+
+uint32_t OS_NnPlanTensors(OS_NnTensor *tensors, uint16_t num)
+{
+    uint16_t i, j, root;
+    uint32_t group_size, best_size, offset, next, peak = 0;
+
+    for (i = 0; i < num; i++)
+        tensors[i].Offset = NN_PLAN_UNPLACED;
+
+    while (1)
+    {
+        // 1. 挑出还没摆放的、最大的一组
+        root = OS_NN_NO_ALIAS;
+        best_size = 0;
+        for (i = 0; i < num; i++)
+        {
+            if (tensors[i].Alias != OS_NN_NO_ALIAS || tensors[i].Offset != NN_PLAN_UNPLACED)
+                continue;
+            if (tensors[i].Size == 0)
+            {
+                tensors[i].Offset = 0;
+                continue;
+            }
+            group_size = 0;
+            for (j = 0; j < num; j++)
+            {
+                if (NnPlanRoot(tensors, j) == i && tensors[j].Size > group_size)
+                    group_size = tensors[j].Size;
+            }
+            if (root == OS_NN_NO_ALIAS || group_size > best_size)
+            {
+                root = i;
+                best_size = group_size;
+            }
+        }
+        if (root == OS_NN_NO_ALIAS)
+            break;
+
+        // 2. 从 0 开始找最低的可用偏移：冲突时跳到冲突张量的末尾，中间的偏移一定也冲突
+        offset = 0;
+        while (NnPlanConflict(tensors, num, root, offset, &next))
+            offset = next;
+
+        // 3. 整组放在同一地址
+        for (i = 0; i < num; i++)
+        {
+            if (NnPlanRoot(tensors, i) == root)
+                tensors[i].Offset = offset;
+        }
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if (tensors[i].Size != 0 && tensors[i].Offset + NnAlign4(tensors[i].Size) > peak)
+            peak = tensors[i].Offset + NnAlign4(tensors[i].Size);
+    }
+    return peak;
+}
+
+uint32_t OS_NnPlanLayers(OS_NnLayer *layers, uint16_t num_layers, OS_NnTensor *tensors,
+                         uint8_t *arena, uint32_t arena_size)
+{
+    OS_NnTensor *t;
+    uint32_t need;
+    uint16_t i;
+
+    if (num_layers == 0)
+        return 0;
+
+    // 1. 张量编号：0 为网络输入，第 i 层的临时缓冲区为 2i+1，输出为 2i+2
+    tensors[0].Size = NnInSize(&layers[0]);
+    tensors[0].First = 0;
+    tensors[0].Last = 0;
+    tensors[0].Alias = OS_NN_NO_ALIAS;
+
+    for (i = 0; i < num_layers; i++)
+    {
+        tensors[2 * i].Last = i; // 输入至少活到本层
+
+        t = &tensors[2 * i + 1];
+        t->Size = OS_NnLayerScratchSize(&layers[i]);
+        t->First = i;
+        t->Last = i;
+        t->Alias = OS_NN_NO_ALIAS;
+
+        t = &tensors[2 * i + 2];
+        t->Size = NnOutSize(&layers[i]);
+        t->First = i;
+        t->Last = i;
+        t->Alias = NnInPlace(&layers[i]) ? (uint16_t)(2 * i) : OS_NN_NO_ALIAS;
+    }
+    tensors[2 * num_layers].Last = num_layers; // 网络输出在推理结束后还要读
+
+    // 2. 排进内存池
+    need = OS_NnPlanTensors(tensors, OS_NN_PLAN_TENSORS(num_layers));
+    if (arena == NULL || need > arena_size)
+        return need;
+
+    // 3. 回填各层的指针
+    for (i = 0; i < num_layers; i++)
+    {
+        layers[i].In = (q7_t *)(arena + tensors[2 * i].Offset);
+        layers[i].Out = (q7_t *)(arena + tensors[2 * i + 2].Offset);
+        layers[i].Scratch = (tensors[2 * i + 1].Size != 0) ? (q15_t *)(arena + tensors[2 * i + 1].Offset) : NULL;
+    }
+    return need;
+}
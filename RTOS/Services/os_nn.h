@@ -0,0 +1,222 @@
+/**
+ ******************************************************************************
+ * @file    os_nn.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   可抢占的 CMSIS-NN 推理运行器
+ *
+ * - 网络描述成一张层表，运行器每次只执行一“步”：一层，或者一层里的若干输出行
+ * - 步与步之间让出 CPU (OS_Yield) 并检查截止时间，推理可以放在后台任务里，
+ *   和同优先级的控制任务轮流运行；超时返回后进度保留，下次调用接着算
+ * - 卷积和全连接层可以按输出行分块（TileRows），用 *_nonsquare 卷积实现；
+ *   分块不改变任何一个输出的计算，结果和整层调用逐位一致
+ * - 记录每次推理从第一步到最后一步的耗时（节拍定时器计数）
+ * - 卷积 + ReLU + 最大池化可以融合成一层：卷积按行带计算到一小块缓冲区，
+ *   凑够一个池化窗口就池化输出，完整的卷积输出从不落地
+ * - 性能统计：每层累计周期数，按层导出 CSV（周期、MAC/周期、激活读写量）。
+ *   时钟默认取 DWT 周期计数器，主机模拟或 QEMU 上定义 OS_NN_PROFILE_CLOCK 换成别的计数器
+ * - 静态内存规划：按层表算出每个激活张量和临时缓冲区的生存期，
+ *   允许原地计算的层直接复用输入，然后把它们全部排进一块内存池
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_NN_H
+#define __OS_NN_H
+
+#include "os_core.h"
+#include "os_time.h"
+#include "arm_math.h"
+#include "arm_nnfunctions.h"
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#ifndef OS_NN_PROFILE_CLOCK
+#define OS_NN_PROFILE_CLOCK() (DWT->CYCCNT) ///< 性能统计用的 32 位递增计数器
+#define OS_NN_PROFILE_DWT                   ///< 使用默认时钟，开始统计时打开 DWT
+#endif
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+#define OS_NN_DONE     0u  ///< 一次推理完成
+#define OS_NN_TIMEOUT  1u  ///< 截止时间到了，进度已保留
+#define OS_NN_ERROR    2u  ///< 某一层的尺寸不满足内核要求，进度已复位
+#define OS_NN_BUSY     3u  ///< OS_NnStep：这一步做完了，后面还有
+
+#define OS_NN_NO_ALIAS 0xFFFFu ///< OS_NnTensor.Alias：不复用其他张量的内存
+
+/**
+ * @brief  层表规划需要的张量数：网络输入 + 每层的输出和临时缓冲区
+ */
+#define OS_NN_PLAN_TENSORS(num_layers) (2u * (num_layers) + 1u)
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  层类型
+ */
+typedef enum
+{
+    OS_NN_CONV_RGB = 0,   ///< arm_convolve_HWC_q7_RGB（分块时改用 basic_nonsquare，权重格式相同）
+    OS_NN_CONV_BASIC,     ///< arm_convolve_HWC_q7_basic / basic_nonsquare
+    OS_NN_CONV_FAST,      ///< arm_convolve_HWC_q7_fast / fast_nonsquare（InCh 为 4 的倍数、OutCh 为偶数，权重格式同 basic）
+    OS_NN_CONV_DW,        ///< arm_depthwise_separable_conv_HWC_q7（InCh == OutCh，不分块）
+    OS_NN_RELU,           ///< arm_relu_q7，原地处理 In
+    OS_NN_MAXPOOL,        ///< arm_maxpool_q7_HWC（会改写 In，不分块）
+    OS_NN_AVEPOOL,        ///< arm_avepool_q7_HWC（会改写 In，不分块）
+    OS_NN_FC,             ///< arm_fully_connected_q7
+    OS_NN_FC_OPT,         ///< arm_fully_connected_q7_opt（权重需重排，分块按 4 行对齐）
+    OS_NN_SOFTMAX,        ///< arm_softmax_q7
+    OS_NN_CONV_RELU_POOL, ///< basic 卷积 + ReLU + 最大池化（权重格式同 basic/RGB）
+    OS_NN_CONV_FAST_RELU_POOL ///< fast 卷积 + ReLU + 最大池化（通道要求同 fast）
+} OS_NnLayerType;
+
+/**
+ * @brief  层描述（方形 HWC 张量）
+ * @note   ReLU 处理 InDim * InDim * InCh 个元素；
+ *         全连接层 InDim 为输入向量长度，OutCh 为输出个数；Softmax 的 InDim 为向量长度；
+ *         融合层的 OutDim 是卷积输出边长，Out 里是 PoolDim 边长的池化结果，
+ *         TileRows 为每步输出的池化行数
+ */
+typedef struct
+{
+    OS_NnLayerType Type;  ///< 层类型
+    q7_t *In;             ///< 输入
+    q7_t *Out;            ///< 输出（ReLU 不用）
+    const q7_t *Weights;  ///< 权重
+    const q7_t *Bias;     ///< 偏置
+    uint16_t InDim;       ///< 输入边长
+    uint16_t InCh;        ///< 输入通道数
+    uint16_t OutDim;      ///< 输出边长
+    uint16_t OutCh;       ///< 输出通道数
+    uint16_t KerDim;      ///< 卷积核/池化窗口边长
+    uint16_t Padding;     ///< 填充
+    uint16_t Stride;      ///< 步长
+    uint16_t BiasShift;   ///< 偏置左移
+    uint16_t OutShift;    ///< 输出右移
+    uint16_t TileRows;    ///< 每步计算的输出行数，0 表示整层一步
+    uint16_t PoolKer;     ///< 融合层：池化窗口边长
+    uint16_t PoolPadding; ///< 融合层：池化填充
+    uint16_t PoolStride;  ///< 融合层：池化步长
+    uint16_t PoolDim;     ///< 融合层：池化输出边长
+    q15_t *Scratch;       ///< 本层的临时缓冲区，NULL 时用运行器的 ColBuffer
+} OS_NnLayer;
+
+/**
+ * @brief  内存规划用的张量描述
+ * @note   生存期 [First, Last] 以步骤（层）编号计，两端都包含；
+ *         Alias 指向一个编号更小的张量，表示原地计算：和它放在同一地址
+ */
+typedef struct
+{
+    uint32_t Size;        ///< 字节数
+    uint16_t First;       ///< 第一次被写的步骤
+    uint16_t Last;        ///< 最后一次被读的步骤
+    uint16_t Alias;       ///< 原地复用的张量，OS_NN_NO_ALIAS 表示独立分配
+    uint32_t Offset;      ///< 规划结果：在内存池里的偏移
+} OS_NnTensor;
+
+/**
+ * @brief  单层的性能统计（从开始统计起累计）
+ */
+typedef struct
+{
+    uint32_t Steps;            ///< 执行的步数
+    uint64_t Cycles;           ///< 累计的周期数
+} OS_NnLayerProfile;
+
+/**
+ * @brief  运行器结构体定义
+ */
+typedef struct
+{
+    const OS_NnLayer *Layers;  ///< 层表
+    uint16_t NumLayers;        ///< 层数
+    q15_t *ColBuffer;          ///< im2col / 全连接 / 池化共用的临时缓冲区
+
+    uint16_t Layer;            ///< 下一步所在的层
+    uint16_t Row;              ///< 下一步在该层里的起始输出行
+    uint8_t TailDone;          ///< 带填充的 fast 卷积：底部那一块已经算过
+    uint16_t BandStart;        ///< 融合层：行带缓冲区里第一行的卷积行号
+    uint16_t BandEnd;          ///< 融合层：行带缓冲区已算到的卷积行号（不含）
+    uint64_t StartCycles;      ///< 本次推理第一步开始的时刻
+
+    uint32_t Inferences;       ///< 完成的推理次数
+    uint32_t Steps;            ///< 最近一次推理的步数
+    uint64_t LastCycles;       ///< 最近一次推理的耗时（节拍定时器计数）
+    uint64_t MaxCycles;        ///< 最长一次推理的耗时
+
+    OS_NnLayerProfile *Profile; ///< 每层一项的性能统计，NULL 表示不统计
+    uint32_t ProfileRuns;      ///< 开始统计以来完成的推理次数
+} OS_NnRunner;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化运行器
+ * @param  col_buffer: 公用临时缓冲区，大小取没有自带 Scratch 的层要求的最大值；
+ *                     所有层都经过 OS_NnPlanLayers 规划时可以传 NULL
+ */
+void OS_NnRunnerInit(OS_NnRunner *p_run, const OS_NnLayer *layers, uint16_t num_layers, q15_t *col_buffer);
+
+/**
+ * @brief  执行一步（不让出 CPU，调用者自己决定步间做什么）
+ * @return uint8_t: OS_NN_BUSY / OS_NN_DONE / OS_NN_ERROR
+ */
+uint8_t OS_NnStep(OS_NnRunner *p_run);
+
+/**
+ * @brief  运行推理，每步之间让出 CPU
+ * @param  deadline: 截止时刻 (OS_TimeNowCycles)，0 表示不限
+ * @return uint8_t: OS_NN_DONE / OS_NN_TIMEOUT / OS_NN_ERROR
+ */
+uint8_t OS_NnRun(OS_NnRunner *p_run, uint64_t deadline);
+
+/**
+ * @brief  放弃当前推理，下一步从第一层开始
+ */
+void OS_NnAbort(OS_NnRunner *p_run);
+
+/**
+ * @brief  某一层需要的临时缓冲区字节数（im2col 等；融合层还包括行带缓冲区）
+ * @note   不经过 OS_NnPlanLayers 时，ColBuffer 取所有层的最大值
+ */
+uint32_t OS_NnLayerScratchSize(const OS_NnLayer *p_l);
+
+/**
+ * @brief  开始（或重新开始）逐层性能统计
+ * @param  profile: 至少 NumLayers 项，NULL 表示关闭统计
+ * @note   在两次推理之间调用；统计的是墙上时间，被抢占的时间也会计入，
+ *         需要纯计算时间时让推理任务独占 CPU
+ */
+void OS_NnProfileStart(OS_NnRunner *p_run, OS_NnLayerProfile *profile);
+
+/**
+ * @brief  把逐层统计按 CSV 格式写入 buf（每次推理的平均值）
+ * @return uint32_t: 写入的字符数（不含结尾的 0），buf 不够时截断
+ * @note   列：layer,type,steps,cycles,macs,macs_per_cycle,act_bytes,weight_bytes；
+ *         act_bytes 为本层读入和写出的激活字节数，weight_bytes 含偏置
+ */
+uint32_t OS_NnProfileCsv(const OS_NnRunner *p_run, char *buf, uint32_t size);
+
+/**
+ * @brief  把一组张量排进一块内存池（按大小从大到小，放到最低的空闲偏移）
+ * @return uint32_t: 内存池需要的字节数（峰值）
+ * @note   生存期重叠的张量不会重叠摆放，偏移按 4 字节对齐
+ */
+uint32_t OS_NnPlanTensors(OS_NnTensor *tensors, uint16_t num);
+
+/**
+ * @brief  规划顺序网络（第 i 层的输入就是第 i - 1 层的输出）的激活和临时缓冲区
+ * @param  tensors   : 工作区，至少 OS_NN_PLAN_TENSORS(num_layers) 个
+ * @param  arena     : 内存池，NULL 时只计算需要的大小
+ * @param  arena_size: 内存池字节数
+ * @return uint32_t: 需要的字节数；内存池够用时改写各层的 In/Out/Scratch，
+ *                   网络输入为 layers[0].In，输出为 layers[num_layers - 1].Out
+ * @note   ReLU、Softmax 以及满足条件的最大池化原地计算
+ */
+uint32_t OS_NnPlanLayers(OS_NnLayer *layers, uint16_t num_layers, OS_NnTensor *tensors,
+                         uint8_t *arena, uint32_t arena_size);
+
+#endif /* __OS_NN_H */
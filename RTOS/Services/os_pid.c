@@ -0,0 +1,255 @@
+/**
+ ******************************************************************************
+ * @file    os_pid.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   硬实时 PID 控制环服务实现
+ *
+ * 任务和中断之间的约定：
+ * - TIM1 中断优先级高于内核天花板，任务永远打断不了它，
+ *   所以中断里的读写对任务来说总是一次完成的
+ * - 设定值/增益：任务把活动份复制到非活动份、修改后再切换 ConfigActive，
+ *   中断每次只按 ConfigActive 读一份完整的配置；多个写者用 OS_SchedLock 串行化
+ * - 清积分/清统计：任务只递增请求计数，中断发现计数不相等时处理并追平
+ * - 遥测：中断写之前和写之后各把 TelemetrySeq 加一，
+ *   任务读到奇数或前后不一致说明被打断了，重读即可
+ *
+ ******************************************************************************
+ */
+
+#include "os_pid.h"
+#include <string.h>
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static TIM_HandleTypeDef PidTimerHandle;
+static OS_PidLoop *volatile PidLoopListHead = NULL;
+static uint32_t PidLastCycles;
+static uint8_t PidFirstRun;
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// 由增益算出 A0/A1/A2（arm_pid_init_q31 带饱和处理）
+static void PidComputeCoeffs(OS_PidConfig *p_cfg, q31_t kp, q31_t ki, q31_t kd)
+{
+    arm_pid_instance_q31 tmp;
+
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.Kp = kp;
+    tmp.Ki = ki;
+    tmp.Kd = kd;
+    arm_pid_init_q31(&tmp, 0);
+
+    p_cfg->A0 = tmp.A0;
+    p_cfg->A1 = tmp.A1;
+    p_cfg->A2 = tmp.A2;
+}
+
+// 切换到刚写好的那一份配置
+static void PidPublishConfig(OS_PidLoop *p_loop, uint8_t idx)
+{
+    __DMB(); // 配置内容先落地，再让中断看到新的索引
+    p_loop->ConfigActive = idx;
+}
+
+static void PidRun(OS_PidLoop *p_loop, uint32_t period)
+{
+    const OS_PidConfig *p_cfg = &p_loop->Config[p_loop->ConfigActive];
+    OS_PidTelemetry *p_tel = &p_loop->Telemetry;
+    uint32_t start = DWT->CYCCNT;
+    uint32_t exec;
+    q31_t meas;
+    q31_t out;
+
+    p_loop->Pid.A0 = p_cfg->A0;
+    p_loop->Pid.A1 = p_cfg->A1;
+    p_loop->Pid.A2 = p_cfg->A2;
+
+    if (p_loop->ResetRequest != p_loop->ResetAck)
+    {
+        arm_pid_reset_q31(&p_loop->Pid);
+        p_loop->ResetAck = p_loop->ResetRequest;
+    }
+
+    // 1. 采样 -> 误差 -> 输出
+    meas = p_loop->ReadInput(p_loop->Arg);
+    out = arm_pid_q31(&p_loop->Pid, __QSUB(p_cfg->Setpoint, meas));
+    p_loop->WriteOutput(out, p_loop->Arg);
+
+    exec = DWT->CYCCNT - start;
+
+    // 2. 更新遥测（顺序锁写端）
+    p_loop->TelemetrySeq++;
+    __DMB();
+
+    if (p_loop->StatsResetRequest != p_loop->StatsResetAck)
+    {
+        p_tel->PeriodMin = 0xFFFFFFFFu;
+        p_tel->PeriodMax = 0;
+        p_tel->ExecMax = 0;
+        p_loop->StatsResetAck = p_loop->StatsResetRequest;
+    }
+
+    p_tel->Setpoint = p_cfg->Setpoint;
+    p_tel->Measurement = meas;
+    p_tel->Output = out;
+    p_tel->Iterations++;
+    if (period != 0)
+    {
+        if (period < p_tel->PeriodMin)
+            p_tel->PeriodMin = period;
+        if (period > p_tel->PeriodMax)
+            p_tel->PeriodMax = period;
+    }
+    if (exec > p_tel->ExecMax)
+        p_tel->ExecMax = exec;
+
+    __DMB();
+    p_loop->TelemetrySeq++;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void OS_PidLoopInit(OS_PidLoop *p_loop, q31_t (*read_input)(void *), void (*write_output)(q31_t, void *),
+                    void *arg, q31_t kp, q31_t ki, q31_t kd)
+{
+    memset(p_loop, 0, sizeof(OS_PidLoop));
+
+    p_loop->ReadInput = read_input;
+    p_loop->WriteOutput = write_output;
+    p_loop->Arg = arg;
+
+    p_loop->Pid.Kp = kp;
+    p_loop->Pid.Ki = ki;
+    p_loop->Pid.Kd = kd;
+    arm_pid_init_q31(&p_loop->Pid, 1);
+
+    PidComputeCoeffs(&p_loop->Config[0], kp, ki, kd);
+    p_loop->Config[1] = p_loop->Config[0];
+    p_loop->ConfigActive = 0;
+
+    p_loop->Telemetry.PeriodMin = 0xFFFFFFFFu;
+}
+
+void OS_PidAdd(OS_PidLoop *p_loop)
+{
+    // 头插法，中断要么看到旧表头，要么看到完整链好的新节点
+    p_loop->Next = PidLoopListHead;
+    __DMB();
+    PidLoopListHead = p_loop;
+}
+
+uint8_t OS_PidStart(uint32_t rate_hz)
+{
+    uint32_t pclk2 = HAL_RCC_GetPCLK2Freq();
+    uint32_t timclk = ((RCC->CFGR & RCC_CFGR_PPRE2) == RCC_CFGR_PPRE2_DIV1) ? pclk2 : pclk2 * 2;
+    uint32_t total;
+    uint32_t psc;
+
+    if (rate_hz == 0 || rate_hz > timclk)
+        return 0;
+
+    // 1. 拆分成 预分频 x 重装载，二者都不能超过 16 位
+    total = timclk / rate_hz;
+    psc = (total - 1) / 0x10000u + 1;
+    if (psc > 0x10000u)
+        return 0;
+
+    // 2. 打开 DWT 周期计数器（不清零，可能别的模块也在用）
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    PidFirstRun = 1;
+
+    // 3. 配置 TIM1 更新中断
+    __HAL_RCC_TIM1_CLK_ENABLE();
+
+    PidTimerHandle.Instance = TIM1;
+    PidTimerHandle.Init.Prescaler = psc - 1;
+    PidTimerHandle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    PidTimerHandle.Init.Period = total / psc - 1;
+    PidTimerHandle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    PidTimerHandle.Init.RepetitionCounter = 0;
+    PidTimerHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(&PidTimerHandle) != HAL_OK)
+        return 0;
+
+    // 高于内核天花板：BASEPRI 临界区屏蔽不到它
+    NVIC_SetPriority(TIM1_UP_IRQn, OS_PID_IRQ_PRIO);
+    NVIC_EnableIRQ(TIM1_UP_IRQn);
+
+    __HAL_TIM_CLEAR_FLAG(&PidTimerHandle, TIM_FLAG_UPDATE);
+    if (HAL_TIM_Base_Start_IT(&PidTimerHandle) != HAL_OK)
+        return 0;
+
+    return 1;
+}
+
+void OS_PidSetSetpoint(OS_PidLoop *p_loop, q31_t setpoint)
+{
+    uint8_t idx;
+
+    OS_SchedLock();
+    idx = p_loop->ConfigActive ^ 1u;
+    p_loop->Config[idx] = p_loop->Config[idx ^ 1u];
+    p_loop->Config[idx].Setpoint = setpoint;
+    PidPublishConfig(p_loop, idx);
+    OS_SchedUnlock();
+}
+
+void OS_PidSetGains(OS_PidLoop *p_loop, q31_t kp, q31_t ki, q31_t kd)
+{
+    uint8_t idx;
+
+    OS_SchedLock();
+    idx = p_loop->ConfigActive ^ 1u;
+    p_loop->Config[idx] = p_loop->Config[idx ^ 1u];
+    PidComputeCoeffs(&p_loop->Config[idx], kp, ki, kd);
+    PidPublishConfig(p_loop, idx);
+    OS_SchedUnlock();
+}
+
+void OS_PidReset(OS_PidLoop *p_loop)
+{
+    OS_SchedLock();
+    p_loop->ResetRequest++;
+    OS_SchedUnlock();
+}
+
+void OS_PidResetStats(OS_PidLoop *p_loop)
+{
+    OS_SchedLock();
+    p_loop->StatsResetRequest++;
+    OS_SchedUnlock();
+}
+
+void OS_PidGetTelemetry(OS_PidLoop *p_loop, OS_PidTelemetry *p_tel)
+{
+    uint32_t seq;
+
+    do
+    {
+        // 中断总是整段写完才返回，任务看到的序号前后不一致就说明中途被打断了
+        seq = p_loop->TelemetrySeq;
+        __DMB();
+        *p_tel = p_loop->Telemetry;
+        __DMB();
+    } while ((seq & 1u) != 0 || seq != p_loop->TelemetrySeq);
+}
+
+void OS_Pid_IRQHandler(void)
+{
+    uint32_t now = DWT->CYCCNT;
+    uint32_t period = PidFirstRun ? 0 : now - PidLastCycles;
+    OS_PidLoop *p_loop;
+
+    __HAL_TIM_CLEAR_FLAG(&PidTimerHandle, TIM_FLAG_UPDATE);
+    PidLastCycles = now;
+    PidFirstRun = 0;
+
+    // 不调用任何 OS_ 函数：这里在内核天花板之上，内核数据可能正处于修改中途
+    for (p_loop = PidLoopListHead; p_loop != NULL; p_loop = p_loop->Next)
+    {
+        PidRun(p_loop, period);
+    }
+}
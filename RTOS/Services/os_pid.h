@@ -0,0 +1,140 @@
+/**
+ ******************************************************************************
+ * @file    os_pid.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   硬实时 PID 控制环服务 (arm_pid_q31，TIM1 中断驱动)
+ *
+ * - 控制环在 TIM1 更新中断里执行，优先级高于内核中断天花板，
+ *   内核临界区、任务切换都不会推迟它
+ * - 中断里不调用任何 OS_ 函数，和任务之间只通过无锁结构交换数据：
+ *   设定值/增益用双缓冲（任务写非活动份，再切换索引），
+ *   遥测和抖动统计用顺序锁（中断写，任务读到不一致就重读）
+ * - 用 DWT 周期计数器记录相邻两次执行的间隔和每次执行的耗时
+ * - 使用时在 stm32f1xx_it.c 里添加 TIM1_UP_IRQHandler 调用 OS_Pid_IRQHandler
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_PID_H
+#define __OS_PID_H
+
+#include "os_core.h"
+#include "arm_math.h"
+#include "stm32f1xx_hal.h"
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#ifndef OS_PID_IRQ_PRIO
+#define OS_PID_IRQ_PRIO  1u  ///< TIM1 更新中断的优先级，必须高于内核天花板
+#endif
+
+#if (OS_PID_IRQ_PRIO >= OS_CFG_MAX_SYSCALL_PRIO)
+#error "OS_PID_IRQ_PRIO must be above the kernel ceiling (numerically below OS_CFG_MAX_SYSCALL_PRIO)"
+#endif
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  设定值和增益（双缓冲的一份）
+ */
+typedef struct
+{
+    q31_t Setpoint;                      ///< 设定值
+    q31_t A0;                            ///< arm_pid_init_q31 导出的系数，由任务一侧预先算好
+    q31_t A1;
+    q31_t A2;
+} OS_PidConfig;
+
+/**
+ * @brief  遥测快照
+ */
+typedef struct
+{
+    q31_t Setpoint;                      ///< 本次使用的设定值
+    q31_t Measurement;                   ///< 本次采样值
+    q31_t Output;                        ///< 本次输出
+    uint32_t Iterations;                 ///< 已执行的次数
+    uint32_t PeriodMin;                  ///< 相邻两次执行的最短间隔（CPU 周期）
+    uint32_t PeriodMax;                  ///< 相邻两次执行的最长间隔（CPU 周期）
+    uint32_t ExecMax;                    ///< 单次执行的最长耗时（CPU 周期）
+} OS_PidTelemetry;
+
+/**
+ * @brief  控制环结构体定义
+ */
+typedef struct Pid_Loop
+{
+    arm_pid_instance_q31 Pid;            ///< CMSIS-DSP PID 实例，只由中断访问
+    q31_t (*ReadInput)(void *arg);       ///< 读取反馈量（在中断里调用）
+    void (*WriteOutput)(q31_t out, void *arg); ///< 输出控制量（在中断里调用）
+    void *Arg;                           ///< 回调参数
+
+    OS_PidConfig Config[2];              ///< 设定值/增益双缓冲
+    volatile uint8_t ConfigActive;       ///< 中断正在使用的那一份
+
+    volatile uint32_t ResetRequest;      ///< 任务请求清积分的次数
+    uint32_t ResetAck;                   ///< 中断已经处理的次数
+
+    volatile uint32_t TelemetrySeq;      ///< 顺序锁：奇数表示中断正在写
+    OS_PidTelemetry Telemetry;           ///< 遥测
+    volatile uint32_t StatsResetRequest; ///< 任务请求清抖动统计的次数
+    uint32_t StatsResetAck;              ///< 中断已经处理的次数
+
+    struct Pid_Loop *Next;               ///< 指向同一个中断里的下一个控制环
+} OS_PidLoop;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化控制环
+ * @param  read_input  : 读取反馈量的回调
+ * @param  write_output: 输出控制量的回调
+ * @param  kp/ki/kd    : q31 增益
+ */
+void OS_PidLoopInit(OS_PidLoop *p_loop, q31_t (*read_input)(void *), void (*write_output)(q31_t, void *),
+                    void *arg, q31_t kp, q31_t ki, q31_t kd);
+
+/**
+ * @brief  把控制环挂到 TIM1 中断里（运行中也可以添加）
+ */
+void OS_PidAdd(OS_PidLoop *p_loop);
+
+/**
+ * @brief  配置 TIM1 并开始以 rate_hz 的频率执行所有控制环
+ * @return uint8_t: 1 成功，0 频率无法实现
+ */
+uint8_t OS_PidStart(uint32_t rate_hz);
+
+/**
+ * @brief  修改设定值（任务里调用，下一次执行生效）
+ */
+void OS_PidSetSetpoint(OS_PidLoop *p_loop, q31_t setpoint);
+
+/**
+ * @brief  修改增益（任务里调用，下一次执行生效，不清积分）
+ */
+void OS_PidSetGains(OS_PidLoop *p_loop, q31_t kp, q31_t ki, q31_t kd);
+
+/**
+ * @brief  请求清除 PID 状态（积分和历史误差）
+ */
+void OS_PidReset(OS_PidLoop *p_loop);
+
+/**
+ * @brief  读取一份一致的遥测快照
+ */
+void OS_PidGetTelemetry(OS_PidLoop *p_loop, OS_PidTelemetry *p_tel);
+
+/**
+ * @brief  请求清除抖动统计
+ */
+void OS_PidResetStats(OS_PidLoop *p_loop);
+
+/**
+ * @brief  TIM1 更新中断入口，由 TIM1_UP_IRQHandler 调用
+ */
+void OS_Pid_IRQHandler(void);
+
+#endif /* __OS_PID_H */
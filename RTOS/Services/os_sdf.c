@@ -0,0 +1,420 @@
+/**
+ ******************************************************************************
+ * @file    os_sdf.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   同步数据流 (SDF) 图运行时实现
+ *
+ * 重复向量：
+ * - 对每条边有 rep(src) * produce = rep(dst) * consume
+ * - 从第一个节点 (rep = 1) 出发沿边传播分数解，再乘以分母的最小公倍数、
+ *   除以整体的最大公约数，得到最小的正整数解；最后逐条边复核平衡方程
+ *
+ * 单次出现调度：
+ * - 拓扑序里每个节点连续点火 Repetition 次。生产者一个周期内先把边写满，
+ *   消费者再全部读完，所以每个周期边缓冲都从头开始用，不需要环形回绕，
+ *   点火函数拿到的总是连续的一段
+ *
+ ******************************************************************************
+ */
+
+#include "os_sdf.h"
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t Gcd(uint32_t a, uint32_t b)
+{
+    uint32_t t;
+
+    while (b != 0)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 解平衡方程，结果写入各节点的 Repetition
+static uint8_t SdfSolveRepetition(OS_SdfGraph *p_graph)
+{
+    uint32_t num[OS_SDF_MAX_NODES];
+    uint32_t den[OS_SDF_MAX_NODES];
+    uint32_t lcm = 1;
+    uint32_t g = 0;
+    uint32_t n, d, k;
+    uint8_t i, s, t, changed;
+    OS_SdfEdge *e;
+
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        num[i] = 0; // 0 表示还没求出
+        den[i] = 1;
+        p_graph->Nodes[i]->Repetition = i; // 暂存下标，下面用来由节点找回下标
+    }
+    num[0] = 1;
+
+    // 1. 沿边传播分数解，直到不再变化
+    do
+    {
+        changed = 0;
+        for (i = 0; i < p_graph->NumEdges; i++)
+        {
+            e = p_graph->Edges[i];
+            s = (uint8_t)e->Src->Repetition;
+            t = (uint8_t)e->Dst->Repetition;
+            if (num[s] != 0 && num[t] == 0)
+            {
+                n = num[s] * e->Src->Produce[e->SrcPort];
+                d = den[s] * e->Dst->Consume[e->DstPort];
+                k = Gcd(n, d);
+                num[t] = n / k;
+                den[t] = d / k;
+                changed = 1;
+            }
+            else if (num[t] != 0 && num[s] == 0)
+            {
+                n = num[t] * e->Dst->Consume[e->DstPort];
+                d = den[t] * e->Src->Produce[e->SrcPort];
+                k = Gcd(n, d);
+                num[s] = n / k;
+                den[s] = d / k;
+                changed = 1;
+            }
+        }
+    } while (changed);
+
+    // 2. 化成最小正整数解
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        if (num[i] == 0) // 图不连通
+            return 0;
+        lcm = lcm / Gcd(lcm, den[i]) * den[i];
+    }
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        num[i] = num[i] * (lcm / den[i]);
+        g = Gcd(g, num[i]);
+    }
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        p_graph->Nodes[i]->Repetition = num[i] / g;
+    }
+
+    // 3. 复核：速率不一致的图（例如两条路径汇合处比例对不上）没有解
+    for (i = 0; i < p_graph->NumEdges; i++)
+    {
+        e = p_graph->Edges[i];
+        if (e->Src->Repetition * e->Src->Produce[e->SrcPort] != e->Dst->Repetition * e->Dst->Consume[e->DstPort])
+            return 0;
+    }
+
+    return 1;
+}
+
+// Kahn 算法求拓扑序，有环返回 0
+static uint8_t SdfSort(OS_SdfGraph *p_graph)
+{
+    uint8_t indegree[OS_SDF_MAX_NODES];
+    uint8_t count = 0;
+    uint8_t i, j, k, done;
+    OS_SdfNode *node;
+
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        indegree[i] = p_graph->Nodes[i]->NumIn;
+    }
+
+    while (count < p_graph->NumNodes)
+    {
+        done = 0;
+        for (i = 0; i < p_graph->NumNodes; i++)
+        {
+            if (indegree[i] != 0)
+                continue;
+
+            // 入度为 0：排进调度，删掉它的输出边
+            indegree[i] = 0xFF;
+            p_graph->Order[count++] = i;
+            node = p_graph->Nodes[i];
+            for (j = 0; j < node->NumOut; j++)
+            {
+                for (k = 0; k < p_graph->NumNodes; k++)
+                {
+                    if (p_graph->Nodes[k] == node->Out[j]->Dst)
+                        indegree[k]--;
+                }
+            }
+            done = 1;
+        }
+        if (!done) // 剩下的节点都在环上
+            return 0;
+    }
+
+    return 1;
+}
+
+static void *SdfReadPtr(OS_SdfEdge *e)
+{
+    return &e->Buffer[e->ReadSlot * e->PeriodBytes + e->ReadPos];
+}
+
+static void *SdfWritePtr(OS_SdfEdge *e)
+{
+    return &e->Buffer[e->WriteSlot * e->PeriodBytes + e->WritePos];
+}
+
+// 把已经拿到的前 num_in 个输入、num_out 个输出缓冲原样还回去（不推进份号）
+static void SdfGiveBack(OS_SdfNode *node, uint8_t num_in, uint8_t num_out)
+{
+    uint8_t p;
+
+    for (p = 0; p < num_in; p++)
+    {
+        if (node->In[p]->CrossStage)
+            OS_SemPost(&node->In[p]->Full);
+    }
+    for (p = 0; p < num_out; p++)
+    {
+        if (node->Out[p]->CrossStage)
+            OS_SemPost(&node->Out[p]->Empty);
+    }
+}
+
+// 把节点连续点火 Repetition 次
+// 返回 0 表示缓冲没拿齐（不能阻塞的上下文里对方还没交出来），节点没有点火
+static uint8_t SdfFireNode(OS_SdfNode *node)
+{
+    void *in[OS_SDF_MAX_PORTS];
+    void *out[OS_SDF_MAX_PORTS];
+    OS_SdfEdge *e;
+    uint32_t r;
+    uint8_t p;
+
+    // 1. 拿到本周期的缓冲：跨级的边要等对方交出来
+    for (p = 0; p < node->NumIn; p++)
+    {
+        e = node->In[p];
+        if (e->CrossStage && !OS_SemWait(&e->Full))
+        {
+            SdfGiveBack(node, p, 0);
+            return 0;
+        }
+        e->ReadPos = 0;
+    }
+    for (p = 0; p < node->NumOut; p++)
+    {
+        e = node->Out[p];
+        if (e->CrossStage && !OS_SemWait(&e->Empty))
+        {
+            SdfGiveBack(node, node->NumIn, p);
+            return 0;
+        }
+        e->WritePos = 0;
+    }
+
+    // 2. 点火
+    for (r = 0; r < node->Repetition; r++)
+    {
+        for (p = 0; p < node->NumIn; p++)
+            in[p] = SdfReadPtr(node->In[p]);
+        for (p = 0; p < node->NumOut; p++)
+            out[p] = SdfWritePtr(node->Out[p]);
+
+        node->Fire(node, in, out);
+
+        for (p = 0; p < node->NumIn; p++)
+            node->In[p]->ReadPos += node->Consume[p] * node->In[p]->ItemSize;
+        for (p = 0; p < node->NumOut; p++)
+            node->Out[p]->WritePos += node->Produce[p] * node->Out[p]->ItemSize;
+    }
+
+    // 3. 交出缓冲
+    for (p = 0; p < node->NumOut; p++)
+    {
+        e = node->Out[p];
+        if (e->CrossStage)
+        {
+            e->WriteSlot = (uint8_t)((e->WriteSlot + 1) % e->Slots);
+            OS_SemPost(&e->Full);
+        }
+    }
+    for (p = 0; p < node->NumIn; p++)
+    {
+        e = node->In[p];
+        if (e->CrossStage)
+        {
+            e->ReadSlot = (uint8_t)((e->ReadSlot + 1) % e->Slots);
+            OS_SemPost(&e->Empty);
+        }
+    }
+
+    return 1;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void OS_SdfNodeInit(OS_SdfNode *p_node, void (*fire)(OS_SdfNode *, void *const *, void *const *),
+                    void *instance, uint32_t param, uint8_t stage)
+{
+    uint8_t p;
+
+    p_node->Fire = fire;
+    p_node->Instance = instance;
+    p_node->Param = param;
+    p_node->NumIn = 0;
+    p_node->NumOut = 0;
+    p_node->Stage = stage;
+    p_node->Repetition = 0;
+    for (p = 0; p < OS_SDF_MAX_PORTS; p++)
+    {
+        p_node->Consume[p] = 0;
+        p_node->Produce[p] = 0;
+        p_node->In[p] = NULL;
+        p_node->Out[p] = NULL;
+    }
+}
+
+void OS_SdfConnect(OS_SdfEdge *p_edge, OS_SdfNode *src, uint8_t src_port,
+                   OS_SdfNode *dst, uint8_t dst_port,
+                   void *buffer, uint32_t capacity, uint16_t item_size)
+{
+    p_edge->Src = src;
+    p_edge->Dst = dst;
+    p_edge->SrcPort = src_port;
+    p_edge->DstPort = dst_port;
+    p_edge->Buffer = (uint8_t *)buffer;
+    p_edge->Capacity = capacity;
+    p_edge->ItemSize = item_size;
+
+    src->Out[src_port] = p_edge;
+    if (src->NumOut <= src_port)
+        src->NumOut = src_port + 1;
+
+    dst->In[dst_port] = p_edge;
+    if (dst->NumIn <= dst_port)
+        dst->NumIn = dst_port + 1;
+}
+
+uint8_t OS_SdfGraphInit(OS_SdfGraph *p_graph, OS_SdfNode **nodes, uint8_t num_nodes,
+                        OS_SdfEdge **edges, uint8_t num_edges)
+{
+    OS_SdfEdge *e;
+    uint8_t i;
+
+    if (num_nodes == 0 || num_nodes > OS_SDF_MAX_NODES)
+        return 0;
+
+    p_graph->Nodes = nodes;
+    p_graph->NumNodes = num_nodes;
+    p_graph->Edges = edges;
+    p_graph->NumEdges = num_edges;
+
+    // 1. 重复向量和静态调度
+    if (!SdfSolveRepetition(p_graph) || !SdfSort(p_graph))
+        return 0;
+
+    // 2. 每条边至少要放得下一个周期；跨级的边放得下两个周期就双缓冲
+    for (i = 0; i < num_edges; i++)
+    {
+        e = edges[i];
+        e->PeriodBytes = e->Src->Repetition * e->Src->Produce[e->SrcPort] * e->ItemSize;
+        if (e->PeriodBytes == 0 || e->Capacity < e->PeriodBytes)
+            return 0;
+
+        e->CrossStage = (e->Src->Stage != e->Dst->Stage);
+        e->Slots = (e->CrossStage && e->Capacity >= 2 * e->PeriodBytes) ? 2 : 1;
+        e->WriteSlot = 0;
+        e->ReadSlot = 0;
+        e->WritePos = 0;
+        e->ReadPos = 0;
+
+        e->Full.count = 0;
+        e->Full.WaitListHead = NULL;
+        e->Full.WaitListTail = NULL;
+        e->Empty.count = e->Slots;
+        e->Empty.WaitListHead = NULL;
+        e->Empty.WaitListTail = NULL;
+    }
+
+    return 1;
+}
+
+uint8_t OS_SdfRunStage(OS_SdfGraph *p_graph, uint8_t stage)
+{
+    OS_SdfNode *node;
+    uint8_t i;
+
+    // 1. 分级运行要靠阻塞等对方；中断里或调度器上锁时 OS_SemWait 不会等，直接返回 0
+    //    整张图在一个任务里跑时缓冲总是现成的，不会阻塞
+    if (stage != OS_SDF_ALL_STAGES && (OS_CPU_InISR() || g_SchedLockNesting > 0))
+        return 0;
+
+    // 2. 按拓扑序点火
+    for (i = 0; i < p_graph->NumNodes; i++)
+    {
+        node = p_graph->Nodes[p_graph->Order[i]];
+        if (stage == OS_SDF_ALL_STAGES || node->Stage == stage)
+        {
+            if (!SdfFireNode(node))
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* CMSIS-DSP 节点包装 ------------------------------------------------------ */
+
+static void SdfFireFirDecimateQ15(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    arm_fir_decimate_q15((const arm_fir_decimate_instance_q15 *)node->Instance,
+                         (q15_t *)in[0], (q15_t *)out[0], node->Param);
+}
+
+static void SdfFireBiquadDf1Q15(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    arm_biquad_cascade_df1_q15((const arm_biquad_casd_df1_inst_q15 *)node->Instance,
+                               (q15_t *)in[0], (q15_t *)out[0], node->Param);
+}
+
+static void SdfFireRfftQ15(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    arm_rfft_q15((const arm_rfft_instance_q15 *)node->Instance, (q15_t *)in[0], (q15_t *)out[0]);
+}
+
+static void SdfFireCmplxMagQ15(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    arm_cmplx_mag_q15((q15_t *)in[0], (q15_t *)out[0], node->Param);
+}
+
+void OS_SdfFirDecimateQ15Init(OS_SdfNode *p_node, arm_fir_decimate_instance_q15 *s,
+                              uint32_t block_size, uint8_t stage)
+{
+    OS_SdfNodeInit(p_node, SdfFireFirDecimateQ15, s, block_size, stage);
+    p_node->Consume[0] = (uint16_t)block_size;
+    p_node->Produce[0] = (uint16_t)(block_size / s->M);
+}
+
+void OS_SdfBiquadDf1Q15Init(OS_SdfNode *p_node, arm_biquad_casd_df1_inst_q15 *s,
+                            uint32_t block_size, uint8_t stage)
+{
+    OS_SdfNodeInit(p_node, SdfFireBiquadDf1Q15, s, block_size, stage);
+    p_node->Consume[0] = (uint16_t)block_size;
+    p_node->Produce[0] = (uint16_t)block_size;
+}
+
+void OS_SdfRfftQ15Init(OS_SdfNode *p_node, arm_rfft_instance_q15 *s, uint8_t stage)
+{
+    OS_SdfNodeInit(p_node, SdfFireRfftQ15, s, s->fftLenReal, stage);
+    p_node->Consume[0] = (uint16_t)s->fftLenReal;
+    p_node->Produce[0] = (uint16_t)(2 * s->fftLenReal);
+}
+
+void OS_SdfCmplxMagQ15Init(OS_SdfNode *p_node, uint32_t num_samples, uint8_t stage)
+{
+    OS_SdfNodeInit(p_node, SdfFireCmplxMagQ15, NULL, num_samples, stage);
+    p_node->Consume[0] = (uint16_t)(2 * num_samples);
+    p_node->Produce[0] = (uint16_t)num_samples;
+}
@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file    os_sdf.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   同步数据流 (SDF) 图运行时，用来串联 CMSIS-DSP 的块处理函数
+ *
+ * - 节点包装一个块处理函数，每个端口每次点火消耗/产生固定数量的样点
+ * - 边是固定大小的缓冲区，由调用者静态分配，运行时不做任何动态分配
+ * - 初始化时解平衡方程得到重复向量，再按拓扑序排出静态调度：
+ *   每个周期按顺序把每个节点连续点火 Repetition 次（单次出现调度）
+ * - 节点可以分到不同的级 (Stage)，每级由一个任务运行；跨级的边用
+ *   满/空两个信号量交接，给两份周期缓冲时两级可以流水并行
+ *
+ * 限制：图必须连通且无环（不支持带延迟的反馈边）
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_SDF_H
+#define __OS_SDF_H
+
+#include "os_core.h"
+#include "arm_math.h"
+
+/* 配置项 ------------------------------------------------------------------ */
+
+#ifndef OS_SDF_MAX_PORTS
+#define OS_SDF_MAX_PORTS  2u   ///< 每个节点最多的输入/输出端口数
+#endif
+
+#ifndef OS_SDF_MAX_NODES
+#define OS_SDF_MAX_NODES  16u  ///< 一张图最多的节点数
+#endif
+
+#define OS_SDF_ALL_STAGES 0xFFu ///< OS_SdfRunStage 的参数：在当前任务里跑完整张图
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+struct Sdf_Edge;
+
+/**
+ * @brief  节点结构体定义
+ * @note   Fire 每次被调用时，in[i]/out[i] 指向端口 i 本次要消耗/产生的连续样点
+ */
+typedef struct Sdf_Node
+{
+    void (*Fire)(struct Sdf_Node *node, void *const *in, void *const *out); ///< 点火函数
+    void *Instance;                              ///< CMSIS-DSP 实例或用户数据
+    uint32_t Param;                              ///< 点火函数的附加参数（块长等）
+    uint16_t Consume[OS_SDF_MAX_PORTS];          ///< 每个输入端口每次消耗的样点数
+    uint16_t Produce[OS_SDF_MAX_PORTS];          ///< 每个输出端口每次产生的样点数
+    uint8_t NumIn;                               ///< 输入端口数（OS_SdfConnect 维护）
+    uint8_t NumOut;                              ///< 输出端口数（OS_SdfConnect 维护）
+    uint8_t Stage;                               ///< 所在的级
+    struct Sdf_Edge *In[OS_SDF_MAX_PORTS];       ///< 输入边
+    struct Sdf_Edge *Out[OS_SDF_MAX_PORTS];      ///< 输出边
+    uint32_t Repetition;                         ///< 每个周期的点火次数（OS_SdfGraphInit 计算）
+} OS_SdfNode;
+
+/**
+ * @brief  边结构体定义
+ */
+typedef struct Sdf_Edge
+{
+    OS_SdfNode *Src;                             ///< 生产者
+    OS_SdfNode *Dst;                             ///< 消费者
+    uint8_t SrcPort;                             ///< 生产者的输出端口
+    uint8_t DstPort;                             ///< 消费者的输入端口
+    uint16_t ItemSize;                           ///< 每个样点的字节数
+    uint8_t *Buffer;                             ///< 缓冲区
+    uint32_t Capacity;                           ///< 缓冲区字节数
+    uint32_t PeriodBytes;                        ///< 一个周期流过的字节数（OS_SdfGraphInit 计算）
+    uint8_t Slots;                               ///< 周期缓冲的份数：同级为 1，跨级最多 2
+    uint8_t CrossStage;                          ///< 两端是否在不同的级
+    uint8_t WriteSlot;                           ///< 生产者正在写的那份
+    uint8_t ReadSlot;                            ///< 消费者正在读的那份
+    uint32_t WritePos;                           ///< 本周期已写入的字节数
+    uint32_t ReadPos;                            ///< 本周期已读出的字节数
+    OS_Sem Full;                                 ///< 写满的份数（跨级时使用）
+    OS_Sem Empty;                                ///< 空闲的份数（跨级时使用）
+} OS_SdfEdge;
+
+/**
+ * @brief  图结构体定义
+ */
+typedef struct Sdf_Graph
+{
+    OS_SdfNode **Nodes;                          ///< 节点表
+    uint8_t NumNodes;                            ///< 节点数
+    OS_SdfEdge **Edges;                          ///< 边表
+    uint8_t NumEdges;                            ///< 边数
+    uint8_t Order[OS_SDF_MAX_NODES];             ///< 静态调度：节点的点火顺序
+} OS_SdfGraph;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化节点（速率由调用者随后写入 Consume/Produce，或用下面的包装函数）
+ */
+void OS_SdfNodeInit(OS_SdfNode *p_node, void (*fire)(OS_SdfNode *, void *const *, void *const *),
+                    void *instance, uint32_t param, uint8_t stage);
+
+/**
+ * @brief  用边把 src 的输出端口连到 dst 的输入端口
+ * @param  buffer  : 边缓冲区，至少一个周期的数据量；跨级时给两个周期可以流水
+ * @param  capacity: 缓冲区字节数
+ * @param  item_size: 每个样点的字节数
+ */
+void OS_SdfConnect(OS_SdfEdge *p_edge, OS_SdfNode *src, uint8_t src_port,
+                   OS_SdfNode *dst, uint8_t dst_port,
+                   void *buffer, uint32_t capacity, uint16_t item_size);
+
+/**
+ * @brief  计算重复向量和静态调度，检查缓冲区大小
+ * @return uint8_t: 1 成功；0 图不连通、有环、速率不一致或缓冲区不够一个周期
+ */
+uint8_t OS_SdfGraphInit(OS_SdfGraph *p_graph, OS_SdfNode **nodes, uint8_t num_nodes,
+                        OS_SdfEdge **edges, uint8_t num_edges);
+
+/**
+ * @brief  运行某一级的一个周期（跨级的边会阻塞等待对方）
+ * @param  stage  : 级号，OS_SDF_ALL_STAGES 表示在当前任务里按顺序跑完整张图
+ * @return uint8_t: 1 完成；0 在中断里或调度器上锁时运行单独的一级（不能阻塞），
+ *                  什么也没做
+ * @note   分级运行只能在任务里、调度器没有上锁时调用
+ */
+uint8_t OS_SdfRunStage(OS_SdfGraph *p_graph, uint8_t stage);
+
+/* CMSIS-DSP 节点包装 ------------------------------------------------------ */
+
+/**
+ * @brief  FIR 抽取：每次消耗 block_size 个样点，产生 block_size / M 个
+ */
+void OS_SdfFirDecimateQ15Init(OS_SdfNode *p_node, arm_fir_decimate_instance_q15 *s,
+                              uint32_t block_size, uint8_t stage);
+
+/**
+ * @brief  DF1 双二阶级联：每次消耗、产生 block_size 个样点
+ */
+void OS_SdfBiquadDf1Q15Init(OS_SdfNode *p_node, arm_biquad_casd_df1_inst_q15 *s,
+                            uint32_t block_size, uint8_t stage);
+
+/**
+ * @brief  实数 FFT：每次消耗 fftLenReal 个样点，产生 2 * fftLenReal 个（交织的复数）
+ * @note   arm_rfft_q15 会改写输入，输入边的数据本来就被消耗掉了，不受影响
+ */
+void OS_SdfRfftQ15Init(OS_SdfNode *p_node, arm_rfft_instance_q15 *s, uint8_t stage);
+
+/**
+ * @brief  复数求模：每次消耗 2 * num_samples 个样点，产生 num_samples 个
+ */
+void OS_SdfCmplxMagQ15Init(OS_SdfNode *p_node, uint32_t num_samples, uint8_t stage);
+
+#endif /* __OS_SDF_H */
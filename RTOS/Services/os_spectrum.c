@@ -0,0 +1,331 @@
+/**
+ ******************************************************************************
+ * @file    os_spectrum.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   连续频谱分析服务实现
+ *
+ * 一帧 N 个样点 = 上一帧留下的 Overlap 个历史样点 + 队列里 Hop 个新样点：
+ * - 历史区循环使用，HistoryPos 指向最旧的样点，乘窗时分两段读出
+ * - 新样点在环形缓冲区里最多分成两段（绕回处），直接乘窗写进帧缓冲
+ * - 算完后只把下一帧要用的 min(Hop, Overlap) 个新样点存进历史区，
+ *   再把 Hop 个样点从队列里消费掉
+ *
+ ******************************************************************************
+ */
+
+#include "os_spectrum.h"
+#include "os_time.h"
+#include <string.h>
+
+/* 私有数据结构 ------------------------------------------------------ */
+
+/**
+ * @brief  本帧新样点在环形缓冲区里的位置（绕回时分两段）
+ */
+typedef struct
+{
+    const uint8_t *Data[2];
+    uint16_t Count[2];
+} SpectrumBlock;
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+/**
+ * @brief  src 乘窗后写到帧缓冲的 [pos, pos + count)
+ */
+static void SpectrumWindow(OS_Spectrum *p_spec, const uint8_t *src, uint16_t pos, uint16_t count)
+{
+    if (count == 0)
+        return;
+
+    if (p_spec->Format == OS_SPECTRUM_F32)
+        arm_mult_f32((float32_t *)src, (float32_t *)p_spec->Window + pos, (float32_t *)p_spec->Frame + pos, count);
+    else
+        arm_mult_q15((q15_t *)src, (q15_t *)p_spec->Window + pos, (q15_t *)p_spec->Frame + pos, count);
+}
+
+/**
+ * @brief  把新样点 [from, from + count) 存进历史区，从 HistoryPos 开始循环写
+ */
+static void SpectrumSaveHistory(OS_Spectrum *p_spec, const SpectrumBlock *blk, uint16_t from, uint16_t count)
+{
+    uint8_t ss = p_spec->SampleSize;
+    uint8_t *history = (uint8_t *)p_spec->History;
+    uint16_t pos = p_spec->HistoryPos;
+
+    while (count > 0)
+    {
+        uint8_t seg = (from < blk->Count[0]) ? 0u : 1u;
+        uint16_t off = (seg == 0u) ? from : (uint16_t)(from - blk->Count[0]);
+        uint16_t n = blk->Count[seg] - off;
+
+        if (n > count)
+            n = count;
+        if (n > p_spec->Overlap - pos)
+            n = p_spec->Overlap - pos;
+
+        memcpy(history + (uint32_t)pos * ss, blk->Data[seg] + (uint32_t)off * ss, (uint32_t)n * ss);
+
+        from += n;
+        count -= n;
+        pos += n;
+        if (pos == p_spec->Overlap)
+            pos = 0;
+    }
+
+    p_spec->HistoryPos = pos;
+}
+
+/**
+ * @brief  由 FFT 输出算幅度谱
+ */
+static void SpectrumMagnitude(OS_Spectrum *p_spec, void *magnitude)
+{
+    uint16_t half = p_spec->FftLen / 2u;
+
+    if (p_spec->Format == OS_SPECTRUM_F32)
+    {
+        // arm_rfft_fast_f32 的打包格式：[0] 直流实部，[1] 奈奎斯特实部，之后是 1..N/2-1 的复数
+        float32_t *spec = (float32_t *)p_spec->Spectrum;
+        float32_t *mag = (float32_t *)magnitude;
+
+        mag[0] = fabsf(spec[0]);
+        arm_cmplx_mag_f32(spec + 2, mag + 1, half - 1u);
+        mag[half] = fabsf(spec[1]);
+    }
+    else
+    {
+        arm_cmplx_mag_q15((q15_t *)p_spec->Spectrum, (q15_t *)magnitude, half + 1u);
+    }
+}
+
+/**
+ * @brief  处理一帧：队列里至少已有 Hop 个样点
+ */
+static void SpectrumFrame(OS_Spectrum *p_spec)
+{
+    uint8_t ss = p_spec->SampleSize;
+    uint16_t overlap = p_spec->Overlap;
+    uint16_t hop = p_spec->Hop;
+    uint16_t older = overlap - p_spec->HistoryPos;
+    uint8_t *history = (uint8_t *)p_spec->History;
+    uint8_t *span;
+    uint32_t bytes;
+    uint8_t back;
+    SpectrumBlock blk;
+    uint64_t start = OS_TimeNowCycles();
+    uint64_t elapsed;
+
+    // 1. 找到新样点：第一段是当前读位置起的连续区，不够再从存储区开头接上
+    bytes = OS_RingBufReadSpan(&p_spec->Ring, &span);
+    blk.Data[0] = span;
+    blk.Count[0] = (bytes >= (uint32_t)hop * ss) ? hop : (uint16_t)(bytes / ss);
+    blk.Data[1] = p_spec->Ring.Buffer;
+    blk.Count[1] = hop - blk.Count[0];
+
+    // 2. 历史（先旧后新）+ 新样点，乘窗拼成一帧
+    SpectrumWindow(p_spec, history + (uint32_t)p_spec->HistoryPos * ss, 0, older);
+    SpectrumWindow(p_spec, history, older, p_spec->HistoryPos);
+    SpectrumWindow(p_spec, blk.Data[0], overlap, blk.Count[0]);
+    SpectrumWindow(p_spec, blk.Data[1], overlap + blk.Count[0], blk.Count[1]);
+
+    // 3. 保存下一帧要用的重叠部分，然后才能把新样点还给生产者
+    if (overlap > 0)
+    {
+        if (hop >= overlap)
+        {
+            p_spec->HistoryPos = 0;
+            SpectrumSaveHistory(p_spec, &blk, hop - overlap, overlap);
+        }
+        else
+        {
+            SpectrumSaveHistory(p_spec, &blk, 0, hop);
+        }
+    }
+    OS_RingBufConsume(&p_spec->Ring, (uint32_t)hop * ss);
+
+    // 4. FFT（会改写帧缓冲）
+    if (p_spec->Format == OS_SPECTRUM_F32)
+        arm_rfft_fast_f32(&p_spec->Fft.F32, (float32_t *)p_spec->Frame, (float32_t *)p_spec->Spectrum, 0);
+    else
+        arm_rfft_q15(&p_spec->Fft.Q15, (q15_t *)p_spec->Frame, (q15_t *)p_spec->Spectrum);
+
+    // 5. 写到后台那一份，顺序锁保护，写完翻转 Front
+    back = p_spec->Front ^ 1u;
+    p_spec->MagSeq[back]++;
+    OS_CPU_DMB();
+    SpectrumMagnitude(p_spec, p_spec->Magnitude[back]);
+    p_spec->MagFrame[back] = p_spec->Frames + 1u;
+    OS_CPU_DMB();
+    p_spec->MagSeq[back]++;
+    p_spec->Front = back;
+    p_spec->Frames++;
+
+    // 6. 发布
+    if (p_spec->Publish != NULL)
+        p_spec->Publish(p_spec->Magnitude[back], p_spec->Frames, p_spec->Arg);
+
+    elapsed = OS_TimeNowCycles() - start;
+    if (elapsed > p_spec->MaxCycles)
+        p_spec->MaxCycles = elapsed;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_SpectrumInit(OS_Spectrum *p_spec, uint8_t format, uint16_t fft_len, uint16_t hop,
+                        const void *window, void *work, uint8_t *ring_buf, uint32_t ring_size)
+{
+    uint8_t ss;
+    uint8_t *w = (uint8_t *)work;
+    uint16_t bins = OS_SPECTRUM_BINS(fft_len);
+
+    // 1. 参数检查（FFT 长度由 CMSIS 的初始化函数检查）
+    if (format == OS_SPECTRUM_F32)
+        ss = sizeof(float32_t);
+    else if (format == OS_SPECTRUM_Q15)
+        ss = sizeof(q15_t);
+    else
+        return 0;
+
+    if (hop == 0 || hop > fft_len || ring_size < (uint32_t)hop * ss)
+        return 0;
+
+    // 2. FFT 实例：旋转因子和位反转表都指向 CMSIS 的常量表
+    if (format == OS_SPECTRUM_F32)
+    {
+        if (arm_rfft_fast_init_f32(&p_spec->Fft.F32, fft_len) != ARM_MATH_SUCCESS)
+            return 0;
+    }
+    else
+    {
+        if (arm_rfft_init_q15(&p_spec->Fft.Q15, fft_len, 0, 1) != ARM_MATH_SUCCESS)
+            return 0;
+    }
+
+    // 3. 样点队列，攒够一帧的新样点才唤醒分析任务
+    if (!OS_RingBufInit(&p_spec->Ring, ring_buf, ring_size, (uint32_t)hop * ss))
+        return 0;
+
+    p_spec->Format = format;
+    p_spec->SampleSize = ss;
+    p_spec->FftLen = fft_len;
+    p_spec->Hop = hop;
+    p_spec->Overlap = fft_len - hop;
+    p_spec->HistoryPos = 0;
+    p_spec->Window = window;
+
+    // 4. 切分工作区，布局见 OS_SPECTRUM_WORK_SIZE_F32/_Q15
+    p_spec->Frame = w;
+    w += (uint32_t)fft_len * ss;
+    p_spec->Spectrum = w;
+    w += (uint32_t)fft_len * ss * ((format == OS_SPECTRUM_F32) ? 1u : 2u);
+    p_spec->Magnitude[0] = w;
+    w += (uint32_t)bins * ss;
+    p_spec->Magnitude[1] = w;
+    w += (uint32_t)bins * ss;
+    p_spec->History = w;
+    memset(p_spec->History, 0, (uint32_t)p_spec->Overlap * ss);
+
+    p_spec->MagSeq[0] = 0;
+    p_spec->MagSeq[1] = 0;
+    p_spec->MagFrame[0] = 0;
+    p_spec->MagFrame[1] = 0;
+    p_spec->Front = 0;
+    p_spec->Publish = NULL;
+    p_spec->Arg = NULL;
+    p_spec->Frames = 0;
+    p_spec->Dropped = 0;
+    p_spec->MaxCycles = 0;
+
+    return 1;
+}
+
+void OS_SpectrumSetPublish(OS_Spectrum *p_spec, void (*publish)(const void *, uint32_t, void *), void *arg)
+{
+    p_spec->Arg = arg;
+    p_spec->Publish = publish;
+}
+
+void OS_SpectrumHann(uint8_t format, void *window, uint16_t fft_len)
+{
+    uint16_t i;
+
+    // 周期 Hann 窗：w[k] = 0.5 - 0.5 cos(2 pi k / N)，重叠 50% 时相邻帧的窗相加为常数
+    for (i = 0; i < fft_len; i++)
+    {
+        float32_t v = 0.5f - 0.5f * arm_cos_f32(2.0f * PI * (float32_t)i / (float32_t)fft_len);
+
+        if (format == OS_SPECTRUM_F32)
+            ((float32_t *)window)[i] = v;
+        else
+            arm_float_to_q15(&v, (q15_t *)window + i, 1);
+    }
+}
+
+uint32_t OS_SpectrumWrite(OS_Spectrum *p_spec, const void *samples, uint32_t count)
+{
+    uint32_t ss = p_spec->SampleSize;
+    uint32_t n = OS_RingBufFree(&p_spec->Ring) / ss;
+
+    // 只写整数个样点，保证样点不会被环形缓冲区的绕回处切开
+    if (n > count)
+        n = count;
+    if (n > 0)
+        OS_RingBufWrite(&p_spec->Ring, (const uint8_t *)samples, n * ss);
+    if (n < count)
+        p_spec->Dropped += count - n;
+
+    return n;
+}
+
+uint32_t OS_SpectrumProcess(OS_Spectrum *p_spec)
+{
+    uint32_t frames = 0;
+    uint32_t need = (uint32_t)p_spec->Hop * p_spec->SampleSize;
+
+    while (OS_RingBufCount(&p_spec->Ring) >= need)
+    {
+        SpectrumFrame(p_spec);
+        frames++;
+    }
+
+    return frames;
+}
+
+void OS_SpectrumRun(OS_Spectrum *p_spec)
+{
+    while (1)
+    {
+        // 不能阻塞（例如调度器还没启动）时退化为让出 CPU 轮询
+        if (!OS_RingBufWait(&p_spec->Ring))
+            OS_Yield();
+
+        OS_SpectrumProcess(p_spec);
+    }
+}
+
+uint32_t OS_SpectrumRead(OS_Spectrum *p_spec, void *magnitude)
+{
+    uint32_t bytes = (uint32_t)OS_SPECTRUM_BINS(p_spec->FftLen) * p_spec->SampleSize;
+    uint32_t seq;
+    uint32_t frame;
+    uint8_t front;
+
+    if (p_spec->Frames == 0)
+        return 0;
+
+    // 写者每帧换一份写，读到一半被覆盖的概率很低；万一碰上就重读
+    do
+    {
+        front = p_spec->Front;
+        seq = p_spec->MagSeq[front];
+        OS_CPU_DMB();
+        memcpy(magnitude, p_spec->Magnitude[front], bytes);
+        frame = p_spec->MagFrame[front];
+        OS_CPU_DMB();
+    } while ((seq & 1u) || seq != p_spec->MagSeq[front]);
+
+    return frame;
+}
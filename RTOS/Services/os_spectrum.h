@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file    os_spectrum.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   连续频谱分析服务：分块取样、加窗、实数 FFT、发布幅度谱
+ *
+ * - 样点经环形缓冲区送进来（ADC 中断/DMA 完成回调里调用 OS_SpectrumWrite），
+ *   每攒够 Hop 个新样点算一帧，相邻两帧重叠 FftLen - Hop 个样点
+ * - 支持 float32 (arm_rfft_fast_f32) 和 q15 (arm_rfft_q15) 两种格式
+ * - FFT 实例和全部工作缓冲区在初始化时一次分配好，运行时不再分配
+ * - 新样点直接从环形缓冲区里读出来乘窗，不先拷贝；
+ *   每帧只把下一帧还要用的重叠部分存进历史区
+ * - 幅度谱双缓冲发布：读任务用 OS_SpectrumRead 随时取最新一帧，
+ *   也可以注册回调在分析任务里直接拿到结果
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_SPECTRUM_H
+#define __OS_SPECTRUM_H
+
+#include "os_core.h"
+#include "os_ringbuf.h"
+#include "arm_math.h"
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+#define OS_SPECTRUM_F32 0u   ///< 样点、窗、幅度谱都是 float32_t
+#define OS_SPECTRUM_Q15 1u   ///< 样点、窗、幅度谱都是 q15_t
+
+/**
+ * @brief  幅度谱的点数：直流到奈奎斯特共 FftLen / 2 + 1 个频点
+ */
+#define OS_SPECTRUM_BINS(fft_len) ((fft_len) / 2u + 1u)
+
+/**
+ * @brief  工作区大小（单位：字节）
+ * @note   帧缓冲 | FFT 输出 | 两份幅度谱 | 重叠历史
+ *         float32：帧 N 个，FFT 输出 N 个（打包格式）
+ *         q15    ：帧 N 个，FFT 输出 2N 个（arm_rfft_q15 输出完整的共轭对称谱）
+ */
+#define OS_SPECTRUM_WORK_SIZE_F32(fft_len, hop) \
+    (sizeof(float32_t) * (2u * (fft_len) + 2u * OS_SPECTRUM_BINS(fft_len) + (fft_len) - (hop)))
+#define OS_SPECTRUM_WORK_SIZE_Q15(fft_len, hop) \
+    (sizeof(q15_t) * (3u * (fft_len) + 2u * OS_SPECTRUM_BINS(fft_len) + (fft_len) - (hop)))
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  频谱分析器
+ */
+typedef struct
+{
+    OS_RingBuf Ring;           ///< 样点队列，唤醒阈值为 Hop 个样点
+    union
+    {
+        arm_rfft_fast_instance_f32 F32;
+        arm_rfft_instance_q15 Q15;
+    } Fft;                     ///< FFT 实例（旋转因子表是 CMSIS 里的常量表）
+
+    uint8_t Format;            ///< OS_SPECTRUM_F32 / OS_SPECTRUM_Q15
+    uint8_t SampleSize;        ///< 单个样点字节数
+    uint16_t FftLen;           ///< 帧长 N
+    uint16_t Hop;              ///< 帧移：每帧的新样点数
+    uint16_t Overlap;          ///< 重叠样点数 N - Hop
+    uint16_t HistoryPos;       ///< 重叠历史里最旧样点的位置（历史区是循环使用的）
+    const void *Window;        ///< 窗函数，N 个系数
+
+    void *Frame;               ///< 加窗后的帧，FFT 会把它当工作区改掉
+    void *Spectrum;            ///< FFT 输出
+    void *Magnitude[2];        ///< 幅度谱双缓冲，每份 OS_SPECTRUM_BINS 个
+    void *History;             ///< 重叠历史，Overlap 个样点
+
+    volatile uint32_t MagSeq[2]; ///< 每份幅度谱的顺序锁，奇数表示正在写
+    volatile uint32_t MagFrame[2]; ///< 每份幅度谱对应的帧序号
+    volatile uint8_t Front;    ///< 最新发布的那一份
+
+    void (*Publish)(const void *magnitude, uint32_t frame, void *arg); ///< 每帧发布后的回调，可以为 NULL
+    void *Arg;                 ///< 回调参数
+
+    volatile uint32_t Frames;  ///< 已发布的帧数
+    volatile uint32_t Dropped; ///< 队列满丢掉的样点数
+    uint64_t MaxCycles;        ///< 单帧最长处理时间（节拍定时器计数）
+} OS_Spectrum;
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  初始化频谱分析器
+ * @param  format: OS_SPECTRUM_F32 / OS_SPECTRUM_Q15
+ * @param  fft_len: 帧长，float32 支持 32~4096，q15 支持 32~8192，都必须是 2 的幂
+ * @param  hop: 帧移，1~fft_len；fft_len / 2 即 50% 重叠
+ * @param  window: 窗函数（可以用 OS_SpectrumHann 生成），格式与 format 一致
+ * @param  work: 工作区，OS_SPECTRUM_WORK_SIZE_F32/_Q15 字节，4 字节对齐
+ * @param  ring_buf: 样点队列存储区，大小为 2 的幂且不小于 hop 个样点
+ * @param  ring_size: 样点队列存储区大小（单位：字节）
+ * @return uint8_t: 1 代表成功；参数不合法时返回 0
+ */
+uint8_t OS_SpectrumInit(OS_Spectrum *p_spec, uint8_t format, uint16_t fft_len, uint16_t hop,
+                        const void *window, void *work, uint8_t *ring_buf, uint32_t ring_size);
+
+/**
+ * @brief  注册每帧的发布回调（在分析任务里调用，magnitude 只在回调期间有效）
+ */
+void OS_SpectrumSetPublish(OS_Spectrum *p_spec, void (*publish)(const void *, uint32_t, void *), void *arg);
+
+/**
+ * @brief  生成 Hann 窗
+ * @param  window: fft_len 个系数，float32_t 或 q15_t
+ */
+void OS_SpectrumHann(uint8_t format, void *window, uint16_t fft_len);
+
+/**
+ * @brief  写入样点（生产者调用，可在中断里使用）
+ * @param  samples: 样点，格式与 format 一致
+ * @param  count: 样点数
+ * @return uint32_t: 实际写入的样点数，队列满时多出来的计入 Dropped
+ */
+uint32_t OS_SpectrumWrite(OS_Spectrum *p_spec, const void *samples, uint32_t count);
+
+/**
+ * @brief  把队列里已经攒够的帧全部算完，不阻塞
+ * @return uint32_t: 本次算出的帧数
+ */
+uint32_t OS_SpectrumProcess(OS_Spectrum *p_spec);
+
+/**
+ * @brief  分析任务主循环：等够一帧的新样点就处理，不返回
+ */
+void OS_SpectrumRun(OS_Spectrum *p_spec);
+
+/**
+ * @brief  复制最新一帧幅度谱（任意任务调用）
+ * @param  magnitude: OS_SPECTRUM_BINS(FftLen) 个元素
+ * @return uint32_t: 这一帧的序号，还没有任何结果时返回 0 且不写 magnitude
+ * @note   float32 输出为线性幅度；q15 输出为 arm_cmplx_mag_q15 的 2.14 格式，
+ *         量程随 FftLen 变化（见 arm_rfft_q15 的输入输出格式表）
+ */
+uint32_t OS_SpectrumRead(OS_Spectrum *p_spec, void *magnitude);
+
+#endif /* __OS_SPECTRUM_H */
@@ -24,9 +24,15 @@
 /* 私有变量定义 ------------------------------------------------------ */
 
 volatile uint32_t g_SystemTickCount = 0; // 系统心跳计数器
+volatile uint32_t g_SystemTickCountHigh = 0; // 心跳计数器的高 32 位，低 32 位回绕时加一
 
 volatile uint32_t g_CriticalNesting = 0; // 临界区嵌套计数器
 
+volatile uint32_t g_OSRunning = 0; // 调度器运行标志，第一个任务启动时由 SVC_Handler 置 1
+
+volatile uint32_t g_SchedLockNesting = 0; // 调度器上锁嵌套计数器
+volatile uint32_t g_SchedPending = 0;     // 上锁期间被推迟的调度请求
+
 OS_TCB *CurrentTCB = NULL;
 OS_TCB *NextTCB = NULL;
 
@@ -54,6 +60,47 @@ OS_TCB *FindNextTask(void)
     return TempTCB;
 }
 
+void SemRemoveWaiter(OS_Sem *p_sem, OS_TCB *tcb)
+{
+    OS_TCB *prev = NULL;
+    OS_TCB *ptr = p_sem->WaitListHead;
+
+    while (ptr != NULL && ptr != tcb)
+    {
+        prev = ptr;
+        ptr = ptr->NextWaitTask;
+    }
+    if (ptr == NULL) // 已经不在链表里了
+        return;
+
+    if (prev == NULL)
+        p_sem->WaitListHead = tcb->NextWaitTask;
+    else
+        prev->NextWaitTask = tcb->NextWaitTask;
+
+    if (p_sem->WaitListTail == tcb)
+        p_sem->WaitListTail = prev;
+
+    tcb->NextWaitTask = NULL;
+}
+
+void RequestSchedule(void)
+{
+    // 调度器上锁期间只记下这次请求，等 OS_SchedUnlock 统一切换一次
+    if (g_SchedLockNesting > 0)
+    {
+        g_SchedPending = 1;
+        return;
+    }
+
+    NextTCB = FindNextTask();
+
+    if (NextTCB != CurrentTCB)
+    {
+        OS_Trigger_PendSV();
+    }
+}
+
 /* 函数声明 ----------------------------------------------------------- */
 
 void OS_TaskCreate(OS_TCB *tcb, void *task_function, uint32_t *stack_init_address, uint32_t stack_depth)
@@ -63,6 +110,8 @@ void OS_TaskCreate(OS_TCB *tcb, void *task_function, uint32_t *stack_init_addres
     tcb->DelayTicks = 0;
     tcb->State = TASK_READY;
     tcb->NextWaitTask = NULL;
+    tcb->PendSem = NULL;
+    tcb->PendTimeout = 0;
 
     if (CurrentTCB == NULL)
     {
@@ -82,41 +131,42 @@ void OS_StartScheduler(void)
     // 0. 创建空闲任务 确保系统中至少有一个始终处于就绪态的任务
     OS_TaskCreate(&IdleTaskTCB, IdleTask, IdleTaskStack, IDLE_STACK_SIZE);
 
-    // 1. 此时 CurrentTCB 肯定不为 NULL 了，原来的防御性检查可以删除
-    // if (CurrentTCB == NULL) return;
+    // 1. 关中断，直到 OS_StartFirstTask 复位 MSP 后才重新打开
+    OS_Disable_IRQ();
 
-    // 2. 关键步骤：设置 NextTCB 为第一个要运行的任务
+    // 2. 第一个要运行的任务就是 CurrentTCB，不再需要把它置为 NULL 来欺骗 PendSV
     NextTCB = CurrentTCB;
 
-    // 3. 关键步骤：欺骗 PendSV
-    // 将 CurrentTCB 暂时设为 NULL。
-    // 这样 PendSV 里的 "CMP R1, #0" 就会成立，从而跳过 STMDB (保存上下文)，
-    // 直接执行 RestoreContext (恢复 NextTCB 的上下文)。
-    CurrentTCB = NULL;
+    // 3. 初始化节拍定时器 (开启时间片，按 OS_TICK_RATE_HZ 产生节拍中断)
+    // 注意：g_OSRunning 在 SVC_Handler 里才置 1，
+    // 所以在第一个任务真正跑起来之前，SysTick 即使触发也不会乱调度。
+    OS_Init_Timer(OS_TICK_RATE_HZ);
 
-    // 4. 初始化 SysTick (开启时间片，开始 1ms 中断)
-    // 注意：SysTick_Handler 里有一句 if(CurrentTCB != NULL)，
-    // 所以在 PendSV 执行完之前，SysTick 即使触发了也不会乱调度。
-    OS_Init_Timer(1);
+    // 4. 复位 MSP，通过 SVC 启动第一个任务，main() 的栈帧就此回收
+    OS_StartFirstTask();
 
-    // 5. 触发 PendSV，开始第一次切换！
-    OS_Trigger_PendSV();
-
-    // 6. 应该永远不会执行到这里
+    // 5. 应该永远不会执行到这里
     while (1)
         ;
 }
 
 void OS_Tick_Handler(void)
 {
-    // 1. 安全检查
-    if (CurrentTCB == NULL)
-        return;
+    // 1. 更新系统时间（64 位，分成两个 32 位变量，读者用 OS_TimeNowTicks 读取）
+    // 调度器启动之前也要计数，OS_TimeNow* 在 main() 里同样可用
+    if (++g_SystemTickCount == 0)
+    {
+        g_SystemTickCountHigh++;
+    }
 
-    // 2. 更新系统时间
-    g_SystemTickCount++;
+    // 2. 安全检查：调度器启动之前，还没有任务链表可以遍历
+    if (g_OSRunning == 0)
+        return;
 
     // 3. 遍历任务列表，将每个延时值（若>0）-1
+    // 优先级更高的中断可能在这期间 OS_SemPost，改同一条等待链表，所以整段放进临界区
+    OS_EnterCritical();
+
     OS_TCB *ptr = CurrentTCB; // 从当前任务开始
 
     do
@@ -128,6 +178,13 @@ void OS_Tick_Handler(void)
                 ptr->DelayTicks--;
                 if (ptr->DelayTicks == 0)
                 {
+                    // 等信号量超时：从等待链表里摘掉，让 OS_SemWaitTimeout 返回 0
+                    if (ptr->PendSem != NULL)
+                    {
+                        SemRemoveWaiter(ptr->PendSem, ptr);
+                        ptr->PendSem = NULL;
+                        ptr->PendTimeout = 1;
+                    }
                     ptr->State = TASK_READY;
                 }
             }
@@ -135,21 +192,23 @@ void OS_Tick_Handler(void)
         ptr = ptr->Next; // 将当前标记指针指向下一个任务
     } while (ptr != CurrentTCB);
 
-    // 4. 核心调度逻辑
-    NextTCB = FindNextTask();
+    // 4. 核心调度逻辑 + 请求上下文切换
+    // 调度器上锁时只记录待切换，延时计数照常递减
+    RequestSchedule();
 
-    // 5. 请求上下文切换
-    // 这里不再直接写寄存器，而是调用移植层的接口
-    if (NextTCB != CurrentTCB)
-    {
-        OS_Trigger_PendSV();
-    }
+    OS_ExitCritical();
 }
 
 void OS_Delay(uint32_t ticks)
 {
     OS_EnterCritical();
 
+    if (g_SchedLockNesting > 0) // 调度器上锁时无法让出 CPU，直接返回
+    {
+        OS_ExitCritical();
+        return;
+    }
+
     CurrentTCB->DelayTicks = ticks;
     CurrentTCB->State = TASK_BLOCKED; // <--- 添加
 
@@ -160,6 +219,13 @@ void OS_Delay(uint32_t ticks)
     OS_ExitCritical(); /* 修改成我们的进入退出临界区函数 */
 }
 
+void OS_Yield(void)
+{
+    OS_EnterCritical();
+    RequestSchedule();
+    OS_ExitCritical();
+}
+
 void OS_EnterCritical(void)
 {
     OS_Disable_IRQ();
@@ -178,8 +244,58 @@ void OS_ExitCritical(void)
     }
 }
 
+void OS_SchedLock(void)
+{
+    OS_EnterCritical();
+    g_SchedLockNesting++;
+    OS_ExitCritical();
+}
+
+void OS_SchedUnlock(void)
+{
+    OS_EnterCritical();
+    if (g_SchedLockNesting > 0)
+    {
+        g_SchedLockNesting--;
+
+        // 最外层解锁：上锁期间攒下的调度请求在这里只切换一次
+        if (g_SchedLockNesting == 0 && g_SchedPending)
+        {
+            g_SchedPending = 0;
+            RequestSchedule();
+        }
+    }
+    OS_ExitCritical();
+}
+
 uint8_t OS_SemWait(OS_Sem *p_sem)
 {
+    return OS_SemWaitTimeout(p_sem, OS_WAIT_FOREVER);
+}
+
+uint8_t OS_SemWaitTimeout(OS_Sem *p_sem, uint32_t ticks)
+{
+#if OS_CFG_SEM_FAST_PATH
+    uint16_t count;
+
+    // 快速路径：信号量充足时独占地减一，不关中断
+    // STREX 失败说明中途被中断或切换打断过，重新读一次 count 再试
+    for (;;)
+    {
+        count = OS_CPU_LDREXH(&p_sem->count);
+        if (count == 0)
+        {
+            OS_CPU_CLREX();
+            break; // 需要阻塞，走下面的慢速路径
+        }
+        if (OS_CPU_STREXH(count - 1, &p_sem->count) == 0)
+        {
+            return 1;
+        }
+    }
+#endif
+
+    // 慢速路径：进入临界区后要重新检查 count，快速路径的 Post 可能刚刚加过
     OS_EnterCritical();
     if (p_sem->count > 0) // 原本就有信号量
     {
@@ -187,9 +303,17 @@ uint8_t OS_SemWait(OS_Sem *p_sem)
         OS_ExitCritical();
         return 1; // 表示成功返回
     }
-    else // 原本没信号量，我睡觉去了，直到信号量来了
+    else if (ticks == 0 || g_SchedLockNesting > 0) // 不等待，或者调度器上锁时不能阻塞
+    {
+        OS_ExitCritical();
+        return 0;
+    }
+    else // 原本没信号量，我睡觉去了，直到信号量来了或者超时
     {
         CurrentTCB->State = TASK_BLOCKED; // 设置当前任务状态
+        CurrentTCB->DelayTicks = (ticks == OS_WAIT_FOREVER) ? 0 : ticks; // 0 表示不参与超时计数
+        CurrentTCB->PendSem = p_sem;
+        CurrentTCB->PendTimeout = 0;
 
         CurrentTCB->NextWaitTask = NULL; // 这个任务就是“等待链表”最后一个
 
@@ -210,12 +334,42 @@ uint8_t OS_SemWait(OS_Sem *p_sem)
         OS_Trigger_PendSV();
         OS_ExitCritical();
 
-        return 1;
+        // 被唤醒后回到这里：OS_SemPost 直接把信号量交给了我们，或者等待超时
+        return CurrentTCB->PendTimeout ? 0 : 1;
     }
 }
 
 uint8_t OS_SemPost(OS_Sem *p_sem)
 {
+#if OS_CFG_SEM_FAST_PATH
+    uint16_t count;
+#endif
+
+#if OS_CFG_DEBUG_CHECKS
+    // 天花板以上的中断不受临界区保护，会和任务同时改等待链表
+    if (OS_CPU_InISR() && !OS_CPU_IrqKernelAware(OS_CPU_ActiveIRQn()))
+        while(1);
+#endif
+
+#if OS_CFG_SEM_FAST_PATH
+    // 快速路径：没人排队时独占地加一，不关中断
+    // 等待者只能在另一个任务或中断里入队，一旦发生 STREX 就会失败，重试时能看到它
+    for (;;)
+    {
+        count = OS_CPU_LDREXH(&p_sem->count);
+        if (p_sem->WaitListHead != NULL)
+        {
+            OS_CPU_CLREX();
+            break; // 需要唤醒任务，走下面的慢速路径
+        }
+        if (OS_CPU_STREXH(count + 1, &p_sem->count) == 0)
+        {
+            return 1;
+        }
+    }
+#endif
+
+    // 慢速路径：进入临界区后重新判断等待链表
     OS_EnterCritical();
     if (p_sem->WaitListHead == NULL)
     {
@@ -234,10 +388,11 @@ uint8_t OS_SemPost(OS_Sem *p_sem)
         }
 
         TaskToWake->NextWaitTask = NULL;
+        TaskToWake->PendSem = NULL;
+        TaskToWake->DelayTicks = 0; // 取消超时计数
         TaskToWake->State = TASK_READY;
 
-        NextTCB = FindNextTask();
-        OS_Trigger_PendSV();
+        RequestSchedule();
         OS_ExitCritical();
 
         return 1;
@@ -0,0 +1,129 @@
+/**
+ ******************************************************************************
+ * @file    os_mpmc.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   多生产者/多消费者无锁有界队列实现
+ *
+ * 槽位序号的含义（pos 为入队或出队位置）：
+ * - Sequence == pos      ：槽位空闲，等待位置为 pos 的生产者
+ * - Sequence == pos + 1  ：槽位已写好，等待位置为 pos 的消费者
+ * - 消费者取走后把序号改成 pos + 容量，留给下一圈的生产者
+ *
+ * 抢位置用 LDREX/STREX：被中断或任务切换打断时 STREX 必然失败，重新读位置即可。
+ *
+ ******************************************************************************
+ */
+
+#include "os_mpmc.h"
+#include <string.h>
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_MpmcQueueInit(OS_MpmcQueue *p_q, void *buffer, volatile uint32_t *sequence,
+                         uint32_t capacity, uint32_t item_size)
+{
+    uint32_t i;
+
+    // 容量为 1 时，入队后序号 pos + 1 正好等于下一个入队位置，会被当成空槽覆盖
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) // 不是 2 的幂
+        return 0;
+
+    p_q->Buffer = (uint8_t *)buffer;
+    p_q->Sequence = sequence;
+    p_q->Mask = capacity - 1;
+    p_q->ItemSize = item_size;
+    p_q->EnqueuePos = 0;
+    p_q->DequeuePos = 0;
+
+    for (i = 0; i < capacity; i++)
+    {
+        sequence[i] = i;
+    }
+
+    return 1;
+}
+
+uint8_t OS_MpmcQueuePush(OS_MpmcQueue *p_q, const void *item)
+{
+    uint32_t pos;
+    uint32_t slot;
+    int32_t diff;
+
+    // 1. 抢一个入队位置
+    for (;;)
+    {
+        pos = OS_CPU_LDREXW(&p_q->EnqueuePos);
+        diff = (int32_t)(p_q->Sequence[pos & p_q->Mask] - pos);
+
+        if (diff == 0) // 槽位空闲，尝试占下它
+        {
+            if (OS_CPU_STREXW(pos + 1, &p_q->EnqueuePos) == 0)
+                break;
+        }
+        else if (diff < 0) // 上一圈的元素还没被取走，队列满
+        {
+            OS_CPU_CLREX();
+            return 0;
+        }
+        else // 位置已被别人推进，重新读
+        {
+            OS_CPU_CLREX();
+        }
+    }
+
+    // 2. 写数据，再发布序号
+    slot = pos & p_q->Mask;
+    memcpy(&p_q->Buffer[slot * p_q->ItemSize], item, p_q->ItemSize);
+    OS_CPU_DMB();
+    p_q->Sequence[slot] = pos + 1;
+
+    return 1;
+}
+
+uint8_t OS_MpmcQueuePop(OS_MpmcQueue *p_q, void *item)
+{
+    uint32_t pos;
+    uint32_t slot;
+    int32_t diff;
+
+    // 1. 抢一个出队位置
+    for (;;)
+    {
+        pos = OS_CPU_LDREXW(&p_q->DequeuePos);
+        diff = (int32_t)(p_q->Sequence[pos & p_q->Mask] - (pos + 1));
+
+        if (diff == 0) // 槽位已写好，尝试占下它
+        {
+            if (OS_CPU_STREXW(pos + 1, &p_q->DequeuePos) == 0)
+                break;
+        }
+        else if (diff < 0) // 生产者还没写到这里，队列空
+        {
+            OS_CPU_CLREX();
+            return 0;
+        }
+        else // 位置已被别人推进，重新读
+        {
+            OS_CPU_CLREX();
+        }
+    }
+
+    // 2. 读数据，再把槽位还给下一圈的生产者
+    slot = pos & p_q->Mask;
+    OS_CPU_DMB();
+    if (item != NULL) // NULL：丢弃
+        memcpy(item, &p_q->Buffer[slot * p_q->ItemSize], p_q->ItemSize);
+    OS_CPU_DMB();
+    p_q->Sequence[slot] = pos + p_q->Mask + 1;
+
+    return 1;
+}
+
+uint32_t OS_MpmcQueueCount(const OS_MpmcQueue *p_q)
+{
+    uint32_t count = p_q->EnqueuePos - p_q->DequeuePos;
+
+    return (count > p_q->Mask + 1) ? (p_q->Mask + 1) : count;
+}
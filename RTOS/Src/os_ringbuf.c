@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file    os_ringbuf.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   单生产者/单消费者无锁环形缓冲区实现
+ *
+ * 同步方式：
+ * - 生产者先写数据，DMB，再推进 Head；消费者先读 Head，DMB，再读数据
+ * - 消费者读完数据，DMB，再推进 Tail；生产者据此判断剩余空间
+ * - 唤醒：读任务先置 ReaderWaiting，DMB 后再检查数据量；生产者推进 Head 后
+ *   DMB 再检查 ReaderWaiting。两边至少有一方能看到对方，不会丢唤醒
+ *
+ ******************************************************************************
+ */
+
+#include "os_ringbuf.h"
+#include <string.h>
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static void RingBufWakeReader(OS_RingBuf *p_rb, uint8_t force)
+{
+    OS_CPU_DMB(); // 先让新的 Head 生效，再看读任务是否在睡
+
+    if (p_rb->ReaderWaiting == 0 || p_rb->WakeThreshold == 0)
+        return;
+
+    if (force || OS_RingBufCount(p_rb) >= p_rb->WakeThreshold)
+    {
+        p_rb->ReaderWaiting = 0; // 一次睡眠只唤醒一次
+        OS_SemPost(&p_rb->DataSem);
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint8_t OS_RingBufInit(OS_RingBuf *p_rb, uint8_t *buffer, uint32_t size, uint32_t wake_threshold)
+{
+    if (size == 0 || (size & (size - 1)) != 0) // 不是 2 的幂
+        return 0;
+
+    p_rb->Buffer = buffer;
+    p_rb->Mask = size - 1;
+    p_rb->Head = 0;
+    p_rb->Tail = 0;
+    p_rb->WakeThreshold = (wake_threshold > size) ? size : wake_threshold;
+    p_rb->ReaderWaiting = 0;
+    p_rb->FlushRequest = 0;
+
+    p_rb->DataSem.count = 0;
+    p_rb->DataSem.WaitListHead = NULL;
+    p_rb->DataSem.WaitListTail = NULL;
+
+    return 1;
+}
+
+uint32_t OS_RingBufCount(const OS_RingBuf *p_rb)
+{
+    return p_rb->Head - p_rb->Tail; // 索引自由增长，无符号减法自动处理回绕
+}
+
+uint32_t OS_RingBufFree(const OS_RingBuf *p_rb)
+{
+    return (p_rb->Mask + 1) - (p_rb->Head - p_rb->Tail);
+}
+
+uint32_t OS_RingBufWriteSpan(OS_RingBuf *p_rb, uint8_t **span)
+{
+    uint32_t head = p_rb->Head;
+    uint32_t free = OS_RingBufFree(p_rb);
+    uint32_t to_end = (p_rb->Mask + 1) - (head & p_rb->Mask); // 到存储区末尾的距离
+
+    OS_CPU_DMB(); // 先确认消费者已经读完，再覆盖这块空间
+
+    *span = &p_rb->Buffer[head & p_rb->Mask];
+    return (free < to_end) ? free : to_end;
+}
+
+void OS_RingBufCommit(OS_RingBuf *p_rb, uint32_t len)
+{
+    OS_CPU_DMB(); // 数据先落地，再发布新的 Head
+    p_rb->Head += len;
+
+    RingBufWakeReader(p_rb, 0);
+}
+
+uint32_t OS_RingBufReadSpan(OS_RingBuf *p_rb, uint8_t **span)
+{
+    uint32_t tail = p_rb->Tail;
+    uint32_t count = OS_RingBufCount(p_rb);
+    uint32_t to_end = (p_rb->Mask + 1) - (tail & p_rb->Mask);
+
+    OS_CPU_DMB(); // 先读到 Head，再读数据
+
+    *span = &p_rb->Buffer[tail & p_rb->Mask];
+    return (count < to_end) ? count : to_end;
+}
+
+void OS_RingBufConsume(OS_RingBuf *p_rb, uint32_t len)
+{
+    OS_CPU_DMB(); // 数据读完，再把空间还给生产者
+    p_rb->Tail += len;
+}
+
+uint32_t OS_RingBufWrite(OS_RingBuf *p_rb, const uint8_t *data, uint32_t len)
+{
+    uint32_t written = 0;
+    uint8_t *span;
+    uint32_t n;
+
+    // 最多分两段（存储区末尾 + 开头），全部写完只提交、唤醒一次
+    while (written < len)
+    {
+        n = OS_RingBufWriteSpan(p_rb, &span);
+        if (n == 0)
+            break;
+        if (n > len - written)
+            n = len - written;
+
+        memcpy(span, data + written, n);
+        OS_CPU_DMB();
+        p_rb->Head += n;
+        written += n;
+    }
+
+    if (written > 0)
+        RingBufWakeReader(p_rb, 0);
+
+    return written;
+}
+
+uint32_t OS_RingBufRead(OS_RingBuf *p_rb, uint8_t *data, uint32_t len)
+{
+    uint32_t read = 0;
+    uint8_t *span;
+    uint32_t n;
+
+    while (read < len)
+    {
+        n = OS_RingBufReadSpan(p_rb, &span);
+        if (n == 0)
+            break;
+        if (n > len - read)
+            n = len - read;
+
+        memcpy(data + read, span, n);
+        OS_RingBufConsume(p_rb, n);
+        read += n;
+    }
+
+    return read;
+}
+
+uint8_t OS_RingBufWait(OS_RingBuf *p_rb)
+{
+    return OS_RingBufWaitTimeout(p_rb, OS_WAIT_FOREVER);
+}
+
+uint8_t OS_RingBufWaitTimeout(OS_RingBuf *p_rb, uint32_t timeout)
+{
+    uint32_t start = g_SystemTickCount;
+    uint32_t elapsed;
+    uint32_t count;
+    uint8_t ok;
+
+    for (;;)
+    {
+        p_rb->ReaderWaiting = 1;
+        OS_CPU_DMB(); // 先声明自己要睡，再检查数据量
+
+        count = OS_RingBufCount(p_rb);
+        if (count >= p_rb->WakeThreshold || (p_rb->FlushRequest && count > 0))
+            break;
+
+        if (timeout == OS_WAIT_FOREVER)
+        {
+            ok = OS_SemWait(&p_rb->DataSem);
+        }
+        else
+        {
+            // 虚假唤醒后只等剩下的时间
+            elapsed = g_SystemTickCount - start;
+            ok = (elapsed < timeout) && OS_SemWaitTimeout(&p_rb->DataSem, timeout - elapsed);
+        }
+
+        if (!ok)
+        {
+            p_rb->ReaderWaiting = 0;
+            return 0;
+        }
+        // 被唤醒后回到循环开头重新检查，生产者和读任务同时清 ReaderWaiting 时
+        // 信号量里可能多出一次计数，这里会把它当作一次虚假唤醒吃掉
+    }
+
+    p_rb->ReaderWaiting = 0;
+    p_rb->FlushRequest = 0;
+    return 1;
+}
+
+void OS_RingBufFlush(OS_RingBuf *p_rb)
+{
+    p_rb->FlushRequest = 1;
+    RingBufWakeReader(p_rb, 1);
+}
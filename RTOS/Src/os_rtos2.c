@@ -0,0 +1,977 @@
+/**
+ ******************************************************************************
+ * @file    os_rtos2.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-RTOS2 适配层实现
+ *
+ * 把 cmsis_os2.h 的接口映射到内核对象上，每个函数都只是一层薄包装：
+ * - osThread*      -> OS_TaskCreate / OS_Yield，线程标志同事件标志
+ * - osDelay*       -> OS_Delay
+ * - osSemaphore*   -> OS_Sem (OS_SemWaitTimeout / OS_SemPost)
+ * - osMutex*       -> 二值 OS_Sem + 持有者
+ * - osMessageQueue*-> OS_MpmcQueue + 两个计数 OS_Sem
+ * - osEventFlags*  -> 标志字 + OS_Sem
+ * - osTimer*       -> 一个定时器线程，睡到最早的到期时刻
+ *
+ * 内核做不到的调用（终止别的线程、删除有人在等的对象等）返回 osErrorResource，
+ * 见 os_rtos2.h。
+ *
+ * 由于 cmsis_os2.h 已经把这些函数声明为外部函数，这里无法做成 inline，
+ * 但每个函数只做参数检查和一次内核调用，开销与直接调用内核接近。
+ *
+ ******************************************************************************
+ */
+
+#include "os_rtos2.h"
+#include <string.h>
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static osKernelState_t KernelState = osKernelInactive;
+
+static OS_Rtos2Timer *TimerListHead = NULL;       // 所有已创建的定时器
+static OS_Sem TimerSem = { 0, NULL, NULL };       // 定时器增删改时唤醒定时器线程
+static OS_Rtos2Thread TimerThread;
+static uint32_t TimerTaskStack[OS_RTOS2_TIMER_STACK_SIZE];
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static void SemInit(OS_Sem *p_sem, uint16_t count)
+{
+    p_sem->count = count;
+    p_sem->WaitListHead = NULL;
+    p_sem->WaitListTail = NULL;
+}
+
+static osStatus_t SemAcquire(OS_Sem *p_sem, uint32_t timeout)
+{
+    if (OS_CPU_InISR() && timeout != 0)
+        return osErrorParameter;
+
+    if (OS_SemWaitTimeout(p_sem, timeout))
+        return osOK;
+
+    return (timeout == 0) ? osErrorResource : osErrorTimeout;
+}
+
+static void FlagsInit(OS_Rtos2EventFlags *ef, const char *name)
+{
+    ef->Flags = 0;
+    ef->Waiters = 0;
+    ef->Name = name;
+    SemInit(&ef->Sem, 0);
+}
+
+static uint32_t FlagsSet(OS_Rtos2EventFlags *ef, uint32_t flags)
+{
+    uint32_t result;
+    uint32_t waiters;
+
+    OS_EnterCritical();
+    ef->Flags |= flags;
+    result = ef->Flags;
+    waiters = ef->Waiters;
+    ef->Waiters = 0;
+    OS_ExitCritical();
+
+    // 把所有等待者都叫醒，各自重新检查自己等的标志
+    while (waiters--)
+    {
+        OS_SemPost(&ef->Sem);
+    }
+
+    return result;
+}
+
+static uint32_t FlagsClear(OS_Rtos2EventFlags *ef, uint32_t flags)
+{
+    uint32_t result;
+
+    OS_EnterCritical();
+    result = ef->Flags;
+    ef->Flags &= ~flags;
+    OS_ExitCritical();
+
+    return result;
+}
+
+static uint32_t FlagsWait(OS_Rtos2EventFlags *ef, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    uint32_t start = g_SystemTickCount;
+    uint32_t elapsed;
+    uint32_t result;
+    uint8_t ready;
+
+    for (;;)
+    {
+        OS_EnterCritical();
+        result = ef->Flags;
+        if (options & osFlagsWaitAll)
+            ready = ((result & flags) == flags);
+        else
+            ready = ((result & flags) != 0);
+
+        if (ready)
+        {
+            if (!(options & osFlagsNoClear))
+                ef->Flags &= ~flags;
+            OS_ExitCritical();
+            return result;
+        }
+        if (timeout == 0)
+        {
+            OS_ExitCritical();
+            return osFlagsErrorResource;
+        }
+        ef->Waiters++;
+        OS_ExitCritical();
+
+        // 超时时间扣掉已经等过的部分；多出来的唤醒只会让我们多检查一次
+        if (timeout == osWaitForever)
+        {
+            OS_SemWait(&ef->Sem);
+        }
+        else
+        {
+            elapsed = g_SystemTickCount - start;
+            if (elapsed >= timeout || !OS_SemWaitTimeout(&ef->Sem, timeout - elapsed))
+                return osFlagsErrorTimeout;
+        }
+    }
+}
+
+static void ThreadEntry(void)
+{
+    // 线程控制块的第一个成员就是 TCB，所以 CurrentTCB 就是自己的控制块
+    OS_Rtos2Thread *thread = (OS_Rtos2Thread *)CurrentTCB;
+
+    thread->Func(thread->Argument);
+    osThreadExit();
+}
+
+static void ThreadInit(OS_Rtos2Thread *thread, osThreadFunc_t func, void *argument, const char *name,
+                       uint32_t *stack, uint32_t stack_size, osPriority_t priority)
+{
+    thread->Func = func;
+    thread->Argument = argument;
+    thread->Name = name;
+    thread->StackSize = stack_size;
+    thread->Priority = priority;
+    thread->Exited = 0;
+    FlagsInit(&thread->Flags, NULL);
+
+    // 调度器启动后也允许创建线程，插入任务链表时要关中断
+    OS_EnterCritical();
+    OS_TaskCreate(&thread->Tcb, ThreadEntry, stack, stack_size / sizeof(uint32_t));
+    OS_ExitCritical();
+}
+
+static void TimerTask(void *argument)
+{
+    OS_Rtos2Timer *timer;
+    osTimerFunc_t func;
+    void *func_argument;
+    uint32_t now;
+    uint32_t wait;
+    int32_t left;
+
+    for (;;)
+    {
+        func = NULL;
+        func_argument = NULL;
+        wait = OS_WAIT_FOREVER;
+
+        // 1. 找出一个已经到期的定时器，顺便算出离最近一次到期还有多久
+        OS_EnterCritical();
+        now = g_SystemTickCount;
+        for (timer = TimerListHead; timer != NULL; timer = timer->Next)
+        {
+            if (!timer->Running)
+                continue;
+
+            left = (int32_t)(timer->Expire - now);
+            if (left <= 0)
+            {
+                // 回调和参数在临界区里取出，之后定时器被删除、控制块被复用也不影响
+                func = timer->Func;
+                func_argument = timer->Argument;
+                if (timer->Type == osTimerPeriodic)
+                    timer->Expire += timer->Period;
+                else
+                    timer->Running = 0;
+                break;
+            }
+            if ((uint32_t)left < wait)
+                wait = (uint32_t)left;
+        }
+        OS_ExitCritical();
+
+        // 2. 回调在线程上下文里执行，不在临界区里
+        if (func != NULL)
+        {
+            func(func_argument);
+            continue;
+        }
+
+        // 3. 睡到最近的到期时刻，期间有定时器启动/停止会被提前唤醒
+        OS_SemWaitTimeout(&TimerSem, wait);
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/* ==== Kernel Management Functions ==== */
+
+osStatus_t osKernelInitialize(void)
+{
+    if (KernelState != osKernelInactive)
+        return osError;
+
+    KernelState = osKernelReady;
+    return osOK;
+}
+
+osStatus_t osKernelGetInfo(osVersion_t *version, char *id_buf, uint32_t id_size)
+{
+    if (version != NULL)
+    {
+        version->api = 20010003u;    // API V2.1.3
+        version->kernel = 10000000u; // 内核 V1.0.0
+    }
+    if (id_buf != NULL && id_size > 0)
+    {
+        strncpy(id_buf, "Build Your Own RTOS", id_size - 1);
+        id_buf[id_size - 1] = '\0';
+    }
+    return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+    if (g_OSRunning)
+        return (g_SchedLockNesting > 0) ? osKernelLocked : osKernelRunning;
+
+    return KernelState;
+}
+
+osStatus_t osKernelStart(void)
+{
+    if (KernelState != osKernelReady)
+        return osError;
+
+    ThreadInit(&TimerThread, TimerTask, NULL, "Timer", TimerTaskStack, sizeof(TimerTaskStack),
+               osPriorityNormal);
+
+    KernelState = osKernelRunning;
+    OS_StartScheduler(); // 不会返回
+    return osError;
+}
+
+int32_t osKernelLock(void)
+{
+    int32_t lock = (g_SchedLockNesting > 0) ? 1 : 0;
+
+    if (OS_CPU_InISR())
+        return (int32_t)osErrorISR;
+
+    OS_SchedLock();
+    return lock;
+}
+
+int32_t osKernelUnlock(void)
+{
+    int32_t lock = (g_SchedLockNesting > 0) ? 1 : 0;
+
+    if (OS_CPU_InISR())
+        return (int32_t)osErrorISR;
+
+    if (lock)
+        OS_SchedUnlock();
+    return lock;
+}
+
+int32_t osKernelRestoreLock(int32_t lock)
+{
+    if (OS_CPU_InISR())
+        return (int32_t)osErrorISR;
+
+    if (lock)
+    {
+        if (g_SchedLockNesting == 0)
+            OS_SchedLock();
+    }
+    else
+    {
+        while (g_SchedLockNesting > 0)
+            OS_SchedUnlock();
+    }
+    return lock;
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+    return g_SystemTickCount;
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+    return OS_TICK_RATE_HZ;
+}
+
+/* ==== Thread Management Functions ==== */
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+    OS_Rtos2Thread *thread;
+
+    if (func == NULL || attr == NULL || OS_CPU_InISR())
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2Thread))
+        return NULL;
+    if (attr->stack_mem == NULL || attr->stack_size < 64u * sizeof(uint32_t))
+        return NULL;
+
+    thread = (OS_Rtos2Thread *)attr->cb_mem;
+    ThreadInit(thread, func, argument, attr->name, (uint32_t *)attr->stack_mem, attr->stack_size,
+               (attr->priority == osPriorityNone) ? osPriorityNormal : attr->priority);
+
+    return (osThreadId_t)thread;
+}
+
+const char *osThreadGetName(osThreadId_t thread_id)
+{
+    return (thread_id == NULL) ? NULL : ((OS_Rtos2Thread *)thread_id)->Name;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+    return (osThreadId_t)CurrentTCB;
+}
+
+osThreadState_t osThreadGetState(osThreadId_t thread_id)
+{
+    OS_TCB *tcb = (OS_TCB *)thread_id;
+
+    if (tcb == NULL)
+        return osThreadError;
+    if (((OS_Rtos2Thread *)tcb)->Exited)
+        return osThreadTerminated;
+    if (tcb == CurrentTCB)
+        return osThreadRunning;
+
+    return (tcb->State == TASK_READY) ? osThreadReady : osThreadBlocked;
+}
+
+uint32_t osThreadGetStackSize(osThreadId_t thread_id)
+{
+    return (thread_id == NULL) ? 0 : ((OS_Rtos2Thread *)thread_id)->StackSize;
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority)
+{
+    if (thread_id == NULL || priority < osPriorityIdle || priority > osPriorityISR)
+        return osErrorParameter;
+
+    ((OS_Rtos2Thread *)thread_id)->Priority = priority; // 只记录，内核按时间片轮转
+    return osOK;
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id)
+{
+    return (thread_id == NULL) ? osPriorityError : ((OS_Rtos2Thread *)thread_id)->Priority;
+}
+
+osStatus_t osThreadYield(void)
+{
+    if (OS_CPU_InISR())
+        return osErrorISR;
+
+    OS_Yield();
+    return osOK;
+}
+
+osStatus_t osThreadSuspend(osThreadId_t thread_id)
+{
+    return osErrorResource; // 内核不能挂起任务
+}
+
+osStatus_t osThreadResume(osThreadId_t thread_id)
+{
+    return osErrorResource;
+}
+
+osStatus_t osThreadDetach(osThreadId_t thread_id)
+{
+    return osErrorResource; // 线程控制块和栈都由应用提供，没有可以回收的
+}
+
+osStatus_t osThreadJoin(osThreadId_t thread_id)
+{
+    return osErrorResource;
+}
+
+__NO_RETURN void osThreadExit(void)
+{
+    OS_Rtos2Thread *thread = (OS_Rtos2Thread *)CurrentTCB;
+
+    // 内核不能把任务从链表里摘掉，只能永远睡下去，不再占用 CPU
+    thread->Exited = 1;
+    for (;;)
+    {
+        OS_Delay(0xFFFFFFFEu);
+    }
+}
+
+osStatus_t osThreadTerminate(osThreadId_t thread_id)
+{
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (thread_id == NULL)
+        return osErrorParameter;
+    if ((OS_TCB *)thread_id != CurrentTCB)
+        return osErrorResource; // 只能终止自己
+
+    osThreadExit();
+}
+
+/* ==== Thread Flags Functions ==== */
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+    if (thread_id == NULL || (flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsSet(&((OS_Rtos2Thread *)thread_id)->Flags, flags);
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+    if (OS_CPU_InISR())
+        return osFlagsErrorISR;
+    if ((flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsClear(&((OS_Rtos2Thread *)CurrentTCB)->Flags, flags);
+}
+
+uint32_t osThreadFlagsGet(void)
+{
+    if (OS_CPU_InISR())
+        return 0;
+
+    return ((OS_Rtos2Thread *)CurrentTCB)->Flags.Flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    if (OS_CPU_InISR())
+        return osFlagsErrorISR;
+    if (flags == 0 || (flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsWait(&((OS_Rtos2Thread *)CurrentTCB)->Flags, flags, options, timeout);
+}
+
+/* ==== Generic Wait Functions ==== */
+
+osStatus_t osDelay(uint32_t ticks)
+{
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (ticks == 0)
+        return osOK;
+
+    OS_Delay(ticks);
+    return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+    int32_t delay;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+
+    delay = (int32_t)(ticks - g_SystemTickCount);
+    if (delay <= 0)
+        return osErrorParameter;
+
+    OS_Delay((uint32_t)delay);
+    return osOK;
+}
+
+/* ==== Timer Management Functions ==== */
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void *argument, const osTimerAttr_t *attr)
+{
+    OS_Rtos2Timer *timer;
+
+    if (func == NULL || attr == NULL || OS_CPU_InISR())
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2Timer))
+        return NULL;
+
+    timer = (OS_Rtos2Timer *)attr->cb_mem;
+    timer->Func = func;
+    timer->Argument = argument;
+    timer->Type = type;
+    timer->Period = 0;
+    timer->Expire = 0;
+    timer->Running = 0;
+    timer->Name = attr->name;
+
+    OS_EnterCritical();
+    timer->Next = TimerListHead;
+    TimerListHead = timer;
+    OS_ExitCritical();
+
+    return (osTimerId_t)timer;
+}
+
+osStatus_t osTimerDelete(osTimerId_t timer_id)
+{
+    OS_Rtos2Timer *timer = (OS_Rtos2Timer *)timer_id;
+    OS_Rtos2Timer **pp;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (timer == NULL)
+        return osErrorParameter;
+
+    // 从链表里摘掉，之后控制块可以被应用复用
+    OS_EnterCritical();
+    for (pp = &TimerListHead; *pp != NULL && *pp != timer; pp = &(*pp)->Next)
+        ;
+    if (*pp == NULL)
+    {
+        OS_ExitCritical();
+        return osErrorParameter; // 不在链表里：没创建过或已经删除
+    }
+    *pp = timer->Next;
+    timer->Running = 0;
+    timer->Next = NULL;
+    OS_ExitCritical();
+
+    return osOK;
+}
+
+const char *osTimerGetName(osTimerId_t timer_id)
+{
+    return (timer_id == NULL) ? NULL : ((OS_Rtos2Timer *)timer_id)->Name;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+{
+    OS_Rtos2Timer *timer = (OS_Rtos2Timer *)timer_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (timer == NULL || ticks == 0)
+        return osErrorParameter;
+
+    OS_EnterCritical();
+    timer->Period = ticks;
+    timer->Expire = g_SystemTickCount + ticks;
+    timer->Running = 1;
+    OS_ExitCritical();
+
+    OS_SemPost(&TimerSem); // 让定时器线程重新计算睡眠时间
+    return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id)
+{
+    OS_Rtos2Timer *timer = (OS_Rtos2Timer *)timer_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (timer == NULL)
+        return osErrorParameter;
+    if (!timer->Running)
+        return osErrorResource;
+
+    timer->Running = 0; // 定时器线程醒来后自然会跳过它
+    return osOK;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id)
+{
+    return (timer_id == NULL) ? 0 : ((OS_Rtos2Timer *)timer_id)->Running;
+}
+
+/* ==== Event Flags Management Functions ==== */
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr)
+{
+    OS_Rtos2EventFlags *ef;
+
+    if (attr == NULL || OS_CPU_InISR())
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2EventFlags))
+        return NULL;
+
+    ef = (OS_Rtos2EventFlags *)attr->cb_mem;
+    FlagsInit(ef, attr->name);
+
+    return (osEventFlagsId_t)ef;
+}
+
+osStatus_t osEventFlagsDelete(osEventFlagsId_t ef_id)
+{
+    OS_Rtos2EventFlags *ef = (OS_Rtos2EventFlags *)ef_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (ef == NULL)
+        return osErrorParameter;
+    if (ef->Waiters != 0 || ef->Sem.WaitListHead != NULL)
+        return osErrorResource;
+
+    ef->Name = NULL;
+    return osOK;
+}
+
+const char *osEventFlagsGetName(osEventFlagsId_t ef_id)
+{
+    return (ef_id == NULL) ? NULL : ((OS_Rtos2EventFlags *)ef_id)->Name;
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
+{
+    if (ef_id == NULL || (flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsSet((OS_Rtos2EventFlags *)ef_id, flags);
+}
+
+uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags)
+{
+    if (ef_id == NULL || (flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsClear((OS_Rtos2EventFlags *)ef_id, flags);
+}
+
+uint32_t osEventFlagsGet(osEventFlagsId_t ef_id)
+{
+    return (ef_id == NULL) ? 0 : ((OS_Rtos2EventFlags *)ef_id)->Flags;
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+    if (ef_id == NULL || flags == 0 || (flags & osFlagsError) != 0)
+        return osFlagsErrorParameter;
+    if (OS_CPU_InISR() && timeout != 0)
+        return osFlagsErrorParameter;
+
+    return FlagsWait((OS_Rtos2EventFlags *)ef_id, flags, options, timeout);
+}
+
+/* ==== Mutex Management Functions ==== */
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+    OS_Rtos2Mutex *mutex;
+
+    if (attr == NULL || OS_CPU_InISR())
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2Mutex))
+        return NULL;
+
+    mutex = (OS_Rtos2Mutex *)attr->cb_mem;
+    mutex->Owner = NULL;
+    mutex->Nesting = 0;
+    mutex->AttrBits = attr->attr_bits;
+    mutex->Name = attr->name;
+    SemInit(&mutex->Sem, 1);
+
+    return (osMutexId_t)mutex;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id)
+{
+    OS_Rtos2Mutex *mutex = (OS_Rtos2Mutex *)mutex_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (mutex == NULL)
+        return osErrorParameter;
+    if (mutex->Owner != NULL || mutex->Sem.WaitListHead != NULL)
+        return osErrorResource;
+
+    mutex->Name = NULL;
+    return osOK;
+}
+
+const char *osMutexGetName(osMutexId_t mutex_id)
+{
+    return (mutex_id == NULL) ? NULL : ((OS_Rtos2Mutex *)mutex_id)->Name;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+    OS_Rtos2Mutex *mutex = (OS_Rtos2Mutex *)mutex_id;
+    osStatus_t status;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (mutex == NULL)
+        return osErrorParameter;
+
+    if (mutex->Owner == CurrentTCB) // 只有持有者自己会走到这里，不需要关中断
+    {
+        if (!(mutex->AttrBits & osMutexRecursive))
+            return osErrorResource;
+        mutex->Nesting++;
+        return osOK;
+    }
+
+    status = SemAcquire(&mutex->Sem, timeout);
+    if (status == osOK)
+    {
+        mutex->Owner = CurrentTCB;
+        mutex->Nesting = 1;
+    }
+    return status;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+    OS_Rtos2Mutex *mutex = (OS_Rtos2Mutex *)mutex_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (mutex == NULL)
+        return osErrorParameter;
+    if (mutex->Owner != CurrentTCB)
+        return osErrorResource;
+
+    if (--mutex->Nesting == 0)
+    {
+        mutex->Owner = NULL;
+        OS_SemPost(&mutex->Sem);
+    }
+    return osOK;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id)
+{
+    return (mutex_id == NULL) ? NULL : (osThreadId_t)((OS_Rtos2Mutex *)mutex_id)->Owner;
+}
+
+/* ==== Semaphore Management Functions ==== */
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr)
+{
+    OS_Rtos2Semaphore *sem;
+
+    if (attr == NULL || OS_CPU_InISR())
+        return NULL;
+    if (max_count == 0 || max_count > 0xFFFFu || initial_count > max_count)
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2Semaphore))
+        return NULL;
+
+    sem = (OS_Rtos2Semaphore *)attr->cb_mem;
+    sem->MaxCount = max_count;
+    sem->Name = attr->name;
+    SemInit(&sem->Sem, (uint16_t)initial_count);
+
+    return (osSemaphoreId_t)sem;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id)
+{
+    OS_Rtos2Semaphore *sem = (OS_Rtos2Semaphore *)semaphore_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (sem == NULL)
+        return osErrorParameter;
+    if (sem->Sem.WaitListHead != NULL)
+        return osErrorResource;
+
+    sem->Name = NULL;
+    return osOK;
+}
+
+const char *osSemaphoreGetName(osSemaphoreId_t semaphore_id)
+{
+    return (semaphore_id == NULL) ? NULL : ((OS_Rtos2Semaphore *)semaphore_id)->Name;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+    if (semaphore_id == NULL)
+        return osErrorParameter;
+
+    return SemAcquire(&((OS_Rtos2Semaphore *)semaphore_id)->Sem, timeout);
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+    OS_Rtos2Semaphore *sem = (OS_Rtos2Semaphore *)semaphore_id;
+
+    if (sem == NULL)
+        return osErrorParameter;
+    if (sem->Sem.count >= sem->MaxCount)
+        return osErrorResource;
+
+    OS_SemPost(&sem->Sem);
+    return osOK;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id)
+{
+    return (semaphore_id == NULL) ? 0 : ((OS_Rtos2Semaphore *)semaphore_id)->Sem.count;
+}
+
+/* ==== Message Queue Management Functions ==== */
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+    OS_Rtos2MessageQueue *mq;
+    uint8_t *mem;
+
+    if (attr == NULL || OS_CPU_InISR() || msg_size == 0 || msg_count > 0xFFFFu)
+        return NULL;
+    if (attr->cb_mem == NULL || attr->cb_size < sizeof(OS_Rtos2MessageQueue))
+        return NULL;
+    if (attr->mq_mem == NULL || attr->mq_size < OS_RTOS2_MQ_MEM_SIZE(msg_count, msg_size))
+        return NULL;
+
+    // mq_mem 前半放消息，后半（4 字节对齐）放每个槽位的序号
+    mq = (OS_Rtos2MessageQueue *)attr->cb_mem;
+    mem = (uint8_t *)attr->mq_mem;
+    if (!OS_MpmcQueueInit(&mq->Queue, mem, (volatile uint32_t *)(mem + ((msg_count * msg_size + 3u) & ~3u)),
+                          msg_count, msg_size))
+        return NULL; // msg_count 不是 2 的幂或小于 2
+
+    mq->Name = attr->name;
+    SemInit(&mq->Items, 0);
+    SemInit(&mq->Slots, (uint16_t)msg_count);
+
+    return (osMessageQueueId_t)mq;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id)
+{
+    OS_Rtos2MessageQueue *mq = (OS_Rtos2MessageQueue *)mq_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (mq == NULL)
+        return osErrorParameter;
+    if (mq->Items.WaitListHead != NULL || mq->Slots.WaitListHead != NULL)
+        return osErrorResource;
+
+    mq->Name = NULL;
+    return osOK;
+}
+
+const char *osMessageQueueGetName(osMessageQueueId_t mq_id)
+{
+    return (mq_id == NULL) ? NULL : ((OS_Rtos2MessageQueue *)mq_id)->Name;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+    OS_Rtos2MessageQueue *mq = (OS_Rtos2MessageQueue *)mq_id;
+    osStatus_t status;
+
+    (void)msg_prio; // 不支持消息优先级，按先进先出处理
+
+    if (mq == NULL || msg_ptr == NULL)
+        return osErrorParameter;
+
+    status = SemAcquire(&mq->Slots, timeout);
+    if (status != osOK)
+        return status;
+
+    // 拿到了空位，但取走它的消费者可能被打断、还没归还槽位：任务里让一让，中断里放弃
+    while (!OS_MpmcQueuePush(&mq->Queue, msg_ptr))
+    {
+        if (OS_CPU_InISR())
+        {
+            OS_SemPost(&mq->Slots);
+            return osErrorResource;
+        }
+        OS_Yield();
+    }
+
+    OS_SemPost(&mq->Items);
+    return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+    OS_Rtos2MessageQueue *mq = (OS_Rtos2MessageQueue *)mq_id;
+    osStatus_t status;
+
+    if (mq == NULL || msg_ptr == NULL)
+        return osErrorParameter;
+
+    status = SemAcquire(&mq->Items, timeout);
+    if (status != osOK)
+        return status;
+
+    // 同理：排在前面的生产者可能还没写完
+    while (!OS_MpmcQueuePop(&mq->Queue, msg_ptr))
+    {
+        if (OS_CPU_InISR())
+        {
+            OS_SemPost(&mq->Items);
+            return osErrorResource;
+        }
+        OS_Yield();
+    }
+
+    if (msg_prio != NULL)
+        *msg_prio = 0;
+
+    OS_SemPost(&mq->Slots);
+    return osOK;
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id)
+{
+    return (mq_id == NULL) ? 0 : ((OS_Rtos2MessageQueue *)mq_id)->Queue.Mask + 1;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id)
+{
+    return (mq_id == NULL) ? 0 : ((OS_Rtos2MessageQueue *)mq_id)->Queue.ItemSize;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id)
+{
+    return (mq_id == NULL) ? 0 : ((OS_Rtos2MessageQueue *)mq_id)->Items.count;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id)
+{
+    return (mq_id == NULL) ? 0 : ((OS_Rtos2MessageQueue *)mq_id)->Slots.count;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id)
+{
+    OS_Rtos2MessageQueue *mq = (OS_Rtos2MessageQueue *)mq_id;
+
+    if (OS_CPU_InISR())
+        return osErrorISR;
+    if (mq == NULL)
+        return osErrorParameter;
+
+    // 像 osMessageQueueGet 一样逐条取出丢掉，空位还给生产者；并发的 Put 照常进行
+    while (SemAcquire(&mq->Items, 0) == osOK)
+    {
+        while (!OS_MpmcQueuePop(&mq->Queue, NULL))
+        {
+            OS_Yield();
+        }
+        OS_SemPost(&mq->Slots);
+    }
+    return osOK;
+}
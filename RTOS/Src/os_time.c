@@ -0,0 +1,270 @@
+/**
+ ******************************************************************************
+ * @file    os_time.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 高分辨率单调时间实现
+ *
+ * 一致性读取 (不关中断)：
+ * - 先后两次读 g_SystemTickCount，中间读高 32 位和定时器计数；
+ *   两次不相等说明节拍中断插了进来，重读即可
+ * - 定时器已经回绕、但节拍中断还没来得及执行（例如在临界区或更高优先级中断里）时，
+ *   用溢出标志补上这一拍。先读计数再读溢出标志：看到溢出时再读一次计数，
+ *   保证用的是回绕之后的值
+ * - 唯一的例外：比节拍中断优先级更高的中断，恰好打断了节拍中断入口到计数加一之间，
+ *   这时读到的时间会落后一拍
+ *
+ * 微秒延时：
+ * - 忙等不依赖节拍中断：直接盯着定时器计数，自己累计经过的计数（含回绕），
+ *   所以在调度器启动前、临界区里、比节拍中断优先级更高的中断里都能按时返回
+ * - 唤醒时刻用节拍定时器计数表示，和 OS_TimeNowCycles 直接比较
+ * - HrWaitListHead 按唤醒时刻从早到晚排序，链表头变化时重新给 TIM3 编程
+ * - TIM3 中断里唤醒所有已经到期的任务；定时器提前或分段到达时只是重新编程
+ *
+ * 周期等待：
+ * - 起点由上一个起点加 period 得到，不从返回的时刻算，计算耗时的抖动不会累积
+ * - 错过的起点只计数、不补跑，之后从当前节拍重新对齐
+ *
+ ******************************************************************************
+ */
+
+#include "os_time.h"
+#include "os_tick.h"
+
+extern void RequestSchedule(void);
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_TCB *HrWaitListHead = NULL; // 按唤醒时刻排序的等待链表
+static uint8_t HrTimerReady = 0;      // TIM3 是否已经初始化
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint64_t TimeRead(uint32_t *p_count, uint32_t *p_overflow)
+{
+    uint32_t low;
+    uint32_t high;
+    uint32_t count;
+    uint32_t overflow;
+
+    do
+    {
+        low = g_SystemTickCount;
+        high = g_SystemTickCountHigh;
+        count = OS_Tick_GetCount();
+        overflow = OS_Tick_GetOverflow();
+        if (overflow)
+        {
+            count = OS_Tick_GetCount(); // 回绕之后的计数
+        }
+    } while (low != g_SystemTickCount);
+
+    if (p_count != NULL)
+        *p_count = count;
+    if (p_overflow != NULL)
+        *p_overflow = overflow;
+
+    return ((uint64_t)high << 32) | low;
+}
+
+// 为链表头重新编程单次定时器，调用者负责关中断
+static void HrTimerProgram(void)
+{
+    uint64_t now;
+    uint64_t remain;
+    uint32_t clock;
+
+    if (HrWaitListHead == NULL)
+    {
+        OS_HrTimer_Stop();
+        return;
+    }
+
+    now = OS_TimeNowCycles();
+    if (HrWaitListHead->WakeCycles <= now)
+    {
+        OS_HrTimer_Start(1); // 已经到期，尽快进一次中断
+        return;
+    }
+
+    // 向上取整，宁可晚一点也不能提前唤醒
+    clock = OS_Tick_GetClock();
+    remain = HrWaitListHead->WakeCycles - now;
+    remain = (remain * 1000000u + clock - 1) / clock;
+    OS_HrTimer_Start(remain > 0xFFFF ? 0xFFFF : (uint32_t)remain);
+}
+
+// 忙等 cycles 个节拍定时器计数，只读定时器计数，不依赖节拍中断有没有执行
+// 每次轮询都远快于一个节拍周期，所以相邻两次读数之间最多回绕一次
+static void DelaySpin(uint64_t cycles)
+{
+    uint32_t interval = OS_Tick_GetInterval();
+    uint32_t last = OS_Tick_GetCount();
+    uint32_t now;
+    uint32_t still = 0;
+    uint64_t elapsed = 0;
+
+    while (elapsed < cycles)
+    {
+        now = OS_Tick_GetCount();
+        if (now == last)
+        {
+            // 定时器还没开始计数（例如 TIM2 作时钟源、调度器启动之前），等不到就放弃
+            if (++still > interval)
+                return;
+            continue;
+        }
+        still = 0;
+        elapsed += (now > last) ? (now - last) : (interval - last + now);
+        last = now;
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint64_t OS_TimeNowTicks(void)
+{
+    return TimeRead(NULL, NULL);
+}
+
+uint64_t OS_TimeNowCycles(void)
+{
+    uint32_t count;
+    uint32_t overflow;
+    uint64_t ticks = TimeRead(&count, &overflow);
+
+    if (overflow) // 这一拍的中断还没处理，补上
+    {
+        ticks++;
+    }
+
+    return ticks * OS_Tick_GetInterval() + count;
+}
+
+uint64_t OS_TimeCyclesToNs(uint64_t cycles)
+{
+    uint32_t clock = OS_Tick_GetClock();
+
+    // 拆成整秒和余数两部分，避免 cycles * 1e9 溢出 64 位
+    return (cycles / clock) * 1000000000ull + (cycles % clock) * 1000000000ull / clock;
+}
+
+uint64_t OS_TimeNowNs(void)
+{
+    return OS_TimeCyclesToNs(OS_TimeNowCycles());
+}
+
+void OS_DelayUs(uint32_t us)
+{
+    uint64_t wake;
+    OS_TCB **pp;
+
+    if (us == 0)
+        return;
+
+    // 1. 太短或者不能阻塞：忙等
+    if (us < OS_CFG_DELAY_US_SPIN || OS_CPU_InISR() || g_OSRunning == 0 || g_SchedLockNesting > 0)
+    {
+        DelaySpin((uint64_t)us * OS_Tick_GetClock() / 1000000u);
+        return;
+    }
+
+    wake = OS_TimeNowCycles() + (uint64_t)us * OS_Tick_GetClock() / 1000000u;
+
+    OS_EnterCritical();
+
+    // 2. 第一次使用时才初始化 TIM3
+    if (!HrTimerReady)
+    {
+        OS_HrTimer_Init();
+        HrTimerReady = 1;
+    }
+
+    // 3. 按唤醒时刻插入等待链表（同一时刻先来先唤醒）
+    CurrentTCB->WakeCycles = wake;
+    pp = &HrWaitListHead;
+    while (*pp != NULL && (*pp)->WakeCycles <= wake)
+    {
+        pp = &(*pp)->NextHrTask;
+    }
+    CurrentTCB->NextHrTask = *pp;
+    *pp = CurrentTCB;
+
+    // 4. 阻塞：DelayTicks 为 0，节拍中断不会碰它，只能由 TIM3 唤醒
+    CurrentTCB->DelayTicks = 0;
+    CurrentTCB->State = TASK_BLOCKED;
+
+    // 5. 成了最早的截止时间，定时器要提前
+    if (HrWaitListHead == CurrentTCB)
+    {
+        HrTimerProgram();
+    }
+
+    RequestSchedule();
+
+    OS_ExitCritical();
+}
+
+uint32_t OS_DelayUntil(uint64_t *p_next, uint32_t period)
+{
+    uint64_t now;
+    uint32_t missed;
+
+    // 0. 周期为 0 会除零；上锁或在中断里 OS_Delay 不阻塞，返回 0 会被当成按时
+    if (period == 0 || g_SchedLockNesting > 0 || OS_CPU_InISR())
+        return OS_DELAY_UNTIL_ERROR;
+
+    // 1. 按绝对时刻算这一个周期的起点，避免 OS_Delay 的误差累积
+    *p_next += period;
+
+    // 2. 还没到：睡到起点。读时间和设置延时之间不能插进节拍，否则会晚醒一拍
+    OS_EnterCritical();
+    now = OS_TimeNowTicks();
+    if (now < *p_next)
+    {
+        OS_Delay((uint32_t)(*p_next - now));
+        OS_ExitCritical();
+        return 0;
+    }
+    OS_ExitCritical();
+
+    // 3. 恰好是起点：不算错过
+    if (now == *p_next)
+        return 0;
+
+    // 4. 已经过了：严格早于当前节拍的起点都算错过，从当前节拍重新对齐
+    missed = (uint32_t)((now - *p_next - 1u) / period) + 1u;
+    *p_next = now;
+    OS_Yield();
+    return missed;
+}
+
+void OS_HrTimer_IRQHandler(void)
+{
+    uint64_t now;
+    OS_TCB *tcb;
+
+    OS_HrTimer_AcknowledgeIRQ();
+
+    // 和节拍中断一样：更高优先级的中断可能同时改任务状态，整段放进临界区
+    OS_EnterCritical();
+
+    // 1. 唤醒所有已经到期的任务
+    now = OS_TimeNowCycles();
+    while (HrWaitListHead != NULL && HrWaitListHead->WakeCycles <= now)
+    {
+        tcb = HrWaitListHead;
+        HrWaitListHead = tcb->NextHrTask;
+        tcb->NextHrTask = NULL;
+        tcb->State = TASK_READY;
+    }
+
+    // 2. 为下一个截止时间编程（链表空了就停掉）
+    HrTimerProgram();
+
+    // 3. 和节拍中断一样，上锁时只记录待切换
+    RequestSchedule();
+
+    OS_ExitCritical();
+}
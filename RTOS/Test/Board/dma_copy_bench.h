@@ -0,0 +1,49 @@
+/**
+ ******************************************************************************
+ * @file    dma_copy_bench.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   memcpy 与 DMA 拷贝的耗时对比 (板上运行，用来定 OS_DMA_COPY_MIN)
+ *
+ * 16 B 到 4 KB 每个长度各测 memcpy 和 DMA 拷贝（OS_DmaCopyAsync + OS_DmaCopyWait，
+ * 即 OS_DmaCopy 不走 memcpy 时的路径）的 DWT 周期数，取多次中的最小值。
+ * DMA 的时间从提交到调用者被唤醒为止，包括启动、完成中断和两次任务切换。
+ *
+ ******************************************************************************
+ */
+
+#ifndef __DMA_COPY_BENCH_H
+#define __DMA_COPY_BENCH_H
+
+#include "os_dma.h"
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define DMA_BENCH_MAX_LEN  4096u  ///< 最大测试长度，长度从 16 起每次翻倍
+#define DMA_BENCH_POINTS   9u     ///< 16, 32, ..., 4096
+#define DMA_BENCH_REPEAT   8u     ///< 每个长度重复次数
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+typedef struct
+{
+    uint32_t Len;           ///< 字节数
+    uint32_t MemcpyCycles;  ///< memcpy 的周期数
+    uint32_t DmaCycles;     ///< DMA 拷贝的周期数，出错时为 0
+} DmaBenchPoint;
+
+extern DmaBenchPoint g_DmaBench[DMA_BENCH_POINTS];
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  测一遍所有长度，结果写进 g_DmaBench
+ * @note   在任务里、调度器已经启动、至少加过一个通道之后调用；
+ *         测量期间不要有别的任务就绪，否则 DMA 一侧会算上它们的运行时间
+ * @return uint32_t: DMA 比 memcpy 快的最小长度（之后的长度也都更快），
+ *                   0 表示测到 4 KB 都不比 memcpy 快或者 DMA 出错
+ */
+uint32_t DmaCopyBench(void);
+
+#endif /* __DMA_COPY_BENCH_H */
@@ -0,0 +1,252 @@
+/**
+ ******************************************************************************
+ * @file    delay_until.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   OS_DelayUntil 的测试 (Linux 主机)
+ *
+ * 主线程扮演周期任务；节拍由主线程直接打（任务不阻塞时），
+ * 或者由扮演节拍中断的线程打（任务阻塞在 OS_Delay 里时）。
+ * 节拍线程记下任务被唤醒时的节拍数。
+ *
+ * 覆盖：起点恰好是当前节拍（不算错过、不阻塞）、晚一拍、晚整数个周期及多一拍
+ * 时错过的个数；按时的周期准确在起点醒来，连续多个周期不漂移；
+ * 超时之后从当前节拍重新对齐；周期为 0、调度器上锁、在中断里调用时报错，
+ * 不改起点、不阻塞。
+ *
+ ******************************************************************************
+ */
+
+#include "os_time.h"
+#include "os_tick.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define PERIOD 10u
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_TCB g_TaskTcb;
+static OS_TCB g_IdleTcb;
+static uint32_t g_DummyStack[2][16];
+
+static volatile uint8_t g_Ticking = 0;    // 节拍线程是否打节拍
+static volatile uint32_t g_TickRounds = 0; // 节拍线程的轮数
+static volatile uint64_t g_WokeAt = 0;    // 任务最近一次被节拍唤醒时的节拍数
+static volatile uint8_t g_Stop = 0;
+static uint32_t g_Errors = 0;
+
+/* 模拟节拍定时器和 TIM3 ----------------------------------------------- */
+
+// 计数停在 0，时间只按节拍走
+uint32_t OS_Tick_GetCount(void)
+{
+    return 0;
+}
+
+uint32_t OS_Tick_GetOverflow(void)
+{
+    return 0;
+}
+
+uint32_t OS_Tick_GetInterval(void)
+{
+    return 72000u;
+}
+
+uint32_t OS_Tick_GetClock(void)
+{
+    return 72000000u;
+}
+
+void OS_HrTimer_Init(void)
+{
+}
+
+void OS_HrTimer_Start(uint32_t us)
+{
+}
+
+void OS_HrTimer_Stop(void)
+{
+}
+
+void OS_HrTimer_AcknowledgeIRQ(void)
+{
+}
+
+static void *TickThread(void *arg)
+{
+    struct timespec nap = {0, 50000};
+    uint8_t blocked;
+
+    (void)arg;
+    while (!g_Stop)
+    {
+        nanosleep(&nap, NULL);
+
+        if (g_Ticking)
+        {
+            HostIsrEnter();
+            blocked = (g_TaskTcb.State == TASK_BLOCKED);
+            OS_Tick_Handler();
+            if (blocked && g_TaskTcb.State == TASK_READY)
+                g_WokeAt = OS_TimeNowTicks();
+            HostIsrExit();
+        }
+        __atomic_fetch_add(&g_TickRounds, 1u, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// 任务不阻塞时由主线程自己打 n 个节拍
+static void Tick(uint32_t n)
+{
+    while (n--)
+    {
+        HostIsrEnter();
+        OS_Tick_Handler();
+        HostIsrExit();
+    }
+}
+
+// 停下节拍线程，等它正在打的那一拍结束
+static void TickPause(void)
+{
+    uint32_t rounds;
+
+    g_Ticking = 0;
+    rounds = g_TickRounds;
+    while (g_TickRounds - rounds < 2u)
+        sched_yield();
+}
+
+// 在 OS_DelayUntil 之前，起点已经比当前节拍早 late 拍时的返回值
+static uint32_t Late(uint64_t late, uint64_t *p_next)
+{
+    uint64_t now = OS_TimeNowTicks();
+    uint32_t missed;
+
+    *p_next = now - PERIOD - late;
+    missed = OS_DelayUntil(p_next, PERIOD);
+    CHECK(*p_next == now);
+    CHECK(OS_TimeNowTicks() == now); // 没有阻塞
+    return missed;
+}
+
+static void TestBoundary(void)
+{
+    uint64_t next;
+
+    Tick(5u * PERIOD);
+
+    // 恰好在起点：不算错过
+    CHECK(Late(0, &next) == 0);
+    // 晚一拍
+    CHECK(Late(1, &next) == 1);
+    // 晚整一个周期：下一个起点正好是现在，只错过一个
+    CHECK(Late(PERIOD, &next) == 1);
+    CHECK(Late(PERIOD + 1u, &next) == 2);
+    CHECK(Late(3u * PERIOD - 1u, &next) == 3);
+    CHECK(Late(3u * PERIOD, &next) == 3);
+}
+
+static void TestErrors(void)
+{
+    uint64_t now = OS_TimeNowTicks();
+    uint64_t next = now - 1u;
+
+    // 周期为 0：不能除零
+    CHECK(OS_DelayUntil(&next, 0) == OS_DELAY_UNTIL_ERROR);
+    CHECK(next == now - 1u);
+
+    // 上锁时 OS_Delay 不阻塞，不能当成按时返回
+    next = now;
+    OS_SchedLock();
+    CHECK(OS_DelayUntil(&next, PERIOD) == OS_DELAY_UNTIL_ERROR);
+    OS_SchedUnlock();
+    CHECK(next == now);
+
+    HostIsrEnter();
+    CHECK(OS_DelayUntil(&next, PERIOD) == OS_DELAY_UNTIL_ERROR);
+    HostIsrExit();
+    CHECK(next == now);
+    CHECK(OS_TimeNowTicks() == now);
+}
+
+static void TestPeriodic(void)
+{
+    uint64_t start;
+    uint64_t next;
+    uint64_t now;
+    uint32_t i;
+
+    // 1. 按时的周期：每次准确在起点醒来，不漂移
+    start = OS_TimeNowTicks();
+    next = start;
+    g_Ticking = 1;
+    for (i = 1; i <= 20u; i++)
+    {
+        // 模拟计算：耗时 0 ~ 3 拍
+        while (OS_TimeNowTicks() < next + i % 4u)
+            sched_yield();
+        CHECK(OS_DelayUntil(&next, PERIOD) == 0);
+        CHECK(next == start + (uint64_t)i * PERIOD);
+        CHECK(g_WokeAt == next);
+    }
+
+    // 2. 一次计算跑过了两个起点：错过 2 个，从当前节拍重新对齐
+    while (OS_TimeNowTicks() < next + 2u * PERIOD + 3u)
+        sched_yield();
+    TickPause();
+    now = OS_TimeNowTicks();
+    CHECK(OS_DelayUntil(&next, PERIOD) == 2);
+    CHECK(next == now);
+
+    // 3. 之后恢复按时
+    g_Ticking = 1;
+    CHECK(OS_DelayUntil(&next, PERIOD) == 0);
+    CHECK(next == now + PERIOD);
+    CHECK(g_WokeAt == next);
+    TickPause();
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    pthread_t tick;
+
+    OS_TaskCreate(&g_IdleTcb, NULL, g_DummyStack[0], 16);
+    OS_TaskCreate(&g_TaskTcb, NULL, g_DummyStack[1], 16);
+    HostTaskBind(&g_TaskTcb);
+    g_OSRunning = 1;
+
+    pthread_create(&tick, NULL, TickThread, NULL);
+
+    TestBoundary();
+    TestErrors();
+    TestPeriodic();
+
+    g_Stop = 1;
+    pthread_join(tick, NULL);
+
+    printf("delay_until: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
@@ -0,0 +1,350 @@
+/**
+ ******************************************************************************
+ * @file    gru_compare.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   流式 GRU (OS_GruStep) 与 CMSIS-NN gru 例程的逐位对比 (Linux 主机)
+ *
+ * - 例程：gru 例程的权重，X4（_opt 重排，例程的 USE_X4）和 X2（普通全连接）两种布局，
+ *   从例程的初始历史状态出发，先喂例程的两帧输入，再喂随机帧；
+ *   每一帧 OS_GruStep 之后的隐藏状态都必须和 gru_example() 的调用顺序逐位一致
+ * - 随机：随机的 InputSize / HistorySize（包括不是 4 的倍数的）、随机权重和位移，两种布局
+ * - 帧直接写进 p_gru->Input（frame 为 NULL）、OS_GruReset 之后从零状态重新开始，结果同样一致
+ * - OS_GruRunPeriodic：取不到帧的周期不计算；BudgetCycles 为 0 不统计，
+ *   设了之后超出的帧计入 OverBudget；OS_DelayUntil 报告的错过起点计入 Overruns，报错时返回
+ *
+ * 缓冲区后面留一段哨兵，OS_GruStep 越界写也算不一致。
+ * 用 port/arm_math_dsp.h 编译就是 Cortex-M4 的 DSP 路径 (gru_compare_dsp)。
+ *
+ * 用法：gru_compare [每种布局的随机帧数]
+ *
+ ******************************************************************************
+ */
+
+#include "os_gru.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arm_nnexamples_gru_test_data.h"
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define DIM_HISTORY  32
+#define DIM_INPUT    32
+#define DIM_VEC      64
+#define MAX_DIM      48u     ///< 随机用例的 InputSize / HistorySize 上限
+#define RAND_CASES   40u     ///< 随机几何的用例数
+#define GUARD        16u     ///< 缓冲区后面的哨兵 q15 个数
+#define GUARD_VALUE  0x5A5A
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static const q7_t g_UpdateX4[DIM_VEC * DIM_HISTORY] = UPDATE_GATE_WEIGHT_X4;
+static const q7_t g_ResetX4[DIM_VEC * DIM_HISTORY] = RESET_GATE_WEIGHT_X4;
+static const q7_t g_HiddenX4[DIM_VEC * DIM_HISTORY] = HIDDEN_STATE_WEIGHT_X4;
+static const q7_t g_UpdateX2[DIM_VEC * DIM_HISTORY] = UPDATE_GATE_WEIGHT_X2;
+static const q7_t g_ResetX2[DIM_VEC * DIM_HISTORY] = RESET_GATE_WEIGHT_X2;
+static const q7_t g_HiddenX2[DIM_VEC * DIM_HISTORY] = HIDDEN_STATE_WEIGHT_X2;
+static const q7_t g_UpdateBias[DIM_HISTORY] = UPDATE_GATE_BIAS;
+static const q7_t g_ResetBias[DIM_HISTORY] = RESET_GATE_BIAS;
+static const q7_t g_HiddenBias[DIM_HISTORY] = HIDDEN_STATE_BIAS;
+static const q15_t g_Input1[DIM_INPUT] = INPUT_DATA1;
+static const q15_t g_Input2[DIM_INPUT] = INPUT_DATA2;
+static const q15_t g_History[DIM_HISTORY] = HISTORY_DATA;
+
+static uint32_t g_Seed = 0x9E3779B9u;
+static uint32_t g_Frames = 200u;
+static uint32_t g_Errors = 0;
+
+// OS_GruRunPeriodic 用的取帧和 OS_DelayUntil 桩
+static uint32_t g_Fetches;
+static uint32_t g_Delays;
+static uint32_t g_DelayLimit;
+
+/* 主机桩 ------------------------------------------------------------- */
+
+// 主机上用单调时钟（纳秒）代替节拍定时器
+uint64_t OS_TimeNowCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t OS_TimeNowTicks(void)
+{
+    return 0;
+}
+
+// 每次报告错过 2 个起点，第 g_DelayLimit 次报错让主循环返回
+uint32_t OS_DelayUntil(uint64_t *p_next, uint32_t period)
+{
+    return (++g_Delays >= g_DelayLimit) ? OS_DELAY_UNTIL_ERROR : 2u;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t Rand(void)
+{
+    g_Seed ^= g_Seed << 13;
+    g_Seed ^= g_Seed >> 17;
+    g_Seed ^= g_Seed << 5;
+    return g_Seed;
+}
+
+static uint16_t RandIn(uint16_t lo, uint16_t hi)
+{
+    return (uint16_t)(lo + Rand() % (hi - lo + 1u));
+}
+
+// 例程输入的幅度在 ±512 左右，随机帧取同一个范围
+static void RandFrame(q15_t *frame, uint16_t n)
+{
+    uint16_t i;
+
+    for (i = 0; i < n; i++)
+        frame[i] = (q15_t)((int32_t)(Rand() % 1025u) - 512);
+}
+
+static void RandWeights(q7_t *w, uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+        w[i] = (q7_t)Rand();
+}
+
+/**
+ * @brief  gru 例程的 gru_example()，x4 选 USE_X4 的 _opt 全连接
+ * @note   例程写死了 bias_shift 0、out_shift 15，这里取自 w，随机用例用别的位移
+ */
+static void GruExample(q15_t *scratch_input, uint16_t input_size, uint16_t history_size, uint8_t x4,
+                       const OS_GruWeights *w)
+{
+    q15_t *reset = scratch_input;
+    q15_t *input = scratch_input + history_size;
+    q15_t *history = scratch_input + history_size + input_size;
+    q15_t *update = scratch_input + 2 * history_size + input_size;
+    q15_t *hidden_state = scratch_input + 3 * history_size + input_size;
+    uint16_t vec = input_size + history_size;
+
+    uint16_t bs = w->BiasShift;
+    uint16_t os = w->OutShift;
+
+    // reset gate
+    if (x4)
+        arm_fully_connected_mat_q7_vec_q15_opt(input, w->Reset, vec, history_size, bs, os, w->ResetBias, reset, NULL);
+    else
+        arm_fully_connected_mat_q7_vec_q15(input, w->Reset, vec, history_size, bs, os, w->ResetBias, reset, NULL);
+    arm_nn_activations_direct_q15(reset, history_size, 0, ARM_SIGMOID);
+    arm_mult_q15(history, reset, reset, history_size);
+
+    // update gate
+    if (x4)
+        arm_fully_connected_mat_q7_vec_q15_opt(input, w->Update, vec, history_size, bs, os, w->UpdateBias, update, NULL);
+    else
+        arm_fully_connected_mat_q7_vec_q15(input, w->Update, vec, history_size, bs, os, w->UpdateBias, update, NULL);
+    arm_nn_activations_direct_q15(update, history_size, 0, ARM_SIGMOID);
+
+    // hidden state
+    if (x4)
+        arm_fully_connected_mat_q7_vec_q15_opt(reset, w->Hidden, vec, history_size, bs, os, w->HiddenBias, hidden_state,
+                                               NULL);
+    else
+        arm_fully_connected_mat_q7_vec_q15(reset, w->Hidden, vec, history_size, bs, os, w->HiddenBias, hidden_state,
+                                           NULL);
+    arm_nn_activations_direct_q15(hidden_state, history_size, 0, ARM_TANH);
+    arm_mult_q15(update, hidden_state, hidden_state, history_size);
+
+    // z - 1, then history_out = z * n - (z - 1) * h
+    arm_offset_q15(update, 0x8000, update, history_size);
+    arm_mult_q15(history, update, update, history_size);
+    arm_sub_q15(hidden_state, update, history, history_size);
+}
+
+/**
+ * @brief  从 history0（NULL 为零状态）出发跑 frames 帧，每帧比较隐藏状态
+ * @param  first: 最先喂的帧（可以为 NULL），之后是随机帧
+ */
+static void CompareRun(const char *name, const OS_GruWeights *w, uint16_t in, uint16_t hs,
+                       const q15_t *history0, const q15_t *const *first, uint32_t n_first, uint32_t frames)
+{
+    q15_t ref[OS_GRU_SCRATCH_SIZE(MAX_DIM, MAX_DIM)];
+    q15_t scratch[OS_GRU_SCRATCH_SIZE(MAX_DIM, MAX_DIM) + GUARD];
+    q15_t frame[MAX_DIM];
+    uint32_t size = OS_GRU_SCRATCH_SIZE(in, hs);
+    const q15_t *out;
+    OS_Gru gru;
+    uint32_t f;
+    uint32_t i;
+    uint32_t bad = 0;
+
+    for (i = 0; i < size + GUARD; i++)
+        scratch[i] = (q15_t)GUARD_VALUE;
+    OS_GruInit(&gru, w, in, hs, scratch);
+    memset(ref, 0, sizeof(ref));
+    if (history0 != NULL)
+    {
+        memcpy(gru.History, history0, hs * sizeof(q15_t));
+        memcpy(ref + hs + in, history0, hs * sizeof(q15_t));
+    }
+
+    for (f = 0; f < frames && !bad; f++)
+    {
+        if (f < n_first)
+            memcpy(frame, first[f], in * sizeof(q15_t));
+        else
+            RandFrame(frame, in);
+
+        memcpy(ref + hs, frame, in * sizeof(q15_t));
+        GruExample(ref, in, hs, w->Reordered, w);
+
+        // 奇数帧直接写进 Input，偶数帧通过参数传入
+        if (f & 1u)
+        {
+            memcpy(gru.Input, frame, in * sizeof(q15_t));
+            out = OS_GruStep(&gru, NULL);
+        }
+        else
+        {
+            out = OS_GruStep(&gru, frame);
+        }
+
+        if (out != gru.History || memcmp(out, ref + hs + in, hs * sizeof(q15_t)) != 0)
+            bad = f + 1u;
+    }
+    for (i = size; i < size + GUARD; i++)
+    {
+        if (scratch[i] != (q15_t)GUARD_VALUE)
+            bad = 0xFFFFFFFFu;
+    }
+
+    if (bad)
+    {
+        printf("FAIL %s in=%u hs=%u reordered=%u: %s %u\n", name, in, hs, w->Reordered,
+               (bad == 0xFFFFFFFFu) ? "wrote past the scratch buffer," : "differs at frame", bad);
+        g_Errors++;
+    }
+    CHECK(gru.Steps == frames || bad);
+}
+
+static void TestExample(uint8_t x4)
+{
+    static const q15_t *const first[] = {g_Input1, g_Input2};
+    OS_GruWeights w = {
+        x4 ? g_UpdateX4 : g_UpdateX2, x4 ? g_ResetX4 : g_ResetX2, x4 ? g_HiddenX4 : g_HiddenX2,
+        g_UpdateBias, g_ResetBias, g_HiddenBias, 0, 15, x4,
+    };
+
+    // 1. 例程的初始历史 + 例程的两帧 + 随机帧
+    CompareRun("example", &w, DIM_INPUT, DIM_HISTORY, g_History, first, 2, 2u + g_Frames);
+    // 2. OS_GruReset 之后的零状态
+    CompareRun("example-reset", &w, DIM_INPUT, DIM_HISTORY, NULL, first, 2, 2u + g_Frames / 4u);
+}
+
+static void TestRandom(void)
+{
+    static q7_t wt[3][(MAX_DIM + MAX_DIM) * MAX_DIM];
+    static q7_t bias[3][MAX_DIM];
+    OS_GruWeights w;
+    uint16_t in;
+    uint16_t hs;
+    uint32_t c;
+
+    for (c = 0; c < RAND_CASES; c++)
+    {
+        in = RandIn(1, MAX_DIM);
+        hs = RandIn(1, MAX_DIM);
+        RandWeights(&wt[0][0], sizeof(wt));
+        RandWeights(&bias[0][0], sizeof(bias));
+
+        w.Update = wt[0];
+        w.Reset = wt[1];
+        w.Hidden = wt[2];
+        w.UpdateBias = bias[0];
+        w.ResetBias = bias[1];
+        w.HiddenBias = bias[2];
+        // 例程的位移下全连接的输出只有几个 LSB，偏置会被舍掉；这里让输出铺满 q15 的范围
+        w.OutShift = RandIn(4, 12);
+        w.BiasShift = RandIn(0, w.OutShift);
+        w.Reordered = (uint8_t)(c & 1u);
+
+        CompareRun("random", &w, in, hs, NULL, NULL, 0, 20);
+    }
+}
+
+static uint8_t Fetch(q15_t *input, void *arg)
+{
+    const OS_Gru *gru = (const OS_Gru *)arg;
+
+    // 第 2 个周期没有新帧
+    if (++g_Fetches == 2u)
+        return 0;
+    RandFrame(input, gru->InputSize);
+    return 1;
+}
+
+static void TestPeriodic(void)
+{
+    OS_GruWeights w = {g_UpdateX4, g_ResetX4, g_HiddenX4, g_UpdateBias, g_ResetBias, g_HiddenBias, 0, 15, 1};
+    q15_t scratch[OS_GRU_SCRATCH_SIZE(DIM_INPUT, DIM_HISTORY)];
+    OS_Gru gru;
+
+    // 1. 不设预算：4 个周期，3 帧；前 3 次等待各错过 2 个起点，第 4 次报错返回
+    OS_GruInit(&gru, &w, DIM_INPUT, DIM_HISTORY, scratch);
+    g_Fetches = 0;
+    g_Delays = 0;
+    g_DelayLimit = 4;
+    OS_GruRunPeriodic(&gru, 10, Fetch, NULL, &gru);
+    CHECK(g_Fetches == 4);
+    CHECK(gru.Steps == 3);
+    CHECK(gru.Overruns == 6);
+    CHECK(gru.OverBudget == 0);
+    CHECK(gru.MaxCycles > 0);
+
+    // 2. 预算 1 ns：每一帧都超出；预算足够大：都不超出
+    OS_GruInit(&gru, &w, DIM_INPUT, DIM_HISTORY, scratch);
+    gru.BudgetCycles = 1;
+    g_Fetches = 0;
+    g_Delays = 0;
+    OS_GruRunPeriodic(&gru, 10, Fetch, NULL, &gru);
+    CHECK(gru.Steps == 3);
+    CHECK(gru.OverBudget == 3);
+
+    OS_GruInit(&gru, &w, DIM_INPUT, DIM_HISTORY, scratch);
+    gru.BudgetCycles = 1000000000u;
+    g_Fetches = 0;
+    g_Delays = 0;
+    OS_GruRunPeriodic(&gru, 10, Fetch, NULL, &gru);
+    CHECK(gru.Steps == 3);
+    CHECK(gru.OverBudget == 0);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+        g_Frames = (uint32_t)strtoul(argv[1], NULL, 0);
+
+    TestExample(1);
+    TestExample(0);
+    TestRandom();
+    TestPeriodic();
+
+    printf("gru_compare: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    stm32f1xx_hal.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   主机测试用的 HAL 替身 (只包含 RTOS/Drivers 用到的部分)
+ *
+ * 类型名、成员名、常量值与 STM32CubeF1 的 HAL 一致，驱动源码不用改就能编译；
+ * HAL 函数由各个测试自己实现（模拟外设行为）。
+ *
+ ******************************************************************************
+ */
+
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+#include <stdint.h>
+
+/* 通用 ------------------------------------------------------------------- */
+
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+/* 中断号 (stm32f103xb.h 的子集) ------------------------------------------ */
+
+typedef enum
+{
+    SysTick_IRQn        = -1,
+    DMA1_Channel1_IRQn  = 11,
+    DMA1_Channel2_IRQn  = 12,
+    DMA1_Channel3_IRQn  = 13,
+    DMA1_Channel4_IRQn  = 14,
+    DMA1_Channel5_IRQn  = 15,
+    DMA1_Channel6_IRQn  = 16,
+    DMA1_Channel7_IRQn  = 17,
+    USART1_IRQn         = 37,
+    USART2_IRQn         = 38,
+    USART3_IRQn         = 39
+} IRQn_Type;
+
+/* 外设地址：只用来比较和换算中断号，主机上从不解引用 */
+#define DMA1_Channel1_BASE  ((uintptr_t)0x40020008U)
+#define DMA1_Channel2_BASE  ((uintptr_t)0x4002001CU)
+#define DMA1_Channel3_BASE  ((uintptr_t)0x40020030U)
+#define DMA1_Channel4_BASE  ((uintptr_t)0x40020044U)
+#define DMA1_Channel5_BASE  ((uintptr_t)0x40020058U)
+#define DMA1_Channel6_BASE  ((uintptr_t)0x4002006CU)
+#define DMA1_Channel7_BASE  ((uintptr_t)0x40020080U)
+#define USART1_BASE         ((uintptr_t)0x40013800U)
+#define USART2_BASE         ((uintptr_t)0x40004400U)
+#define USART3_BASE         ((uintptr_t)0x40004800U)
+
+#define DMA1_Channel1  ((DMA_Channel_TypeDef *)DMA1_Channel1_BASE)
+#define DMA1_Channel2  ((DMA_Channel_TypeDef *)DMA1_Channel2_BASE)
+#define DMA1_Channel3  ((DMA_Channel_TypeDef *)DMA1_Channel3_BASE)
+#define DMA1_Channel4  ((DMA_Channel_TypeDef *)DMA1_Channel4_BASE)
+#define DMA1_Channel5  ((DMA_Channel_TypeDef *)DMA1_Channel5_BASE)
+#define DMA1_Channel6  ((DMA_Channel_TypeDef *)DMA1_Channel6_BASE)
+#define DMA1_Channel7  ((DMA_Channel_TypeDef *)DMA1_Channel7_BASE)
+#define USART1         ((USART_TypeDef *)USART1_BASE)
+#define USART2         ((USART_TypeDef *)USART2_BASE)
+#define USART3         ((USART_TypeDef *)USART3_BASE)
+
+/* DMA -------------------------------------------------------------------- */
+
+#define DMA_NORMAL    0x00000000U
+#define DMA_CIRCULAR  0x00000020U
+
+typedef struct
+{
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+    volatile uint32_t CPAR;
+    volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+} DMA_HandleTypeDef;
+
+/* UART ------------------------------------------------------------------- */
+
+typedef enum
+{
+    HAL_UART_STATE_RESET   = 0x00U,
+    HAL_UART_STATE_READY   = 0x20U,
+    HAL_UART_STATE_BUSY    = 0x24U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+    volatile uint32_t SR;
+    volatile uint32_t DR;
+    volatile uint32_t BRR;
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t CR3;
+    volatile uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+    USART_TypeDef *Instance;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+#endif /* __STM32F1xx_HAL_H */
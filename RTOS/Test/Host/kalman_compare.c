@@ -0,0 +1,416 @@
+/**
+ ******************************************************************************
+ * @file    kalman_compare.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   卡尔曼滤波服务与 double 参考实现的对比 (Linux 主机)
+ *
+ * - 6 状态匀速模型（三个轴的位置和速度），量测三个位置，跑 STEPS 步，
+ *   每步预测 + 更新；同样的输入（q31 版本用量化后的值）交给 double 参考实现，
+ *   逐步比较状态和协方差的最大绝对误差：float32 不超过 F32_TOL，q31 不超过 Q31_TOL
+ *   （本场景实测 float32 约 2.1e-7，q31 约 2.7e-6，两个门限各留了余量）
+ * - q31 的 F、H 对角线上的 1.0 按 arm_float_to_q31 的做法饱和成 0x7FFFFFFF，
+ *   参考实现用同样量化后的值
+ * - 增益大于 1（速度分量）时 q31 版本按 GainShift 缩放存储，这里一并覆盖
+ * - arm_mat_inverse_f32（MatInverse 用它求 m x m 的新息协方差的逆）：
+ *   随机的对称正定矩阵，1 到 6 阶，A * A^-1 与单位阵之差不超过 INV_TOL；
+ *   奇异矩阵要报 ARM_MATH_SINGULAR，滤波器据此跳过更新并计入 Singular
+ *
+ * 输出：format,steps,max_err_x,max_err_p
+ *
+ ******************************************************************************
+ */
+
+#include "os_kalman.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define N         6u
+#define M         3u
+#define STEPS     500u
+#define DT        0.05
+#define F32_TOL   5e-7
+#define Q31_TOL   1e-5
+#define INV_TOL   1e-5
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  double 参考滤波器
+ */
+typedef struct
+{
+    double F[N * N], H[M * N], Q[N * N], R[M * M];
+    double X[N], P[N * N];
+} RefKalman;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Seed = 0x1234567u;
+static uint32_t g_Errors = 0;
+
+/* 主机桩 ------------------------------------------------------------- */
+
+uint64_t OS_TimeNowCycles(void)
+{
+    return 0;
+}
+
+uint64_t OS_TimeNowTicks(void)
+{
+    return 0;
+}
+
+uint32_t OS_DelayUntil(uint64_t *p_next, uint32_t period)
+{
+    return OS_DELAY_UNTIL_ERROR;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// [-1, 1) 的均匀分布
+static double RandUnit(void)
+{
+    g_Seed = g_Seed * 1664525u + 1013904223u;
+    return (double)(int32_t)g_Seed / 2147483648.0;
+}
+
+static void MatMul(const double *a, const double *b, double *c, uint32_t rows, uint32_t inner, uint32_t cols)
+{
+    uint32_t i, j, k;
+
+    for (i = 0; i < rows; i++)
+    {
+        for (j = 0; j < cols; j++)
+        {
+            double sum = 0;
+
+            for (k = 0; k < inner; k++)
+                sum += a[i * inner + k] * b[k * cols + j];
+            c[i * cols + j] = sum;
+        }
+    }
+}
+
+static void MatTrans(const double *a, double *t, uint32_t rows, uint32_t cols)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < rows; i++)
+        for (j = 0; j < cols; j++)
+            t[j * rows + i] = a[i * cols + j];
+}
+
+// 高斯-约当消元，列主元；奇异时返回 0
+static int MatInv(const double *a, double *inv, uint32_t n)
+{
+    double w[N * N];
+    uint32_t i, j, k, p;
+    double t;
+
+    memcpy(w, a, n * n * sizeof(double));
+    for (i = 0; i < n; i++)
+        for (j = 0; j < n; j++)
+            inv[i * n + j] = (i == j);
+
+    for (k = 0; k < n; k++)
+    {
+        for (p = k, i = k + 1u; i < n; i++)
+            if (fabs(w[i * n + k]) > fabs(w[p * n + k]))
+                p = i;
+        if (w[p * n + k] == 0)
+            return 0;
+        for (j = 0; j < n; j++)
+        {
+            t = w[k * n + j]; w[k * n + j] = w[p * n + j]; w[p * n + j] = t;
+            t = inv[k * n + j]; inv[k * n + j] = inv[p * n + j]; inv[p * n + j] = t;
+        }
+        t = w[k * n + k];
+        for (j = 0; j < n; j++)
+        {
+            w[k * n + j] /= t;
+            inv[k * n + j] /= t;
+        }
+        for (i = 0; i < n; i++)
+        {
+            if (i == k)
+                continue;
+            t = w[i * n + k];
+            for (j = 0; j < n; j++)
+            {
+                w[i * n + j] -= t * w[k * n + j];
+                inv[i * n + j] -= t * inv[k * n + j];
+            }
+        }
+    }
+    return 1;
+}
+
+static void RefPredict(RefKalman *r)
+{
+    double x[N], fp[N * N], ft[N * N];
+    uint32_t i;
+
+    MatMul(r->F, r->X, x, N, N, 1);
+    memcpy(r->X, x, sizeof(x));
+    MatTrans(r->F, ft, N, N);
+    MatMul(r->F, r->P, fp, N, N, N);
+    MatMul(fp, ft, r->P, N, N, N);
+    for (i = 0; i < N * N; i++)
+        r->P[i] += r->Q[i];
+}
+
+static void RefUpdate(RefKalman *r, const double *z)
+{
+    double y[M], hx[M], hp[M * N], ht[N * M], s[M * M], si[M * M], pht[N * M], k[N * M], ky[N], khp[N * N];
+    uint32_t i, j;
+
+    MatMul(r->H, r->X, hx, M, N, 1);
+    for (i = 0; i < M; i++)
+        y[i] = z[i] - hx[i];
+    MatMul(r->H, r->P, hp, M, N, N);
+    MatTrans(r->H, ht, M, N);
+    MatMul(hp, ht, s, M, N, M);
+    for (i = 0; i < M * M; i++)
+        s[i] += r->R[i];
+    MatInv(s, si, M);
+    MatTrans(hp, pht, M, N);
+    MatMul(pht, si, k, N, M, M);
+    MatMul(k, y, ky, N, M, 1);
+    for (i = 0; i < N; i++)
+        r->X[i] += ky[i];
+    MatMul(k, hp, khp, N, M, N);
+    for (i = 0; i < N * N; i++)
+        r->P[i] -= khp[i];
+    for (i = 0; i < N; i++)
+    {
+        for (j = i + 1u; j < N; j++)
+        {
+            double v = 0.5 * (r->P[i * N + j] + r->P[j * N + i]);
+
+            r->P[i * N + j] = v;
+            r->P[j * N + i] = v;
+        }
+    }
+}
+
+// 取第 i 个元素的 double 值
+static double Get(uint8_t format, const void *v, uint32_t i)
+{
+    if (format == OS_KALMAN_F32)
+        return ((const float32_t *)v)[i];
+    return ((const q31_t *)v)[i] / 2147483648.0;
+}
+
+// 把 double 写成滤波器格式，并把量化后的值写回 d（参考实现用同样的输入）
+static void Put(uint8_t format, void *v, double *d, uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        if (format == OS_KALMAN_F32)
+        {
+            ((float32_t *)v)[i] = (float32_t)d[i];
+            d[i] = ((float32_t *)v)[i];
+        }
+        else
+        {
+            // 和 arm_float_to_q31 一样饱和：F、H 的 1.0 变成 0x7FFFFFFF
+            double q = nearbyint(d[i] * 2147483648.0);
+
+            ((q31_t *)v)[i] = (q >= 2147483647.0) ? 0x7FFFFFFF : (q31_t)q;
+            d[i] = ((q31_t *)v)[i] / 2147483648.0;
+        }
+    }
+}
+
+/**
+ * @brief  三个轴各自做正弦运动，量测位置加 ±0.01 的均匀噪声；滤波器与参考逐步比较
+ */
+static void TestTrack(uint8_t format, double tol)
+{
+    static uint32_t arena[OS_KALMAN_ARENA_SIZE_Q31(N, M) / 4u];
+    uint32_t F[N * N], H[M * N], Q[N * N], R[M * M], x0[N], P0[N * N], z[M];
+    OS_KalmanModel model = {F, H, Q, R, NULL, NULL, NULL, 4};
+    OS_Kalman kf;
+    RefKalman ref;
+    double zd[M];
+    double err_x = 0;
+    double err_p = 0;
+    double e;
+    uint32_t step;
+    uint32_t i;
+
+    // 1. 模型：x = [px py pz vx vy vz]，p += v * dt
+    memset(&ref, 0, sizeof(ref));
+    for (i = 0; i < N; i++)
+    {
+        ref.F[i * N + i] = 1.0;
+        ref.Q[i * N + i] = (i < 3u) ? 1e-6 : 1e-4;
+        ref.P[i * N + i] = (i < 3u) ? 1e-4 : 1e-3;
+    }
+    for (i = 0; i < 3u; i++)
+    {
+        // 从真实的初值出发，否则速度估计的瞬态会超出 q31 的 [-1, 1)
+        ref.X[i] = 0.3 * sin(i);
+        ref.X[i + 3u] = 0.15 * cos(i);
+        ref.F[i * N + i + 3u] = DT;
+        ref.H[i * N + i] = 1.0;
+        ref.R[i * M + i] = 1e-4;
+    }
+    Put(format, F, ref.F, N * N);
+    Put(format, H, ref.H, M * N);
+    Put(format, Q, ref.Q, N * N);
+    Put(format, R, ref.R, M * M);
+    Put(format, x0, ref.X, N);
+    Put(format, P0, ref.P, N * N);
+
+    CHECK(OS_KalmanInit(&kf, format, N, M, &model, arena, sizeof(arena)));
+    OS_KalmanSetState(&kf, x0, P0);
+
+    // 2. 逐步预测 + 更新
+    for (step = 1; step <= STEPS; step++)
+    {
+        for (i = 0; i < M; i++)
+            zd[i] = 0.3 * sin(0.5 * DT * step + i) + 0.01 * RandUnit();
+        Put(format, z, zd, M);
+
+        OS_KalmanPredict(&kf);
+        RefPredict(&ref);
+        CHECK(OS_KalmanUpdate(&kf, z));
+        RefUpdate(&ref, zd);
+
+        for (i = 0; i < N; i++)
+        {
+            e = fabs(Get(format, kf.X, i) - ref.X[i]);
+            if (e > err_x)
+                err_x = e;
+        }
+        for (i = 0; i < N * N; i++)
+        {
+            e = fabs(Get(format, kf.P, i) - ref.P[i]);
+            if (e > err_p)
+                err_p = e;
+        }
+    }
+
+    printf("%s,%u,%.3g,%.3g\n", (format == OS_KALMAN_F32) ? "f32" : "q31", STEPS, err_x, err_p);
+    CHECK(kf.Steps == STEPS && kf.Updates == STEPS && kf.Singular == 0);
+    if (err_x > tol || err_p > tol)
+    {
+        printf("FAIL %s: error %.3g / %.3g above %.3g\n", (format == OS_KALMAN_F32) ? "f32" : "q31", err_x,
+               err_p, tol);
+        g_Errors++;
+    }
+}
+
+/**
+ * @brief  arm_mat_inverse_f32 直接对比：随机对称正定矩阵 B B' + n I / 4
+ */
+static void TestInverse(void)
+{
+    float32_t a[N * N], a_copy[N * N], inv[N * N], prod[N * N];
+    double b[N * N], bt[N * N], s[N * N];
+    arm_matrix_instance_f32 ma, mi, mc, mp;
+    uint32_t n, c, i, j;
+    double e;
+    double worst = 0;
+
+    for (n = 1; n <= N; n++)
+    {
+        for (c = 0; c < 50u; c++)
+        {
+            for (i = 0; i < n * n; i++)
+                b[i] = RandUnit();
+            MatTrans(b, bt, n, n);
+            MatMul(b, bt, s, n, n, n);
+            for (i = 0; i < n; i++)
+                s[i * n + i] += n / 4.0;
+            for (i = 0; i < n * n; i++)
+                a[i] = a_copy[i] = (float32_t)s[i];
+
+            // arm_mat_inverse_f32 会改写输入，乘积用副本算
+            arm_mat_init_f32(&ma, n, n, a);
+            arm_mat_init_f32(&mi, n, n, inv);
+            arm_mat_init_f32(&mc, n, n, a_copy);
+            arm_mat_init_f32(&mp, n, n, prod);
+            CHECK(arm_mat_inverse_f32(&ma, &mi) == ARM_MATH_SUCCESS);
+            arm_mat_mult_f32(&mc, &mi, &mp);
+
+            for (i = 0; i < n; i++)
+            {
+                for (j = 0; j < n; j++)
+                {
+                    e = fabs(prod[i * n + j] - (i == j));
+                    if (e > worst)
+                        worst = e;
+                }
+            }
+        }
+    }
+    printf("inverse,%u,%.3g,0\n", N, worst);
+    CHECK(worst < INV_TOL);
+
+    // 奇异：第二行是第一行的两倍
+    {
+        float32_t sing[4] = {1.0f, 2.0f, 2.0f, 4.0f};
+        float32_t sing_inv[4];
+
+        arm_mat_init_f32(&ma, 2, 2, sing);
+        arm_mat_init_f32(&mi, 2, 2, sing_inv);
+        CHECK(arm_mat_inverse_f32(&ma, &mi) == ARM_MATH_SINGULAR);
+    }
+}
+
+/**
+ * @brief  S 奇异（R = 0，P = 0）：跳过更新，状态不变，计入 Singular
+ */
+static void TestSingular(void)
+{
+    static uint32_t arena[OS_KALMAN_ARENA_SIZE_F32(N, M) / 4u];
+    float32_t F[N * N] = {0}, H[M * N] = {0}, Q[N * N] = {0}, R[M * M] = {0}, z[M] = {1, 1, 1};
+    OS_KalmanModel model = {F, H, Q, R, NULL, NULL, NULL, 0};
+    OS_Kalman kf;
+    uint32_t i;
+
+    for (i = 0; i < N; i++)
+        F[i * N + i] = 1.0f;
+    for (i = 0; i < M; i++)
+        H[i * N + i] = 1.0f;
+
+    CHECK(OS_KalmanInit(&kf, OS_KALMAN_F32, N, M, &model, arena, sizeof(arena)));
+    OS_KalmanPredict(&kf);
+    CHECK(OS_KalmanUpdate(&kf, z) == 0);
+    CHECK(kf.Singular == 1 && kf.Updates == 0);
+    for (i = 0; i < N; i++)
+        CHECK(((float32_t *)kf.X)[i] == 0.0f);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    printf("format,steps,max_err_x,max_err_p\n");
+    TestTrack(OS_KALMAN_F32, F32_TOL);
+    TestTrack(OS_KALMAN_Q31, Q31_TOL);
+    TestInverse();
+    TestSingular();
+
+    printf("kalman_compare: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
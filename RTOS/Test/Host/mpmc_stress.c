@@ -0,0 +1,381 @@
+/**
+ ******************************************************************************
+ * @file    mpmc_stress.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   MPMC 队列并发压力测试与吞吐对比 (Linux 主机)
+ *
+ * P 个生产者各入队 N 个元素（生产者编号 << 24 | 序号），C 个消费者一直出队，
+ * 直到取够 P * N 个。检查：
+ * - 每个元素恰好取到一次（没有丢失，没有重复）
+ * - 同一个消费者看到的同一个生产者的元素序号递增（FIFO）
+ * - 不会卡死：连续 STALL_MS 毫秒没有任何进展就判失败
+ *
+ * 并发之前先单线程检查小容量：容量 1 被拒绝，容量 2 和 4 正好装满 capacity 个。
+ *
+ * 同样的负载再跑一遍只用临界区保护的环形队列 (CsQueue) 作对照。
+ * 输出一行一个配置：
+ *   queue,producers,consumers,items,ns_per_item,strex_fail,lock_spin
+ *
+ * 用法：mpmc_stress [每个生产者的元素数] [平均每多少次操作随机让出一次 CPU] [每隔多少次 STREX 让出一次 CPU]
+ * 让出 CPU 的参数为 0 表示不让；测吞吐时都用 0。
+ *
+ ******************************************************************************
+ */
+
+#include "os_mpmc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define CAPACITY      64u
+#define MAX_THREADS   4u
+#define STALL_MS      5000u
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  对照组：临界区保护的环形队列
+ */
+typedef struct
+{
+    uint32_t Buffer[CAPACITY];
+    uint32_t Head;
+    uint32_t Tail;
+} CsQueue;
+
+typedef struct
+{
+    uint32_t Id;
+    uint32_t Seed;
+    uint32_t Last[MAX_THREADS]; // 消费者：每个生产者上一次取到的序号 + 1
+} Worker;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Items = 200000u;
+static uint32_t g_YieldOneIn = 0;
+static uint32_t g_UseMpmc = 1;
+static uint32_t g_Producers;
+
+static OS_MpmcQueue g_Mpmc;
+static uint32_t g_MpmcBuffer[CAPACITY];
+static volatile uint32_t g_MpmcSequence[CAPACITY];
+static CsQueue g_Cs;
+
+static uint8_t *g_Seen[MAX_THREADS];  // 每个生产者每个序号取到的次数
+static volatile uint32_t g_Popped = 0;
+static volatile uint32_t g_OrderErrors = 0;
+static volatile uint32_t g_Pushed = 0;
+static volatile uint32_t g_Finished = 0;
+static volatile uint32_t g_Go = 0;
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void MaybeYield(Worker *w)
+{
+    if (g_YieldOneIn != 0 && rand_r(&w->Seed) % g_YieldOneIn == 0)
+        sched_yield();
+}
+
+static uint8_t CsPush(uint32_t item)
+{
+    uint8_t ok = 0;
+
+    OS_EnterCritical();
+    if (g_Cs.Head - g_Cs.Tail < CAPACITY)
+    {
+        g_Cs.Buffer[g_Cs.Head % CAPACITY] = item;
+        g_Cs.Head++;
+        ok = 1;
+    }
+    OS_ExitCritical();
+    return ok;
+}
+
+static uint8_t CsPop(uint32_t *item)
+{
+    uint8_t ok = 0;
+
+    OS_EnterCritical();
+    if (g_Cs.Head != g_Cs.Tail)
+    {
+        *item = g_Cs.Buffer[g_Cs.Tail % CAPACITY];
+        g_Cs.Tail++;
+        ok = 1;
+    }
+    OS_ExitCritical();
+    return ok;
+}
+
+static void *Producer(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    uint32_t i;
+    uint32_t item;
+
+    while (!__atomic_load_n(&g_Go, __ATOMIC_ACQUIRE))
+        sched_yield();
+
+    for (i = 0; i < g_Items; i++)
+    {
+        item = (w->Id << 24) | i;
+        while (!(g_UseMpmc ? OS_MpmcQueuePush(&g_Mpmc, &item) : CsPush(item)))
+            sched_yield(); // 队列满
+        __atomic_fetch_add(&g_Pushed, 1u, __ATOMIC_RELAXED);
+        MaybeYield(w);
+    }
+    __atomic_fetch_add(&g_Finished, 1u, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *Consumer(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    uint32_t total = g_Producers * g_Items;
+    uint32_t item;
+    uint32_t p;
+    uint32_t seq;
+
+    while (!__atomic_load_n(&g_Go, __ATOMIC_ACQUIRE))
+        sched_yield();
+
+    while (__atomic_load_n(&g_Popped, __ATOMIC_RELAXED) < total)
+    {
+        if (!(g_UseMpmc ? OS_MpmcQueuePop(&g_Mpmc, &item) : CsPop(&item)))
+        {
+            sched_yield(); // 队列空
+            continue;
+        }
+
+        p = item >> 24;
+        seq = item & 0xFFFFFFu;
+        if (p >= g_Producers || seq >= g_Items)
+        {
+            __atomic_fetch_add(&g_OrderErrors, 1u, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            __atomic_fetch_add(&g_Seen[p][seq], 1u, __ATOMIC_RELAXED);
+            if (seq < w->Last[p])
+                __atomic_fetch_add(&g_OrderErrors, 1u, __ATOMIC_RELAXED);
+            w->Last[p] = seq + 1u;
+        }
+        __atomic_fetch_add(&g_Popped, 1u, __ATOMIC_RELAXED);
+        MaybeYield(w);
+    }
+    __atomic_fetch_add(&g_Finished, 1u, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static int Run(uint32_t use_mpmc, uint32_t producers, uint32_t consumers)
+{
+    pthread_t tid[2 * MAX_THREADS];
+    Worker w[2 * MAX_THREADS];
+    uint32_t lost = 0;
+    uint32_t dup = 0;
+    uint32_t n = 0;
+    uint32_t i;
+    uint32_t j;
+    uint64_t t0;
+    uint64_t t1;
+    uint32_t progress;
+    uint32_t idle_ms = 0;
+    struct timespec nap = {0, 10000000};
+
+    g_UseMpmc = use_mpmc;
+    g_Producers = producers;
+    OS_MpmcQueueInit(&g_Mpmc, g_MpmcBuffer, g_MpmcSequence, CAPACITY, sizeof(uint32_t));
+    memset(&g_Cs, 0, sizeof(g_Cs));
+    for (i = 0; i < producers; i++)
+        memset(g_Seen[i], 0, g_Items);
+    g_Popped = 0;
+    g_Pushed = 0;
+    g_Finished = 0;
+    g_OrderErrors = 0;
+    g_HostStrexFail = 0;
+    g_HostCriticalSpin = 0;
+    g_Go = 0;
+
+    memset(w, 0, sizeof(w));
+    for (i = 0; i < producers; i++, n++)
+    {
+        w[n].Id = i;
+        w[n].Seed = 0x1234u + n;
+        pthread_create(&tid[n], NULL, Producer, &w[n]);
+    }
+    for (i = 0; i < consumers; i++, n++)
+    {
+        w[n].Id = i;
+        w[n].Seed = 0x1234u + n;
+        pthread_create(&tid[n], NULL, Consumer, &w[n]);
+    }
+
+    t0 = NowNs();
+    __atomic_store_n(&g_Go, 1u, __ATOMIC_RELEASE);
+
+    // 看门狗：入队和出队计数都停住太久就是卡死了（比如位置推进出错后死循环）
+    progress = 0;
+    while (__atomic_load_n(&g_Finished, __ATOMIC_ACQUIRE) < n)
+    {
+        nanosleep(&nap, NULL);
+        if (g_Pushed + g_Popped != progress)
+        {
+            progress = g_Pushed + g_Popped;
+            idle_ms = 0;
+        }
+        else if ((idle_ms += 10u) >= STALL_MS)
+        {
+            fprintf(stderr, "mpmc_stress: %s %uP/%uC stalled: %u pushed, %u popped of %u\n",
+                    use_mpmc ? "mpmc" : "critical", producers, consumers,
+                    g_Pushed, g_Popped, producers * g_Items);
+            exit(1);
+        }
+    }
+    for (i = 0; i < n; i++)
+        pthread_join(tid[i], NULL);
+    t1 = NowNs();
+
+    for (i = 0; i < producers; i++)
+    {
+        for (j = 0; j < g_Items; j++)
+        {
+            if (g_Seen[i][j] == 0)
+                lost++;
+            else if (g_Seen[i][j] > 1)
+                dup++;
+        }
+    }
+
+    printf("%s,%u,%u,%u,%.1f,%u,%u\n", use_mpmc ? "mpmc" : "critical", producers, consumers,
+           producers * g_Items, (double)(t1 - t0) / ((double)producers * g_Items),
+           g_HostStrexFail, g_HostCriticalSpin);
+
+    if (lost || dup || g_OrderErrors || OS_MpmcQueueCount(&g_Mpmc) != 0)
+    {
+        fprintf(stderr, "mpmc_stress: %s %uP/%uC: %u lost, %u duplicated, %u out of order\n",
+                use_mpmc ? "mpmc" : "critical", producers, consumers, lost, dup, g_OrderErrors);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  单线程：容量 1 必须被拒绝；容量 2、4 填到满为止，满了再入队必须失败，
+ *         并且取出顺序不变（跑几圈，覆盖序号回绕到下一圈）
+ */
+static int TestSmall(void)
+{
+    static const uint32_t capacities[] = {2, 4};
+    OS_MpmcQueue q;
+    uint32_t buffer[4];
+    volatile uint32_t sequence[4];
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    uint32_t item;
+    uint32_t c;
+    uint32_t round;
+    uint32_t n;
+    int err = 0;
+
+    if (OS_MpmcQueueInit(&q, buffer, sequence, 1, sizeof(uint32_t)) ||
+        OS_MpmcQueueInit(&q, buffer, sequence, 0, sizeof(uint32_t)) ||
+        OS_MpmcQueueInit(&q, buffer, sequence, 3, sizeof(uint32_t)))
+    {
+        fprintf(stderr, "mpmc_stress: capacity 0, 1 or 3 accepted\n");
+        err = 1;
+    }
+
+    for (c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++)
+    {
+        OS_MpmcQueueInit(&q, buffer, sequence, capacities[c], sizeof(uint32_t));
+        for (round = 0; round < 5; round++)
+        {
+            // 1. 填满：正好 capacity 个，再多一个必须失败
+            for (n = 0; OS_MpmcQueuePush(&q, &next_in); n++)
+                next_in++;
+            if (n != capacities[c] || OS_MpmcQueueCount(&q) != capacities[c])
+            {
+                fprintf(stderr, "mpmc_stress: capacity %u took %u items\n", capacities[c], n);
+                err = 1;
+            }
+
+            // 2. 取一个、补一个，再满
+            if (!OS_MpmcQueuePop(&q, &item) || item != next_out++ || !OS_MpmcQueuePush(&q, &next_in) ||
+                OS_MpmcQueuePush(&q, &next_in))
+            {
+                fprintf(stderr, "mpmc_stress: capacity %u refill after one pop\n", capacities[c]);
+                err = 1;
+            }
+            next_in++;
+
+            // 3. 取空：顺序不变，空了再取必须失败
+            while (OS_MpmcQueuePop(&q, &item))
+            {
+                if (item != next_out++)
+                {
+                    fprintf(stderr, "mpmc_stress: capacity %u popped %u\n", capacities[c], item);
+                    err = 1;
+                }
+            }
+            if (next_out != next_in)
+            {
+                fprintf(stderr, "mpmc_stress: capacity %u lost %u items\n", capacities[c], next_in - next_out);
+                err = 1;
+                next_out = next_in;
+            }
+        }
+    }
+    return err;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const uint32_t configs[][2] = {{1, 1}, {2, 2}, {4, 4}, {4, 1}, {1, 4}};
+    uint32_t c;
+    uint32_t i;
+    int err = 0;
+
+    if (argc > 1)
+        g_Items = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        g_YieldOneIn = (uint32_t)strtoul(argv[2], NULL, 0);
+    if (argc > 3)
+        g_HostPreemptEvery = (uint32_t)strtoul(argv[3], NULL, 0);
+    if (g_Items == 0 || g_Items > 0xFFFFFFu)
+    {
+        fprintf(stderr, "mpmc_stress: items must be 1..%u\n", 0xFFFFFFu);
+        return 2;
+    }
+
+    err |= TestSmall();
+
+    for (i = 0; i < MAX_THREADS; i++)
+        g_Seen[i] = malloc(g_Items);
+
+    for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        err |= Run(1, configs[c][0], configs[c][1]);
+        err |= Run(0, configs[c][0], configs[c][1]);
+    }
+
+    for (i = 0; i < MAX_THREADS; i++)
+        free(g_Seen[i]);
+
+    return err;
+}
@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * @file    nn_cifar10.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-NN cifar10 例程的层表 (Linux 主机测试用)
+ *
+ ******************************************************************************
+ */
+
+#include "nn_cifar10.h"
+#include <string.h>
+#include "arm_nnexamples_cifar10_parameter.h"
+#include "arm_nnexamples_cifar10_weights.h"
+#include "arm_nnexamples_cifar10_inputs.h"
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  一组 卷积 + ReLU + 最大池化
+ */
+typedef struct
+{
+    OS_NnLayerType Type;  ///< 例程用的卷积内核
+    const q7_t *Weights;
+    const q7_t *Bias;
+    uint16_t InDim, InCh, OutDim, OutCh, KerDim, Padding, Stride, BiasShift, OutShift;
+    uint16_t PoolKer, PoolPadding, PoolStride, PoolDim;
+} Cifar10Stage;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static const q7_t conv1_wt[CONV1_IM_CH * CONV1_KER_DIM * CONV1_KER_DIM * CONV1_OUT_CH] = CONV1_WT;
+static const q7_t conv1_bias[CONV1_OUT_CH] = CONV1_BIAS;
+static const q7_t conv2_wt[CONV2_IM_CH * CONV2_KER_DIM * CONV2_KER_DIM * CONV2_OUT_CH] = CONV2_WT;
+static const q7_t conv2_bias[CONV2_OUT_CH] = CONV2_BIAS;
+static const q7_t conv3_wt[CONV3_IM_CH * CONV3_KER_DIM * CONV3_KER_DIM * CONV3_OUT_CH] = CONV3_WT;
+static const q7_t conv3_bias[CONV3_OUT_CH] = CONV3_BIAS;
+static const q7_t ip1_wt[IP1_DIM * IP1_OUT] = IP1_WT;
+static const q7_t ip1_bias[IP1_OUT] = IP1_BIAS;
+static const uint8_t image_data[CONV1_IM_CH * CONV1_IM_DIM * CONV1_IM_DIM] = IMG_DATA;
+
+static const Cifar10Stage g_Stages[3] = {
+    {OS_NN_CONV_RGB, conv1_wt, conv1_bias, CONV1_IM_DIM, CONV1_IM_CH, CONV1_OUT_DIM, CONV1_OUT_CH, CONV1_KER_DIM,
+     CONV1_PADDING, CONV1_STRIDE, CONV1_BIAS_LSHIFT, CONV1_OUT_RSHIFT,
+     POOL1_KER_DIM, POOL1_PADDING, POOL1_STRIDE, POOL1_OUT_DIM},
+    {OS_NN_CONV_FAST, conv2_wt, conv2_bias, CONV2_IM_DIM, CONV2_IM_CH, CONV2_OUT_DIM, CONV2_OUT_CH, CONV2_KER_DIM,
+     CONV2_PADDING, CONV2_STRIDE, CONV2_BIAS_LSHIFT, CONV2_OUT_RSHIFT,
+     POOL2_KER_DIM, POOL2_PADDING, POOL2_STRIDE, POOL2_OUT_DIM},
+    {OS_NN_CONV_FAST, conv3_wt, conv3_bias, CONV3_IM_DIM, CONV3_IM_CH, CONV3_OUT_DIM, CONV3_OUT_CH, CONV3_KER_DIM,
+     CONV3_PADDING, CONV3_STRIDE, CONV3_BIAS_LSHIFT, CONV3_OUT_RSHIFT,
+     POOL3_KER_DIM, POOL3_PADDING, POOL3_STRIDE, POOL3_OUT_DIM},
+};
+
+// 例程的缓冲区
+static q7_t col_buffer[2 * 5 * 5 * 32 * 2];
+static q7_t scratch_buffer[32 * 32 * 10 * 4];
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// 执行一次调用；统计时累计到 profile[i]
+#define CIFAR10_CALL(i, ...)                                                  \
+    do                                                                        \
+    {                                                                         \
+        uint32_t t0 = OS_NN_PROFILE_CLOCK();                                  \
+        __VA_ARGS__;                                                          \
+        if (profile != NULL)                                                  \
+        {                                                                     \
+            profile[i].Steps++;                                               \
+            profile[i].Cycles += (uint32_t)(OS_NN_PROFILE_CLOCK() - t0);      \
+        }                                                                     \
+    } while (0)
+
+/* 函数声明 ----------------------------------------------------------- */
+
+void Cifar10Input(q7_t *dst)
+{
+    static const int mean_data[3] = INPUT_MEAN_SHIFT;
+    static const unsigned int scale_data[3] = INPUT_RIGHT_SHIFT;
+    uint32_t i;
+    uint32_t c;
+
+    for (i = 0; i < CIFAR10_IN_SIZE; i += 3)
+    {
+        for (c = 0; c < 3; c++)
+        {
+            dst[i + c] = (q7_t)__SSAT(((((int)image_data[i + c] - mean_data[c]) << 7) + (0x1 << (scale_data[c] - 1)))
+                                      >> scale_data[c], 8);
+        }
+    }
+}
+
+void Cifar10Example(q7_t *out, OS_NnLayerProfile *profile)
+{
+    q7_t *img_buffer1 = scratch_buffer;
+    q7_t *img_buffer2 = img_buffer1 + 32 * 32 * 32;
+
+    Cifar10Input(img_buffer2);
+
+    CIFAR10_CALL(0, arm_convolve_HWC_q7_RGB(img_buffer2, CONV1_IM_DIM, CONV1_IM_CH, conv1_wt, CONV1_OUT_CH,
+                                            CONV1_KER_DIM, CONV1_PADDING, CONV1_STRIDE, conv1_bias,
+                                            CONV1_BIAS_LSHIFT, CONV1_OUT_RSHIFT, img_buffer1, CONV1_OUT_DIM,
+                                            (q15_t *)col_buffer, NULL));
+    CIFAR10_CALL(1, arm_relu_q7(img_buffer1, CONV1_OUT_DIM * CONV1_OUT_DIM * CONV1_OUT_CH));
+    CIFAR10_CALL(2, arm_maxpool_q7_HWC(img_buffer1, CONV1_OUT_DIM, CONV1_OUT_CH, POOL1_KER_DIM, POOL1_PADDING,
+                                       POOL1_STRIDE, POOL1_OUT_DIM, NULL, img_buffer2));
+
+    CIFAR10_CALL(3, arm_convolve_HWC_q7_fast(img_buffer2, CONV2_IM_DIM, CONV2_IM_CH, conv2_wt, CONV2_OUT_CH,
+                                             CONV2_KER_DIM, CONV2_PADDING, CONV2_STRIDE, conv2_bias,
+                                             CONV2_BIAS_LSHIFT, CONV2_OUT_RSHIFT, img_buffer1, CONV2_OUT_DIM,
+                                             (q15_t *)col_buffer, NULL));
+    CIFAR10_CALL(4, arm_relu_q7(img_buffer1, CONV2_OUT_DIM * CONV2_OUT_DIM * CONV2_OUT_CH));
+    CIFAR10_CALL(5, arm_maxpool_q7_HWC(img_buffer1, CONV2_OUT_DIM, CONV2_OUT_CH, POOL2_KER_DIM, POOL2_PADDING,
+                                       POOL2_STRIDE, POOL2_OUT_DIM, col_buffer, img_buffer2));
+
+    CIFAR10_CALL(6, arm_convolve_HWC_q7_fast(img_buffer2, CONV3_IM_DIM, CONV3_IM_CH, conv3_wt, CONV3_OUT_CH,
+                                             CONV3_KER_DIM, CONV3_PADDING, CONV3_STRIDE, conv3_bias,
+                                             CONV3_BIAS_LSHIFT, CONV3_OUT_RSHIFT, img_buffer1, CONV3_OUT_DIM,
+                                             (q15_t *)col_buffer, NULL));
+    CIFAR10_CALL(7, arm_relu_q7(img_buffer1, CONV3_OUT_DIM * CONV3_OUT_DIM * CONV3_OUT_CH));
+    CIFAR10_CALL(8, arm_maxpool_q7_HWC(img_buffer1, CONV3_OUT_DIM, CONV3_OUT_CH, POOL3_KER_DIM, POOL3_PADDING,
+                                       POOL3_STRIDE, POOL3_OUT_DIM, col_buffer, img_buffer2));
+
+    CIFAR10_CALL(9, arm_fully_connected_q7_opt(img_buffer2, ip1_wt, IP1_DIM, IP1_OUT, IP1_BIAS_LSHIFT,
+                                               IP1_OUT_RSHIFT, ip1_bias, out, (q15_t *)img_buffer1));
+    CIFAR10_CALL(10, arm_softmax_q7(out, IP1_OUT, out));
+}
+
+uint16_t Cifar10Layers(OS_NnLayer *layers, uint8_t fused, uint16_t tile_rows)
+{
+    const Cifar10Stage *s;
+    OS_NnLayer *p = layers;
+    uint16_t i;
+
+    for (i = 0; i < 3; i++)
+    {
+        s = &g_Stages[i];
+
+        // 1. 卷积（融合时连同 ReLU 和池化）
+        memset(p, 0, sizeof(*p));
+        p->Type = s->Type;
+        p->Weights = s->Weights;
+        p->Bias = s->Bias;
+        p->InDim = s->InDim;
+        p->InCh = s->InCh;
+        p->OutDim = s->OutDim;
+        p->OutCh = s->OutCh;
+        p->KerDim = s->KerDim;
+        p->Padding = s->Padding;
+        p->Stride = s->Stride;
+        p->BiasShift = s->BiasShift;
+        p->OutShift = s->OutShift;
+        p->TileRows = tile_rows;
+        if (fused)
+        {
+            p->Type = (s->Type == OS_NN_CONV_FAST) ? OS_NN_CONV_FAST_RELU_POOL : OS_NN_CONV_RELU_POOL;
+            p->PoolKer = s->PoolKer;
+            p->PoolPadding = s->PoolPadding;
+            p->PoolStride = s->PoolStride;
+            p->PoolDim = s->PoolDim;
+            p++;
+            continue;
+        }
+        p++;
+
+        // 2. ReLU
+        memset(p, 0, sizeof(*p));
+        p->Type = OS_NN_RELU;
+        p->InDim = s->OutDim;
+        p->InCh = s->OutCh;
+        p->TileRows = tile_rows;
+        p++;
+
+        // 3. 最大池化
+        memset(p, 0, sizeof(*p));
+        p->Type = OS_NN_MAXPOOL;
+        p->InDim = s->OutDim;
+        p->InCh = s->OutCh;
+        p->OutDim = s->PoolDim;
+        p->KerDim = s->PoolKer;
+        p->Padding = s->PoolPadding;
+        p->Stride = s->PoolStride;
+        p++;
+    }
+
+    // 4. 全连接 + Softmax
+    memset(p, 0, sizeof(*p));
+    p->Type = OS_NN_FC_OPT;
+    p->Weights = ip1_wt;
+    p->Bias = ip1_bias;
+    p->InDim = IP1_DIM;
+    p->OutCh = IP1_OUT;
+    p->BiasShift = IP1_BIAS_LSHIFT;
+    p->OutShift = IP1_OUT_RSHIFT;
+    p->TileRows = tile_rows;
+    p++;
+
+    memset(p, 0, sizeof(*p));
+    p->Type = OS_NN_SOFTMAX;
+    p->InDim = IP1_OUT;
+    p++;
+
+    return (uint16_t)(p - layers);
+}
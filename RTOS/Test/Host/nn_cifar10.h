@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    nn_cifar10.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-NN cifar10 例程的层表 (Linux 主机测试用)
+ *
+ * 权重、参数和输入图像直接取 Drivers/CMSIS/NN/Examples/.../cifar10 下的头文件。
+ * - Cifar10Example：照抄例程 main() 的调用顺序和缓冲区，作为对照；
+ *   可以顺带记录每一次 CMSIS-NN 调用的耗时
+ * - Cifar10Layers：同一个网络写成 OS_NnLayer 层表，不融合时和例程的调用一一对应
+ *
+ ******************************************************************************
+ */
+
+#ifndef __NN_CIFAR10_H
+#define __NN_CIFAR10_H
+
+#include "os_nn.h"
+
+/* 宏定义 ------------------------------------------------------------------ */
+
+#define CIFAR10_IN_SIZE     (32u * 32u * 3u) ///< 预处理后的输入字节数
+#define CIFAR10_OUT_SIZE    10u              ///< 输出类别数
+#define CIFAR10_LAYERS      11u              ///< 不融合的层数（= 例程的调用次数）
+#define CIFAR10_FUSED_LAYERS 5u              ///< 融合后的层数
+
+/**
+ * @brief  例程静态分配的激活内存：col_buffer + scratch_buffer + output_data
+ */
+#define CIFAR10_EXAMPLE_BYTES (2u * 5u * 5u * 32u * 2u + 32u * 32u * 10u * 4u + CIFAR10_OUT_SIZE)
+
+/* 函数声明 ----------------------------------------------------------- */
+
+/**
+ * @brief  输入预处理（减均值、移位），和例程相同
+ */
+void Cifar10Input(q7_t *dst);
+
+/**
+ * @brief  按例程的调用顺序跑一遍
+ * @param  out    : CIFAR10_OUT_SIZE 字节的输出（softmax 之后）
+ * @param  profile: CIFAR10_LAYERS 项，第 i 项累计第 i 次调用的耗时，NULL 表示不统计
+ */
+void Cifar10Example(q7_t *out, OS_NnLayerProfile *profile);
+
+/**
+ * @brief  填写层表（In/Out/Scratch 为 NULL，由 OS_NnPlanLayers 分配）
+ * @param  layers   : 至少 CIFAR10_LAYERS 项
+ * @param  fused    : 1 表示卷积 + ReLU + 池化融合成一层
+ * @param  tile_rows: 卷积、ReLU、全连接和融合层的 TileRows
+ * @return uint16_t: 层数
+ */
+uint16_t Cifar10Layers(OS_NnLayer *layers, uint8_t fused, uint16_t tile_rows);
+
+#endif /* __NN_CIFAR10_H */
@@ -0,0 +1,408 @@
+/**
+ ******************************************************************************
+ * @file    nn_compare.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   NN 运行器与直接调用 CMSIS-NN 的逐位对比 (Linux 主机)
+ *
+ * - 分块：随机的卷积 (RGB/basic/fast)、全连接 (普通/opt) 和 ReLU 层，
+ *   TileRows 从 1 取到比输出行数多 1，结果必须和整层一步（直接调用内核）逐位一致
+ * - 融合：随机的 卷积 + ReLU + 最大池化，融合层的输出必须和依次调用
+ *   卷积、arm_relu_q7、arm_maxpool_q7_HWC 的结果逐位一致
+ * - cifar10：例程的网络写成层表（不融合/融合，不同 TileRows），
+ *   经 OS_NnPlanLayers 规划后运行，输出必须和例程的调用顺序一致；
+ *   每一步都超时返回、再接着算，结果也不变。同时核对内存池大小
+ *
+ * 输出缓冲区后面留一段哨兵字节，越界写也算不一致。
+ * 输出：
+ *   cifar10,fused,tile_rows,arena_bytes,steps
+ *
+ * 用法：nn_compare [融合层随机用例数]
+ *
+ ******************************************************************************
+ */
+
+#include "nn_cifar10.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define GUARD        16u     ///< 输出后面的哨兵字节数
+#define GUARD_BYTE   0x5A
+#define TILE_CASES   60u     ///< 每种分块层的随机几何数
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Seed = 0x2545F491u;
+static uint32_t g_Cases = 100u;
+static uint32_t g_Errors = 0;
+static OS_TCB g_IdleTcb;
+static OS_TCB g_TaskTcb;
+static uint32_t g_DummyStack[2][16];
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// 主机上用单调时钟（纳秒）代替节拍定时器
+uint64_t OS_TimeNowCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t Rand(void)
+{
+    g_Seed ^= g_Seed << 13;
+    g_Seed ^= g_Seed >> 17;
+    g_Seed ^= g_Seed << 5;
+    return g_Seed;
+}
+
+// [lo, hi] 里的随机数
+static uint16_t RandIn(uint16_t lo, uint16_t hi)
+{
+    return (uint16_t)(lo + Rand() % (uint32_t)(hi - lo + 1u));
+}
+
+// 多留 4 字节：DSP 路径的 RGB 卷积按字读输入，最后一个像素会多读一个字节
+static q7_t *RandBuf(uint32_t n)
+{
+    q7_t *p = malloc(n + 4u);
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+        p[i] = (q7_t)Rand();
+    return p;
+}
+
+// 带哨兵的输出缓冲区
+static q7_t *OutBuf(uint32_t n)
+{
+    q7_t *p = malloc(n + GUARD);
+
+    memset(p, GUARD_BYTE, n + GUARD);
+    return p;
+}
+
+static uint32_t ConvDim(uint16_t in, uint16_t ker, uint16_t pad, uint16_t stride)
+{
+    return (uint32_t)(in + 2u * pad - ker) / stride + 1u;
+}
+
+// 单层运行器：一步一步跑完，返回步数，出错返回 0
+static uint32_t RunLayer(const OS_NnLayer *p_l)
+{
+    OS_NnRunner run;
+    q15_t *col = malloc(OS_NnLayerScratchSize(p_l) + 4u);
+    uint32_t steps = 0;
+    uint8_t ret;
+
+    OS_NnRunnerInit(&run, p_l, 1, col);
+    do
+    {
+        ret = OS_NnStep(&run);
+        steps++;
+    } while (ret == OS_NN_BUSY);
+    free(col);
+    return (ret == OS_NN_DONE) ? steps : 0;
+}
+
+static void Check(int ok, const char *what, const OS_NnLayer *p_l)
+{
+    if (ok)
+        return;
+    g_Errors++;
+    if (g_Errors <= 10)
+    {
+        fprintf(stderr, "nn_compare: %s: type %d in %ux%u out %ux%u ker %u pad %u stride %u tile %u "
+                "pool %u/%u/%u\n", what, (int)p_l->Type, p_l->InDim, p_l->InCh, p_l->OutDim, p_l->OutCh,
+                p_l->KerDim, p_l->Padding, p_l->Stride, p_l->TileRows, p_l->PoolKer, p_l->PoolPadding,
+                p_l->PoolStride);
+    }
+}
+
+// 随机卷积几何；fast 内核要求输入通道是 4 的倍数、输出通道是偶数
+static void RandConv(OS_NnLayer *p_l, OS_NnLayerType type)
+{
+    memset(p_l, 0, sizeof(*p_l));
+    p_l->Type = type;
+    do
+    {
+        p_l->InDim = RandIn(3, 14);
+        p_l->KerDim = RandIn(1, 5);
+        p_l->Padding = RandIn(0, p_l->KerDim / 2u);
+        p_l->Stride = RandIn(1, 2);
+    } while (p_l->InDim + 2u * p_l->Padding < p_l->KerDim);
+    p_l->OutDim = (uint16_t)ConvDim(p_l->InDim, p_l->KerDim, p_l->Padding, p_l->Stride);
+
+    if (type == OS_NN_CONV_RGB)
+        p_l->InCh = 3;
+    else if (type == OS_NN_CONV_FAST || type == OS_NN_CONV_FAST_RELU_POOL)
+        p_l->InCh = 4u * RandIn(1, 3);
+    else
+        p_l->InCh = RandIn(1, 9);
+    p_l->OutCh = (type == OS_NN_CONV_FAST || type == OS_NN_CONV_FAST_RELU_POOL) ? 2u * RandIn(1, 4)
+                                                                                 : RandIn(1, 7);
+    p_l->BiasShift = RandIn(0, 3);
+    p_l->OutShift = RandIn(5, 9);
+}
+
+/**
+ * @brief  分块：同一层 TileRows = 0 和 1..rows+1 的输出逐位一致
+ */
+static void TestTiles(OS_NnLayerType type)
+{
+    OS_NnLayer l;
+    q7_t *in, *wt, *bias, *ref, *out;
+    uint32_t in_size, out_size, wt_size;
+    uint16_t rows, tile;
+    uint32_t c;
+
+    for (c = 0; c < TILE_CASES; c++)
+    {
+        // 1. 随机几何和数据
+        if (type == OS_NN_FC || type == OS_NN_FC_OPT)
+        {
+            memset(&l, 0, sizeof(l));
+            l.Type = type;
+            l.InDim = RandIn(1, 70);
+            l.OutCh = RandIn(1, 23);
+            l.BiasShift = RandIn(0, 3);
+            l.OutShift = RandIn(5, 9);
+            in_size = l.InDim;
+            out_size = l.OutCh;
+            wt_size = (uint32_t)l.InDim * l.OutCh;
+            rows = l.OutCh;
+        }
+        else if (type == OS_NN_RELU)
+        {
+            memset(&l, 0, sizeof(l));
+            l.Type = type;
+            l.InDim = RandIn(1, 20);
+            l.InCh = RandIn(1, 9);
+            in_size = (uint32_t)l.InDim * l.InDim * l.InCh;
+            out_size = 0;
+            wt_size = 0;
+            rows = l.InDim;
+        }
+        else
+        {
+            RandConv(&l, type);
+            in_size = (uint32_t)l.InDim * l.InDim * l.InCh;
+            out_size = (uint32_t)l.OutDim * l.OutDim * l.OutCh;
+            wt_size = (uint32_t)l.OutCh * l.InCh * l.KerDim * l.KerDim;
+            rows = l.OutDim;
+        }
+        in = RandBuf(in_size);
+        wt = RandBuf(wt_size + 1u);
+        bias = RandBuf(l.OutCh + 1u);
+        l.Weights = wt;
+        l.Bias = bias;
+
+        // 2. 整层一步作为参考（ReLU 原地改写，每次从同一份输入复制）
+        ref = OutBuf(out_size + in_size);
+        out = OutBuf(out_size + in_size);
+        l.In = (type == OS_NN_RELU) ? ref : in;
+        l.Out = ref;
+        if (type == OS_NN_RELU)
+            memcpy(ref, in, in_size);
+        Check(RunLayer(&l) == 1, "whole layer failed", &l);
+
+        // 3. 各种块大小
+        for (tile = 1; tile <= rows + 1u; tile++)
+        {
+            memset(out, GUARD_BYTE, out_size + in_size + GUARD);
+            l.TileRows = tile;
+            l.In = (type == OS_NN_RELU) ? out : in;
+            l.Out = out;
+            if (type == OS_NN_RELU)
+                memcpy(out, in, in_size);
+            Check(RunLayer(&l) != 0, "tiled layer failed", &l);
+            Check(memcmp(ref, out, out_size + in_size + GUARD) == 0, "tiled output differs", &l);
+        }
+        l.TileRows = 0;
+
+        free(in);
+        free(wt);
+        free(bias);
+        free(ref);
+        free(out);
+    }
+}
+
+/**
+ * @brief  融合：卷积 + ReLU + 最大池化一层算完，和三次调用的结果逐位一致
+ */
+static void TestFused(void)
+{
+    OS_NnLayer l;
+    q7_t *in, *wt, *bias, *conv, *ref, *out;
+    q15_t *col;
+    uint32_t in_size, conv_size, pool_size;
+    uint32_t c;
+    arm_status st;
+
+    for (c = 0; c < g_Cases; c++)
+    {
+        // 1. 随机几何：fast 带填充时输出至少 2 * pad 行
+        do
+        {
+            RandConv(&l, (Rand() & 1u) ? OS_NN_CONV_FAST_RELU_POOL : OS_NN_CONV_RELU_POOL);
+        } while (l.Type == OS_NN_CONV_FAST_RELU_POOL && l.OutDim < 2u * l.Padding);
+#if defined(ARM_MATH_DSP)
+        // DSP 路径的 arm_maxpool_q7_HWC 一次比较 4 个通道、沿 x 原地池化：
+        // 通道数不是 4 的倍数或者带填充时它自己就不对，参考值只能取它支持的几何
+        l.OutCh = 4u * RandIn(1, 2);
+#endif
+        do
+        {
+            l.PoolKer = RandIn(1, 3);
+            l.PoolStride = RandIn(1, 3);
+            l.PoolPadding = RandIn(0, l.PoolKer - 1u);
+#if defined(ARM_MATH_DSP)
+            l.PoolPadding = 0;
+#endif
+        } while (l.OutDim + 2u * l.PoolPadding < l.PoolKer ||
+                 (l.PoolDim = (uint16_t)ConvDim(l.OutDim, l.PoolKer, l.PoolPadding, l.PoolStride),
+                  (uint32_t)(l.PoolDim - 1u) * l.PoolStride >= l.OutDim + l.PoolPadding)); // 最后一个窗口不能全是填充
+        l.TileRows = RandIn(0, l.PoolDim + 1u);
+
+        in_size = (uint32_t)l.InDim * l.InDim * l.InCh;
+        conv_size = (uint32_t)l.OutDim * l.OutDim * l.OutCh;
+        pool_size = (uint32_t)l.PoolDim * l.PoolDim * l.OutCh;
+        in = RandBuf(in_size);
+        wt = RandBuf((uint32_t)l.OutCh * l.InCh * l.KerDim * l.KerDim);
+        bias = RandBuf(l.OutCh);
+        l.Weights = wt;
+        l.Bias = bias;
+
+        // 2. 参考：卷积、ReLU、池化依次调用
+        conv = malloc(conv_size);
+        ref = OutBuf(pool_size);
+        col = malloc(2u * 2u * l.InCh * l.KerDim * l.KerDim + l.OutDim * l.OutCh);
+        if (l.Type == OS_NN_CONV_FAST_RELU_POOL)
+            st = arm_convolve_HWC_q7_fast(in, l.InDim, l.InCh, wt, l.OutCh, l.KerDim, l.Padding, l.Stride, bias,
+                                          l.BiasShift, l.OutShift, conv, l.OutDim, col, NULL);
+        else
+            st = arm_convolve_HWC_q7_basic(in, l.InDim, l.InCh, wt, l.OutCh, l.KerDim, l.Padding, l.Stride, bias,
+                                           l.BiasShift, l.OutShift, conv, l.OutDim, col, NULL);
+        Check(st == ARM_MATH_SUCCESS, "reference conv failed", &l);
+        arm_relu_q7(conv, (uint16_t)conv_size);
+        arm_maxpool_q7_HWC(conv, l.OutDim, l.OutCh, l.PoolKer, l.PoolPadding, l.PoolStride, l.PoolDim,
+                           (q7_t *)col, ref);
+
+        // 3. 融合层
+        out = OutBuf(pool_size);
+        l.In = in;
+        l.Out = out;
+        Check(RunLayer(&l) != 0, "fused layer failed", &l);
+        Check(memcmp(ref, out, pool_size + GUARD) == 0, "fused output differs", &l);
+
+        free(in);
+        free(wt);
+        free(bias);
+        free(conv);
+        free(ref);
+        free(out);
+        free(col);
+    }
+}
+
+/**
+ * @brief  cifar10：规划后的层表和例程的输出一致，返回内存池字节数
+ * @param  preempt: 1 表示每一步都让 OS_NnRun 超时返回
+ */
+static uint32_t TestCifar10(const q7_t *ref, uint8_t fused, uint16_t tile, uint8_t preempt)
+{
+    OS_NnLayer layers[CIFAR10_LAYERS];
+    OS_NnTensor tensors[OS_NN_PLAN_TENSORS(CIFAR10_LAYERS)];
+    OS_NnRunner run;
+    uint16_t n = Cifar10Layers(layers, fused, tile);
+    uint32_t need = OS_NnPlanLayers(layers, n, tensors, NULL, 0);
+    uint8_t *arena = malloc(need + GUARD);
+    uint32_t timeouts = 0;
+    uint8_t ret;
+
+    memset(arena, GUARD_BYTE, need + GUARD);
+    Check(OS_NnPlanLayers(layers, n, tensors, arena, need) == need, "cifar10 plan changed", &layers[0]);
+    Cifar10Input(layers[0].In);
+
+    OS_NnRunnerInit(&run, layers, n, NULL);
+    while ((ret = OS_NnRun(&run, preempt ? OS_TimeNowCycles() : 0)) == OS_NN_TIMEOUT)
+        timeouts++;
+    Check(ret == OS_NN_DONE, "cifar10 run failed", &layers[0]);
+    Check(memcmp(layers[n - 1].Out, ref, CIFAR10_OUT_SIZE) == 0, "cifar10 output differs", &layers[0]);
+    Check(memcmp(arena + need, "\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A\x5A", GUARD) == 0,
+          "cifar10 wrote past the arena", &layers[0]);
+    Check(!preempt || timeouts + 1u == run.Steps, "cifar10 did not stop after every step", &layers[0]);
+
+    if (!preempt)
+        printf("cifar10,%u,%u,%u,%u\n", fused, tile, need, run.Steps);
+    free(arena);
+    return need;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static const uint16_t tiles[] = {0, 1, 2, 3, 5};
+    q7_t ref[CIFAR10_OUT_SIZE];
+    uint32_t plain = 0, fused = 0, fused2 = 0, need;
+    uint32_t i;
+
+    if (argc > 1)
+        g_Cases = (uint32_t)strtoul(argv[1], NULL, 0);
+
+    // OS_NnRun 在步间调用 OS_Yield：一个任务（主线程）加一个空闲任务
+    OS_TaskCreate(&g_IdleTcb, NULL, g_DummyStack[0], 16);
+    OS_TaskCreate(&g_TaskTcb, NULL, g_DummyStack[1], 16);
+    g_OSRunning = 1;
+
+    // 1. 分块
+    TestTiles(OS_NN_CONV_RGB);
+    TestTiles(OS_NN_CONV_BASIC);
+    TestTiles(OS_NN_CONV_FAST);
+    TestTiles(OS_NN_FC);
+    TestTiles(OS_NN_FC_OPT);
+    TestTiles(OS_NN_RELU);
+
+    // 2. 融合
+    TestFused();
+
+    // 3. cifar10：例程的静态缓冲区 -> 规划后 -> 融合后
+    Cifar10Example(ref, NULL);
+    printf("cifar10,example,,%u,%u\n", CIFAR10_EXAMPLE_BYTES, CIFAR10_LAYERS);
+    for (i = 0; i < sizeof(tiles) / sizeof(tiles[0]); i++)
+    {
+        need = TestCifar10(ref, 0, tiles[i], 0);
+        if (tiles[i] == 0)
+            plain = need;
+        need = TestCifar10(ref, 1, tiles[i], 0);
+        if (tiles[i] == 0)
+            fused = need;
+        if (tiles[i] == 2)
+            fused2 = need;
+    }
+    TestCifar10(ref, 0, 2, 1);
+    TestCifar10(ref, 1, 1, 1);
+
+    if (CIFAR10_EXAMPLE_BYTES != 44170u || plain != 36140u || fused != 14636u || fused2 != 16684u)
+    {
+        fprintf(stderr, "nn_compare: cifar10 arena %u -> %u -> %u (2-row steps %u), expected "
+                "44170 -> 36140 -> 14636 (16684)\n", CIFAR10_EXAMPLE_BYTES, plain, fused, fused2);
+        g_Errors++;
+    }
+
+    if (g_Errors != 0)
+    {
+        fprintf(stderr, "nn_compare: %u mismatches\n", g_Errors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ ******************************************************************************
+ * @file    nn_profile.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-NN 例程逐层性能统计，输出 CSV (Linux 主机)
+ *
+ * - cifar10 例程：按例程的调用顺序跑，每一次 CMSIS-NN 调用单独计时
+ *   (Cifar10Example)；再用 OS_NnRunner 跑同一网络的几种层表
+ *   （例程的内核、按 2 行分块、卷积 + ReLU + 池化融合），输出 OS_NnProfileCsv
+ * - gru 例程：gru_example() 里的每一次调用单独计时；再把它的 5 个向量按调用的
+ *   生存期写成张量表，用 OS_NnPlanTensors 规划，内存池必须和例程的
+ *   scratch_buffer 一样是 320 字节
+ *
+ * 每一段前面有一行 "# 名称"，后面是 CSV：
+ *   layer,type,steps,cycles,macs,macs_per_cycle,act_bytes,weight_bytes
+ * 主机上 OS_NN_PROFILE_CLOCK 是单调时钟，cycles 一列实际是纳秒，
+ * 只能在同一台机器上横向比较；周期数要在板子上用 DWT 测（HowTo.txt）。
+ * 运行器的输出必须和例程逐位一致、gru 的内存池必须是 320 字节，否则判失败。
+ *
+ * 用法：nn_profile [推理次数]
+ *
+ ******************************************************************************
+ */
+
+#include "nn_cifar10.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arm_nnexamples_gru_test_data.h"
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define DIM_HISTORY 32
+#define DIM_INPUT   32
+#define DIM_VEC     64
+#define GRU_CALLS   11u  ///< gru_example() 里的调用次数
+#define GRU_TENSORS 6u   ///< gru_example() 的向量数，外加原地写回的新历史状态
+#define GRU_BYTES   320u ///< 例程 scratch_buffer 的字节数，也是规划的结果
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  例程里一次调用的统计
+ */
+typedef struct
+{
+    const char *Name;     ///< CMSIS 函数名
+    uint32_t Macs;        ///< 乘加次数（只统计全连接）
+    uint32_t ActBytes;    ///< 读入和写出的激活字节数
+    uint32_t WeightBytes; ///< 权重和偏置字节数
+    uint64_t Cycles;      ///< 累计耗时
+} NnCall;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Runs = 20u;
+
+static const q7_t update_gate_weights[DIM_VEC * DIM_HISTORY] = UPDATE_GATE_WEIGHT_X4;
+static const q7_t reset_gate_weights[DIM_VEC * DIM_HISTORY] = RESET_GATE_WEIGHT_X4;
+static const q7_t hidden_state_weights[DIM_VEC * DIM_HISTORY] = HIDDEN_STATE_WEIGHT_X4;
+static const q7_t update_gate_bias[DIM_HISTORY] = UPDATE_GATE_BIAS;
+static const q7_t reset_gate_bias[DIM_HISTORY] = RESET_GATE_BIAS;
+static const q7_t hidden_state_bias[DIM_HISTORY] = HIDDEN_STATE_BIAS;
+static const q15_t test_input1[DIM_INPUT] = INPUT_DATA1;
+static const q15_t test_history[DIM_HISTORY] = HISTORY_DATA;
+static q15_t scratch_buffer[DIM_HISTORY * 4 + DIM_INPUT];
+
+static NnCall g_GruCalls[GRU_CALLS];
+static char g_Csv[4096];
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+// 主机上用单调时钟（纳秒）代替节拍定时器
+uint64_t OS_TimeNowCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// 执行第 i 次调用并计时
+#define GRU_CALL(i, name, macs, act, wt, ...)                                 \
+    do                                                                        \
+    {                                                                         \
+        uint32_t t0 = OS_NN_PROFILE_CLOCK();                                  \
+        __VA_ARGS__;                                                          \
+        g_GruCalls[i].Cycles += (uint32_t)(OS_NN_PROFILE_CLOCK() - t0);       \
+        g_GruCalls[i].Name = name;                                            \
+        g_GruCalls[i].Macs = macs;                                            \
+        g_GruCalls[i].ActBytes = act;                                         \
+        g_GruCalls[i].WeightBytes = wt;                                       \
+    } while (0)
+
+/**
+ * @brief  gru 例程的 gru_example()（USE_X4），每次调用单独计时
+ */
+static void GruExample(q15_t *scratch_input, uint16_t input_size, uint16_t history_size)
+{
+    q15_t *reset = scratch_input;
+    q15_t *input = scratch_input + history_size;
+    q15_t *history = scratch_input + history_size + input_size;
+    q15_t *update = scratch_input + 2 * history_size + input_size;
+    q15_t *hidden_state = scratch_input + 3 * history_size + input_size;
+    uint16_t vec = input_size + history_size;
+    uint32_t fc_macs = (uint32_t)vec * history_size;
+    uint32_t fc_act = 2u * (vec + history_size);
+    uint32_t fc_wt = (uint32_t)history_size * (vec + 1u);
+    uint32_t v1 = 2u * 2u * history_size; // 一进一出
+    uint32_t v2 = 3u * 2u * history_size; // 两进一出
+
+    // reset gate
+    GRU_CALL(0, "arm_fully_connected_mat_q7_vec_q15_opt", fc_macs, fc_act, fc_wt,
+             arm_fully_connected_mat_q7_vec_q15_opt(input, reset_gate_weights, vec, history_size, 0, 15,
+                                                    reset_gate_bias, reset, NULL));
+    GRU_CALL(1, "arm_nn_activations_direct_q15", 0, v1, 0,
+             arm_nn_activations_direct_q15(reset, history_size, 0, ARM_SIGMOID));
+    GRU_CALL(2, "arm_mult_q15", 0, v2, 0, arm_mult_q15(history, reset, reset, history_size));
+
+    // update gate
+    GRU_CALL(3, "arm_fully_connected_mat_q7_vec_q15_opt", fc_macs, fc_act, fc_wt,
+             arm_fully_connected_mat_q7_vec_q15_opt(input, update_gate_weights, vec, history_size, 0, 15,
+                                                    update_gate_bias, update, NULL));
+    GRU_CALL(4, "arm_nn_activations_direct_q15", 0, v1, 0,
+             arm_nn_activations_direct_q15(update, history_size, 0, ARM_SIGMOID));
+
+    // hidden state
+    GRU_CALL(5, "arm_fully_connected_mat_q7_vec_q15_opt", fc_macs, fc_act, fc_wt,
+             arm_fully_connected_mat_q7_vec_q15_opt(reset, hidden_state_weights, vec, history_size, 0, 15,
+                                                    hidden_state_bias, hidden_state, NULL));
+    GRU_CALL(6, "arm_nn_activations_direct_q15", 0, v1, 0,
+             arm_nn_activations_direct_q15(hidden_state, history_size, 0, ARM_TANH));
+    GRU_CALL(7, "arm_mult_q15", 0, v2, 0, arm_mult_q15(update, hidden_state, hidden_state, history_size));
+
+    // history_out = hidden_state - (z - 1) * history
+    GRU_CALL(8, "arm_offset_q15", 0, v1, 0, arm_offset_q15(update, 0x8000, update, history_size));
+    GRU_CALL(9, "arm_mult_q15", 0, v2, 0, arm_mult_q15(history, update, update, history_size));
+    GRU_CALL(10, "arm_sub_q15", 0, v2, 0, arm_sub_q15(hidden_state, update, history, history_size));
+}
+
+static void PrintCalls(const NnCall *calls, uint16_t num, uint32_t runs)
+{
+    uint64_t cycles, mpc;
+    uint16_t i;
+
+    printf("layer,type,steps,cycles,macs,macs_per_cycle,act_bytes,weight_bytes\n");
+    for (i = 0; i < num; i++)
+    {
+        cycles = calls[i].Cycles / runs;
+        mpc = (cycles != 0) ? (uint64_t)calls[i].Macs * 1000u / cycles : 0;
+        printf("%u,%s,1,%lu,%u,%lu.%03lu,%u,%u\n", (unsigned)i, calls[i].Name, (unsigned long)cycles,
+               calls[i].Macs, (unsigned long)(mpc / 1000u), (unsigned long)(mpc % 1000u), calls[i].ActBytes,
+               calls[i].WeightBytes);
+    }
+}
+
+/**
+ * @brief  运行器跑一种层表并输出统计，返回 0 表示输出和例程一致
+ */
+static int ProfileRunner(const q7_t *ref, uint8_t fused, uint16_t tile)
+{
+    OS_NnLayer layers[CIFAR10_LAYERS];
+    OS_NnTensor tensors[OS_NN_PLAN_TENSORS(CIFAR10_LAYERS)];
+    OS_NnLayerProfile profile[CIFAR10_LAYERS];
+    OS_NnRunner run;
+    uint16_t n = Cifar10Layers(layers, fused, tile);
+    uint32_t need = OS_NnPlanLayers(layers, n, tensors, NULL, 0);
+    uint8_t *arena = malloc(need);
+    uint32_t i;
+    int err = 0;
+
+    OS_NnPlanLayers(layers, n, tensors, arena, need);
+    OS_NnRunnerInit(&run, layers, n, NULL);
+    OS_NnProfileStart(&run, profile);
+    for (i = 0; i < g_Runs; i++)
+    {
+        Cifar10Input(layers[0].In);
+        if (OS_NnRun(&run, 0) != OS_NN_DONE || memcmp(layers[n - 1].Out, ref, CIFAR10_OUT_SIZE) != 0)
+            err = 1;
+    }
+
+    printf("# cifar10 runner fused=%u tile_rows=%u arena=%u\n", fused, tile, need);
+    OS_NnProfileCsv(&run, g_Csv, sizeof(g_Csv));
+    fputs(g_Csv, stdout);
+    free(arena);
+    return err;
+}
+
+/**
+ * @brief  gru 例程的张量表：步骤就是 GRU_CALL 的编号，返回规划出的内存池字节数
+ * @note   例程的全连接要求 [input, history] 和 [reset, input] 各自连续，
+ *         张量表表达不了这种相邻关系，这里只核对大小：第 5 步 5 个向量全部活着，
+ *         320 字节已经是下限
+ */
+static uint32_t GruPlan(void)
+{
+    uint32_t vec = DIM_HISTORY * sizeof(q15_t);
+    OS_NnTensor t[GRU_TENSORS] = {
+        {DIM_INPUT * sizeof(q15_t), 0, 5, OS_NN_NO_ALIAS, 0}, // input：两个门和隐藏状态的全连接读
+        {vec, 0, 9, OS_NN_NO_ALIAS, 0},                      // history：第 2、9 步还要读
+        {vec, 0, 5, OS_NN_NO_ALIAS, 0},                      // reset：第 0 步写，第 5 步读
+        {vec, 3, 10, OS_NN_NO_ALIAS, 0},                     // update：第 3 步写，第 10 步读
+        {vec, 5, 10, OS_NN_NO_ALIAS, 0},                     // hidden_state：第 5 步写，第 10 步读
+        {vec, 10, GRU_CALLS, 1, 0},                          // 新的 history：arm_sub_q15 原地写回
+    };
+    uint32_t need = OS_NnPlanTensors(t, GRU_TENSORS);
+    uint32_t i;
+
+    printf("# gru tensors arena=%u\n", need);
+    printf("tensor,bytes,first,last,offset\n");
+    for (i = 0; i < GRU_TENSORS; i++)
+        printf("%u,%u,%u,%u,%u\n", i, t[i].Size, t[i].First, t[i].Last, t[i].Offset);
+    return need;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    static OS_TCB idle_tcb, task_tcb;
+    static uint32_t dummy_stack[2][16];
+    OS_NnLayer layers[CIFAR10_LAYERS];
+    OS_NnLayerProfile profile[CIFAR10_LAYERS];
+    OS_NnRunner fmt;
+    q7_t ref[CIFAR10_OUT_SIZE];
+    uint32_t i, need;
+    int err = 0;
+
+    if (argc > 1)
+        g_Runs = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (g_Runs == 0)
+        g_Runs = 1;
+
+    // OS_NnRun 在步间调用 OS_Yield：一个任务（主线程）加一个空闲任务
+    OS_TaskCreate(&idle_tcb, NULL, dummy_stack[0], 16);
+    OS_TaskCreate(&task_tcb, NULL, dummy_stack[1], 16);
+    g_OSRunning = 1;
+
+    // 1. cifar10 例程，每次调用单独计时；不融合的层表和调用一一对应，借它的格式输出
+    OS_NnRunnerInit(&fmt, layers, Cifar10Layers(layers, 0, 0), NULL);
+    OS_NnProfileStart(&fmt, profile);
+    for (i = 0; i < g_Runs; i++)
+        Cifar10Example(ref, profile);
+    fmt.ProfileRuns = g_Runs;
+    printf("# cifar10 example\n");
+    OS_NnProfileCsv(&fmt, g_Csv, sizeof(g_Csv));
+    fputs(g_Csv, stdout);
+
+    // 2. 运行器：例程的内核 / 按 2 行分块 / 融合
+    err |= ProfileRunner(ref, 0, 0);
+    err |= ProfileRunner(ref, 0, 2);
+    err |= ProfileRunner(ref, 1, 0);
+    if (err)
+        fprintf(stderr, "nn_profile: runner output differs from the example\n");
+
+    // 3. gru 例程：每次都从例程的初始历史状态算第一个时间步
+    for (i = 0; i < g_Runs; i++)
+    {
+        memcpy(scratch_buffer + DIM_HISTORY, test_input1, sizeof(test_input1));
+        memcpy(scratch_buffer + DIM_HISTORY + DIM_INPUT, test_history, sizeof(test_history));
+        GruExample(scratch_buffer, DIM_INPUT, DIM_HISTORY);
+    }
+    printf("# gru example\n");
+    PrintCalls(g_GruCalls, GRU_CALLS, g_Runs);
+
+    // 4. gru 的内存：例程的缓冲区和规划结果
+    need = GruPlan();
+    if (sizeof(scratch_buffer) != GRU_BYTES || need != GRU_BYTES)
+    {
+        fprintf(stderr, "nn_profile: gru arena %u -> %u, expected %u -> %u\n",
+                (unsigned)sizeof(scratch_buffer), need, GRU_BYTES, GRU_BYTES);
+        err = 1;
+    }
+    return err;
+}
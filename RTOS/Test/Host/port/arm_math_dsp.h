@@ -0,0 +1,26 @@
+/**
+ ******************************************************************************
+ * @file    arm_math_dsp.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   在主机上编译 CMSIS-DSP/NN 的 DSP 扩展代码路径 (Linux 主机测试用)
+ *
+ * 用 -include 强制包含。ARM_MATH_CM3 下 arm_math.h 给出 __SMLAD、__SXTB16、
+ * __QADD16 等 SIMD 指令的 C 实现；之后再定义 ARM_MATH_DSP，各内核就走
+ * Cortex-M4 (DSP 扩展) 的代码路径，指令由这些 C 实现完成。
+ * 用于在主机上覆盖 fast 卷积等只在 DSP 路径上才跳过边界检查的代码。
+ *
+ ******************************************************************************
+ */
+
+#ifndef __ARM_MATH_DSP_HOST_H
+#define __ARM_MATH_DSP_HOST_H
+
+#include "arm_math.h"
+
+#ifndef ARM_MATH_DSP
+#define ARM_MATH_DSP
+#endif
+
+#endif /* __ARM_MATH_DSP_HOST_H */
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file    os_cpu.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 移植层 C 语言实现 (Linux 主机测试用)
+ *
+ * 临界区是一把全局自旋锁；进出临界区都会让监视器代号前进，
+ * 跨过临界区的 LDREX/STREX 必然失败，和单核上被中断打断的效果一样。
+ *
+ ******************************************************************************
+ */
+
+#include "os_core.h"
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+volatile uint32_t g_HostMonitor = 0;
+volatile uint32_t g_HostStrexFail = 0;
+volatile uint32_t g_HostCriticalSpin = 0;
+volatile uint32_t g_HostPendSV = 0;
+__thread uint32_t t_HostReserve = 1u;
+__thread uint32_t t_HostReserveValue = 0;
+__thread uint8_t  t_HostInISR = 0;
+volatile uint32_t g_HostCpuLock = 0;
+__thread uint8_t  t_HostIrqOff = 0;
+uint32_t g_HostPreemptEvery = 0;
+__thread uint32_t t_HostStrexCount = 0;
+uint8_t g_HostIrqPrio[HOST_IRQ_NUM];
+__thread int32_t t_HostActiveIRQn = -1;
+
+static __thread OS_TCB *t_HostTask = NULL;   // 本线程扮演的任务
+static __thread uint8_t t_HostIsrLock = 0;  // 本线程在“中断”里持有临界区锁
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static void HostMonitorClear(void)
+{
+    uint32_t gen;
+
+    // 等正在写的 STREX 写完，再让代号前进
+    for (;;)
+    {
+        gen = HostMonitorIdle();
+        if (__atomic_compare_exchange_n(&g_HostMonitor, &gen, gen + 2u, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            return;
+    }
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32_t stack_depth)
+{
+    (void)task_function;
+    return stack_init_address + stack_depth;
+}
+
+void OS_Init_Timer(uint32_t freq)
+{
+    (void)freq;
+}
+
+void OS_StartFirstTask(void)
+{
+}
+
+void OS_Trigger_PendSV(void)
+{
+    __atomic_fetch_add(&g_HostPendSV, 1u, __ATOMIC_RELAXED);
+}
+
+void OS_Disable_IRQ(void)
+{
+    if (t_HostIrqOff) // 已经在临界区里（BASEPRI 已经提高过）
+        return;
+
+    while (__atomic_exchange_n(&g_HostCpuLock, 1u, __ATOMIC_ACQUIRE))
+    {
+        __atomic_fetch_add(&g_HostCriticalSpin, 1u, __ATOMIC_RELAXED);
+        sched_yield();
+    }
+    t_HostIrqOff = 1;
+    HostMonitorClear();
+}
+
+void OS_Enable_IRQ(void)
+{
+    if (!t_HostIrqOff || t_HostIsrLock) // 中断里的临界区不能提前放掉中断自己的锁
+        return;
+
+    HostMonitorClear();
+    t_HostIrqOff = 0;
+    __atomic_store_n(&g_HostCpuLock, 0u, __ATOMIC_RELEASE);
+
+    // 真机上 PendSV 在这里才会切走；阻塞的任务等中断线程把它唤醒
+    if (t_HostTask != NULL)
+    {
+        while (__atomic_load_n(&t_HostTask->State, __ATOMIC_ACQUIRE) == TASK_BLOCKED)
+            sched_yield();
+    }
+}
+
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn)
+{
+    if (irqn < 0)
+        return 1;
+    return irqn < (int32_t)HOST_IRQ_NUM && g_HostIrqPrio[irqn] >= OS_CFG_MAX_SYSCALL_PRIO;
+}
+
+void HostTaskBind(void *tcb)
+{
+    t_HostTask = (OS_TCB *)tcb;
+    CurrentTCB = t_HostTask;
+    NextTCB = t_HostTask;
+}
+
+void HostIsrEnter(void)
+{
+    OS_Disable_IRQ();
+    t_HostIsrLock = 1;
+    t_HostInISR = 1;
+}
+
+void HostIsrExit(void)
+{
+    t_HostInISR = 0;
+    t_HostIsrLock = 0;
+    OS_Enable_IRQ();
+}
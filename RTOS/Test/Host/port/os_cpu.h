@@ -0,0 +1,210 @@
+/**
+ ******************************************************************************
+ * @file    os_cpu.h
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   RTOS 架构相关头文件 (Linux 主机测试用)
+ *
+ * 让内核和服务的 C 代码直接在 Linux 上用 gcc 编译，由多个 pthread 线程
+ * 扮演任务和中断，用于并发压力测试和开销对比：
+ * - 临界区：OS_Disable_IRQ / OS_Enable_IRQ 是一把全局自旋锁，同一线程可重入
+ * - 独占访问：LDREX/STREX 用 GCC 的 __atomic 内建函数模拟单核的独占监视器，
+ *   STREX 在以下情况失败：
+ *   1) 从 LDREX 起有别的 STREX 成功过（单核上说明中间发生过切换）
+ *   2) 从 LDREX 起有线程进入或退出过临界区
+ *   3) 被独占的值已经变了
+ *   别的线程在临界区里时 LDREX 会等它出来：单核上关中断期间不会有别的上下文运行
+ * - 中断：扮演中断的线程用 HostIsrEnter/HostIsrExit 包住一次“中断”，
+ *   期间持有临界区锁（任务不会和中断同时运行），OS_CPU_InISR 为真
+ * - 阻塞：HostTaskBind 登记的任务线程在退出最外层临界区时，
+ *   如果自己的 TCB 是 TASK_BLOCKED，就一直等到中断线程把它改回就绪，
+ *   相当于 PendSV 切走、再被切回来。只支持一个任务线程（CurrentTCB 只有一个）
+ * - g_HostPreemptEvery 不为 0 时，每隔这么多次 STREX 就在 STREX 之前让出 CPU，
+ *   模拟中断恰好打在 LDREX 和 STREX 之间
+ *
+ ******************************************************************************
+ */
+
+#ifndef __OS_CPU_H
+#define __OS_CPU_H
+
+#include <stdint.h>
+#include <sched.h>
+
+/* 模拟用的全局状态（os_cpu.c） -------------------------------------------- */
+
+extern volatile uint32_t g_HostMonitor;          ///< 监视器代号：偶数空闲，奇数表示有 STREX 正在写
+extern volatile uint32_t g_HostStrexFail;        ///< STREX 失败次数
+extern volatile uint32_t g_HostCriticalSpin;     ///< 进临界区时等锁的次数
+extern volatile uint32_t g_HostCpuLock;          ///< 临界区锁，1 表示有线程在临界区里
+extern __thread uint8_t  t_HostIrqOff;           ///< 本线程持有临界区锁
+extern __thread uint32_t t_HostReserve;          ///< 本线程 LDREX 时的监视器代号，奇数表示没有
+extern __thread uint32_t t_HostReserveValue;     ///< 本线程 LDREX 读到的值
+extern __thread uint8_t  t_HostInISR;            ///< 本线程正在扮演中断
+extern uint32_t g_HostPreemptEvery;              ///< 每隔多少次 STREX 让出一次 CPU，0 表示不让
+extern __thread uint32_t t_HostStrexCount;       ///< 本线程 STREX 次数
+
+/**
+ * @brief  等监视器空闲，返回当前代号
+ */
+static inline uint32_t HostMonitorIdle(void)
+{
+    uint32_t gen;
+
+    while ((gen = __atomic_load_n(&g_HostMonitor, __ATOMIC_ACQUIRE)) & 1u)
+    {
+        sched_yield();
+    }
+    return gen;
+}
+
+static inline uint32_t HostLdrex(const volatile void *addr, uint32_t size)
+{
+    uint32_t value;
+
+    // 先取代号再看锁：看锁之后才进临界区的线程一定会让代号前进
+    for (;;)
+    {
+        t_HostReserve = HostMonitorIdle();
+        if (t_HostIrqOff || __atomic_load_n(&g_HostCpuLock, __ATOMIC_ACQUIRE) == 0u)
+            break;
+        sched_yield();
+    }
+    if (size == 2u)
+        value = __atomic_load_n((const volatile uint16_t *)addr, __ATOMIC_SEQ_CST);
+    else
+        value = __atomic_load_n((const volatile uint32_t *)addr, __ATOMIC_SEQ_CST);
+    t_HostReserveValue = value;
+    return value;
+}
+
+static inline uint32_t HostStrex(uint32_t value, volatile void *addr, uint32_t size)
+{
+    uint32_t gen;
+    uint32_t now;
+
+    // 0. 模拟中断打在 LDREX 之后、STREX 之前（调用者已经根据读到的值做完判断）
+    if (g_HostPreemptEvery != 0u && ++t_HostStrexCount % g_HostPreemptEvery == 0u)
+    {
+        sched_yield();
+    }
+
+    gen = t_HostReserve;
+    t_HostReserve = 1u; // 一次 LDREX 只能配一次 STREX
+
+    // 1. 抢下监视器：代号变过说明中间有别的 STREX 或临界区
+    if ((gen & 1u) ||
+        !__atomic_compare_exchange_n(&g_HostMonitor, &gen, gen + 1u, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+        __atomic_fetch_add(&g_HostStrexFail, 1u, __ATOMIC_RELAXED);
+        return 1u;
+    }
+
+    // 2. 值没变才写
+    if (size == 2u)
+        now = __atomic_load_n((volatile uint16_t *)addr, __ATOMIC_SEQ_CST);
+    else
+        now = __atomic_load_n((volatile uint32_t *)addr, __ATOMIC_SEQ_CST);
+    if (now != t_HostReserveValue)
+    {
+        __atomic_store_n(&g_HostMonitor, gen + 2u, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&g_HostStrexFail, 1u, __ATOMIC_RELAXED);
+        return 1u;
+    }
+    if (size == 2u)
+        __atomic_store_n((volatile uint16_t *)addr, (uint16_t)value, __ATOMIC_SEQ_CST);
+    else
+        __atomic_store_n((volatile uint32_t *)addr, value, __ATOMIC_SEQ_CST);
+
+    // 3. 放开监视器，代号前进，别人手里的预约全部作废
+    __atomic_store_n(&g_HostMonitor, gen + 2u, __ATOMIC_RELEASE);
+    return 0u;
+}
+
+/* 独占访问指令 (LDREX/STREX) ------------------------------------------------ */
+
+#define OS_CPU_LDREXH(addr)         ((uint16_t)HostLdrex((addr), 2u))  ///< 独占读 16 位
+#define OS_CPU_STREXH(value, addr)  HostStrex((value), (addr), 2u)     ///< 独占写 16 位，成功返回 0
+#define OS_CPU_LDREXW(addr)         HostLdrex((addr), 4u)              ///< 独占读 32 位
+#define OS_CPU_STREXW(value, addr)  HostStrex((value), (addr), 4u)     ///< 独占写 32 位，成功返回 0
+#define OS_CPU_CLREX()              (t_HostReserve = 1u)               ///< 放弃独占访问
+
+/* 当前是否运行在中断（Handler 模式）里 */
+#define OS_CPU_InISR()              (t_HostInISR != 0u)
+
+/* 当前中断的中断号：扮演中断的线程可以改 t_HostActiveIRQn，默认 -1（SysTick） */
+#define OS_CPU_ActiveIRQn()         (t_HostActiveIRQn)
+
+/* 内存屏障：同时也是编译器屏障 */
+#define OS_CPU_DMB()                __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* 函数声明 ---------------------------------------------------------------- */
+
+/**
+ * @brief  主机上任务不切栈，只返回栈顶
+ */
+uint32_t* OS_StackInit(void* task_function, uint32_t* stack_init_address, uint32_t stack_depth);
+
+/**
+ * @brief  主机上没有节拍中断，测试自己调用 OS_Tick_Handler
+ * @param  freq: 节拍频率（单位Hz）
+ */
+void OS_Init_Timer(uint32_t freq);
+
+/**
+ * @brief  主机上不会真正启动任务
+ */
+void OS_StartFirstTask(void);
+
+/**
+ * @brief  只计数（g_HostPendSV）
+ */
+void OS_Trigger_PendSV(void);
+
+/**
+ * @brief  释放全局临界区锁
+ */
+void OS_Enable_IRQ(void);
+
+/**
+ * @brief  获取全局临界区锁（同一线程可重入）
+ */
+void OS_Disable_IRQ(void);
+
+/**
+ * @brief  中断里能否调用 OS_ 函数：按 g_HostIrqPrio 里的优先级判断，系统异常总是可以
+ */
+uint8_t OS_CPU_IrqKernelAware(int32_t irqn);
+
+#define HOST_IRQ_NUM  64u
+
+extern volatile uint32_t g_HostPendSV;          ///< OS_Trigger_PendSV 被调用的次数
+extern uint8_t g_HostIrqPrio[HOST_IRQ_NUM];     ///< 模拟的 NVIC 优先级，复位值 0（高于内核天花板）
+extern __thread int32_t t_HostActiveIRQn;       ///< OS_CPU_ActiveIRQn 的返回值
+
+/* 高分辨率单次定时器：链接 os_time.c 的测试程序提供 ------------------------ */
+
+void OS_HrTimer_Init(void);
+void OS_HrTimer_Start(uint32_t us);
+void OS_HrTimer_Stop(void);
+void OS_HrTimer_AcknowledgeIRQ(void);
+
+/* 任务与中断模拟 ------------------------------------------------------------ */
+
+/**
+ * @brief  把当前线程登记为任务，CurrentTCB 指向 tcb（类型为 OS_TCB *）
+ */
+void HostTaskBind(void *tcb);
+
+/**
+ * @brief  进入一次“中断”：拿临界区锁，OS_CPU_InISR() 为真
+ */
+void HostIsrEnter(void);
+
+/**
+ * @brief  退出“中断”
+ */
+void HostIsrExit(void);
+
+#endif /* __OS_CPU_H */
@@ -0,0 +1,497 @@
+/**
+ ******************************************************************************
+ * @file    rtos2_test.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   CMSIS-RTOS2 适配层的测试 (Linux 主机)
+ *
+ * 直接包含 os_rtos2.c，以便拿到定时器线程和定时器链表。
+ *
+ * 第一部分：主线程扮演一个 osThreadNew 创建的线程，节拍线程一直打节拍。
+ * 节拍线程在任务阻塞后的第一拍执行一次挂上的钩子（中断里或任务里），
+ * 用来在等待期间释放信号量、放消息、置标志，或者尝试删除正在被等待的对象。
+ * 覆盖：信号量、消息队列、事件标志、线程标志的立即失败 (timeout 0)、
+ * 超时（在 timeout 拍之后返回）和被唤醒三条路径；各 Delete 在有等待者时拒绝；
+ * osMessageQueueReset；不支持的线程调用返回 osErrorResource。
+ *
+ * 第二部分：另一个线程扮演定时器线程跑 TimerTask，主线程一拍一拍地打节拍，
+ * 每拍之后等定时器线程重新阻塞，回调里记下当时的节拍数。
+ * 覆盖：单次和周期定时器准确在到期拍执行；停止后不再执行；删除后从链表摘掉，
+ * 控制块被覆盖也不影响其它定时器；重复删除、中断里删除被拒绝。
+ *
+ ******************************************************************************
+ */
+
+#include "../../Src/os_rtos2.c"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+// 调用 call，检查返回值和它用掉的节拍数（节拍线程异步在打，允许多 2 拍）
+#define CHECK_TIMED(call, expect, ticks)                                      \
+    do                                                                        \
+    {                                                                         \
+        uint32_t start_ = g_SystemTickCount;                                  \
+        uint32_t result_ = (uint32_t)(call);                                  \
+        uint32_t used_ = g_SystemTickCount - start_;                          \
+        if (result_ != (uint32_t)(expect) || used_ - (ticks) > 2u) /* 少用了会回绕 */ \
+        {                                                                     \
+            printf("FAIL %s:%d: %s = 0x%x after %u ticks\n", __FILE__, __LINE__, #call, \
+                   result_, used_);                                           \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+#define MAX_FIRES 16u
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_TCB g_IdleTcb;
+static uint32_t g_IdleStack[16];
+static OS_Rtos2Thread g_AppCb;
+static uint32_t g_AppStack[64];
+static osThreadId_t g_App;
+
+static volatile uint8_t g_Ticking = 0;     // 节拍线程是否打节拍
+static volatile uint32_t g_TickRounds = 0; // 节拍线程的轮数
+static volatile uint8_t g_Stop = 0;
+static void (*volatile g_IsrHook)(void);   // 任务阻塞后，下一拍在中断里执行一次
+static void (*volatile g_TaskHook)(void);  // 同上，但在中断之外（扮演另一个任务）
+static uint32_t g_Errors = 0;
+
+static OS_Rtos2Semaphore g_SemCb;
+static OS_Rtos2MessageQueue g_MqCb;
+static uint32_t g_MqMem[OS_RTOS2_MQ_MEM_SIZE(4, sizeof(uint32_t)) / sizeof(uint32_t)];
+static OS_Rtos2Mutex g_MutexCb;
+static OS_Rtos2EventFlags g_EfCb;
+static osSemaphoreId_t g_Sem;
+static osMessageQueueId_t g_Mq;
+static osEventFlagsId_t g_Ef;
+static volatile osStatus_t g_HookStatus;
+
+static OS_Rtos2Timer g_TimerCb[3];
+static uint32_t g_Fires[3];
+static uint32_t g_FiredAt[3][MAX_FIRES];
+
+/* 节拍线程和钩子 ----------------------------------------------------- */
+
+static void *TickThread(void *arg)
+{
+    struct timespec nap = {0, 50000};
+    void (*hook)(void);
+    uint8_t blocked;
+
+    (void)arg;
+    while (!g_Stop)
+    {
+        nanosleep(&nap, NULL);
+
+        if (g_Ticking)
+        {
+            HostIsrEnter();
+            blocked = (g_AppCb.Tcb.State == TASK_BLOCKED);
+            OS_Tick_Handler();
+            hook = g_IsrHook;
+            if (blocked && hook != NULL)
+            {
+                g_IsrHook = NULL;
+                hook();
+            }
+            HostIsrExit();
+
+            hook = g_TaskHook;
+            if (blocked && hook != NULL)
+            {
+                g_TaskHook = NULL;
+                hook();
+            }
+        }
+        __atomic_fetch_add(&g_TickRounds, 1u, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+// 停下节拍线程，等它正在打的那一拍结束
+static void TickPause(void)
+{
+    uint32_t rounds;
+
+    g_Ticking = 0;
+    rounds = g_TickRounds;
+    while (g_TickRounds - rounds < 2u)
+        sched_yield();
+}
+
+static void SemReleaseHook(void)
+{
+    CHECK(osSemaphoreRelease(g_Sem) == osOK);
+}
+
+static void SemDeleteHook(void)
+{
+    g_HookStatus = osSemaphoreDelete(g_Sem);
+    osSemaphoreRelease(g_Sem);
+}
+
+static void MqPutHook(void)
+{
+    uint32_t msg = 42;
+
+    CHECK(osMessageQueuePut(g_Mq, &msg, 0, 0) == osOK);
+}
+
+static void MqGetHook(void)
+{
+    uint32_t msg;
+
+    CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 0) == osOK);
+}
+
+static void MqDeleteHook(void)
+{
+    uint32_t msg = 7;
+
+    g_HookStatus = osMessageQueueDelete(g_Mq);
+    osMessageQueuePut(g_Mq, &msg, 0, 0);
+}
+
+static void EfSetHook(void)
+{
+    osEventFlagsSet(g_Ef, 0x2u);
+}
+
+static void EfDeleteHook(void)
+{
+    g_HookStatus = osEventFlagsDelete(g_Ef);
+    osEventFlagsSet(g_Ef, 0x1u);
+}
+
+static void ThreadFlagsHook(void)
+{
+    osThreadFlagsSet(g_App, 0x4u);
+}
+
+// app 线程的线程函数：主线程直接扮演它，不会被调用
+static void AppMain(void *argument)
+{
+}
+
+/* 第一部分：等待和超时 ------------------------------------------------ */
+
+static void TestSemaphore(void)
+{
+    osSemaphoreAttr_t attr = {"sem", 0, &g_SemCb, sizeof(g_SemCb)};
+
+    g_Sem = osSemaphoreNew(2, 1, &attr);
+    CHECK(g_Sem != NULL);
+
+    // 1. 立即失败和超时
+    CHECK(osSemaphoreAcquire(g_Sem, 0) == osOK);
+    CHECK_TIMED(osSemaphoreAcquire(g_Sem, 0), osErrorResource, 0);
+    CHECK_TIMED(osSemaphoreAcquire(g_Sem, 5), osErrorTimeout, 5);
+
+    // 2. 等待期间在中断里释放
+    g_IsrHook = SemReleaseHook;
+    CHECK(osSemaphoreAcquire(g_Sem, 1000) == osOK);
+    CHECK(g_IsrHook == NULL);
+
+    // 3. 计数上限
+    CHECK(osSemaphoreRelease(g_Sem) == osOK);
+    CHECK(osSemaphoreRelease(g_Sem) == osOK);
+    CHECK(osSemaphoreRelease(g_Sem) == osErrorResource);
+    CHECK(osSemaphoreGetCount(g_Sem) == 2);
+
+    // 4. 有人在等时不能删除
+    CHECK(osSemaphoreAcquire(g_Sem, 0) == osOK);
+    CHECK(osSemaphoreAcquire(g_Sem, 0) == osOK);
+    g_HookStatus = osOK;
+    g_TaskHook = SemDeleteHook;
+    CHECK(osSemaphoreAcquire(g_Sem, 1000) == osOK);
+    CHECK(g_HookStatus == osErrorResource);
+    CHECK(osSemaphoreDelete(g_Sem) == osOK);
+    CHECK(osSemaphoreGetName(g_Sem) == NULL);
+}
+
+static void TestMessageQueue(void)
+{
+    osMessageQueueAttr_t attr = {"mq", 0, &g_MqCb, sizeof(g_MqCb), g_MqMem, sizeof(g_MqMem)};
+    uint32_t msg;
+    uint32_t i;
+
+    CHECK(osMessageQueueNew(1, sizeof(uint32_t), &attr) == NULL); // 一个槽位的 MPMC 队列不成立
+    g_Mq = osMessageQueueNew(4, sizeof(uint32_t), &attr);
+    CHECK(g_Mq != NULL);
+
+    // 1. 满：立即失败和超时
+    for (i = 0; i < 4; i++)
+        CHECK(osMessageQueuePut(g_Mq, &i, 0, 0) == osOK);
+    msg = 4;
+    CHECK_TIMED(osMessageQueuePut(g_Mq, &msg, 0, 0), osErrorResource, 0);
+    CHECK_TIMED(osMessageQueuePut(g_Mq, &msg, 0, 3), osErrorTimeout, 3);
+
+    // 2. 满时等待，中断里取走一条
+    g_IsrHook = MqGetHook;
+    CHECK(osMessageQueuePut(g_Mq, &msg, 0, 1000) == osOK);
+    for (i = 1; i <= 4; i++)
+    {
+        CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 0) == osOK);
+        CHECK(msg == i);
+    }
+
+    // 3. 空：立即失败和超时，中断里放一条
+    CHECK_TIMED(osMessageQueueGet(g_Mq, &msg, NULL, 0), osErrorResource, 0);
+    CHECK_TIMED(osMessageQueueGet(g_Mq, &msg, NULL, 4), osErrorTimeout, 4);
+    g_IsrHook = MqPutHook;
+    CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 1000) == osOK);
+    CHECK(msg == 42);
+
+    // 4. 清空之后计数复原，队列照常使用
+    for (i = 0; i < 3; i++)
+        CHECK(osMessageQueuePut(g_Mq, &i, 0, 0) == osOK);
+    CHECK(osMessageQueueReset(g_Mq) == osOK);
+    CHECK(osMessageQueueGetCount(g_Mq) == 0);
+    CHECK(osMessageQueueGetSpace(g_Mq) == 4);
+    CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 0) == osErrorResource);
+    for (i = 10; i < 14; i++)
+        CHECK(osMessageQueuePut(g_Mq, &i, 0, 0) == osOK);
+    CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 0) == osOK);
+    CHECK(msg == 10);
+    CHECK(osMessageQueueReset(g_Mq) == osOK);
+
+    // 5. 有人在等时不能删除
+    g_HookStatus = osOK;
+    g_TaskHook = MqDeleteHook;
+    CHECK(osMessageQueueGet(g_Mq, &msg, NULL, 1000) == osOK);
+    CHECK(msg == 7);
+    CHECK(g_HookStatus == osErrorResource);
+    CHECK(osMessageQueueDelete(g_Mq) == osOK);
+}
+
+static void TestMutex(void)
+{
+    osMutexAttr_t attr = {"mutex", osMutexRecursive, &g_MutexCb, sizeof(g_MutexCb)};
+    osMutexId_t mutex = osMutexNew(&attr);
+
+    CHECK(mutex != NULL);
+    CHECK(osMutexAcquire(mutex, 0) == osOK);
+    CHECK(osMutexDelete(mutex) == osErrorResource); // 还被持有
+    CHECK(osMutexRelease(mutex) == osOK);
+    CHECK(osMutexDelete(mutex) == osOK);
+}
+
+static void TestFlags(void)
+{
+    osEventFlagsAttr_t attr = {"ef", 0, &g_EfCb, sizeof(g_EfCb)};
+
+    // 1. 事件标志：立即失败、超时、中断里置位
+    g_Ef = osEventFlagsNew(&attr);
+    CHECK(g_Ef != NULL);
+    CHECK_TIMED(osEventFlagsWait(g_Ef, 0x3u, osFlagsWaitAny, 0), osFlagsErrorResource, 0);
+    CHECK_TIMED(osEventFlagsWait(g_Ef, 0x3u, osFlagsWaitAny, 6), osFlagsErrorTimeout, 6);
+    g_IsrHook = EfSetHook;
+    CHECK(osEventFlagsWait(g_Ef, 0x3u, osFlagsWaitAny, 1000) == 0x2u);
+    CHECK(osEventFlagsGet(g_Ef) == 0);
+
+    // 2. 有人在等时不能删除
+    g_HookStatus = osOK;
+    g_TaskHook = EfDeleteHook;
+    CHECK(osEventFlagsWait(g_Ef, 0x1u, osFlagsWaitAny, 1000) == 0x1u);
+    CHECK(g_HookStatus == osErrorResource);
+    CHECK(osEventFlagsDelete(g_Ef) == osOK);
+
+    // 3. 线程标志
+    CHECK(osThreadFlagsGet() == 0);
+    CHECK_TIMED(osThreadFlagsWait(0x4u, osFlagsWaitAny, 0), osFlagsErrorResource, 0);
+    CHECK_TIMED(osThreadFlagsWait(0x4u, osFlagsWaitAny, 3), osFlagsErrorTimeout, 3);
+    g_IsrHook = ThreadFlagsHook;
+    CHECK(osThreadFlagsWait(0x4u, osFlagsWaitAny, 1000) == 0x4u);
+    CHECK(osThreadFlagsGet() == 0);
+    CHECK(osThreadFlagsSet(g_App, 0x9u) == 0x9u);
+    CHECK(osThreadFlagsWait(0x9u, osFlagsWaitAll | osFlagsNoClear, 0) == 0x9u);
+    CHECK(osThreadFlagsClear(0x1u) == 0x9u);
+    CHECK(osThreadFlagsGet() == 0x8u);
+    CHECK(osThreadFlagsClear(0x8u) == 0x8u);
+}
+
+static void TestThread(void)
+{
+    CHECK(osThreadGetId() == g_App);
+    CHECK(osThreadGetState(g_App) == osThreadRunning);
+    CHECK(osThreadTerminate((osThreadId_t)&TimerThread) == osErrorResource);
+    CHECK(osThreadSuspend(g_App) == osErrorResource);
+    CHECK(osThreadResume(g_App) == osErrorResource);
+    CHECK(osThreadDetach(g_App) == osErrorResource);
+    CHECK(osThreadJoin((osThreadId_t)&TimerThread) == osErrorResource);
+}
+
+/* 第二部分：定时器 --------------------------------------------------- */
+
+static void TimerCallback(void *argument)
+{
+    uint32_t id = (uint32_t)(uintptr_t)argument;
+
+    if (g_Fires[id] < MAX_FIRES)
+        g_FiredAt[id][g_Fires[id]] = g_SystemTickCount;
+    g_Fires[id]++;
+}
+
+static void *TimerThreadMain(void *arg)
+{
+    (void)arg;
+    HostTaskBind(&TimerThread.Tcb);
+    TimerTask(NULL);
+    return NULL;
+}
+
+// 等定时器线程处理完手上的事、重新阻塞
+static void TimerSettle(void)
+{
+    while (__atomic_load_n(&TimerThread.Tcb.State, __ATOMIC_ACQUIRE) != TASK_BLOCKED)
+        sched_yield();
+}
+
+// 打 n 拍，每拍之后让定时器线程跑完
+static void Step(uint32_t n)
+{
+    while (n--)
+    {
+        HostIsrEnter();
+        OS_Tick_Handler();
+        HostIsrExit();
+        TimerSettle();
+    }
+}
+
+static uint8_t TimerLinked(const OS_Rtos2Timer *timer)
+{
+    const OS_Rtos2Timer *t;
+
+    for (t = TimerListHead; t != NULL; t = t->Next)
+    {
+        if (t == timer)
+            return 1;
+    }
+    return 0;
+}
+
+static void TestTimers(void)
+{
+    osTimerAttr_t attr[3] = {
+        {"t0", 0, &g_TimerCb[0], sizeof(g_TimerCb[0])},
+        {"t1", 0, &g_TimerCb[1], sizeof(g_TimerCb[1])},
+        {"t2", 0, &g_TimerCb[2], sizeof(g_TimerCb[2])},
+    };
+    osTimerId_t timer[3];
+    uint32_t start;
+    uint32_t i;
+
+    timer[0] = osTimerNew(TimerCallback, osTimerOnce, (void *)0, &attr[0]);
+    timer[1] = osTimerNew(TimerCallback, osTimerPeriodic, (void *)1, &attr[1]);
+    timer[2] = osTimerNew(TimerCallback, osTimerPeriodic, (void *)2, &attr[2]);
+    CHECK(timer[0] != NULL && timer[1] != NULL && timer[2] != NULL);
+
+    // 1. 单次：正好在第 5 拍执行一次
+    start = g_SystemTickCount;
+    CHECK(osTimerStart(timer[0], 5) == osOK);
+    TimerSettle();
+    Step(4);
+    CHECK(g_Fires[0] == 0);
+    Step(1);
+    CHECK(g_Fires[0] == 1 && g_FiredAt[0][0] == start + 5u);
+    CHECK(!osTimerIsRunning(timer[0]));
+    Step(10);
+    CHECK(g_Fires[0] == 1);
+
+    // 2. 周期：每 3 拍一次，不漂移；停止后不再执行
+    start = g_SystemTickCount;
+    CHECK(osTimerStart(timer[1], 3) == osOK);
+    TimerSettle();
+    Step(9);
+    CHECK(g_Fires[1] == 3);
+    for (i = 0; i < 3; i++)
+        CHECK(g_FiredAt[1][i] == start + 3u * (i + 1u));
+    CHECK(osTimerStop(timer[1]) == osOK);
+    CHECK(osTimerStop(timer[1]) == osErrorResource);
+    Step(6);
+    CHECK(g_Fires[1] == 3);
+
+    // 3. 删除链表中间的定时器，覆盖它的控制块，另外两个照常执行
+    g_Fires[0] = g_Fires[1] = g_Fires[2] = 0;
+    CHECK(osTimerStart(timer[0], 4) == osOK);
+    CHECK(osTimerStart(timer[1], 2) == osOK);
+    CHECK(osTimerStart(timer[2], 2) == osOK);
+    TimerSettle();
+    CHECK(osTimerDelete(timer[1]) == osOK);
+    CHECK(!TimerLinked(&g_TimerCb[1]));
+    CHECK(TimerLinked(&g_TimerCb[0]) && TimerLinked(&g_TimerCb[2]));
+    memset(&g_TimerCb[1], 0xA5, sizeof(g_TimerCb[1]));
+    Step(8);
+    CHECK(g_Fires[0] == 1);
+    CHECK(g_Fires[1] == 0);
+    CHECK(g_Fires[2] == 4);
+    CHECK(osTimerDelete(timer[1]) == osErrorParameter); // 已经删除
+
+    // 4. 中断里不能删除；删除正在运行的定时器
+    HostIsrEnter();
+    CHECK(osTimerDelete(timer[2]) == osErrorISR);
+    HostIsrExit();
+    CHECK(osTimerDelete(timer[2]) == osOK);
+    CHECK(osTimerDelete(timer[0]) == osOK);
+    CHECK(TimerListHead == NULL);
+    Step(4);
+    CHECK(g_Fires[2] == 4);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    osThreadAttr_t app_attr = {"app", 0, &g_AppCb, sizeof(g_AppCb), g_AppStack, sizeof(g_AppStack),
+                               osPriorityNormal, 0, 0};
+    pthread_t tick;
+    pthread_t timer;
+
+    OS_TaskCreate(&g_IdleTcb, NULL, g_IdleStack, 16);
+    g_App = osThreadNew(NULL, NULL, &app_attr);
+    CHECK(g_App == NULL); // 没有线程函数
+    g_App = osThreadNew(AppMain, NULL, &app_attr);
+    CHECK(g_App == (osThreadId_t)&g_AppCb);
+    HostTaskBind(&g_AppCb.Tcb);
+    g_OSRunning = 1;
+
+    // 1. 等待和超时：主线程是 app 线程，节拍线程一直在打
+    pthread_create(&tick, NULL, TickThread, NULL);
+    g_Ticking = 1;
+    TestSemaphore();
+    TestMessageQueue();
+    TestMutex();
+    TestFlags();
+    TestThread();
+    TickPause();
+
+    // 2. 定时器：另一个线程跑定时器线程，主线程打节拍
+    ThreadInit(&TimerThread, TimerTask, NULL, "Timer", TimerTaskStack, sizeof(TimerTaskStack),
+               osPriorityNormal);
+    pthread_create(&timer, NULL, TimerThreadMain, NULL);
+    TimerSettle();
+    TestTimers();
+
+    g_Stop = 1;
+    pthread_join(tick, NULL);
+
+    printf("rtos2_test: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
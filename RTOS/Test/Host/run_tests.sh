@@ -0,0 +1,135 @@
+#!/usr/bin/env bash
+#
+# Build and run the RTOS host tests on Linux with gcc and pthreads.
+#
+# The kernel and service sources are compiled unchanged against port/os_cpu.h,
+# which maps the critical section to a global lock and LDREX/STREX to a model
+# of the single-core exclusive monitor built on GCC __atomic builtins.
+#
+# Exit status is non-zero if any test fails. Benchmarks print CSV lines that are
+# kept in <out>/<test>.log.
+#
+# See HowTo.txt.
+
+set -euo pipefail
+
+usage()
+{
+    cat <<EOF
+usage: $0 [options] [test...]
+  -o DIR         build/output directory (default: build)
+  -l             list the tests and exit
+EOF
+    exit 2
+}
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+ROOT="$(cd "$HERE/../../.." && pwd)"
+OUT=
+LIST=0
+
+while getopts "o:lh" opt; do
+    case "$opt" in
+        o) OUT="$OPTARG" ;;
+        l) LIST=1 ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+CC="${CC:-gcc}"
+CFLAGS="-O2 -g -std=gnu99 -Wall -Wextra -Wno-unused-parameter -pthread"
+INCS="-I$HERE/port -I$ROOT/RTOS/Inc"
+
+# NN runner tests: CMSIS-NN built natively (Cortex-M3 C paths) against the
+# core_cm3.h stand-in of the DSP suite runner; the profile clock is the host clock
+NN_FLAGS="-I$ROOT/RTOS/Services -isystem $ROOT/Drivers/CMSIS/DSP/DSP_Lib_TestSuite/DspLibTest_Linux/platform/host \
+-isystem $ROOT/Drivers/CMSIS/DSP/Include -isystem $ROOT/Drivers/CMSIS/NN/Include \
+-isystem $ROOT/Drivers/CMSIS/NN/Examples/ARM/arm_nn_examples/cifar10 \
+-DARM_MATH_CM3 -DOS_NN_PROFILE_CLOCK()=((uint32_t)OS_TimeNowCycles())"
+NN_SRCS="RTOS/Test/Host/nn_cifar10.c RTOS/Services/os_nn.c RTOS/Src/os_core.c Drivers/CMSIS/NN/Source/*/*.c"
+NN_GRU_SRCS="Drivers/CMSIS/DSP/Source/BasicMathFunctions/arm_mult_q15.c \
+Drivers/CMSIS/DSP/Source/BasicMathFunctions/arm_offset_q15.c Drivers/CMSIS/DSP/Source/BasicMathFunctions/arm_sub_q15.c"
+# Kalman test: the DSP matrix, basic math and conversion functions, same CMSIS headers
+KALMAN_SRCS="RTOS/Test/Host/kalman_compare.c RTOS/Services/os_kalman.c RTOS/Src/os_core.c \
+Drivers/CMSIS/DSP/Source/MatrixFunctions/*.c Drivers/CMSIS/DSP/Source/BasicMathFunctions/*.c \
+Drivers/CMSIS/DSP/Source/SupportFunctions/*.c"
+# Spectrum and SDF tests: the DSP FFT and everything it needs, with the suite
+# runner's C version of arm_bitreversal2.S; the SDF test adds the filters its nodes wrap
+FFT_DSP_SRCS="Drivers/CMSIS/DSP/Source/TransformFunctions/*.c Drivers/CMSIS/DSP/Source/CommonTables/*.c \
+Drivers/CMSIS/DSP/Source/BasicMathFunctions/*.c Drivers/CMSIS/DSP/Source/ComplexMathFunctions/*.c \
+Drivers/CMSIS/DSP/Source/FastMathFunctions/*.c Drivers/CMSIS/DSP/Source/SupportFunctions/*.c \
+Drivers/CMSIS/DSP/DSP_Lib_TestSuite/DspLibTest_Linux/platform/host/arm_bitreversal2_host.c"
+SPECTRUM_SRCS="RTOS/Test/Host/spectrum_compare.c RTOS/Services/os_spectrum.c RTOS/Src/os_ringbuf.c RTOS/Src/os_core.c \
+$FFT_DSP_SRCS"
+SDF_SRCS="RTOS/Test/Host/sdf_test.c RTOS/Services/os_sdf.c RTOS/Src/os_core.c $FFT_DSP_SRCS \
+Drivers/CMSIS/DSP/Source/FilteringFunctions/arm_fir_decimate_q15.c \
+Drivers/CMSIS/DSP/Source/FilteringFunctions/arm_fir_decimate_init_q15.c \
+Drivers/CMSIS/DSP/Source/FilteringFunctions/arm_biquad_cascade_df1_q15.c \
+Drivers/CMSIS/DSP/Source/FilteringFunctions/arm_biquad_cascade_df1_init_q15.c"
+GRU_FLAGS="$NN_FLAGS -isystem $ROOT/Drivers/CMSIS/NN/Examples/ARM/arm_nn_examples/gru"
+GRU_SRCS="RTOS/Test/Host/gru_compare.c RTOS/Services/os_gru.c RTOS/Src/os_core.c Drivers/CMSIS/NN/Source/*/*.c $NN_GRU_SRCS"
+
+# name|flags|sources (relative to the repository root, may be globs)|arguments
+TESTS=(
+    "sem_bench_fast|-DOS_CFG_SEM_FAST_PATH=1|RTOS/Test/Host/sem_bench.c RTOS/Src/os_core.c|1000000"
+    "sem_bench_critical|-DOS_CFG_SEM_FAST_PATH=0|RTOS/Test/Host/sem_bench.c RTOS/Src/os_core.c|1000000"
+    "sem_bench_fast_preempt|-DOS_CFG_SEM_FAST_PATH=1|RTOS/Test/Host/sem_bench.c RTOS/Src/os_core.c|200000 7"
+    "mpmc_stress||RTOS/Test/Host/mpmc_stress.c RTOS/Src/os_mpmc.c RTOS/Src/os_core.c|50000 8 5"
+    "mpmc_bench||RTOS/Test/Host/mpmc_stress.c RTOS/Src/os_mpmc.c RTOS/Src/os_core.c|1000000 0 0"
+    "uart_loopback|-DOS_CFG_DEBUG_CHECKS=1 -I$HERE/hal -I$ROOT/RTOS/Drivers|RTOS/Test/Host/uart_loopback.c RTOS/Drivers/os_uart.c RTOS/Src/os_ringbuf.c RTOS/Src/os_core.c|"
+    "delay_until|-isystem $ROOT/Drivers/CMSIS/RTOS2/Include|RTOS/Test/Host/delay_until.c RTOS/Src/os_time.c RTOS/Src/os_core.c|"
+    "rtos2_test|-isystem $ROOT/Drivers/CMSIS/RTOS2/Include|RTOS/Test/Host/rtos2_test.c RTOS/Src/os_mpmc.c RTOS/Src/os_core.c|"
+    "nn_compare|$NN_FLAGS|RTOS/Test/Host/nn_compare.c $NN_SRCS|100"
+    "nn_compare_dsp|$NN_FLAGS -include $HERE/port/arm_math_dsp.h|RTOS/Test/Host/nn_compare.c $NN_SRCS|100"
+    "gru_compare|$GRU_FLAGS|$GRU_SRCS|200"
+    "gru_compare_dsp|$GRU_FLAGS -include $HERE/port/arm_math_dsp.h|$GRU_SRCS|200"
+    "kalman_compare|$NN_FLAGS|$KALMAN_SRCS|"
+    "spectrum_compare|$NN_FLAGS|$SPECTRUM_SRCS|"
+    "sdf_test|$NN_FLAGS|$SDF_SRCS|"
+    "nn_profile|$GRU_FLAGS|RTOS/Test/Host/nn_profile.c $NN_SRCS $NN_GRU_SRCS|20"
+)
+
+if [ "$LIST" = 1 ]; then
+    for t in "${TESTS[@]}"; do echo "${t%%|*}"; done
+    exit 0
+fi
+
+command -v "$CC" >/dev/null || { echo "error: $CC not found" >&2; exit 2; }
+
+OUT="${OUT:-$HERE/build}"
+mkdir -p "$OUT"
+
+pass=0
+fail=0
+for t in "${TESTS[@]}"; do
+    IFS='|' read -r name flags srcs args <<< "$t"
+    if [ $# -gt 0 ]; then
+        case " $* " in *" $name "*) ;; *) continue ;; esac
+    fi
+
+    files="$HERE/port/os_cpu.c"
+    for s in $srcs; do files="$files $ROOT/$s"; done
+
+    # shellcheck disable=SC2086
+    if ! $CC $CFLAGS $INCS $flags $files -lm -o "$OUT/$name" 2> "$OUT/$name.build.log"; then
+        cat "$OUT/$name.build.log"
+        echo "FAIL   $name (build)"
+        fail=$((fail + 1))
+        continue
+    fi
+    [ -s "$OUT/$name.build.log" ] && cat "$OUT/$name.build.log"
+
+    # shellcheck disable=SC2086
+    if timeout 300 "$OUT/$name" $args > "$OUT/$name.log" 2>&1; then
+        echo "PASS   $name"
+        pass=$((pass + 1))
+    else
+        echo "FAIL   $name"
+        fail=$((fail + 1))
+    fi
+    sed 's/^/       /' "$OUT/$name.log"
+done
+
+echo "$((pass + fail)) tests: $pass passed, $fail failed"
+[ "$fail" = 0 ] && [ "$((pass + fail))" -gt 0 ]
@@ -0,0 +1,497 @@
+/**
+ ******************************************************************************
+ * @file    sdf_test.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   SDF 图运行时的测试 (Linux 主机)
+ *
+ * 被测的图：源 -> FIR 抽取 -> 双二阶 -> rfft -> 求模 -> 汇，节点表故意打乱顺序。
+ * - 重复向量必须是最小正整数解 [8, 6, 4, 3, 3, 6]，每条边满足平衡方程，
+ *   PeriodBytes 是一个周期流过的字节数，Order 是拓扑序
+ * - 有环、速率不一致、不连通、缓冲区不够一个周期、没有节点的图被拒绝；
+ *   速率一致的菱形图被接受
+ * - 汇收到的数据和参考逐位相同：参考用另一组 CMSIS-DSP 实例，
+ *   按同样的块长对整条输入线性地处理
+ * - 跑法：整张图一级；分两级在一个线程里交替运行（双缓冲和单缓冲），
+ *   每次之后检查 Full/Empty 计数和读写份号；分两级由两个线程运行，
+ *   级 1 的任务真的阻塞在 Full 上、被级 0 唤醒
+ * - 单独一级在中断里或调度器上锁时返回 0，什么也不做
+ *
+ * 输出：run,periods,slots,blocked
+ *
+ ******************************************************************************
+ */
+
+#include "os_sdf.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define SRC_BLOCK   48u                  // 源每次产生的样点数
+#define FIR_BLOCK   64u
+#define FIR_M       4u
+#define FIR_TAPS    16u
+#define BIQ_BLOCK   24u
+#define FFT_LEN     32u
+#define SINK_BLOCK  16u
+
+#define PERIOD_IN   (8u * SRC_BLOCK)     // 每个周期源产生的样点数
+#define PERIOD_OUT  (6u * SINK_BLOCK)    // 每个周期汇收到的样点数
+#define PERIODS     40u
+
+#define NUM_NODES   6u
+#define NUM_EDGES   5u
+#define CROSS_EDGE  2u                   // 双二阶 -> rfft，两级之间的边
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  源和汇节点的实例：线性样点记录和当前位置
+ */
+typedef struct
+{
+    q15_t *Data;
+    uint32_t Pos;
+} StreamNode;
+
+/**
+ * @brief  被测的链：节点、边、实例和状态
+ */
+typedef struct
+{
+    OS_SdfNode Src, Fir, Biq, Rfft, Mag, Sink;
+    OS_SdfEdge Edge[NUM_EDGES];
+    OS_SdfNode *Nodes[NUM_NODES];
+    OS_SdfEdge *Edges[NUM_EDGES];
+    OS_SdfGraph Graph;
+    StreamNode In, Out;
+    arm_fir_decimate_instance_q15 FirInst;
+    arm_biquad_casd_df1_inst_q15 BiqInst;
+    arm_rfft_instance_q15 RfftInst;
+    q15_t FirState[FIR_TAPS + FIR_BLOCK - 1u];
+    q15_t BiqState[4];
+} Chain;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Seed = 0x5d1f00du;
+static volatile uint32_t g_Errors = 0;
+
+static q15_t g_FirCoeffs[FIR_TAPS];
+static q15_t g_BiqCoeffs[6] = {3277, 0, 6554, 3277, 9830, -3277}; // b0 0 b1 b2 a1 a2，postShift 1
+
+// 输入和输出多留一个周期，给分级的图最后再整张跑一次
+static q15_t g_Input[(PERIODS + 1u) * PERIOD_IN];
+static q15_t g_Expect[PERIODS * PERIOD_OUT];
+static q15_t g_Output[(PERIODS + 1u) * PERIOD_OUT];
+
+// 每条边两个周期的缓冲，依次是 源->FIR、FIR->双二阶、双二阶->rfft、rfft->求模、求模->汇
+static q15_t g_Buf0[2u * PERIOD_IN];
+static q15_t g_Buf1[2u * PERIOD_IN / FIR_M];
+static q15_t g_Buf2[2u * PERIOD_IN / FIR_M];
+static q15_t g_Buf3[4u * PERIOD_IN / FIR_M];
+static q15_t g_Buf4[2u * PERIOD_OUT];
+
+static Chain g_Chain;
+
+static OS_TCB g_TaskTcb;
+static OS_TCB g_IdleTcb;
+static uint32_t g_DummyStack[2][16];
+static volatile uint32_t g_Blocked = 0; // 级 0 交出数据前看到级 1 正在阻塞的次数
+
+/* 主机桩 ------------------------------------------------------------- */
+
+uint64_t OS_TimeNowCycles(void)
+{
+    return 0;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t Rand(void)
+{
+    g_Seed ^= g_Seed << 13;
+    g_Seed ^= g_Seed >> 17;
+    g_Seed ^= g_Seed << 5;
+    return g_Seed;
+}
+
+static void FireSource(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    StreamNode *s = (StreamNode *)node->Instance;
+
+    memcpy(out[0], &s->Data[s->Pos], node->Produce[0] * sizeof(q15_t));
+    s->Pos += node->Produce[0];
+}
+
+static void FireSink(OS_SdfNode *node, void *const *in, void *const *out)
+{
+    StreamNode *s = (StreamNode *)node->Instance;
+
+    memcpy(&s->Data[s->Pos], in[0], node->Consume[0] * sizeof(q15_t));
+    s->Pos += node->Consume[0];
+}
+
+// 测拒绝用的节点，不会被点火
+static void FireNothing(OS_SdfNode *node, void *const *in, void *const *out)
+{
+}
+
+/**
+ * @brief  参考：另一组实例，按同样的块长线性处理整条输入
+ */
+static void Reference(void)
+{
+    static arm_fir_decimate_instance_q15 fir;
+    static arm_biquad_casd_df1_inst_q15 biq;
+    static arm_rfft_instance_q15 rfft;
+    static q15_t fir_state[FIR_TAPS + FIR_BLOCK - 1u];
+    static q15_t biq_state[4];
+    static q15_t dec[PERIOD_IN / FIR_M];
+    static q15_t filtered[PERIOD_IN / FIR_M];
+    static q15_t frame[FFT_LEN];
+    static q15_t spec[2u * FFT_LEN];
+    uint32_t p, i;
+
+    CHECK(arm_fir_decimate_init_q15(&fir, FIR_TAPS, FIR_M, g_FirCoeffs, fir_state, FIR_BLOCK) == ARM_MATH_SUCCESS);
+    arm_biquad_cascade_df1_init_q15(&biq, 1, g_BiqCoeffs, biq_state, 1);
+    CHECK(arm_rfft_init_q15(&rfft, FFT_LEN, 0, 1) == ARM_MATH_SUCCESS);
+
+    for (p = 0; p < PERIODS; p++)
+    {
+        for (i = 0; i < PERIOD_IN / FIR_BLOCK; i++)
+            arm_fir_decimate_q15(&fir, &g_Input[p * PERIOD_IN + i * FIR_BLOCK], &dec[i * FIR_BLOCK / FIR_M], FIR_BLOCK);
+        for (i = 0; i < PERIOD_IN / FIR_M / BIQ_BLOCK; i++)
+            arm_biquad_cascade_df1_q15(&biq, &dec[i * BIQ_BLOCK], &filtered[i * BIQ_BLOCK], BIQ_BLOCK);
+        for (i = 0; i < PERIOD_IN / FIR_M / FFT_LEN; i++)
+        {
+            memcpy(frame, &filtered[i * FFT_LEN], sizeof(frame)); // arm_rfft_q15 会改写输入
+            arm_rfft_q15(&rfft, frame, spec);
+            arm_cmplx_mag_q15(spec, &g_Expect[p * PERIOD_OUT + i * FFT_LEN], FFT_LEN);
+        }
+    }
+}
+
+/**
+ * @brief  搭被测的链
+ * @param  two_stage  : 0 全部在级 0；1 源、FIR、双二阶在级 0，其余在级 1
+ * @param  cross_slots: 双二阶 -> rfft 那条边给几个周期的缓冲
+ */
+static uint8_t BuildChain(Chain *c, uint8_t two_stage, uint8_t cross_slots)
+{
+    uint8_t s1 = two_stage ? 1 : 0;
+    uint8_t i;
+
+    memset(c, 0, sizeof(*c));
+    c->In.Data = g_Input;
+    c->Out.Data = g_Output;
+    CHECK(arm_fir_decimate_init_q15(&c->FirInst, FIR_TAPS, FIR_M, g_FirCoeffs, c->FirState, FIR_BLOCK) == ARM_MATH_SUCCESS);
+    arm_biquad_cascade_df1_init_q15(&c->BiqInst, 1, g_BiqCoeffs, c->BiqState, 1);
+    CHECK(arm_rfft_init_q15(&c->RfftInst, FFT_LEN, 0, 1) == ARM_MATH_SUCCESS);
+
+    OS_SdfNodeInit(&c->Src, FireSource, &c->In, 0, 0);
+    c->Src.Produce[0] = SRC_BLOCK;
+    OS_SdfFirDecimateQ15Init(&c->Fir, &c->FirInst, FIR_BLOCK, 0);
+    OS_SdfBiquadDf1Q15Init(&c->Biq, &c->BiqInst, BIQ_BLOCK, 0);
+    OS_SdfRfftQ15Init(&c->Rfft, &c->RfftInst, s1);
+    OS_SdfCmplxMagQ15Init(&c->Mag, FFT_LEN, s1);
+    OS_SdfNodeInit(&c->Sink, FireSink, &c->Out, 0, s1);
+    c->Sink.Consume[0] = SINK_BLOCK;
+
+    OS_SdfConnect(&c->Edge[0], &c->Src, 0, &c->Fir, 0, g_Buf0, sizeof(g_Buf0), sizeof(q15_t));
+    OS_SdfConnect(&c->Edge[1], &c->Fir, 0, &c->Biq, 0, g_Buf1, sizeof(g_Buf1), sizeof(q15_t));
+    OS_SdfConnect(&c->Edge[CROSS_EDGE], &c->Biq, 0, &c->Rfft, 0, g_Buf2, cross_slots * sizeof(g_Buf2) / 2u, sizeof(q15_t));
+    OS_SdfConnect(&c->Edge[3], &c->Rfft, 0, &c->Mag, 0, g_Buf3, sizeof(g_Buf3), sizeof(q15_t));
+    OS_SdfConnect(&c->Edge[4], &c->Mag, 0, &c->Sink, 0, g_Buf4, sizeof(g_Buf4), sizeof(q15_t));
+
+    // 节点表打乱顺序，拓扑序不能靠表里的顺序碰巧成立
+    c->Nodes[0] = &c->Mag;
+    c->Nodes[1] = &c->Sink;
+    c->Nodes[2] = &c->Biq;
+    c->Nodes[3] = &c->Src;
+    c->Nodes[4] = &c->Rfft;
+    c->Nodes[5] = &c->Fir;
+    for (i = 0; i < NUM_EDGES; i++)
+        c->Edges[i] = &c->Edge[NUM_EDGES - 1u - i];
+
+    return OS_SdfGraphInit(&c->Graph, c->Nodes, NUM_NODES, c->Edges, NUM_EDGES);
+}
+
+/**
+ * @brief  检查重复向量、平衡方程、周期字节数和拓扑序
+ */
+static void CheckSchedule(Chain *c)
+{
+    uint8_t pos[NUM_NODES];
+    uint8_t i, s, t;
+    OS_SdfEdge *e;
+
+    CHECK(c->Src.Repetition == 8 && c->Fir.Repetition == 6 && c->Biq.Repetition == 4);
+    CHECK(c->Rfft.Repetition == 3 && c->Mag.Repetition == 3 && c->Sink.Repetition == 6);
+
+    for (i = 0; i < NUM_NODES; i++)
+        pos[c->Graph.Order[i]] = i;
+
+    for (i = 0; i < NUM_EDGES; i++)
+    {
+        e = &c->Edge[i];
+        CHECK(e->Src->Repetition * e->Src->Produce[e->SrcPort] == e->Dst->Repetition * e->Dst->Consume[e->DstPort]);
+        CHECK(e->PeriodBytes == e->Src->Repetition * e->Src->Produce[e->SrcPort] * sizeof(q15_t));
+        for (s = 0; c->Nodes[s] != e->Src; s++)
+            ;
+        for (t = 0; c->Nodes[t] != e->Dst; t++)
+            ;
+        CHECK(pos[s] < pos[t]);
+    }
+    CHECK(c->Edge[0].PeriodBytes == PERIOD_IN * sizeof(q15_t));
+    CHECK(c->Edge[4].PeriodBytes == PERIOD_OUT * sizeof(q15_t));
+}
+
+static void CheckOutput(const char *run, uint32_t periods)
+{
+    CHECK(g_Chain.In.Pos == periods * PERIOD_IN);
+    CHECK(g_Chain.Out.Pos == periods * PERIOD_OUT);
+    if (memcmp(g_Output, g_Expect, periods * PERIOD_OUT * sizeof(q15_t)) != 0)
+    {
+        printf("FAIL %s: sink output differs from the reference\n", run);
+        g_Errors++;
+    }
+}
+
+/**
+ * @brief  拒绝：有环、速率不一致、不连通、缓冲区不够；接受速率一致的菱形
+ */
+static void TestReject(void)
+{
+    static q15_t buf[4][8];
+    OS_SdfNode n[4];
+    OS_SdfEdge e[4];
+    OS_SdfNode *nodes[4] = {&n[0], &n[1], &n[2], &n[3]};
+    OS_SdfEdge *edges[4] = {&e[0], &e[1], &e[2], &e[3]};
+    OS_SdfGraph g;
+    uint8_t i;
+
+#define RESET_NODES()                                                         \
+    for (i = 0; i < 4; i++)                                                   \
+        OS_SdfNodeInit(&n[i], FireNothing, NULL, 0, 0)
+
+    // 1. 没有节点
+    CHECK(!OS_SdfGraphInit(&g, nodes, 0, edges, 0));
+
+    // 2. 有环：0 -> 1 -> 2 -> 1，速率一致，只能靠拓扑排序发现
+    RESET_NODES();
+    n[0].Produce[0] = 1;
+    n[1].Consume[0] = 1; n[1].Consume[1] = 1; n[1].Produce[0] = 1;
+    n[2].Consume[0] = 1; n[2].Produce[0] = 1;
+    OS_SdfConnect(&e[0], &n[0], 0, &n[1], 0, buf[0], sizeof(buf[0]), sizeof(q15_t));
+    OS_SdfConnect(&e[1], &n[1], 0, &n[2], 0, buf[1], sizeof(buf[1]), sizeof(q15_t));
+    OS_SdfConnect(&e[2], &n[2], 0, &n[1], 1, buf[2], sizeof(buf[2]), sizeof(q15_t));
+    CHECK(!OS_SdfGraphInit(&g, nodes, 3, edges, 3));
+
+    // 3. 菱形：0 分两路到 3，一路经过 1；速率一致时接受，1 产生 2 个时拒绝
+    RESET_NODES();
+    n[0].Produce[0] = 2; n[0].Produce[1] = 1;
+    n[1].Consume[0] = 1; n[1].Produce[0] = 1;
+    n[3].Consume[0] = 2; n[3].Consume[1] = 1;
+    OS_SdfConnect(&e[0], &n[0], 0, &n[3], 0, buf[0], sizeof(buf[0]), sizeof(q15_t));
+    OS_SdfConnect(&e[1], &n[0], 1, &n[1], 0, buf[1], sizeof(buf[1]), sizeof(q15_t));
+    OS_SdfConnect(&e[2], &n[1], 0, &n[3], 1, buf[2], sizeof(buf[2]), sizeof(q15_t));
+    nodes[2] = &n[3];
+    CHECK(OS_SdfGraphInit(&g, nodes, 3, edges, 3));
+    CHECK(n[0].Repetition == 1 && n[1].Repetition == 1 && n[3].Repetition == 1);
+    n[1].Produce[0] = 2;
+    CHECK(!OS_SdfGraphInit(&g, nodes, 3, edges, 3));
+    nodes[2] = &n[2];
+
+    // 4. 不连通：0 -> 1 和 2 -> 3
+    RESET_NODES();
+    n[0].Produce[0] = 1; n[1].Consume[0] = 1;
+    n[2].Produce[0] = 1; n[3].Consume[0] = 1;
+    OS_SdfConnect(&e[0], &n[0], 0, &n[1], 0, buf[0], sizeof(buf[0]), sizeof(q15_t));
+    OS_SdfConnect(&e[1], &n[2], 0, &n[3], 0, buf[1], sizeof(buf[1]), sizeof(q15_t));
+    CHECK(!OS_SdfGraphInit(&g, nodes, 4, edges, 2));
+
+    // 5. 0 -> 1，速率 3 : 2，一个周期 6 个样点；少一个样点的缓冲被拒绝
+    RESET_NODES();
+    n[0].Produce[0] = 3; n[1].Consume[0] = 2;
+    OS_SdfConnect(&e[0], &n[0], 0, &n[1], 0, buf[0], 6u * sizeof(q15_t), sizeof(q15_t));
+    CHECK(OS_SdfGraphInit(&g, nodes, 2, edges, 1));
+    CHECK(n[0].Repetition == 2 && n[1].Repetition == 3 && e[0].PeriodBytes == 6u * sizeof(q15_t));
+    e[0].Capacity = 5u * sizeof(q15_t);
+    CHECK(!OS_SdfGraphInit(&g, nodes, 2, edges, 1));
+
+#undef RESET_NODES
+}
+
+/**
+ * @brief  整张图在一级里跑
+ */
+static void TestOneStage(void)
+{
+    uint32_t p;
+    uint8_t i;
+
+    memset(g_Output, 0, sizeof(g_Output));
+    CHECK(BuildChain(&g_Chain, 0, 2));
+    CheckSchedule(&g_Chain);
+    for (i = 0; i < NUM_EDGES; i++)
+        CHECK(!g_Chain.Edge[i].CrossStage && g_Chain.Edge[i].Slots == 1);
+
+    for (p = 0; p < PERIODS; p++)
+        CHECK(OS_SdfRunStage(&g_Chain.Graph, OS_SDF_ALL_STAGES));
+    CheckOutput("one stage", PERIODS);
+    printf("one_stage,%u,1,0\n", PERIODS);
+}
+
+/**
+ * @brief  两级在一个线程里按随机顺序交替运行，手里的份数不超过 Slots
+ */
+static void TestTwoStagesInterleaved(uint8_t slots)
+{
+    OS_SdfEdge *x = &g_Chain.Edge[CROSS_EDGE];
+    uint32_t produced = 0;
+    uint32_t consumed = 0;
+    uint8_t i;
+
+    memset(g_Output, 0, sizeof(g_Output));
+    CHECK(BuildChain(&g_Chain, 1, slots));
+    CheckSchedule(&g_Chain);
+    for (i = 0; i < NUM_EDGES; i++)
+        CHECK(g_Chain.Edge[i].CrossStage == (i == CROSS_EDGE));
+    CHECK(x->Slots == slots && x->Full.count == 0 && x->Empty.count == slots);
+
+    // 1. 单独一级在中断里或调度器上锁时不能阻塞，直接返回 0，什么也不做
+    HostIsrEnter();
+    CHECK(!OS_SdfRunStage(&g_Chain.Graph, 0));
+    HostIsrExit();
+    OS_SchedLock();
+    CHECK(!OS_SdfRunStage(&g_Chain.Graph, 0));
+    CHECK(!OS_SdfRunStage(&g_Chain.Graph, 1));
+    OS_SchedUnlock();
+    CHECK(g_Chain.In.Pos == 0 && x->Full.count == 0 && x->Empty.count == slots);
+
+    // 2. 交替运行：没有写满的份时跑级 0，份都写满时跑级 1，否则随机
+    while (consumed < PERIODS)
+    {
+        uint32_t held = produced - consumed;
+
+        if (produced < PERIODS && (held == 0 || (held < slots && (Rand() & 1u))))
+        {
+            CHECK(OS_SdfRunStage(&g_Chain.Graph, 0));
+            produced++;
+        }
+        else
+        {
+            CHECK(OS_SdfRunStage(&g_Chain.Graph, 1));
+            consumed++;
+        }
+        CHECK(x->Full.count == produced - consumed);
+        CHECK(x->Empty.count == slots - (produced - consumed));
+        CHECK(x->WriteSlot == produced % slots && x->ReadSlot == consumed % slots);
+        CHECK(g_Chain.Out.Pos == consumed * PERIOD_OUT);
+    }
+    CheckOutput(slots == 2 ? "two stages, double buffer" : "two stages, single buffer", PERIODS);
+
+    // 3. 分了级的图也能在一个任务里整张跑，跨级的边照样轮换份号
+    CHECK(OS_SdfRunStage(&g_Chain.Graph, OS_SDF_ALL_STAGES));
+    CHECK(x->Full.count == 0 && x->Empty.count == slots);
+    CHECK(x->WriteSlot == (PERIODS + 1u) % slots && x->ReadSlot == x->WriteSlot);
+
+    printf("interleaved,%u,%u,0\n", PERIODS, slots);
+}
+
+// 级 0 的任务：只在有空份时运行，所以不会阻塞（主机移植只有一个任务线程能阻塞）
+static void *Stage0Thread(void *arg)
+{
+    struct timespec nap = {0, 20000};
+    OS_SdfEdge *x = &g_Chain.Edge[CROSS_EDGE];
+    uint32_t p;
+
+    (void)arg;
+    for (p = 0; p < PERIODS; p++)
+    {
+        while (__atomic_load_n(&x->Empty.count, __ATOMIC_ACQUIRE) == 0)
+            sched_yield();
+
+        // 让级 1 先把手上的份读完、阻塞在 Full 上
+        nanosleep(&nap, NULL);
+        if (__atomic_load_n(&g_TaskTcb.State, __ATOMIC_ACQUIRE) == TASK_BLOCKED)
+            __atomic_fetch_add(&g_Blocked, 1u, __ATOMIC_RELAXED);
+
+        if (!OS_SdfRunStage(&g_Chain.Graph, 0))
+        {
+            printf("FAIL stage 0 period %u\n", p);
+            __atomic_fetch_add(&g_Errors, 1u, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  两级由两个线程运行：主线程扮演级 1 的任务，阻塞在 Full 上等级 0
+ */
+static void TestTwoStagesThreaded(void)
+{
+    OS_SdfEdge *x = &g_Chain.Edge[CROSS_EDGE];
+    pthread_t stage0;
+    uint32_t p;
+
+    memset(g_Output, 0, sizeof(g_Output));
+    CHECK(BuildChain(&g_Chain, 1, 2));
+
+    OS_TaskCreate(&g_IdleTcb, NULL, g_DummyStack[0], 16);
+    OS_TaskCreate(&g_TaskTcb, NULL, g_DummyStack[1], 16);
+    HostTaskBind(&g_TaskTcb);
+    g_OSRunning = 1;
+
+    pthread_create(&stage0, NULL, Stage0Thread, NULL);
+    for (p = 0; p < PERIODS; p++)
+        CHECK(OS_SdfRunStage(&g_Chain.Graph, 1));
+    pthread_join(stage0, NULL);
+
+    CheckOutput("two stages, threaded", PERIODS);
+    CHECK(x->Full.count == 0 && x->Empty.count == 2);
+    CHECK(x->Full.WaitListHead == NULL && x->Empty.WaitListHead == NULL);
+    CHECK(g_Blocked > 0);
+
+    printf("threaded,%u,2,%u\n", PERIODS, g_Blocked);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    uint32_t i;
+
+    // 1. 低通 FIR 系数、随机输入、参考输出
+    for (i = 0; i < FIR_TAPS; i++)
+        g_FirCoeffs[i] = (q15_t)((i + 1u) * (FIR_TAPS - i) * 40u);
+    for (i = 0; i < (PERIODS + 1u) * PERIOD_IN; i++)
+        g_Input[i] = (q15_t)((int16_t)(Rand() >> 16) / 2);
+    Reference();
+
+    // 2. 各项测试
+    printf("run,periods,slots,blocked\n");
+    TestReject();
+    TestOneStage();
+    TestTwoStagesInterleaved(2);
+    TestTwoStagesInterleaved(1);
+    TestTwoStagesThreaded();
+
+    printf("sdf_test: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
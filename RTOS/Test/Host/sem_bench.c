@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file    sem_bench.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   信号量快速路径与临界区路径的争用对比 (Linux 主机)
+ *
+ * 同一份 os_core.c 编两次：OS_CFG_SEM_FAST_PATH=1（LDREX/STREX）和 =0（临界区），
+ * 1/2/4 个线程同时对同一个信号量反复 Post + WaitTimeout(0)。
+ * 每个线程先 Post 再 Wait，所以每次 Wait 都必须成功，结束时 count 必须回到 0，
+ * 任何一次丢失的更新都会被发现。
+ *
+ * 输出一行一个配置：
+ *   path,threads,pairs,ns_per_pair,strex_fail,lock_spin
+ * path 为 fast 或 critical；strex_fail 是 STREX 失败（重试）次数，
+ * lock_spin 是进临界区时等锁的次数。
+ *
+ * 用法：sem_bench [每线程次数] [每隔多少次 STREX 让出一次 CPU]
+ *
+ ******************************************************************************
+ */
+
+#include "os_core.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static OS_Sem g_Sem;
+static uint32_t g_Pairs = 1000000u;
+static volatile uint32_t g_WaitFail = 0;
+static volatile uint32_t g_Go = 0;
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void *Worker(void *arg)
+{
+    uint32_t i;
+    uint32_t fail = 0;
+
+    (void)arg;
+    while (!__atomic_load_n(&g_Go, __ATOMIC_ACQUIRE))
+        sched_yield();
+
+    for (i = 0; i < g_Pairs; i++)
+    {
+        OS_SemPost(&g_Sem);
+        if (!OS_SemWaitTimeout(&g_Sem, 0))
+            fail++;
+    }
+
+    __atomic_fetch_add(&g_WaitFail, fail, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static int Run(uint32_t threads)
+{
+    pthread_t tid[4];
+    uint64_t t0;
+    uint64_t t1;
+    uint32_t i;
+
+    g_Sem.count = 0;
+    g_Sem.WaitListHead = NULL;
+    g_Sem.WaitListTail = NULL;
+    g_WaitFail = 0;
+    g_HostStrexFail = 0;
+    g_HostCriticalSpin = 0;
+    g_Go = 0;
+
+    for (i = 0; i < threads; i++)
+        pthread_create(&tid[i], NULL, Worker, NULL);
+
+    t0 = NowNs();
+    __atomic_store_n(&g_Go, 1u, __ATOMIC_RELEASE);
+    for (i = 0; i < threads; i++)
+        pthread_join(tid[i], NULL);
+    t1 = NowNs();
+
+    printf("%s,%u,%u,%.1f,%u,%u\n", OS_CFG_SEM_FAST_PATH ? "fast" : "critical", threads, g_Pairs,
+           (double)(t1 - t0) / ((double)g_Pairs * threads), g_HostStrexFail, g_HostCriticalSpin);
+
+    if (g_WaitFail != 0 || g_Sem.count != 0)
+    {
+        fprintf(stderr, "sem_bench: %u threads: %u waits failed, final count %u\n",
+                threads, g_WaitFail, g_Sem.count);
+        return 1;
+    }
+    return 0;
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    int err = 0;
+
+    if (argc > 1)
+        g_Pairs = (uint32_t)strtoul(argv[1], NULL, 0);
+    if (argc > 2)
+        g_HostPreemptEvery = (uint32_t)strtoul(argv[2], NULL, 0);
+
+    err |= Run(1);
+    err |= Run(2);
+    err |= Run(4);
+
+    return err;
+}
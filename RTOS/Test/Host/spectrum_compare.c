@@ -0,0 +1,252 @@
+/**
+ ******************************************************************************
+ * @file    spectrum_compare.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   频谱分析服务与“拷贝 N 个样点、乘窗、rfft”参考实现的逐帧对比 (Linux 主机)
+ *
+ * - 样点按随机长度的小块写进 OS_SpectrumWrite，每写一次调一次 OS_SpectrumProcess；
+ *   同样的样点同时记在一条线性记录里
+ * - 第 k 帧（从 1 数）的参考：线性记录里 [k * Hop - N, k * Hop) 这 N 个样点
+ *   （负下标为 0，对应初始化时清零的历史区），乘窗，用另一个 FFT 实例做 rfft，
+ *   再按服务的方式取幅度。乘窗是逐点的，所以发布的幅度谱必须逐位相同
+ * - 帧移覆盖 Hop < Overlap、Hop == Overlap、Hop > Overlap 和 Overlap == 0；
+ *   Hop 个样点的字节数不整除队列大小时，帧的新样点会跨过环形缓冲区的绕回处，
+ *   这种帧每个配置都要出现过
+ * - float32 和 q15 各跑一遍；发布回调和 OS_SpectrumRead 都要和参考一致
+ *
+ * 输出：format,fft_len,hop,frames,wrapped
+ *
+ ******************************************************************************
+ */
+
+#include "os_spectrum.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define FFT_LEN   64u
+#define FRAMES    200u
+#define MAX_HOP   FFT_LEN
+#define RECORD    (FRAMES * MAX_HOP + 2u * MAX_HOP)
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 数据结构定义 -------------------------------------------------------- */
+
+/**
+ * @brief  参考实现：线性样点记录、窗和自己的 FFT 实例
+ */
+typedef struct
+{
+    uint8_t Format;
+    uint8_t SampleSize;
+    uint16_t Hop;
+    const void *Window;
+    const uint8_t *Record;     // 写进服务的全部样点，按写入顺序
+    union
+    {
+        arm_rfft_fast_instance_f32 F32;
+        arm_rfft_instance_q15 Q15;
+    } Fft;
+    uint32_t Checked;          // 回调里比较过的帧数
+} RefSpectrum;
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static uint32_t g_Seed = 0x2468aceu;
+static uint32_t g_Errors = 0;
+
+/* 主机桩 ------------------------------------------------------------- */
+
+uint64_t OS_TimeNowCycles(void)
+{
+    return 0;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static uint32_t Rand(void)
+{
+    g_Seed ^= g_Seed << 13;
+    g_Seed ^= g_Seed >> 17;
+    g_Seed ^= g_Seed << 5;
+    return g_Seed;
+}
+
+/**
+ * @brief  第 frame 帧的参考幅度谱
+ */
+static void RefFrame(RefSpectrum *p_ref, uint32_t frame, void *magnitude)
+{
+    static uint8_t buf[FFT_LEN * sizeof(float32_t)];
+    static uint8_t windowed[FFT_LEN * sizeof(float32_t)];
+    static uint8_t spec[2u * FFT_LEN * sizeof(float32_t)];
+    uint8_t ss = p_ref->SampleSize;
+    int32_t first = (int32_t)(frame * p_ref->Hop) - (int32_t)FFT_LEN;
+    uint32_t half = FFT_LEN / 2u;
+    uint32_t i;
+
+    // 1. 拷贝 N 个样点，第一帧之前的部分是 0
+    for (i = 0; i < FFT_LEN; i++)
+    {
+        if (first + (int32_t)i < 0)
+            memset(buf + i * ss, 0, ss);
+        else
+            memcpy(buf + i * ss, p_ref->Record + (uint32_t)(first + (int32_t)i) * ss, ss);
+    }
+
+    // 2. 乘窗、rfft、取幅度
+    if (p_ref->Format == OS_SPECTRUM_F32)
+    {
+        float32_t *s = (float32_t *)spec;
+        float32_t *mag = (float32_t *)magnitude;
+
+        arm_mult_f32((float32_t *)buf, (float32_t *)p_ref->Window, (float32_t *)windowed, FFT_LEN);
+        arm_rfft_fast_f32(&p_ref->Fft.F32, (float32_t *)windowed, s, 0);
+        mag[0] = fabsf(s[0]);
+        arm_cmplx_mag_f32(s + 2, mag + 1, half - 1u);
+        mag[half] = fabsf(s[1]);
+    }
+    else
+    {
+        arm_mult_q15((q15_t *)buf, (q15_t *)p_ref->Window, (q15_t *)windowed, FFT_LEN);
+        arm_rfft_q15(&p_ref->Fft.Q15, (q15_t *)windowed, (q15_t *)spec);
+        arm_cmplx_mag_q15((q15_t *)spec, (q15_t *)magnitude, half + 1u);
+    }
+}
+
+/**
+ * @brief  发布回调：当场和参考比较
+ */
+static void OnPublish(const void *magnitude, uint32_t frame, void *arg)
+{
+    RefSpectrum *p_ref = (RefSpectrum *)arg;
+    uint8_t expect[OS_SPECTRUM_BINS(FFT_LEN) * sizeof(float32_t)];
+    uint32_t bytes = OS_SPECTRUM_BINS(FFT_LEN) * p_ref->SampleSize;
+
+    CHECK(frame == p_ref->Checked + 1u);
+    RefFrame(p_ref, frame, expect);
+    if (memcmp(magnitude, expect, bytes) != 0)
+    {
+        printf("FAIL %s hop %u: frame %u differs from the reference\n",
+               (p_ref->Format == OS_SPECTRUM_F32) ? "f32" : "q15", p_ref->Hop, frame);
+        g_Errors++;
+    }
+    p_ref->Checked = frame;
+}
+
+/**
+ * @brief  一种格式、一个帧移：随机小块写入，每帧对比
+ */
+static void TestHop(uint8_t format, uint16_t hop)
+{
+    static uint8_t record[RECORD * sizeof(float32_t)];
+    static uint32_t work[OS_SPECTRUM_WORK_SIZE_Q15(FFT_LEN, 1) / 4u + OS_SPECTRUM_WORK_SIZE_F32(FFT_LEN, 1) / 4u];
+    static uint8_t ring[4096];
+    static float32_t window_f32[FFT_LEN];
+    static q15_t window_q15[FFT_LEN];
+    uint8_t ss = (format == OS_SPECTRUM_F32) ? sizeof(float32_t) : sizeof(q15_t);
+    uint8_t expect[OS_SPECTRUM_BINS(FFT_LEN) * sizeof(float32_t)];
+    uint8_t got[OS_SPECTRUM_BINS(FFT_LEN) * sizeof(float32_t)];
+    uint32_t ring_size = 16u;
+    uint32_t hop_bytes = (uint32_t)hop * ss;
+    uint32_t written = 0;
+    uint32_t wrapped = 0;
+    uint32_t frames = 0;
+    uint32_t i;
+    const void *window = (format == OS_SPECTRUM_F32) ? (const void *)window_f32 : (const void *)window_q15;
+    OS_Spectrum spec;
+    RefSpectrum ref;
+
+    // 1. 队列不小于 4 个帧移：每次写入后都马上处理，写入不会被截断
+    while (ring_size < 4u * hop_bytes)
+        ring_size *= 2u;
+
+    OS_SpectrumHann(format, (void *)window, FFT_LEN);
+    memset(&ref, 0, sizeof(ref));
+    ref.Format = format;
+    ref.SampleSize = ss;
+    ref.Hop = hop;
+    ref.Window = window;
+    ref.Record = record;
+    if (format == OS_SPECTRUM_F32)
+        CHECK(arm_rfft_fast_init_f32(&ref.Fft.F32, FFT_LEN) == ARM_MATH_SUCCESS);
+    else
+        CHECK(arm_rfft_init_q15(&ref.Fft.Q15, FFT_LEN, 0, 1) == ARM_MATH_SUCCESS);
+
+    CHECK(OS_SpectrumInit(&spec, format, FFT_LEN, hop, window, work, ring, ring_size));
+    OS_SpectrumSetPublish(&spec, OnPublish, &ref);
+
+    // 2. 随机样点，随机长度 1..2 * Hop 分块写入
+    for (i = 0; i < FRAMES * hop + hop / 2u; i++)
+    {
+        if (format == OS_SPECTRUM_F32)
+            ((float32_t *)record)[i] = (float32_t)((int32_t)Rand() >> 8) / 8388608.0f;
+        else
+            ((q15_t *)record)[i] = (q15_t)(Rand() >> 16);
+    }
+
+    while (written < FRAMES * hop + hop / 2u)
+    {
+        uint32_t n = 1u + Rand() % (2u * hop);
+        uint32_t before = spec.Frames;
+
+        if (n > FRAMES * hop + hop / 2u - written)
+            n = FRAMES * hop + hop / 2u - written;
+        CHECK(OS_SpectrumWrite(&spec, record + written * ss, n) == n);
+        written += n;
+
+        frames += OS_SpectrumProcess(&spec);
+
+        // 这次处理的帧里，新样点跨过队列绕回处的计数
+        for (i = before; i < spec.Frames; i++)
+        {
+            uint32_t start = (i * hop_bytes) & (ring_size - 1u);
+
+            if (start + hop_bytes > ring_size)
+                wrapped++;
+        }
+    }
+
+    // 3. 帧数、回调、最新一帧
+    CHECK(frames == FRAMES && spec.Frames == FRAMES && ref.Checked == FRAMES);
+    CHECK(spec.Dropped == 0);
+    CHECK(OS_RingBufCount(&spec.Ring) == (uint32_t)(hop / 2u) * ss);
+    CHECK(OS_SpectrumRead(&spec, got) == FRAMES);
+    RefFrame(&ref, FRAMES, expect);
+    CHECK(memcmp(got, expect, OS_SPECTRUM_BINS(FFT_LEN) * ss) == 0);
+    if (ring_size % hop_bytes != 0)
+        CHECK(wrapped > 0);
+
+    printf("%s,%u,%u,%u,%u\n", (format == OS_SPECTRUM_F32) ? "f32" : "q15", FFT_LEN, hop, frames, wrapped);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    // Hop < Overlap，Hop == Overlap，Hop > Overlap，Overlap == 0，以及很小的 Hop
+    static const uint16_t hops[] = {24, 32, 40, 64, 5};
+    uint32_t i;
+
+    printf("format,fft_len,hop,frames,wrapped\n");
+    for (i = 0; i < sizeof(hops) / sizeof(hops[0]); i++)
+    {
+        TestHop(OS_SPECTRUM_F32, hops[i]);
+        TestHop(OS_SPECTRUM_Q15, hops[i]);
+    }
+
+    printf("spectrum_compare: %u errors\n", g_Errors);
+    return g_Errors != 0;
+}
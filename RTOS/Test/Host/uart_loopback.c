@@ -0,0 +1,420 @@
+/**
+ ******************************************************************************
+ * @file    uart_loopback.c
+ * @author  SandOcean
+ * @version V1.0
+ * @date    2025-12-14
+ * @brief   os_uart.c 的回环测试 (Linux 主机，模拟 HAL)
+ *
+ * HAL_UART_Transmit_DMA / HAL_UARTEx_ReceiveToIdle_DMA 由本文件模拟：
+ * 一个扮演中断的“线路”线程每一轮先打一次节拍，再把正在发送的数据
+ * 一次几个字节地搬进循环 DMA 接收区，和真实 HAL 一样在半满、满、
+ * 一帧结束（空闲线）时回调 HAL_UARTEx_RxEventCallback，发完回调
+ * HAL_UART_TxCpltCallback。主线程扮演读写任务，阻塞在驱动的信号量上。
+ *
+ * 覆盖：中断优先级高于内核天花板时拒绝初始化、回环数据逐字节一致（长度 1..150，跨过 64 字节 DMA 区的回绕；
+ * 以及只有空闲线事件、新数据分成尾部和开头两段的情况）、
+ * 发送请求排队顺序、排队超时撤销、读超时、接收溢出计数、出错后重启接收。
+ *
+ ******************************************************************************
+ */
+
+#include "os_uart.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* 宏定义 ----------------------------------------------------------- */
+
+#define RX_DMA_SIZE   64u
+#define RX_RING_SIZE  256u
+#define WIRE_CHUNK    7u     // 每轮“线路”搬运的字节数
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+            g_Errors++;                                                       \
+        }                                                                     \
+    } while (0)
+
+/* 私有变量定义 ------------------------------------------------------ */
+
+static UART_HandleTypeDef g_Huart;
+static DMA_HandleTypeDef g_HdmaRx;
+static DMA_HandleTypeDef g_HdmaTx;
+
+static OS_Uart g_Uart;
+static uint8_t g_RxDmaBuf[RX_DMA_SIZE];
+static uint8_t g_RxRing[RX_RING_SIZE];
+
+static OS_TCB g_TaskTcb;
+static OS_TCB g_IdleTcb;
+static uint32_t g_DummyStack[2][16];
+
+// 模拟的外设状态，只在“中断”里或临界区里修改
+static uint8_t *g_RxBuf;
+static uint16_t g_RxSize;
+static uint16_t g_RxPos;            // DMA 下一个要写的位置
+static uint32_t g_RxStarts;         // HAL_UARTEx_ReceiveToIdle_DMA 调用次数
+static const uint8_t *g_TxData;
+static uint16_t g_TxLen;
+static uint16_t g_TxSent;
+static uint32_t g_TxStarts;         // HAL_UART_Transmit_DMA 成功次数
+static volatile uint8_t g_TxBusy;
+
+static volatile uint8_t g_WirePaused = 0;
+static volatile uint8_t g_WireIdleOnly = 0;   // 只报空闲线事件（半满/满中断来迟、合并进空闲事件）
+static volatile uint8_t g_Stop = 0;
+static uint32_t g_Errors = 0;
+
+/* 模拟 HAL ---------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    g_RxBuf = pData;
+    g_RxSize = Size;
+    g_RxPos = 0;
+    g_RxStarts++;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    if (g_TxBusy)
+        return HAL_BUSY;
+
+    g_TxData = pData;
+    g_TxLen = Size;
+    g_TxSent = 0;
+    g_TxStarts++;
+    g_TxBusy = 1;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    return HAL_OK;
+}
+
+// 一个字节落进循环 DMA 区：半满、满各回调一次
+static void WireRxByte(uint8_t b)
+{
+    g_RxBuf[g_RxPos++] = b;
+    if (g_WireIdleOnly)
+    {
+        if (g_RxPos == g_RxSize)
+            g_RxPos = 0;
+    }
+    else if (g_RxPos == g_RxSize / 2u)
+    {
+        HAL_UARTEx_RxEventCallback(&g_Huart, g_RxPos);
+    }
+    else if (g_RxPos == g_RxSize)
+    {
+        HAL_UARTEx_RxEventCallback(&g_Huart, g_RxSize);
+        g_RxPos = 0;
+    }
+}
+
+// 空闲线：和 HAL 一样，只有 DMA 停在区间中间时才回调
+static void WireRxIdle(void)
+{
+    if (g_RxPos > 0 && g_RxPos < g_RxSize)
+        HAL_UARTEx_RxEventCallback(&g_Huart, g_RxPos);
+    else if (g_WireIdleOnly)
+        HAL_UARTEx_RxEventCallback(&g_Huart, g_RxSize);
+}
+
+static void *WireThread(void *arg)
+{
+    struct timespec nap = {0, 20000};
+    uint32_t i;
+
+    (void)arg;
+    while (!g_Stop)
+    {
+        nanosleep(&nap, NULL);
+
+        HostIsrEnter();
+        OS_Tick_Handler();
+        HostIsrExit();
+
+        if (g_WirePaused || !g_TxBusy)
+            continue;
+
+        // DMA 搬运 + 接收事件 + 发送完成，都是中断（OS_CFG_DEBUG_CHECKS 按 USART1 的优先级检查）
+        HostIsrEnter();
+        t_HostActiveIRQn = USART1_IRQn;
+        for (i = 0; i < WIRE_CHUNK && g_TxSent < g_TxLen; i++)
+        {
+            WireRxByte(g_TxData[g_TxSent++]);
+        }
+        if (g_TxSent == g_TxLen)
+        {
+            WireRxIdle();
+            g_TxBusy = 0;
+            g_Huart.gState = HAL_UART_STATE_READY;
+            HAL_UART_TxCpltCallback(&g_Huart);
+        }
+        t_HostActiveIRQn = -1;
+        HostIsrExit();
+    }
+    return NULL;
+}
+
+/* 私有函数定义 ------------------------------------------------------ */
+
+static void Pattern(uint8_t *buf, uint32_t len, uint32_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+// 读满 len 个字节，每次最多等 timeout 个节拍
+static uint32_t ReadAll(uint8_t *buf, uint32_t len, uint32_t timeout)
+{
+    uint32_t got = 0;
+    uint32_t n;
+
+    while (got < len)
+    {
+        n = OS_UartRead(&g_Uart, buf + got, len - got, timeout);
+        if (n == 0)
+            break;
+        got += n;
+    }
+    return got;
+}
+
+static void TestInit(void)
+{
+    g_HdmaRx.Init.Mode = DMA_NORMAL;
+    CHECK(OS_UartInit(&g_Uart, &g_Huart, g_RxDmaBuf, RX_DMA_SIZE, g_RxRing, RX_RING_SIZE) == 0);
+    g_HdmaRx.Init.Mode = DMA_CIRCULAR;
+
+    // 三个中断任何一个还是复位值 0（高于内核天花板）都不行
+    g_HostIrqPrio[USART1_IRQn] = 0;
+    CHECK(OS_UartInit(&g_Uart, &g_Huart, g_RxDmaBuf, RX_DMA_SIZE, g_RxRing, RX_RING_SIZE) == 0);
+    g_HostIrqPrio[USART1_IRQn] = OS_CFG_MAX_SYSCALL_PRIO;
+    g_HostIrqPrio[DMA1_Channel4_IRQn] = OS_CFG_MAX_SYSCALL_PRIO - 1;
+    CHECK(OS_UartInit(&g_Uart, &g_Huart, g_RxDmaBuf, RX_DMA_SIZE, g_RxRing, RX_RING_SIZE) == 0);
+    g_HostIrqPrio[DMA1_Channel4_IRQn] = 6;
+    g_HdmaRx.Instance = (DMA_Channel_TypeDef *)USART1_BASE; // 不是 DMA 通道
+    CHECK(OS_UartInit(&g_Uart, &g_Huart, g_RxDmaBuf, RX_DMA_SIZE, g_RxRing, RX_RING_SIZE) == 0);
+    g_HdmaRx.Instance = DMA1_Channel5;
+    CHECK(g_RxStarts == 0);
+
+    CHECK(OS_UartInit(&g_Uart, &g_Huart, g_RxDmaBuf, RX_DMA_SIZE, g_RxRing, RX_RING_SIZE) == 1);
+    CHECK(g_RxStarts == 1);
+    CHECK(g_RxBuf == g_RxDmaBuf && g_RxSize == RX_DMA_SIZE);
+}
+
+static void TestLoopback(void)
+{
+    static uint8_t tx[150];
+    static uint8_t rx[150];
+    uint32_t len;
+    uint32_t starts = g_TxStarts;
+
+    for (len = 1; len <= sizeof(tx); len++)
+    {
+        Pattern(tx, len, len);
+        memset(rx, 0, sizeof(rx));
+
+        CHECK(OS_UartWrite(&g_Uart, tx, (uint16_t)len, OS_WAIT_FOREVER) == 1);
+        CHECK(ReadAll(rx, len, 50) == len);
+        if (memcmp(tx, rx, len) != 0)
+        {
+            printf("FAIL loopback: %u bytes differ\n", len);
+            g_Errors++;
+        }
+    }
+    CHECK(g_TxStarts - starts == sizeof(tx));
+    CHECK(OS_RingBufCount(&g_Uart.Rx) == 0);
+    CHECK(g_Uart.RxOverflow == 0);
+}
+
+static void TestWrapAtIdle(void)
+{
+    static uint8_t tx[RX_DMA_SIZE - 1];
+    static uint8_t rx[RX_DMA_SIZE - 1];
+    uint32_t len;
+
+    // 每帧只在空闲线报一次，DMA 位置经常已经绕过末尾（新数据分两段）
+    g_WireIdleOnly = 1;
+    for (len = 1; len <= sizeof(tx); len++)
+    {
+        Pattern(tx, len, 500 + len);
+        CHECK(OS_UartWrite(&g_Uart, tx, (uint16_t)len, OS_WAIT_FOREVER) == 1);
+        CHECK(ReadAll(rx, len, 50) == len);
+        if (memcmp(tx, rx, len) != 0)
+        {
+            printf("FAIL wrap at idle: %u bytes differ\n", len);
+            g_Errors++;
+        }
+    }
+    g_WireIdleOnly = 0;
+    CHECK(OS_RingBufCount(&g_Uart.Rx) == 0);
+}
+
+static void TestQueue(void)
+{
+    static uint8_t a[40], b[70], c[25];
+    static uint8_t rx[135];
+    OS_UartTxReq ra, rb, rc;
+    uint32_t starts = g_TxStarts;
+
+    Pattern(a, sizeof(a), 101);
+    Pattern(b, sizeof(b), 102);
+    Pattern(c, sizeof(c), 103);
+
+    // 1. 线路暂停：只有队列头交给了 DMA
+    g_WirePaused = 1;
+    CHECK(OS_UartWriteAsync(&g_Uart, &ra, a, sizeof(a)) == 1);
+    CHECK(OS_UartWriteAsync(&g_Uart, &rb, b, sizeof(b)) == 1);
+    CHECK(OS_UartWriteAsync(&g_Uart, &rc, c, sizeof(c)) == 1);
+    CHECK(g_TxStarts - starts == 1);
+    CHECK(g_TxData == a && g_TxLen == sizeof(a));
+    CHECK(OS_UartTxWait(&ra, 0) == 0);
+
+    // 2. 放开线路：按顺序发完，等最后一个就够了
+    g_WirePaused = 0;
+    CHECK(OS_UartTxWait(&rc, OS_WAIT_FOREVER) == 1);
+    CHECK(OS_UartTxWait(&ra, 0) == 1);
+    CHECK(OS_UartTxWait(&rb, 0) == 1);
+    CHECK(g_TxStarts - starts == 3);
+
+    CHECK(ReadAll(rx, sizeof(rx), 50) == sizeof(rx));
+    CHECK(memcmp(rx, a, sizeof(a)) == 0);
+    CHECK(memcmp(rx + sizeof(a), b, sizeof(b)) == 0);
+    CHECK(memcmp(rx + sizeof(a) + sizeof(b), c, sizeof(c)) == 0);
+}
+
+static void TestWriteTimeout(void)
+{
+    static uint8_t a[30], b[20];
+    static uint8_t rx[64];
+    OS_UartTxReq ra;
+    uint32_t starts = g_TxStarts;
+    uint64_t t0;
+
+    Pattern(a, sizeof(a), 201);
+    Pattern(b, sizeof(b), 202);
+
+    // 1. a 占着 DMA 发不完，b 在队列里等 5 个节拍后撤销
+    g_WirePaused = 1;
+    CHECK(OS_UartWriteAsync(&g_Uart, &ra, a, sizeof(a)) == 1);
+    t0 = g_SystemTickCount;
+    CHECK(OS_UartWrite(&g_Uart, b, sizeof(b), 5) == 0);
+    CHECK(g_SystemTickCount - t0 >= 5);
+    CHECK(g_Uart.TxHead == &ra && g_Uart.TxTail == &ra && ra.Next == NULL);
+
+    // 2. a 发完后不会再启动 b
+    g_WirePaused = 0;
+    CHECK(OS_UartTxWait(&ra, OS_WAIT_FOREVER) == 1);
+    CHECK(g_TxStarts - starts == 1);
+    CHECK(ReadAll(rx, sizeof(a), 50) == sizeof(a));
+    CHECK(memcmp(rx, a, sizeof(a)) == 0);
+    CHECK(OS_UartRead(&g_Uart, rx, sizeof(rx), 3) == 0);
+}
+
+static void TestReadTimeout(void)
+{
+    uint8_t rx[8];
+    uint64_t t0 = g_SystemTickCount;
+
+    CHECK(OS_UartRead(&g_Uart, rx, sizeof(rx), 0) == 0);
+    CHECK(OS_UartRead(&g_Uart, rx, sizeof(rx), 10) == 0);
+    CHECK(g_SystemTickCount - t0 >= 10);
+}
+
+static void TestOverflow(void)
+{
+    static uint8_t tx[RX_RING_SIZE + 44];
+    static uint8_t rx[RX_RING_SIZE];
+
+    // 不读，发得比环形缓冲区还多：多出来的字节丢弃并计数
+    Pattern(tx, sizeof(tx), 301);
+    CHECK(OS_UartWrite(&g_Uart, tx, sizeof(tx) / 2, OS_WAIT_FOREVER) == 1);
+    CHECK(OS_UartWrite(&g_Uart, tx + sizeof(tx) / 2, sizeof(tx) - sizeof(tx) / 2, OS_WAIT_FOREVER) == 1);
+    CHECK(g_Uart.RxOverflow == 44);
+    CHECK(ReadAll(rx, sizeof(rx), 5) == sizeof(rx));
+    CHECK(memcmp(rx, tx, sizeof(rx)) == 0);
+    g_Uart.RxOverflow = 0;
+}
+
+static void TestErrorRestart(void)
+{
+    static uint8_t tx[50];
+    static uint8_t rx[50];
+    uint32_t starts;
+
+    // 1. DMA 停在区间中间时出错，HAL 停掉接收、RxState 回到 READY
+    Pattern(tx, 10, 401);
+    CHECK(OS_UartWrite(&g_Uart, tx, 10, OS_WAIT_FOREVER) == 1);
+    CHECK(ReadAll(rx, 10, 5) == 10);
+
+    HostIsrEnter();
+    starts = g_RxStarts;
+    g_Huart.RxState = HAL_UART_STATE_READY;
+    HAL_UART_ErrorCallback(&g_Huart);
+    HostIsrExit();
+
+    // 2. 驱动重新从 DMA 区开头接收，位置也跟着复位
+    CHECK(g_RxStarts == starts + 1);
+    CHECK(g_Uart.RxDmaPos == 0);
+    Pattern(tx, sizeof(tx), 402);
+    CHECK(OS_UartWrite(&g_Uart, tx, sizeof(tx), OS_WAIT_FOREVER) == 1);
+    CHECK(ReadAll(rx, sizeof(rx), 50) == sizeof(rx));
+    CHECK(memcmp(rx, tx, sizeof(rx)) == 0);
+}
+
+/* 函数声明 ----------------------------------------------------------- */
+
+int main(void)
+{
+    pthread_t wire;
+
+    // 1. 一个任务（主线程）加一个空闲任务，调度器视为已经启动
+    OS_TaskCreate(&g_IdleTcb, NULL, g_DummyStack[0], 16);
+    OS_TaskCreate(&g_TaskTcb, NULL, g_DummyStack[1], 16);
+    HostTaskBind(&g_TaskTcb);
+    g_OSRunning = 1;
+
+    // USART1：接收 DMA1 通道 5，发送 DMA1 通道 4，中断优先级都在内核天花板之下
+    g_Huart.Instance = USART1;
+    g_Huart.hdmarx = &g_HdmaRx;
+    g_Huart.hdmatx = &g_HdmaTx;
+    g_HdmaRx.Instance = DMA1_Channel5;
+    g_HdmaTx.Instance = DMA1_Channel4;
+    g_HostIrqPrio[USART1_IRQn] = 6;
+    g_HostIrqPrio[DMA1_Channel5_IRQn] = 6;
+    g_HostIrqPrio[DMA1_Channel4_IRQn] = 6;
+    g_Huart.gState = HAL_UART_STATE_READY;
+    g_Huart.RxState = HAL_UART_STATE_READY;
+    g_HdmaTx.Init.Mode = DMA_NORMAL;
+
+    pthread_create(&wire, NULL, WireThread, NULL);
+
+    TestInit();
+    TestLoopback();
+    TestWrapAtIdle();
+    TestQueue();
+    TestWriteTimeout();
+    TestReadTimeout();
+    TestOverflow();
+    TestErrorRestart();
+
+    g_Stop = 1;
+    pthread_join(wire, NULL);
+
+    printf("uart_loopback: %u ticks, %u transmits, %u errors\n",
+           (uint32_t)g_SystemTickCount, g_TxStarts, g_Errors);
+    return g_Errors != 0;
+}